@@ -28,13 +28,23 @@
 #include "descriptor/include/Descriptor.h"
 #include "gwafile/include/GwaFile.h"
 #include "gwasqc/include/analyzer/Analyzer.h"
+#include "gwasqc/include/analyzer/AnalyzerPool.h"
 #include "gwasformat/include/formatter/Formatter.h"
 #include "annotation/include/Annotator.h"
+#include "pipeline/include/Pipeline.h"
 #include "harmonization/include/Harmonizer.h"
 #include "harmonization/include/Harmonizer2.h"
 #include "independization/include/Selector.h"
 #include "randomeffect/include/Sampler.h"
 
+#include "Rversion.h"
+#include "R_ext/Rdynload.h"
+
+#if defined(R_VERSION) && (R_VERSION >= R_Version(3, 5, 0))
+#include "R_ext/Altrep.h"
+#define PLOT_ARRAYS_ALTREP
+#endif
+
 /* Define LINUX flag for compilation under Linux */
 #ifndef WIN32
 #define LINUX
@@ -147,6 +157,11 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 	SEXP renamed_columns = R_NilValue;
 	SEXP reordered_columns = R_NilValue;
 	SEXP ld_files = R_NilValue;
+	SEXP precisions = R_NilValue;
+	SEXP histograms = R_NilValue;
+	SEXP histogram_names = R_NilValue;
+	SEXP histogram_ranges = R_NilValue;
+	SEXP histogram_range = R_NilValue;
 
 	if (external_descriptor_pointer == R_NilValue) {
 		error("\nThe external Descriptor pointer argument is NULL.");
@@ -158,7 +173,7 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 
 	descriptor = (Descriptor*)R_ExternalPtrAddr(external_descriptor_pointer);
 
-	PROTECT(attributes = allocVector(STRSXP, 11));
+	PROTECT(attributes = allocVector(STRSXP, 13));
 	SET_STRING_ELT(attributes, 0, mkChar("path_separator"));
 	SET_STRING_ELT(attributes, 1, mkChar("name"));
 	SET_STRING_ELT(attributes, 2, mkChar("path"));
@@ -170,11 +185,13 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 	SET_STRING_ELT(attributes, 8, mkChar("renamed_columns"));
 	SET_STRING_ELT(attributes, 9, mkChar("reordered_columns"));
 	SET_STRING_ELT(attributes, 10, mkChar("ld_files"));
+	SET_STRING_ELT(attributes, 11, mkChar("precisions"));
+	SET_STRING_ELT(attributes, 12, mkChar("histograms"));
 
 	PROTECT(class_name = allocVector(STRSXP, 1));
 	SET_STRING_ELT(class_name, 0, mkChar("Descriptor"));
 
-	PROTECT(descriptor_robj = allocVector(VECSXP, 11));
+	PROTECT(descriptor_robj = allocVector(VECSXP, 13));
 
 	PROTECT(path_separator = allocVector(STRSXP, 1));
 	buffer[0] = descriptor->get_path_separator();
@@ -312,6 +329,55 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 		UNPROTECT(1);
 	}
 
+	if (descriptor->precisions.size() > 0) {
+		PROTECT(precisions = allocMatrix(STRSXP, descriptor->precisions.size(), 2));
+
+		descriptor->map_char_it = descriptor->precisions.begin();
+		i = 0;
+		while (descriptor->map_char_it != descriptor->precisions.end()) {
+			SET_STRING_ELT(precisions, i, mkChar(descriptor->map_char_it->first));
+			SET_STRING_ELT(precisions, i + descriptor->precisions.size(), mkChar(descriptor->map_char_it->second));
+			i += 1;
+			descriptor->map_char_it++;
+		}
+
+		UNPROTECT(1);
+	}
+
+	if (descriptor->histograms.size() > 0) {
+		PROTECT(histogram_names = allocVector(STRSXP, descriptor->histograms.size()));
+		PROTECT(histogram_ranges = allocVector(VECSXP, descriptor->histograms.size()));
+
+		descriptor->map_vect_it = descriptor->histograms.begin();
+		i = 0;
+		while (descriptor->map_vect_it != descriptor->histograms.end()) {
+			PROTECT(histogram_range = allocVector(REALSXP, descriptor->map_vect_it->second->size()));
+
+			descriptor->vector_double_it = descriptor->map_vect_it->second->begin();
+			j = 0;
+			while (descriptor->vector_double_it != descriptor->map_vect_it->second->end()) {
+				REAL(histogram_range)[j] = *(descriptor->vector_double_it);
+				j += 1;
+				descriptor->vector_double_it++;
+			}
+
+			UNPROTECT(1);
+
+			SET_STRING_ELT(histogram_names, i, mkChar(descriptor->map_vect_it->first));
+			SET_VECTOR_ELT(histogram_ranges, i, histogram_range);
+
+			i += 1;
+			descriptor->map_vect_it++;
+		}
+
+		PROTECT(histograms = allocVector(VECSXP, 2));
+
+		SET_VECTOR_ELT(histograms, 0, histogram_names);
+		SET_VECTOR_ELT(histograms, 1, histogram_ranges);
+
+		UNPROTECT(3);
+	}
+
 	SET_VECTOR_ELT(descriptor_robj, 0, path_separator);
 	SET_VECTOR_ELT(descriptor_robj, 1, name);
 	SET_VECTOR_ELT(descriptor_robj, 2, path);
@@ -323,6 +389,8 @@ SEXP Descriptor2Robj(SEXP external_descriptor_pointer) {
 	SET_VECTOR_ELT(descriptor_robj, 8, renamed_columns);
 	SET_VECTOR_ELT(descriptor_robj, 9, reordered_columns);
 	SET_VECTOR_ELT(descriptor_robj, 10, ld_files);
+	SET_VECTOR_ELT(descriptor_robj, 11, precisions);
+	SET_VECTOR_ELT(descriptor_robj, 12, histograms);
 
 	setAttrib(descriptor_robj, R_NamesSymbol, attributes);
 	setAttrib(descriptor_robj, R_ClassSymbol, class_name);
@@ -368,6 +436,11 @@ SEXP Robj2Descriptor(SEXP descriptor_Robj) {
 	SEXP renamed_columns = R_NilValue;
 	SEXP reordered_columns = R_NilValue;
 	SEXP ld_files = R_NilValue;
+	SEXP precisions = R_NilValue;
+	SEXP histograms = R_NilValue;
+	SEXP histogram_names = R_NilValue;
+	SEXP histogram_ranges = R_NilValue;
+	SEXP histogram_range = R_NilValue;
 
 	int ncol = 0;
 
@@ -544,6 +617,54 @@ SEXP Robj2Descriptor(SEXP descriptor_Robj) {
 //						descriptor->add_ld_file(CHAR(STRING_ELT(ld_files, j)), CHAR(STRING_ELT(ld_files, j + ncol / 2)));
 //					}
 //				}
+			} else if (strcmp(value, "precisions") == 0) {
+				precisions = VECTOR_ELT(descriptor_Robj, i);
+				if (precisions != R_NilValue) {
+					if (!isMatrix(precisions)) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+					if ((ncol = length(precisions)) % 2 != 0) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+					for (int j = 0; j < ncol / 2; j++) {
+						descriptor->add_precision(CHAR(STRING_ELT(precisions, j)), CHAR(STRING_ELT(precisions, j + ncol / 2)));
+					}
+				}
+			} else if (strcmp(value, "histograms") == 0) {
+				histograms = VECTOR_ELT(descriptor_Robj, i);
+				if (histograms != R_NilValue) {
+					if (!isVector(histograms)) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+					if (length(histograms) != 2) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+
+					histogram_names = VECTOR_ELT(histograms, 0);
+					if ((histogram_names == R_NilValue) || (!isString(histogram_names))) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+
+					histogram_ranges = VECTOR_ELT(histograms, 1);
+					if ((histogram_ranges == R_NilValue) || (!isVector(histogram_ranges))) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+
+					ncol = length(histogram_names);
+					if (ncol != length(histogram_ranges)) {
+						error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+					}
+
+					for (int j = 0; j < ncol; j++) {
+						histogram_range = VECTOR_ELT(histogram_ranges, j);
+						if ((histogram_range == R_NilValue) || (TYPEOF(histogram_range) != REALSXP) || (length(histogram_range) != 2)) {
+							error("\nMismatch in Descriptor class structure on line %d.", __LINE__);
+						}
+						for (int k = 0; k < 2; k++) {
+							descriptor->add_histogram(CHAR(STRING_ELT(histogram_names, j)), REAL(histogram_range)[k]);
+						}
+					}
+				}
 			}
 		}
 
@@ -572,6 +693,96 @@ SEXP Robj2Descriptor(SEXP descriptor_Robj) {
 	return external_descriptor_pointer;
 }
 
+#ifdef PLOT_ARRAYS_ALTREP
+/*
+ * Plot arrays are handed over to R without copying. A plot array vector is an ALTREP view of a memory block taken
+ * from a plot: the block is owned by an external pointer (data1), which frees it when no view refers to it anymore,
+ * and the offset and the length of the view inside the block are kept in data2.
+ */
+static R_altrep_class_t plot_array_class;
+
+static void plot_array_finalize(SEXP owner) {
+	void* block = R_ExternalPtrAddr(owner);
+
+	if (block != NULL) {
+		free(block);
+		R_ClearExternalPtr(owner);
+	}
+}
+
+static R_xlen_t plot_array_length(SEXP x) {
+	return (R_xlen_t)REAL(R_altrep_data2(x))[1];
+}
+
+static void* plot_array_dataptr(SEXP x, Rboolean writeable) {
+	return (double*)R_ExternalPtrAddr(R_altrep_data1(x)) + (R_xlen_t)REAL(R_altrep_data2(x))[0];
+}
+
+static const void* plot_array_dataptr_or_null(SEXP x) {
+	return plot_array_dataptr(x, FALSE);
+}
+
+static double plot_array_elt(SEXP x, R_xlen_t i) {
+	return ((double*)plot_array_dataptr(x, FALSE))[i];
+}
+#endif
+
+/*
+ * Returns the length values of the *array plot array, starting at offset, as an R vector. With ALTREP (R >= 3.5.0) the
+ * array is taken from the plot when its first view is created: *array is set to NULL and *owner keeps the external
+ * pointer, which must be passed again for the other views of the same array. Otherwise the values are copied.
+ */
+static SEXP PlotArray2Robj(double** array, SEXP* owner, R_xlen_t offset, R_xlen_t length) {
+	SEXP robj = R_NilValue;
+	double* robj_ptr = NULL;
+
+#ifdef PLOT_ARRAYS_ALTREP
+	SEXP view = R_NilValue;
+
+	if (length > 0) {
+		if (*owner == R_NilValue) {
+			PROTECT(*owner = R_MakeExternalPtr((void*)*array, R_NilValue, R_NilValue));
+			R_RegisterCFinalizerEx(*owner, plot_array_finalize, TRUE);
+			*array = NULL;
+		} else {
+			PROTECT(*owner);
+		}
+
+		PROTECT(view = allocVector(REALSXP, 2));
+		REAL(view)[0] = (double)offset;
+		REAL(view)[1] = (double)length;
+
+		robj = R_new_altrep(plot_array_class, *owner, view);
+
+		UNPROTECT(2);
+
+		return robj;
+	}
+#endif
+
+	PROTECT(robj = allocVector(REALSXP, length));
+
+	robj_ptr = REAL(robj);
+	for (R_xlen_t j = 0; j < length; j++) {
+		robj_ptr[j] = (*array)[offset + j];
+	}
+
+	UNPROTECT(1);
+
+	return robj;
+}
+
+void R_init_GWAtoolbox(DllInfo* dll) {
+#ifdef PLOT_ARRAYS_ALTREP
+	plot_array_class = R_make_altreal_class("plot_array", "GWAtoolbox", dll);
+
+	R_set_altrep_Length_method(plot_array_class, plot_array_length);
+	R_set_altvec_Dataptr_method(plot_array_class, plot_array_dataptr);
+	R_set_altvec_Dataptr_or_null_method(plot_array_class, plot_array_dataptr_or_null);
+	R_set_altreal_Elt_method(plot_array_class, plot_array_elt);
+#endif
+}
+
 SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 	Boxplot* boxplot = NULL;
 
@@ -587,6 +798,7 @@ SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 	SEXP title = R_NilValue;
 	SEXP widths = R_NilValue;
 	SEXP quantiles = R_NilValue;
+	SEXP outliers_totals = R_NilValue;
 	SEXP boxplot_names = R_NilValue;
 
 	double* tukey_ptr = NULL;
@@ -595,6 +807,7 @@ SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 	double* groups_ptr = NULL;
 	double* widths_ptr = NULL;
 	double* quantiles_ptr = NULL;
+	double* outliers_totals_ptr = NULL;
 
 	if (external_boxplot_pointer == R_NilValue) {
 		error("\nThe external Boxplot pointer argument is NULL.");
@@ -614,7 +827,7 @@ SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 	SET_STRING_ELT(boxplot_names, 4, mkChar("group"));
 	SET_STRING_ELT(boxplot_names, 5, mkChar("names"));
 
-	PROTECT(boxplot_wrapper_obj = allocVector(VECSXP, 4));
+	PROTECT(boxplot_wrapper_obj = allocVector(VECSXP, 5));
 
 	PROTECT(boxplot_robj = allocVector(VECSXP, 6));
 
@@ -627,6 +840,7 @@ SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 	PROTECT(widths = allocVector(REALSXP, boxplot->groups_cnt));
 	PROTECT(quantiles = allocVector(REALSXP, 5));
 	PROTECT(title = allocVector(STRSXP, 1));
+	PROTECT(outliers_totals = allocVector(REALSXP, boxplot->groups_cnt));
 
 	tukey_ptr = REAL(tukey);
 	observations_ptr = REAL(observations);
@@ -634,6 +848,7 @@ SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 	groups_ptr = REAL(groups);
 	widths_ptr = REAL(widths);
 	quantiles_ptr = REAL(quantiles);
+	outliers_totals_ptr = REAL(outliers_totals);
 
 	for (int j = 0; j < (Boxplot::TUKEY_SIZE * boxplot->groups_cnt); j++) {
 		tukey_ptr[j] = boxplot->tukey[j];
@@ -643,6 +858,7 @@ SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 		observations_ptr[j] = boxplot->observations[j];
 		SET_STRING_ELT(names, j, mkChar(boxplot->names[j]));
 		widths_ptr[j] = boxplot->widths[j];
+		outliers_totals_ptr[j] = (double)boxplot->outliers_totals[j];
 	}
 
 	for (int j = 0; j < boxplot->outliers_cnt; j++) {
@@ -669,8 +885,9 @@ SEXP Boxplot2Robj(SEXP external_boxplot_pointer) {
 	SET_VECTOR_ELT(boxplot_wrapper_obj, 1, quantiles);
 	SET_VECTOR_ELT(boxplot_wrapper_obj, 2, widths);
 	SET_VECTOR_ELT(boxplot_wrapper_obj, 3, title);
+	SET_VECTOR_ELT(boxplot_wrapper_obj, 4, outliers_totals);
 
-	UNPROTECT(12);
+	UNPROTECT(13);
 
 	return boxplot_wrapper_obj;
 }
@@ -691,11 +908,12 @@ SEXP Histogram2Robj(SEXP external_histogram_pointer) {
 	SEXP histogram_names = R_NilValue;
 	SEXP histogram_class = R_NilValue;
 
-	double* breaks_ptr = NULL;
+	SEXP breaks_owner = R_NilValue;
+	SEXP density_owner = R_NilValue;
+	SEXP mids_owner = R_NilValue;
+
 	double* counts_ptr = NULL;
-	double* density_ptr = NULL;
 	double* intensities_ptr = NULL;
-	double* mids_ptr = NULL;
 
 	if (external_histogram_pointer == R_NilValue) {
 		error("\nThe external Histogram pointer argument is NULL.");
@@ -721,30 +939,28 @@ SEXP Histogram2Robj(SEXP external_histogram_pointer) {
 
 	PROTECT(histogram_robj = allocVector(VECSXP, 8));
 
-	PROTECT(breaks = allocVector(REALSXP, histogram->nclass + 1));
+	/* The counts are 64-bit integers and the intensities share their array with the densities: both are copied. */
 	PROTECT(counts = allocVector(REALSXP, histogram->nclass));
-	PROTECT(density = allocVector(REALSXP, histogram->nclass));
 	PROTECT(intensities = allocVector(REALSXP, histogram->nclass));
-	PROTECT(mids = allocVector(REALSXP, histogram->nclass));
 	PROTECT(xname = allocVector(STRSXP, 1));
 	PROTECT(equidist = allocVector(LGLSXP, 1));
 	PROTECT(title = allocVector(STRSXP, 1));
 
-	breaks_ptr = REAL(breaks);
 	counts_ptr = REAL(counts);
-	density_ptr = REAL(density);
 	intensities_ptr = REAL(intensities);
-	mids_ptr = REAL(mids);
 
 	for (int j = 0; j < histogram->nclass; j++) {
-		breaks_ptr[j] = histogram->breaks[j];
 		counts_ptr[j] = histogram->counts[j];
-		density_ptr[j] = histogram->density[j];
 		intensities_ptr[j] = histogram->intensities[j];
-		mids_ptr[j] = histogram->mids[j];
 	}
 
-	breaks_ptr[histogram->nclass] = histogram->breaks[histogram->nclass];
+	PROTECT(breaks = PlotArray2Robj(&histogram->breaks, &breaks_owner, 0, histogram->nclass + 1));
+	PROTECT(density = PlotArray2Robj(&histogram->density, &density_owner, 0, histogram->nclass));
+	PROTECT(mids = PlotArray2Robj(&histogram->mids, &mids_owner, 0, histogram->nclass));
+
+	if (histogram->density == NULL) {
+		histogram->intensities = NULL;
+	}
 
 	SET_STRING_ELT(xname, 0, mkChar(histogram->xname));
 	LOGICAL(equidist)[0] = 1;
@@ -780,8 +996,8 @@ SEXP Qqplot2Robj(SEXP external_qqplot_pointer) {
 	SEXP x = R_NilValue;
 	SEXP y = R_NilValue;
 
-	double* x_ptr = NULL;
-	double* y_ptr = NULL;
+	SEXP x_owner = R_NilValue;
+	SEXP y_owner = R_NilValue;
 
 	int qqplot_coord_index = 0;
 
@@ -801,23 +1017,22 @@ SEXP Qqplot2Robj(SEXP external_qqplot_pointer) {
 		PROTECT(name = allocVector(STRSXP, 1));
 		PROTECT(color = allocVector(STRSXP, 1));
 		PROTECT(lambda = allocVector(REALSXP, 1));
-		PROTECT(points = allocVector(INTSXP, 1));
-		PROTECT(x = allocVector(REALSXP, qqplot->size[k]));
-		PROTECT(y = allocVector(REALSXP, qqplot->size[k]));
-
-		x_ptr = REAL(x);
-		y_ptr = REAL(y);
+		/* The number of p-values stays an integer in R, unless it doesn't fit. */
+		PROTECT(points = allocVector(qqplot->points[k] > numeric_limits<int>::max() ? REALSXP : INTSXP, 1));
+		/* All lines share the x and y arrays, which are handed over to R as a whole. */
+		PROTECT(x = PlotArray2Robj(&qqplot->x, &x_owner, qqplot_coord_index, qqplot->size[k]));
+		PROTECT(y = PlotArray2Robj(&qqplot->y, &y_owner, qqplot_coord_index, qqplot->size[k]));
 
-		for (int j = 0; j < qqplot->size[k]; j++) {
-			x_ptr[j] = qqplot->x[qqplot_coord_index];
-			y_ptr[j] = qqplot->y[qqplot_coord_index];
-			qqplot_coord_index += 1;
-		}
+		qqplot_coord_index += qqplot->size[k];
 
 		SET_STRING_ELT(name, 0, mkChar(qqplot->names[k]));
 		SET_STRING_ELT(color, 0, mkChar(qqplot->colors[k]));
 		REAL(lambda)[0] = qqplot->lambdas[k];
-		INTEGER(points)[0] = qqplot->points[k];
+		if (TYPEOF(points) == REALSXP) {
+			REAL(points)[0] = qqplot->points[k];
+		} else {
+			INTEGER(points)[0] = (int)qqplot->points[k];
+		}
 
 		SET_VECTOR_ELT(qqplot_robj, k * 6, name);
 		SET_VECTOR_ELT(qqplot_robj, k * 6 + 1, color);
@@ -834,6 +1049,76 @@ SEXP Qqplot2Robj(SEXP external_qqplot_pointer) {
 	return qqplot_robj;
 }
 
+SEXP Manhattan2Robj(SEXP external_manhattan_pointer) {
+	Manhattan* manhattan = NULL;
+
+	SEXP manhattan_robj = R_NilValue;
+
+	SEXP chromosome_names = R_NilValue;
+	SEXP offsets = R_NilValue;
+	SEXP x = R_NilValue;
+	SEXP y = R_NilValue;
+	SEXP chromosomes = R_NilValue;
+	SEXP threshold = R_NilValue;
+	SEXP points = R_NilValue;
+
+	SEXP x_owner = R_NilValue;
+	SEXP y_owner = R_NilValue;
+
+	if (external_manhattan_pointer == R_NilValue) {
+		error("\nThe external Manhattan pointer argument is NULL.");
+	}
+
+	if (TYPEOF(external_manhattan_pointer) != EXTPTRSXP) {
+		error("\nThe external Manhattan pointer argument has an incorrect type.");
+	}
+
+	manhattan = (Manhattan*)R_ExternalPtrAddr(external_manhattan_pointer);
+
+	PROTECT(manhattan_robj = allocVector(VECSXP, 7));
+
+	PROTECT(chromosome_names = allocVector(STRSXP, manhattan->chromosomes_count));
+	PROTECT(offsets = allocVector(REALSXP, manhattan->chromosomes_count + 1));
+	PROTECT(x = PlotArray2Robj(&manhattan->x, &x_owner, 0, manhattan->size));
+	PROTECT(y = PlotArray2Robj(&manhattan->y, &y_owner, 0, manhattan->size));
+	PROTECT(chromosomes = allocVector(INTSXP, manhattan->size));
+	PROTECT(threshold = allocVector(REALSXP, 1));
+	/* The number of p-values stays an integer in R, unless it doesn't fit. */
+	PROTECT(points = allocVector(manhattan->points > numeric_limits<int>::max() ? REALSXP : INTSXP, 1));
+
+	for (int k = 0; k < manhattan->chromosomes_count; k++) {
+		SET_STRING_ELT(chromosome_names, k, mkChar(manhattan->chromosome_names[k]));
+	}
+
+	for (int k = 0; k <= manhattan->chromosomes_count; k++) {
+		REAL(offsets)[k] = manhattan->offsets[k];
+	}
+
+	/* Chromosomes are numbered from 1 in R. */
+	for (int64_t i = 0; i < manhattan->size; i++) {
+		INTEGER(chromosomes)[i] = manhattan->chromosomes[i] + 1;
+	}
+
+	REAL(threshold)[0] = manhattan->threshold;
+	if (TYPEOF(points) == REALSXP) {
+		REAL(points)[0] = manhattan->points;
+	} else {
+		INTEGER(points)[0] = (int)manhattan->points;
+	}
+
+	SET_VECTOR_ELT(manhattan_robj, 0, chromosome_names);
+	SET_VECTOR_ELT(manhattan_robj, 1, offsets);
+	SET_VECTOR_ELT(manhattan_robj, 2, x);
+	SET_VECTOR_ELT(manhattan_robj, 3, y);
+	SET_VECTOR_ELT(manhattan_robj, 4, chromosomes);
+	SET_VECTOR_ELT(manhattan_robj, 5, threshold);
+	SET_VECTOR_ELT(manhattan_robj, 6, points);
+
+	UNPROTECT(8);
+
+	return manhattan_robj;
+}
+
 SEXP Plot2Robj(SEXP external_plot_pointer) {
 	Plot* plot = NULL;
 
@@ -848,6 +1133,8 @@ SEXP Plot2Robj(SEXP external_plot_pointer) {
 	SEXP boxplot = R_NilValue;
 	SEXP qqplots = R_NilValue;
 	SEXP qqplot = R_NilValue;
+	SEXP manhattans = R_NilValue;
+	SEXP manhattan = R_NilValue;
 
 	if (external_plot_pointer == R_NilValue) {
 		error("\nThe external Plot pointer argument is NULL.");
@@ -859,7 +1146,7 @@ SEXP Plot2Robj(SEXP external_plot_pointer) {
 
 	plot = (Plot*)R_ExternalPtrAddr(external_plot_pointer);
 
-	PROTECT(plot_robj = allocVector(VECSXP, 5));
+	PROTECT(plot_robj = allocVector(VECSXP, 6));
 
 	PROTECT(plot_title = allocVector(STRSXP, 1));
 	SET_STRING_ELT(plot_title, 0, (plot->title != NULL) ? mkChar(plot->title) : mkChar(""));
@@ -913,6 +1200,20 @@ SEXP Plot2Robj(SEXP external_plot_pointer) {
 		SET_VECTOR_ELT(plot_robj, 4, R_NilValue);
 	}
 
+	if (plot->manhattans.size() > 0) {
+		PROTECT(manhattans = allocVector(VECSXP, plot->manhattans.size()));
+		for (unsigned int m = 0; m < plot->manhattans.size(); m++) {
+			external_pointer = R_MakeExternalPtr((void*)plot->manhattans.at(m), R_NilValue, R_NilValue);
+			manhattan = Manhattan2Robj(external_pointer);
+			SET_VECTOR_ELT(manhattans, m, manhattan);
+		}
+
+		SET_VECTOR_ELT(plot_robj, 5, manhattans);
+		UNPROTECT(1);
+	} else {
+		SET_VECTOR_ELT(plot_robj, 5, R_NilValue);
+	}
+
 	UNPROTECT(1);
 
 	return plot_robj;
@@ -923,14 +1224,24 @@ SEXP perform_quality_check(SEXP external_descriptor_pointer, SEXP resource_path)
 	const char* c_resource_path = NULL;
 	GwaFile* gwa_file = NULL;
 
-	void (GwaFile::*check_functions[7])(Descriptor*) = {
+	void (GwaFile::*check_functions[17])(Descriptor*) = {
 			&GwaFile::check_filters,
 			&GwaFile::check_thresholds,
+			&GwaFile::check_histograms,
 			&GwaFile::check_prefix,
 			&GwaFile::check_casesensitivity,
 			&GwaFile::check_missing_value,
 			&GwaFile::check_separators,
-			&GwaFile::check_filesize
+			&GwaFile::check_filesize,
+			&GwaFile::check_fingerprint,
+			&GwaFile::check_cache,
+			&GwaFile::check_resultcache,
+			&GwaFile::check_preview,
+			&GwaFile::check_partition,
+			&GwaFile::check_lowmemory,
+			&GwaFile::check_raster,
+			&GwaFile::check_threads,
+			&GwaFile::check_verbosity_level
 	};
 
 	SEXP output_robj = R_NilValue;
@@ -983,7 +1294,7 @@ SEXP perform_quality_check(SEXP external_descriptor_pointer, SEXP resource_path)
 
 		Analyzer analyzer;
 
-		gwa_file = new GwaFile(descriptor, check_functions, 7);
+		gwa_file = new GwaFile(descriptor, check_functions, 17);
 
 		analyzer.open_gwafile(gwa_file);
 
@@ -997,15 +1308,22 @@ SEXP perform_quality_check(SEXP external_descriptor_pointer, SEXP resource_path)
 
 		used_memory = analyzer.get_memory_usage();
 
-		analyzer.finalize_processing();
+		/* a partition only saves its partial state, which is reported after merging */
+		if ((gwa_file->is_partition_on()) && (gwa_file->get_partition() > 0)) {
+			analyzer.save_state(&result_html_path);
+		} else {
+			analyzer.finalize_processing();
+
+			analyzer.create_plots(single_file_plots);
+			analyzer.create_combined_qqplots(single_file_plots);
+			analyzer.create_combined_boxplots(combined_boxplots);
 
-		analyzer.create_plots(single_file_plots);
-		analyzer.create_combined_qqplots(single_file_plots);
-		analyzer.create_combined_boxplots(combined_boxplots);
+			analyzer.print_txt_report();
+			analyzer.print_csv_report();
+			analyzer.print_html_report(&result_html_path, single_file_plots, c_resource_path);
 
-		analyzer.print_txt_report();
-		analyzer.print_csv_report();
-		analyzer.print_html_report(&result_html_path, single_file_plots, c_resource_path);
+			analyzer.render_plots(single_file_plots);
+		}
 
 		PROTECT(output_robj = allocVector(VECSXP, 5));
 
@@ -1062,6 +1380,207 @@ SEXP perform_quality_check(SEXP external_descriptor_pointer, SEXP resource_path)
 	return output_robj;
 }
 
+/*
+ * The file results of perform_quality_checks() are converted to R objects while the workers are still running. An R error
+ * during the conversion jumps out of the call, therefore the pool is deleted in the cleanup of R_ExecWithCleanup(), which
+ * stops the workers and closes the files in either case.
+ */
+struct quality_checks {
+	AnalyzerPool* pool;
+	int n_files;
+	char* error_message;
+};
+
+static SEXP collect_quality_checks(void* data) {
+	quality_checks* checks = (quality_checks*)data;
+	AnalyzerPool::job* processed_job = NULL;
+
+	SEXP output_robj = R_NilValue;
+	SEXP file_robj = R_NilValue;
+	SEXP single_file_plots_robj = R_NilValue;
+	SEXP common_boxplots_robj = R_NilValue;
+	SEXP external_pointer = R_NilValue;
+	SEXP plot = R_NilValue;
+	SEXP name = R_NilValue;
+	SEXP path = R_NilValue;
+	SEXP stats = R_NilValue;
+
+	PROTECT(output_robj = allocVector(VECSXP, checks->n_files));
+
+	/* Plots point into the analyzer of a file: they are converted here before the file is released and its memory is freed. */
+	while ((processed_job = checks->pool->wait_processed()) != NULL) {
+		if ((processed_job->error_message != NULL) || (processed_job->html_report_path == NULL)) {
+			if ((checks->error_message == NULL) && (processed_job->error_message != NULL)) {
+				checks->error_message = R_alloc(strlen(processed_job->error_message) + 1, sizeof(char));
+				strcpy(checks->error_message, processed_job->error_message);
+			}
+			checks->pool->release(processed_job);
+			continue;
+		}
+
+		PROTECT(file_robj = allocVector(VECSXP, 5));
+
+		single_file_plots_robj = R_NilValue;
+		common_boxplots_robj = R_NilValue;
+
+		if (processed_job->single_file_plots.size() > 0) {
+			PROTECT(single_file_plots_robj = allocVector(VECSXP, processed_job->single_file_plots.size()));
+			for (unsigned int i = 0; i < processed_job->single_file_plots.size(); i++) {
+				external_pointer = R_MakeExternalPtr((void*)processed_job->single_file_plots.at(i), R_NilValue, R_NilValue);
+				plot = Plot2Robj(external_pointer);
+				SET_VECTOR_ELT(single_file_plots_robj, i, plot);
+			}
+			SET_VECTOR_ELT(file_robj, 2, single_file_plots_robj);
+			UNPROTECT(1);
+		}
+
+		if (processed_job->combined_boxplots.size() > 0) {
+			PROTECT(common_boxplots_robj = allocVector(VECSXP, processed_job->combined_boxplots.size()));
+			for (unsigned int i = 0; i < processed_job->combined_boxplots.size(); i++) {
+				external_pointer = R_MakeExternalPtr((void*)processed_job->combined_boxplots.at(i), R_NilValue, R_NilValue);
+				plot = Plot2Robj(external_pointer);
+				SET_VECTOR_ELT(common_boxplots_robj, i, plot);
+			}
+			SET_VECTOR_ELT(file_robj, 3, common_boxplots_robj);
+			UNPROTECT(1);
+		}
+
+		PROTECT(name = allocVector(STRSXP, 1));
+		SET_STRING_ELT(name, 0, mkChar(processed_job->descriptor->get_name()));
+		SET_VECTOR_ELT(file_robj, 0, name);
+		UNPROTECT(1);
+
+		PROTECT(path = allocVector(STRSXP, 1));
+		SET_STRING_ELT(path, 0, mkChar(processed_job->html_report_path));
+		SET_VECTOR_ELT(file_robj, 1, path);
+		UNPROTECT(1);
+
+		PROTECT(stats = allocVector(REALSXP, 2));
+		REAL(stats)[0] = processed_job->execution_time;
+		REAL(stats)[1] = processed_job->used_memory;
+		SET_VECTOR_ELT(file_robj, 4, stats);
+		UNPROTECT(1);
+
+		SET_VECTOR_ELT(output_robj, processed_job->id, file_robj);
+		UNPROTECT(1);
+
+		checks->pool->release(processed_job);
+	}
+
+	UNPROTECT(1);
+
+	return output_robj;
+}
+
+static void stop_quality_checks(void* data) {
+	quality_checks* checks = (quality_checks*)data;
+
+	delete checks->pool;
+	checks->pool = NULL;
+}
+
+SEXP perform_quality_checks(SEXP external_descriptor_pointers, SEXP resource_path, SEXP threads) {
+	int n_pointers = 0;
+	int c_threads = 0;
+	const char* c_resource_path = NULL;
+
+	SEXP external_descriptor_pointer = R_NilValue;
+
+	Descriptor* descriptor = NULL;
+	vector<Descriptor*> descriptors;
+
+	AnalyzerPool* pool = NULL;
+	quality_checks checks;
+
+	SEXP output_robj = R_NilValue;
+
+	if (external_descriptor_pointers == R_NilValue) {
+		error("\nThe vector of file descriptors is NULL.");
+	}
+
+	if (!isVector(external_descriptor_pointers)) {
+		error("\nThe vector of file descriptors has incorrect type.");
+	}
+
+	n_pointers = length(external_descriptor_pointers);
+	if (n_pointers <= 0) {
+		error("\nThe vector of file descriptors is empty.");
+	}
+
+	for (int i = 0; i < n_pointers; ++i) {
+		external_descriptor_pointer = VECTOR_ELT(external_descriptor_pointers, i);
+
+		if (external_descriptor_pointer == R_NilValue) {
+			error("\nThe external Descriptor pointer argument is NULL.");
+		}
+
+		if (TYPEOF(external_descriptor_pointer) != EXTPTRSXP) {
+			error("\nThe external Descriptor pointer argument has incorrect type.");
+		}
+
+		descriptor = (Descriptor*)R_ExternalPtrAddr(external_descriptor_pointer);
+
+		descriptors.push_back(descriptor);
+	}
+
+	if (resource_path == R_NilValue) {
+		error("\nThe resource path is NULL.");
+	}
+
+	if (!isString(resource_path)) {
+		error("\nThe resource path is not a string.");
+	}
+
+	if (length(resource_path) <= 0) {
+		error("\nThe resource path is empty.");
+	}
+
+	if (length(resource_path) > 1) {
+		error("\nThe resource path has multiple values.");
+	}
+
+	c_resource_path = CHAR(STRING_ELT(resource_path, 0));
+
+	if (threads == R_NilValue) {
+		error("\nThe number of threads is NULL.");
+	}
+
+	if (!isInteger(threads)) {
+		error("\nThe number of threads is not an integer.");
+	}
+
+	if (length(threads) != 1) {
+		error("\nThe number of threads must have a single value.");
+	}
+
+	c_threads = INTEGER(threads)[0];
+	if ((c_threads == NA_INTEGER) || (c_threads <= 0)) {
+		error("\nThe number of threads must be greater than 0.");
+	}
+
+	try {
+		pool = new AnalyzerPool(descriptors, c_resource_path, (unsigned int)c_threads);
+		pool->start();
+	} catch (Exception &e) {
+		if (pool != NULL) {
+			delete pool;
+		}
+		error("\n%s", e.what());
+	}
+
+	checks.pool = pool;
+	checks.n_files = n_pointers;
+	checks.error_message = NULL;
+
+	output_robj = R_ExecWithCleanup(collect_quality_checks, &checks, stop_quality_checks, &checks);
+
+	if (checks.error_message != NULL) {
+		error("\n%s", checks.error_message);
+	}
+
+	return output_robj;
+}
+
 SEXP print_combined_reports(SEXP reports, SEXP boxplot_names, SEXP resource_path, SEXP path_separator) {
 	int ncol = 0;
 	const char* c_resource_path = NULL;
@@ -1171,7 +1690,7 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 	Descriptor* descriptor = NULL;
 	GwaFile* gwa_file = NULL;
 
-	void (GwaFile::*check_functions[8])(Descriptor*) = {
+	void (GwaFile::*check_functions[9])(Descriptor*) = {
 			&GwaFile::check_filters,
 			&GwaFile::check_thresholds,
 			&GwaFile::check_prefix,
@@ -1179,7 +1698,8 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 			&GwaFile::check_missing_value,
 			&GwaFile::check_separators,
 			&GwaFile::check_order,
-			&GwaFile::check_genomiccontrol
+			&GwaFile::check_genomiccontrol,
+			&GwaFile::check_resultcache
 	};
 
 	double inflation_factor = numeric_limits<double>::quiet_NaN();
@@ -1221,7 +1741,7 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 	try {
 		Formatter formatter;
 
-		gwa_file = new GwaFile(descriptor, check_functions, 8);
+		gwa_file = new GwaFile(descriptor, check_functions, 9);
 
 		formatter.open_gwafile(gwa_file);
 		formatter.process_header();
@@ -1230,7 +1750,7 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 			inflation_factor = gwa_file->get_inflation_factor();
 			if (isnan(inflation_factor)) {
 				start_time = clock();
-				inflation_factor = formatter.calculate_lambda(n_total, n_filtered);
+				inflation_factor = formatter.spill('\t', n_total, n_filtered);
 				execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
 
 				PROTECT(inflation_factor_stats = allocVector(REALSXP, 3));
@@ -1274,6 +1794,209 @@ SEXP perform_formatting(SEXP external_descriptor_pointer) {
 	return output_robj;
 }
 
+SEXP perform_pipeline(SEXP external_descriptor_pointer, SEXP resource_path) {
+	Descriptor* descriptor = NULL;
+	const char* c_resource_path = NULL;
+	GwaFile* gwa_file = NULL;
+	Analyzer* analyzer = NULL;
+
+	void (GwaFile::*check_functions[20])(Descriptor*) = {
+			&GwaFile::check_filters,
+			&GwaFile::check_thresholds,
+			&GwaFile::check_histograms,
+			&GwaFile::check_prefix,
+			&GwaFile::check_formatprefix,
+			&GwaFile::check_casesensitivity,
+			&GwaFile::check_missing_value,
+			&GwaFile::check_separators,
+			&GwaFile::check_filesize,
+			&GwaFile::check_fingerprint,
+			&GwaFile::check_cache,
+			&GwaFile::check_verbosity_level,
+			&GwaFile::check_order,
+			&GwaFile::check_genomiccontrol,
+			&GwaFile::check_raster,
+			&GwaFile::check_regions_file,
+			&GwaFile::check_regions_file_separators,
+			&GwaFile::check_regions_deviation,
+			&GwaFile::check_regions_append,
+			&GwaFile::check_map_file_separators
+	};
+	unsigned int check_functions_number = 20;
+
+	SEXP output_robj = R_NilValue;
+	SEXP single_file_plots_robj = R_NilValue;
+	SEXP common_boxplots_robj = R_NilValue;
+	SEXP external_pointer = R_NilValue;
+	SEXP plot = R_NilValue;
+	SEXP name = R_NilValue;
+	SEXP path = R_NilValue;
+	SEXP stats = R_NilValue;
+	SEXP formatting_robj = R_NilValue;
+	SEXP attributes = R_NilValue;
+	SEXP inflation_factor_value = R_NilValue;
+	SEXP inflation_factor_stats = R_NilValue;
+	SEXP formatting_stats = R_NilValue;
+
+	clock_t start_time = 0;
+	double execution_time = 0.0;
+	double used_memory = 0.0;
+
+	if (external_descriptor_pointer == R_NilValue) {
+		error("\nThe external Descriptor pointer argument is NULL.");
+	}
+
+	if (TYPEOF(external_descriptor_pointer) != EXTPTRSXP) {
+		error("\nThe external Descriptor pointer argument has an incorrect type.");
+	}
+
+	if (resource_path == R_NilValue) {
+		error("\nThe resource path is NULL.");
+	}
+
+	if (!isString(resource_path)) {
+		error("\nThe resource path is not a string.");
+	}
+
+	if (length(resource_path) <= 0) {
+		error("\nThe resource path is empty.");
+	}
+
+	if (length(resource_path) > 1) {
+		error("\nThe resource path has multiple values.");
+	}
+
+	descriptor = (Descriptor*)R_ExternalPtrAddr(external_descriptor_pointer);
+	c_resource_path = CHAR(STRING_ELT(resource_path, 0));
+
+	vector<Plot*> single_file_plots;
+	vector<Plot*> combined_boxplots;
+
+	char* result_html_path = NULL;
+
+	try {
+		start_time = clock();
+
+		Pipeline pipeline;
+
+		/* annotation is optional: the last five checks are applied only if the regions file is specified */
+		if (descriptor->get_property(Descriptor::REGIONS_FILE) == NULL) {
+			check_functions_number = 15;
+		}
+
+		gwa_file = new GwaFile(descriptor, check_functions, check_functions_number);
+
+		pipeline.open_gwafile(gwa_file);
+		pipeline.process_header();
+		pipeline.process_data();
+
+		analyzer = pipeline.get_analyzer();
+
+		used_memory = analyzer->get_memory_usage();
+
+		analyzer->finalize_processing();
+
+		analyzer->create_plots(single_file_plots);
+		analyzer->create_combined_qqplots(single_file_plots);
+		analyzer->create_combined_boxplots(combined_boxplots);
+
+		analyzer->print_txt_report();
+		analyzer->print_csv_report();
+		analyzer->print_html_report(&result_html_path, single_file_plots, c_resource_path);
+
+		analyzer->render_plots(single_file_plots);
+
+		PROTECT(output_robj = allocVector(VECSXP, 6));
+
+		if (single_file_plots.size() > 0) {
+			PROTECT(single_file_plots_robj = allocVector(VECSXP, single_file_plots.size()));
+			for (unsigned int i = 0; i < single_file_plots.size(); i++) {
+				external_pointer = R_MakeExternalPtr((void*)single_file_plots.at(i), R_NilValue, R_NilValue);
+				plot = Plot2Robj(external_pointer);
+				SET_VECTOR_ELT(single_file_plots_robj, i, plot);
+			}
+			UNPROTECT(1);
+		}
+
+		if (combined_boxplots.size() > 0) {
+			PROTECT(common_boxplots_robj = allocVector(VECSXP, combined_boxplots.size()));
+			for (unsigned int i = 0; i < combined_boxplots.size(); i++) {
+				external_pointer = R_MakeExternalPtr((void*)combined_boxplots.at(i), R_NilValue, R_NilValue);
+				plot = Plot2Robj(external_pointer);
+				SET_VECTOR_ELT(common_boxplots_robj, i, plot);
+			}
+			UNPROTECT(1);
+		}
+
+		PROTECT(name = allocVector(STRSXP, 1));
+		SET_STRING_ELT(name, 0, mkChar(gwa_file->get_descriptor()->get_name()));
+		UNPROTECT(1);
+
+		PROTECT(path = allocVector(STRSXP, 1));
+		SET_STRING_ELT(path, 0, mkChar(result_html_path));
+		UNPROTECT(1);
+
+		execution_time = (clock() - start_time)/(double)CLOCKS_PER_SEC;
+
+		PROTECT(stats = allocVector(REALSXP, 2));
+		REAL(stats)[0] = execution_time;
+		REAL(stats)[1] = used_memory;
+		UNPROTECT(1);
+
+		PROTECT(formatting_robj = allocVector(VECSXP, 4));
+
+		PROTECT(attributes = allocVector(STRSXP, 4));
+		SET_STRING_ELT(attributes, 0, mkChar("inflation_factor_value"));
+		SET_STRING_ELT(attributes, 1, mkChar("inflation_factor_stats"));
+		SET_STRING_ELT(attributes, 2, mkChar("formatting_stats"));
+		SET_STRING_ELT(attributes, 3, mkChar("annotation"));
+
+		if (gwa_file->is_gc_on()) {
+			PROTECT(inflation_factor_value = allocVector(REALSXP, 1));
+			REAL(inflation_factor_value)[0] = pipeline.get_inflation_factor();
+			UNPROTECT(1);
+
+			if (pipeline.is_inflation_factor_estimated()) {
+				PROTECT(inflation_factor_stats = allocVector(REALSXP, 2));
+				REAL(inflation_factor_stats)[0] = pipeline.get_n_lambda();
+				REAL(inflation_factor_stats)[1] = pipeline.get_n_total();
+				UNPROTECT(1);
+			}
+		}
+
+		PROTECT(formatting_stats = allocVector(REALSXP, 2));
+		REAL(formatting_stats)[0] = pipeline.get_n_filtered();
+		REAL(formatting_stats)[1] = pipeline.get_n_total();
+		UNPROTECT(1);
+
+		SET_VECTOR_ELT(formatting_robj, 0, inflation_factor_value);
+		SET_VECTOR_ELT(formatting_robj, 1, inflation_factor_stats);
+		SET_VECTOR_ELT(formatting_robj, 2, formatting_stats);
+		SET_VECTOR_ELT(formatting_robj, 3, ScalarLogical(pipeline.is_annotation_on() ? TRUE : FALSE));
+
+		setAttrib(formatting_robj, R_NamesSymbol, attributes);
+
+		UNPROTECT(1);
+
+		SET_VECTOR_ELT(output_robj, 0, name);
+		SET_VECTOR_ELT(output_robj, 1, path);
+		SET_VECTOR_ELT(output_robj, 2, single_file_plots_robj);
+		SET_VECTOR_ELT(output_robj, 3, common_boxplots_robj);
+		SET_VECTOR_ELT(output_robj, 4, stats);
+		SET_VECTOR_ELT(output_robj, 5, formatting_robj);
+
+		UNPROTECT(2);
+
+		pipeline.close_gwafile();
+
+		delete gwa_file;
+	} catch (Exception &e) {
+		error("\n%s", e.what());
+	}
+
+	return output_robj;
+}
+
 SEXP perform_annotation(SEXP external_descriptor_pointer) {
 	Descriptor* descriptor = NULL;
 	GwaFile* gwa_file = NULL;
@@ -38,6 +38,7 @@ Annotator::Annotator() : gwafile(NULL), regions_file(NULL), map_file(NULL),
 	map_chr_column_pos(numeric_limits<int>::min()),
 	map_position_column_pos(numeric_limits<int>::min()),
 	regions_indices(auxiliary::bool_strcmp),
+	regions_deviation(NULL),
 	map_index(NULL),
 	map_chromosomes(NULL),
 	map_positions(NULL),
@@ -337,10 +338,16 @@ void Annotator::index_regions() throw (AnnotatorException) {
 	regions_indices.clear();
 
 	try {
+		regions_deviation = gwafile->get_descriptor()->get_threshold(Descriptor::REGIONS_DEVIATION);
+
 		open_regions_file();
 		process_regions_file_header();
 		process_regions_file_data();
 		close_regions_file();
+	} catch (DescriptorException &e) {
+		AnnotatorException new_e(e);
+		new_e.add_message("Annotator", "index_regions()", __LINE__, 15);
+		throw new_e;
 	} catch (AnnotatorException &e) {
 		e.add_message("Annotator", "index_regions()", __LINE__, 15);
 		throw;
@@ -423,12 +430,6 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 	vector<double>* deviation = NULL;
 	int deviation_value = 0;
 
-	IntervalTree<char*>* genes_index = NULL;
-	IntervalTree<char*> genes_index_subset;
-
-	map<int, vector<char*>*> annotated_genes;
-	map<int, vector<char*>*>::iterator annotated_genes_it;
-
 	if (gwafile == NULL) {
 		return;
 	}
@@ -524,51 +525,8 @@ void Annotator::annotate_without_map() throw (AnnotatorException) {
 					ofile_stream << marker_token << data_separator << chr_token << data_separator << position_token;
 				}
 
-				regions_indices_it = regions_indices.find(chr_token);
-				if (regions_indices_it != regions_indices.end()) {
-					genes_index = regions_indices_it->second;
-
-					deviation_value = (int)deviation->back();
-					genes_index->get_intersecting_intervals(position - deviation_value, position + deviation_value, deviation_value, genes_index_subset);
-					for (int i = deviation->size() - 2; i >= 0; --i) {
-						deviation_value = (int)deviation->at(i);
-						genes_index_subset.mark_intersecting_intervals(position - deviation_value, position + deviation_value, deviation_value);
-					}
-
-					genes_index_subset.get_marked_values(annotated_genes);
-
-					if (annotated_genes.size() > 0) {
-						for (unsigned int i = 0u; i < deviation->size(); ++i) {
-							ofile_stream << data_separator;
-							annotated_genes_it = annotated_genes.find(((int)deviation->at(i)));
-							if (annotated_genes_it != annotated_genes.end()) {
-								write_char_vector(ofile_stream, annotated_genes_it->second, region_separator);
-							} else {
-								ofile_stream << "NA";
-							}
-						}
-						ofile_stream << endl;
-					} else {
-						for (unsigned int i = 0u; i < deviation->size(); ++i) {
-							ofile_stream << data_separator << "NA";
-						}
-						ofile_stream << endl;
-					}
-
-					annotated_genes_it = annotated_genes.begin();
-					while(annotated_genes_it != annotated_genes.end()) {
-						delete annotated_genes_it->second;
-						annotated_genes_it++;
-					}
-					annotated_genes.clear();
-
-					genes_index_subset.clear();
-				} else {
-					for (unsigned int i = 0u; i < deviation->size(); ++i) {
-						ofile_stream << data_separator << "NA";
-					}
-					ofile_stream << endl;
-				}
+				write_regions(ofile_stream, chr_token, position, data_separator, region_separator);
+				ofile_stream << endl;
 
 				++line_number;
 			}
@@ -634,12 +592,6 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 	vector<double>* deviation = NULL;
 	int deviation_value = 0;
 
-	IntervalTree<char*>* genes_index = NULL;
-	IntervalTree<char*> genes_index_subset;
-
-	map<int, vector<char*>*> annotated_genes;
-	map<int, vector<char*>*>::iterator annotated_genes_it;
-
 	if (gwafile == NULL) {
 		return;
 	}
@@ -751,51 +703,8 @@ void Annotator::annotate_with_map() throw (AnnotatorException) {
 							ofile_stream << key_marker_index.name << data_separator << chr << data_separator << position;
 						}
 
-						regions_indices_it = regions_indices.find(chr);
-						if (regions_indices_it != regions_indices.end()) {
-							genes_index = regions_indices_it->second;
-
-							deviation_value = (int)deviation->back();
-							genes_index->get_intersecting_intervals(position - deviation_value, position + deviation_value, deviation_value, genes_index_subset);
-							for (int i = deviation->size() - 2; i >= 0; --i) {
-								deviation_value = (int)deviation->at(i);
-								genes_index_subset.mark_intersecting_intervals(position - deviation_value, position + deviation_value, deviation_value);
-							}
-
-							genes_index_subset.get_marked_values(annotated_genes);
-
-							if (annotated_genes.size() > 0) {
-								for (unsigned int i = 0u; i < deviation->size(); ++i) {
-									ofile_stream << data_separator;
-									annotated_genes_it = annotated_genes.find(((int)deviation->at(i)));
-									if (annotated_genes_it != annotated_genes.end()) {
-										write_char_vector(ofile_stream, annotated_genes_it->second, region_separator);
-									} else {
-										ofile_stream << "NA";
-									}
-								}
-								ofile_stream << endl;
-							} else {
-								for (unsigned int i = 0u; i < deviation->size(); ++i) {
-									ofile_stream << data_separator << "NA";
-								}
-								ofile_stream << endl;
-							}
-
-							annotated_genes_it = annotated_genes.begin();
-							while(annotated_genes_it != annotated_genes.end()) {
-								delete annotated_genes_it->second;
-								annotated_genes_it++;
-							}
-							annotated_genes.clear();
-
-							genes_index_subset.clear();
-						} else {
-							for (unsigned int i = 0u; i < deviation->size(); ++i) {
-								ofile_stream << data_separator << "NA";
-							}
-							ofile_stream << endl;
-						}
+						write_regions(ofile_stream, chr, position, data_separator, region_separator);
+						ofile_stream << endl;
 
 						++found_marker_index_pos;
 					}
@@ -1404,7 +1313,7 @@ void Annotator::process_map_file_data() throw (AnnotatorException) {
 	}
 }
 
-void Annotator::write_char_vector(ofstream &ofile_stream, vector<char*>* values, char separator) throw (ofstream::failure) {
+void Annotator::write_char_vector(ostream &ofile_stream, vector<char*>* values, char separator) throw (ostream::failure) {
 	int size = 0;
 	if ((values != NULL) && ((size = values->size()) > 0)) {
 		--size;
@@ -1415,6 +1324,155 @@ void Annotator::write_char_vector(ofstream &ofile_stream, vector<char*>* values,
 	}
 }
 
+void Annotator::write_regions(ostream &ofile_stream, char* chr, int position, char separator, char region_separator) throw (ostream::failure) {
+	IntervalTree<char*>* genes_index = NULL;
+	int deviation_value = 0;
+
+	map<int, vector<char*>*> annotated_genes;
+	map<int, vector<char*>*>::iterator annotated_genes_it;
+
+	regions_indices_it = regions_indices.find(chr);
+	if (regions_indices_it == regions_indices.end()) {
+		for (unsigned int i = 0u; i < regions_deviation->size(); ++i) {
+			ofile_stream << separator << "NA";
+		}
+		return;
+	}
+
+	genes_index = regions_indices_it->second;
+
+	deviation_value = (int)regions_deviation->back();
+	genes_index->get_intersecting_intervals(position - deviation_value, position + deviation_value, deviation_value, regions_subset);
+	for (int i = regions_deviation->size() - 2; i >= 0; --i) {
+		deviation_value = (int)regions_deviation->at(i);
+		regions_subset.mark_intersecting_intervals(position - deviation_value, position + deviation_value, deviation_value);
+	}
+
+	regions_subset.get_marked_values(annotated_genes);
+
+	for (unsigned int i = 0u; i < regions_deviation->size(); ++i) {
+		ofile_stream << separator;
+		annotated_genes_it = annotated_genes.find(((int)regions_deviation->at(i)));
+		if (annotated_genes_it != annotated_genes.end()) {
+			write_char_vector(ofile_stream, annotated_genes_it->second, region_separator);
+		} else {
+			ofile_stream << "NA";
+		}
+	}
+
+	annotated_genes_it = annotated_genes.begin();
+	while(annotated_genes_it != annotated_genes.end()) {
+		delete annotated_genes_it->second;
+		annotated_genes_it++;
+	}
+	annotated_genes.clear();
+
+	regions_subset.clear();
+}
+
+void Annotator::write_header(ostream &ofile_stream, char separator) throw (AnnotatorException) {
+	Descriptor* descriptor = NULL;
+	const char* column_name = NULL;
+	int deviation_value = 0;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	try {
+		descriptor = gwafile->get_descriptor();
+
+		if (has_map) {
+			ofile_stream << separator << ((column_name = descriptor->get_property(Descriptor::MAP_CHR)) != NULL ? column_name : Descriptor::MAP_CHR);
+			ofile_stream << separator << ((column_name = descriptor->get_property(Descriptor::MAP_POSITION)) != NULL ? column_name : Descriptor::MAP_POSITION);
+		}
+
+		for (unsigned int i = 0u; i < regions_deviation->size(); ++i) {
+			deviation_value = (int)regions_deviation->at(i);
+			if (deviation_value != 0) {
+				ofile_stream << separator << "+/-" << deviation_value;
+			} else {
+				ofile_stream << separator << "IN";
+			}
+		}
+	} catch (DescriptorException &e) {
+		AnnotatorException new_e(e);
+		new_e.add_message("Annotator", "write_header( ostream& , char )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	}
+}
+
+void Annotator::annotate_row(char** tokens, unsigned int line_number, vector<string>& annotations, char separator) throw (AnnotatorException) {
+	Descriptor* descriptor = NULL;
+	const char* column_name = NULL;
+	char region_separator = '\0';
+	char* end_ptr = NULL;
+
+	marker_index key_marker_index;
+	marker_index* found_marker_index = NULL;
+	unsigned int found_marker_index_pos = 0u;
+	unsigned int index = 0u;
+	int position = 0;
+
+	ostringstream annotation;
+
+	annotations.clear();
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	descriptor = gwafile->get_descriptor();
+	region_separator = (separator == ',') ? ';' : ',';
+
+	try {
+		if (has_map) {
+			key_marker_index.name = tokens[marker_column_pos];
+
+			found_marker_index = (marker_index*)bsearch(&key_marker_index, map_index, map_index_size, sizeof(marker_index), qsort_marker_index_cmp);
+			if (found_marker_index == NULL) {
+				annotation << separator << "NA" << separator << "NA";
+				for (unsigned int i = 0u; i < regions_deviation->size(); ++i) {
+					annotation << separator << "NA";
+				}
+				annotations.push_back(annotation.str());
+				return;
+			}
+
+			found_marker_index_pos = found_marker_index - map_index;
+			while ((found_marker_index_pos < map_index_size) && (auxiliary::strcmp_ignore_case(key_marker_index.name, map_index[found_marker_index_pos].name) == 0)) {
+				index = map_index[found_marker_index_pos].index;
+
+				annotation.str("");
+				annotation << separator << map_chromosomes[index] << separator << map_positions[index];
+				write_regions(annotation, map_chromosomes[index], map_positions[index], separator, region_separator);
+				annotations.push_back(annotation.str());
+
+				++found_marker_index_pos;
+			}
+		} else {
+			position = (int)strtol(tokens[position_column_pos], &end_ptr, 10);
+			if (*end_ptr != '\0') {
+				throw AnnotatorException("Annotator", "annotate_row( char** , unsigned int , vector<string>& , char )",  __LINE__, 10, tokens[position_column_pos], ((column_name = descriptor->get_column(Descriptor::POSITION)) != NULL) ? column_name : Descriptor::POSITION, line_number);
+			}
+
+			if (position < 0) {
+				throw AnnotatorException("Annotator", "annotate_row( char** , unsigned int , vector<string>& , char )",  __LINE__, 11, ((column_name = descriptor->get_column(Descriptor::POSITION)) != NULL) ? column_name : Descriptor::POSITION, position, line_number);
+			}
+
+			write_regions(annotation, tokens[chr_column_pos], position, separator, region_separator);
+			annotations.push_back(annotation.str());
+		}
+	} catch (DescriptorException &e) {
+		AnnotatorException new_e(e);
+		new_e.add_message("Annotator", "annotate_row( char** , unsigned int , vector<string>& , char )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	} catch (AnnotatorException &e) {
+		e.add_message("Annotator", "annotate_row( char** , unsigned int , vector<string>& , char )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		throw;
+	}
+}
+
 bool Annotator::is_map_present() {
 	return has_map;
 }
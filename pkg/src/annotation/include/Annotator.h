@@ -22,6 +22,8 @@
 
 #include <map>
 #include <vector>
+#include <string>
+#include <sstream>
 
 #include "AnnotatorException.h"
 #include "../../auxiliary/include/auxiliary.h"
@@ -61,6 +63,8 @@ private:
 
 	map<char*, IntervalTree<char*>*, bool(*)(const char*, const char*)> regions_indices;
 	map<char*, IntervalTree<char*>*, bool(*)(const char*, const char*)>::iterator regions_indices_it;
+	IntervalTree<char*> regions_subset;
+	vector<double>* regions_deviation;
 
 	struct marker_index {
 		char* name;
@@ -90,7 +94,8 @@ private:
 	void process_map_file_header() throw (AnnotatorException);
 	void process_map_file_data() throw (AnnotatorException);
 
-	void write_char_vector(ofstream &ofile_stream, vector<char*>* values, char separator) throw (ofstream::failure);
+	void write_char_vector(ostream &ofile_stream, vector<char*>* values, char separator) throw (ostream::failure);
+	void write_regions(ostream &ofile_stream, char* chr, int position, char separator, char region_separator) throw (ostream::failure);
 
 public:
 	static const unsigned int MAP_HEAP_SIZE;
@@ -108,6 +113,9 @@ public:
 	void index_regions() throw (AnnotatorException);
 	void index_map() throw (AnnotatorException);
 	void annotate() throw (AnnotatorException);
+
+	void write_header(ostream &ofile_stream, char separator) throw (AnnotatorException);
+	void annotate_row(char** tokens, unsigned int line_number, vector<string>& annotations, char separator) throw (AnnotatorException);
 };
 
 #endif
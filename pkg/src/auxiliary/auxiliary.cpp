@@ -87,6 +87,25 @@ int auxiliary::strcmp_ignore_case(const char* first, const char* second, int n)
 	return 1;
 }
 
+char* auxiliary::format_time(time_t time, char* buffer) {
+	static const char* days[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+	static const char* months[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
+	struct tm local_time;
+
+#ifdef WIN32
+	/* localtime() uses thread-local storage in the Windows C runtime. */
+	local_time = *localtime(&time);
+#else
+	localtime_r(&time, &local_time);
+#endif
+
+	sprintf(buffer, "%.3s %.3s%3d %.2d:%.2d:%.2d %d",
+			days[local_time.tm_wday], months[local_time.tm_mon], local_time.tm_mday,
+			local_time.tm_hour, local_time.tm_min, local_time.tm_sec, 1900 + local_time.tm_year);
+
+	return buffer;
+}
+
 char* auxiliary::transform_file_name(char** new_file_name, const char* prefix, const char* old_file_name, const char* extension, bool preserve_old_extension) {
 	int old_extension_start = -1;
 
@@ -134,49 +153,86 @@ char* auxiliary::transform_file_name(char** new_file_name, const char* prefix, c
 	return *new_file_name;
 }
 
-double auxiliary::stats_mean(double* data, unsigned int size) {
-	double sum = 0.0;
+void auxiliary::stats_moments(const double* data, uint64_t size, double& mean, double& sd, double& skewness, double& kurtosis) {
+	double sums[3] = {0.0, 0.0, 0.0};
+	double sd2 = 0.0;
 
-	for (unsigned int i = 0; i < size; i++) {
-		sum += data[i];
-	}
+	mean = stats_pairwise_sum(data, size) / size;
+
+	stats_pairwise_central_sums(data, size, mean, sums);
 
-	return sum / size;
+	sd2 = sums[0] / (size - 1);
+	sd = sqrt(sd2);
+	skewness = sums[1] / (sd2 * sd) / size;
+	kurtosis = sums[2] / (sd2 * sd2) / size - 3.0;
 }
 
-double auxiliary::stats_sd(double* data, unsigned int size, double mean) {
-	double variance = 0.0;
+double auxiliary::stats_pairwise_sum(const double* data, uint64_t size) {
+	double lanes[4] = {0.0, 0.0, 0.0, 0.0};
+	uint64_t i = 0;
 
-	for (unsigned int i = 0; i < size; i++) {
-		variance += pow(data[i] - mean, 2.0);
+	if (size > STATS_BLOCK_SIZE) {
+		return stats_pairwise_sum(data, size / 2) + stats_pairwise_sum(data + size / 2, size - size / 2);
 	}
 
-	variance = variance / (size - 1);
-
-	return sqrt(variance);
-}
-
-double auxiliary::stats_skewness(double* data, unsigned int size, double mean, double sd) {
-	double skewness = 0.0;
+	for (i = 0; i + 4 <= size; i += 4) {
+		lanes[0] += data[i];
+		lanes[1] += data[i + 1];
+		lanes[2] += data[i + 2];
+		lanes[3] += data[i + 3];
+	}
 
-	for (unsigned int i = 0; i < size; i++) {
-		skewness += pow((data[i] - mean) / sd, 3.0);
+	for (; i < size; i++) {
+		lanes[0] += data[i];
 	}
 
-	return skewness / size;
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
 }
 
-double auxiliary::stats_kurtosis(double* data, unsigned int size, double mean, double sd) {
-	double kurtosis = 0.0;
+/*
+ * Stores the sums of the 2nd, 3rd and 4th powers of the deviations from the mean in sums[0], sums[1] and sums[2].
+ * Like in stats_pairwise_sum(), the sums of the two halves are computed separately and then added.
+ */
+void auxiliary::stats_pairwise_central_sums(const double* data, uint64_t size, double mean, double* sums) {
+	double lanes[3][4] = {{0.0, 0.0, 0.0, 0.0}, {0.0, 0.0, 0.0, 0.0}, {0.0, 0.0, 0.0, 0.0}};
+	double half_sums[3] = {0.0, 0.0, 0.0};
+	double deviation = 0.0;
+	double deviation2 = 0.0;
+	uint64_t i = 0;
+
+	if (size > STATS_BLOCK_SIZE) {
+		stats_pairwise_central_sums(data, size / 2, mean, sums);
+		stats_pairwise_central_sums(data + size / 2, size - size / 2, mean, half_sums);
+		for (unsigned int k = 0; k < 3; k++) {
+			sums[k] += half_sums[k];
+		}
+		return;
+	}
 
-	for (unsigned int i = 0; i < size; i++) {
-		kurtosis += pow((data[i] - mean) / sd, 4.0);
+	for (i = 0; i + 4 <= size; i += 4) {
+		for (unsigned int j = 0; j < 4; j++) {
+			deviation = data[i + j] - mean;
+			deviation2 = deviation * deviation;
+			lanes[0][j] += deviation2;
+			lanes[1][j] += deviation2 * deviation;
+			lanes[2][j] += deviation2 * deviation2;
+		}
+	}
+
+	for (; i < size; i++) {
+		deviation = data[i] - mean;
+		deviation2 = deviation * deviation;
+		lanes[0][0] += deviation2;
+		lanes[1][0] += deviation2 * deviation;
+		lanes[2][0] += deviation2 * deviation2;
 	}
 
-	return kurtosis / size - 3.0;
+	for (unsigned int k = 0; k < 3; k++) {
+		sums[k] = (lanes[k][0] + lanes[k][1]) + (lanes[k][2] + lanes[k][3]);
+	}
 }
 
-double auxiliary::stats_median_from_sorted_data(double* data, unsigned int size) {
+double auxiliary::stats_median_from_sorted_data(double* data, uint64_t size) {
 	if (size % 2 == 0) {
 		return (data[size / 2 - 1] + data[size / 2]) / 2.0;
 	} else {
@@ -184,8 +240,8 @@ double auxiliary::stats_median_from_sorted_data(double* data, unsigned int size)
 	}
 }
 
-double auxiliary::stats_quantile_from_sorted_data(double* data, unsigned int size, double fraction) {
-	unsigned int i = (unsigned int)floor((size - 1) * fraction);
+double auxiliary::stats_quantile_from_sorted_data(double* data, uint64_t size, double fraction) {
+	uint64_t i = (uint64_t)floor((size - 1) * fraction);
 	double delta = (size - 1) * fraction - i;
 
 	if (delta == 0) {
@@ -26,11 +26,16 @@
 #include <cstring>
 #include <cmath>
 #include <limits>
+#include <ctime>
+#include <cstdio>
+#include <stdint.h>
 
 using namespace std;
 
 namespace auxiliary {
 
+	const unsigned int STATS_BLOCK_SIZE = 256;
+
 	char* strtok(char** start, char separator);
 
 	int strcmp_ignore_case(const char* first, const char* second);
@@ -105,19 +110,83 @@ namespace auxiliary {
 		return 0;
 	}
 
-	char* transform_file_name(char** new_file_name, const char* prefix, const char* file_name, const char* suffix, bool preserve_old_suffix);
+	inline int uint64cmp(const void* first, const void* second) {
+		uint64_t u_first = *(uint64_t*)first;
+		uint64_t u_second = *(uint64_t*)second;
+
+		if (u_first < u_second) {
+			return -1;
+		}
+		else if (u_first > u_second) {
+			return 1;
+		}
+
+		return 0;
+	}
+
+	/*
+	 * 64-bit FNV-1a hash followed by the MurmurHash3 finalizer.
+	 * The finalizer spreads the bits well enough for the hash to be split into a bucket index and a rank.
+	 */
+	inline uint64_t hash64(const char* value) {
+		uint64_t hash = 14695981039346656037ULL;
+
+		while (*value != '\0') {
+			hash ^= (unsigned char)*value;
+			hash *= 1099511628211ULL;
+			++value;
+		}
+
+		hash ^= hash >> 33;
+		hash *= 0xff51afd7ed558ccdULL;
+		hash ^= hash >> 33;
+		hash *= 0xc4ceb9fe1a85ec53ULL;
+		hash ^= hash >> 33;
+
+		return hash;
+	}
+
+	/*
+	 * xorshift64* pseudo-random generator. The state must be initialized with a non-zero seed.
+	 */
+	inline uint64_t random64(uint64_t* state) {
+		*state ^= *state >> 12;
+		*state ^= *state << 25;
+		*state ^= *state >> 27;
 
-	double stats_mean(double* data, unsigned int size);
+		return *state * 2685821657736338717ULL;
+	}
+
+	/*
+	 * Uniformly distributed double in [0, 1) from the 53 upper bits of random64().
+	 */
+	inline double random_uniform(uint64_t* state) {
+		return (random64(state) >> 11) * (1.0 / 9007199254740992.0);
+	}
+
+	/*
+	 * Formats the time like asctime() (without the trailing new line) into the given buffer of at least 25 characters.
+	 * Unlike asctime(localtime()), does not use shared static buffers.
+	 */
+	char* format_time(time_t time, char* buffer);
+
+	char* transform_file_name(char** new_file_name, const char* prefix, const char* file_name, const char* suffix, bool preserve_old_suffix);
 
-	double stats_sd(double* data, unsigned int size, double mean);
+	/*
+	 * Calculates the mean, standard deviation, skewness and excess kurtosis in two passes over the data: the sum of the
+	 * values, and the fused sums of the 2nd, 3rd and 4th powers of the deviations from the mean. The sums are pairwise:
+	 * blocks of STATS_BLOCK_SIZE values are summed in four independent lanes, and the sums of the two halves of a larger
+	 * range are computed recursively and then added.
+	 */
+	void stats_moments(const double* data, uint64_t size, double& mean, double& sd, double& skewness, double& kurtosis);
 
-	double stats_skewness(double* data, unsigned int size, double mean, double sd);
+	double stats_pairwise_sum(const double* data, uint64_t size);
 
-	double stats_kurtosis(double* data, unsigned int size, double mean, double sd);
+	void stats_pairwise_central_sums(const double* data, uint64_t size, double mean, double* sums);
 
-	double stats_median_from_sorted_data(double* data, unsigned int size);
+	double stats_median_from_sorted_data(double* data, uint64_t size);
 
-	double stats_quantile_from_sorted_data(double* data, unsigned int size, double fraction);
+	double stats_quantile_from_sorted_data(double* data, uint64_t size, double fraction);
 
 	inline int fcmp(double x, double y, double epsilon) {
 		int max_exponent = 0;
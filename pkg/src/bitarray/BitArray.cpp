@@ -19,96 +19,313 @@
 
 #include "include/BitArray.h"
 
-const unsigned long int BitArray::INITIAL_SIZE = 4194304;
-const unsigned long int BitArray::INCREMENT = 1048576;
+const uint64_t BitArray::INITIAL_SIZE = 4194304;
+const unsigned int BitArray::WORD_BITS = 64;
+const unsigned int BitArray::RANK_BLOCK_WORDS = 8;
 
-BitArray::BitArray(unsigned long int size) throw (BitArrayException):
-		bit_array(NULL), new_bit_array(NULL), bit_array_size(size), total_bytes(0)  {
+BitArray::BitArray(uint64_t size) throw (BitArrayException):
+		words(NULL), new_words(NULL), total_words(0),
+		ranks(NULL), new_ranks(NULL), total_ranks(0), ranks_valid(false) {
 
 	if (size > 0) {
-		total_bytes = (unsigned long int)ceil(bit_array_size / 8.0);
+		total_words = (size + WORD_BITS - 1) / WORD_BITS;
 
-		bit_array = (unsigned char*)malloc(total_bytes * sizeof(unsigned char));
-		if (bit_array == NULL) {
-			throw BitArrayException("BitArray", "BitArray( unsigned long int )", __LINE__, 2, total_bytes * sizeof(unsigned char));
+		words = (uint64_t*)malloc(total_words * sizeof(uint64_t));
+		if (words == NULL) {
+			throw BitArrayException("BitArray", "BitArray( uint64_t )", __LINE__, 2, total_words * sizeof(uint64_t));
 		}
 
-		for (unsigned int i = 0; i < total_bytes; i++) {
-			bit_array[i] = 0x00;
-		}
+		memset(words, 0, total_words * sizeof(uint64_t));
 	}
 }
 
 BitArray::~BitArray() {
-	if (bit_array != NULL) {
-		free(bit_array);
-		bit_array = NULL;
+	if (words != NULL) {
+		free(words);
+		words = NULL;
+	}
+
+	if (ranks != NULL) {
+		free(ranks);
+		ranks = NULL;
+	}
+}
+
+/*
+ * Makes room for the specified bit. The number of words is at least doubled, so that bits set in ascending order
+ * cause a logarithmic number of reallocations.
+ */
+void BitArray::reserve(uint64_t bit) throw (BitArrayException) {
+	uint64_t word = bit / WORD_BITS;
+	uint64_t first_word = total_words;
+
+	if (word < total_words) {
+		return;
+	}
+
+	total_words = (2 * total_words > word + 1) ? 2 * total_words : word + 1;
+	ranks_valid = false;
+
+	new_words = (uint64_t*)realloc(words, total_words * sizeof(uint64_t));
+	if (new_words == NULL) {
+		free(words);
+		words = NULL;
+		total_words = 0;
+		throw BitArrayException("BitArray", "reserve( uint64_t )", __LINE__, 3, (word + 1) * sizeof(uint64_t));
+	}
+
+	words = new_words;
+
+	memset(words + first_word, 0, (total_words - first_word) * sizeof(uint64_t));
+}
+
+unsigned int BitArray::count_bits(uint64_t word) {
+#if defined(__GNUC__)
+	return __builtin_popcountll(word);
+#else
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (unsigned int)((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+/*
+ * The word must not be 0.
+ */
+unsigned int BitArray::lowest_bit(uint64_t word) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#else
+	return count_bits((word & (~word + 1)) - 1);
+#endif
+}
+
+void BitArray::set_bit(uint64_t bit) throw (BitArrayException) {
+	reserve(bit);
+
+	words[bit / WORD_BITS] |= (uint64_t)1 << (bit % WORD_BITS);
+	ranks_valid = false;
+}
+
+/*
+ * Sets the bits whose selection is not 0. The bits must be in ascending order, so that the storage is reserved once.
+ */
+void BitArray::set_bits(const uint64_t* bits, const unsigned char* selection, uint64_t size) throw (BitArrayException) {
+	uint64_t last = size;
+
+	while ((last > 0) && (selection[last - 1] == 0)) {
+		last -= 1;
 	}
+
+	if (last == 0) {
+		return;
+	}
+
+	reserve(bits[last - 1]);
+
+	for (uint64_t i = 0; i < last; i++) {
+		words[bits[i] / WORD_BITS] |= (uint64_t)(selection[i] != 0) << (bits[i] % WORD_BITS);
+	}
+
+	ranks_valid = false;
 }
 
-void BitArray::set_bit(unsigned long int bit) throw (BitArrayException) {
-	unsigned long int byte = bit >> 3;
+/*
+ * The bits outside of the reserved storage are 0.
+ */
+unsigned char BitArray::get_bit(uint64_t bit) {
+	if (bit / WORD_BITS >= total_words) {
+		return 0;
+	}
 
-	if (byte >= total_bytes) {
-		unsigned long int first_byte = total_bytes;
-		unsigned long int increment = (unsigned long int)ceil(INCREMENT / 8.0);
+	return (unsigned char)((words[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1);
+}
+
+uint64_t BitArray::get_total_bytes() {
+	return total_words * sizeof(uint64_t);
+}
+
+/*
+ * ranks[i] is the number of set bits in the blocks before the i-th block, and the last entry is the number of all set bits.
+ */
+void BitArray::update_ranks() throw (BitArrayException) {
+	uint64_t blocks = (total_words + RANK_BLOCK_WORDS - 1) / RANK_BLOCK_WORDS;
+	uint64_t bits = 0;
 
-		total_bytes += ((increment > (byte - total_bytes + 1)) ? increment : (byte - total_bytes + 1));
-		bit_array_size = total_bytes * sizeof(unsigned char) * 8;
+	if (ranks_valid) {
+		return;
+	}
 
-		new_bit_array = (unsigned char*)realloc(bit_array, total_bytes * sizeof(unsigned char));
-		if (new_bit_array == NULL) {
-			free(bit_array);
-			bit_array = NULL;
-			throw BitArrayException("BitArray", "set_bit( unsigned long int )", __LINE__, 3, total_bytes * sizeof(unsigned char));
+	if (total_ranks != blocks + 1) {
+		new_ranks = (uint64_t*)realloc(ranks, (blocks + 1) * sizeof(uint64_t));
+		if (new_ranks == NULL) {
+			free(ranks);
+			ranks = NULL;
+			total_ranks = 0;
+			throw BitArrayException("BitArray", "update_ranks()", __LINE__, 3, (blocks + 1) * sizeof(uint64_t));
 		}
 
-		bit_array = new_bit_array;
+		ranks = new_ranks;
+		total_ranks = blocks + 1;
+	}
 
-		for (unsigned long int i = first_byte; i < total_bytes; i++) {
-			bit_array[i] = 0x00;
+	for (uint64_t i = 0; i < total_words; i++) {
+		if (i % RANK_BLOCK_WORDS == 0) {
+			ranks[i / RANK_BLOCK_WORDS] = bits;
 		}
+		bits += count_bits(words[i]);
 	}
 
-	bit_array[byte] |= (0x80 >> (bit & 0x07));
+	ranks[blocks] = bits;
+	ranks_valid = true;
+}
+
+/*
+ * Number of the set bits.
+ */
+uint64_t BitArray::count() throw (BitArrayException) {
+	update_ranks();
+
+	return ranks[total_ranks - 1];
 }
 
-unsigned char BitArray::get_bit(unsigned long int bit) {
-	return *(bit_array + (bit >> 3)) & (0x80 >> (bit & 0x07));
+/*
+ * Number of the set bits before the specified bit.
+ */
+uint64_t BitArray::rank(uint64_t bit) throw (BitArrayException) {
+	uint64_t word = bit / WORD_BITS;
+	uint64_t bits = 0;
+
+	update_ranks();
+
+	if (word >= total_words) {
+		return ranks[total_ranks - 1];
+	}
+
+	bits = ranks[word / RANK_BLOCK_WORDS];
+	for (uint64_t i = word - word % RANK_BLOCK_WORDS; i < word; i++) {
+		bits += count_bits(words[i]);
+	}
+
+	return bits + count_bits(words[word] & (((uint64_t)1 << (bit % WORD_BITS)) - 1));
 }
 
-unsigned long int BitArray::get_total_bytes() {
-	return total_bytes;
+/*
+ * Position of the set bit which has the specified number of set bits before it, or -1 if there are not so many set bits.
+ * The block is found by bisection over the directory.
+ */
+int64_t BitArray::select(uint64_t rank) throw (BitArrayException) {
+	uint64_t first = 0, last = 0, middle = 0;
+	uint64_t word = 0;
+	unsigned int bits = 0;
+
+	update_ranks();
+
+	if (rank >= ranks[total_ranks - 1]) {
+		return -1;
+	}
+
+	/* the last block whose preceding blocks have at most rank set bits */
+	last = total_ranks - 2;
+	while (first < last) {
+		middle = first + (last - first + 1) / 2;
+		if (ranks[middle] <= rank) {
+			first = middle;
+		} else {
+			last = middle - 1;
+		}
+	}
+
+	rank -= ranks[first];
+
+	for (uint64_t i = first * RANK_BLOCK_WORDS; i < total_words; i++) {
+		bits = count_bits(words[i]);
+		if (rank < bits) {
+			word = words[i];
+			while (rank > 0) {
+				word &= word - 1;
+				rank -= 1;
+			}
+			return (int64_t)(i * WORD_BITS + lowest_bit(word));
+		}
+		rank -= bits;
+	}
+
+	return -1;
 }
 
-void BitArray::filter(const double* data, double* filtered_data, unsigned long int size) throw (BitArrayException) {
-	unsigned long int upper_byte = bit_array_size >> 3;
-	unsigned long int current_chunk = 0;
-	unsigned long int current_filtered = 0;
+/*
+ * Copies the values at the positions of the set bits. Returns false if a set bit is outside of the data.
+ */
+template <typename T> bool BitArray::compress(const T* data, double* filtered_data, uint64_t size) {
+	uint64_t full_words = size / WORD_BITS;
+	uint64_t current_filtered = 0;
+	uint64_t position = 0;
+	uint64_t word = 0;
+
+	for (uint64_t i = 0; i < total_words; i++) {
+		word = words[i];
+		if (word == 0) {
+			continue;
+		}
+
+		position = i * WORD_BITS;
+
+		if (i >= full_words) {
+			if ((i > full_words) || ((word >> (size % WORD_BITS)) != 0)) {
+				return false;
+			}
+		} else if (word == ~(uint64_t)0) {
+			for (unsigned int j = 0; j < WORD_BITS; j++) {
+				filtered_data[current_filtered + j] = data[position + j];
+			}
+			current_filtered += WORD_BITS;
+			continue;
+		}
 
+		while (word != 0) {
+			filtered_data[current_filtered] = data[position + lowest_bit(word)];
+			current_filtered += 1;
+			word &= word - 1;
+		}
+	}
+
+	return true;
+}
+
+void BitArray::filter(const double* data, double* filtered_data, uint64_t size) throw (BitArrayException) {
 	if (data == NULL) {
-		throw BitArrayException("BitArray", "filter( const double* , double* , unsigned long int )", __LINE__, 0, "data");
+		throw BitArrayException("BitArray", "filter( const double* , double* , uint64_t )", __LINE__, 0, "data");
 	}
 
 	if (filtered_data == NULL) {
-		throw BitArrayException("BitArray", "filter( const double* , double* , unsigned long int )", __LINE__, 0, "filtered_data");
+		throw BitArrayException("BitArray", "filter( const double* , double* , uint64_t )", __LINE__, 0, "filtered_data");
 	}
 
 	if (size == 0) {
-		throw BitArrayException("BitArray", "filter( const double* , double* , unsigned long int )", __LINE__, 1, "size");
+		throw BitArrayException("BitArray", "filter( const double* , double* , uint64_t )", __LINE__, 1, "size");
 	}
 
-	for (unsigned long int i = 0u; i < upper_byte; ++i) {
-		current_chunk = i * 8;
-		for (unsigned int j = 0u; j < 8u; ++j) {
-			if ((bit_array[i] & (0x80 >> j)) != 0x00) {
-				if (current_chunk + j >= size) {
-					throw BitArrayException("BitArray", "filter( const double* , double* , unsigned long int )", __LINE__, 1, "size");
-				}
+	if (!compress(data, filtered_data, size)) {
+		throw BitArrayException("BitArray", "filter( const double* , double* , uint64_t )", __LINE__, 1, "size");
+	}
+}
 
-				filtered_data[current_filtered] = data[current_chunk + j];
-				current_filtered += 1;
-			}
-		}
+void BitArray::filter(const float* data, double* filtered_data, uint64_t size) throw (BitArrayException) {
+	if (data == NULL) {
+		throw BitArrayException("BitArray", "filter( const float* , double* , uint64_t )", __LINE__, 0, "data");
+	}
+
+	if (filtered_data == NULL) {
+		throw BitArrayException("BitArray", "filter( const float* , double* , uint64_t )", __LINE__, 0, "filtered_data");
+	}
+
+	if (size == 0) {
+		throw BitArrayException("BitArray", "filter( const float* , double* , uint64_t )", __LINE__, 1, "size");
+	}
+
+	if (!compress(data, filtered_data, size)) {
+		throw BitArrayException("BitArray", "filter( const float* , double* , uint64_t )", __LINE__, 1, "size");
 	}
 }
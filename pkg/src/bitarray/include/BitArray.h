@@ -22,32 +22,60 @@
 
 #include <iostream>
 #include <cstdlib>
+#include <cstring>
 #include <cmath>
+#include <stdint.h>
 
 #include "BitArrayException.h"
 
 using namespace std;
 
+/*
+ * The bits are kept in 64-bit words: bit i is the (i mod 64)-th lowest bit of the word i / 64. The storage grows
+ * geometrically, and the selected values are copied by whole words: empty words are skipped, full words are copied
+ * as runs, and the set bits of the other words are visited without testing the unset ones.
+ *
+ * rank() and select() use a directory with the number of set bits before every block of RANK_BLOCK_WORDS words. It is built
+ * on their first call after the bits were changed, so that a query counts the bits of at most one block with popcount.
+ */
 class BitArray {
 private:
-	static const unsigned long int INITIAL_SIZE;
-	static const unsigned long int INCREMENT;
+	static const uint64_t INITIAL_SIZE;
+	static const unsigned int WORD_BITS;
+	static const unsigned int RANK_BLOCK_WORDS;
+
+	uint64_t* words;
+	uint64_t* new_words;
+	uint64_t total_words;
 
-	unsigned char* bit_array;
-	unsigned char* new_bit_array;
-	unsigned long int bit_array_size;
+	uint64_t* ranks;
+	uint64_t* new_ranks;
+	uint64_t total_ranks;
+	bool ranks_valid;
 
-	unsigned long int total_bytes;
+	void reserve(uint64_t bit) throw (BitArrayException);
+	void update_ranks() throw (BitArrayException);
+
+	template <typename T> bool compress(const T* data, double* filtered_data, uint64_t size);
+
+	static unsigned int count_bits(uint64_t word);
+	static unsigned int lowest_bit(uint64_t word);
 
 public:
-	BitArray(unsigned long int size = INITIAL_SIZE) throw (BitArrayException);
+	BitArray(uint64_t size = INITIAL_SIZE) throw (BitArrayException);
 	virtual ~BitArray();
 
-	void set_bit(unsigned long int bit) throw (BitArrayException);
-	unsigned char get_bit(unsigned long int bit);
-	unsigned long int get_total_bytes();
+	void set_bit(uint64_t bit) throw (BitArrayException);
+	void set_bits(const uint64_t* bits, const unsigned char* selection, uint64_t size) throw (BitArrayException);
+	unsigned char get_bit(uint64_t bit);
+	uint64_t get_total_bytes();
+
+	uint64_t count() throw (BitArrayException);
+	uint64_t rank(uint64_t bit) throw (BitArrayException);
+	int64_t select(uint64_t rank) throw (BitArrayException);
 
-	void filter(const double* data, double* filtered_data, unsigned long int size) throw (BitArrayException);
+	void filter(const double* data, double* filtered_data, uint64_t size) throw (BitArrayException);
+	void filter(const float* data, double* filtered_data, uint64_t size) throw (BitArrayException);
 };
 
 #endif
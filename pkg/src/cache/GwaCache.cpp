@@ -0,0 +1,887 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/GwaCache.h"
+
+const char* GwaCache::EXTENSION = ".gwac";
+const char GwaCache::MAGIC[] = {'G', 'W', 'A', 'C'};
+const unsigned int GwaCache::FORMAT_VERSION = 1;
+const unsigned int GwaCache::DICTIONARY_SIZE = 256;
+const unsigned int GwaCache::ROWS_HEAP_SIZE = 65536;
+const unsigned int GwaCache::STRINGS_HEAP_SIZE = 4096;
+const unsigned int GwaCache::BUFFER_SIZE = 65536;
+const unsigned int GwaCache::HASH_SLOTS = 512;
+const char* GwaCache::SPILL_EXTENSION = ".tmp";
+
+const unsigned int GwaCache::PLAIN = 0;
+const unsigned int GwaCache::DICTIONARY = 1;
+
+GwaCache::GwaCache() : cache_file_name(NULL), spill_file_name(NULL), na_marker(NULL), spill(NULL),
+	row_columns(0), rows_heap_size(0), writing(false), data(NULL), data_size(0) {
+	memset(&header, 0, sizeof(file_header));
+}
+
+GwaCache::~GwaCache() {
+	close();
+}
+
+uint64_t GwaCache::align(uint64_t offset) {
+	return (offset + 7u) & ~((uint64_t)7u);
+}
+
+bool GwaCache::fits(uint64_t offset, uint64_t size, uint64_t total_size) {
+	return (offset <= total_size) && (size <= total_size - offset);
+}
+
+/* FNV-1a */
+uint32_t GwaCache::hash(const char* value) {
+	uint32_t h = 2166136261u;
+
+	while (*value != '\0') {
+		h ^= (unsigned char)*value;
+		h *= 16777619u;
+		value += 1;
+	}
+
+	return h;
+}
+
+bool GwaCache::seek(FILE* file, uint64_t offset) {
+#ifdef WIN32
+	return _fseeki64(file, (__int64)offset, SEEK_SET) == 0;
+#else
+	return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+void GwaCache::get_status(const char* file_name, uint64_t& size, int64_t& mtime) throw (GwaCacheException) {
+#ifdef WIN32
+	/* the size in struct stat is 32-bit on Windows */
+	struct _stati64 file_status;
+
+	if (_stati64(file_name, &file_status) != 0) {
+#else
+	struct stat file_status;
+
+	if (stat(file_name, &file_status) != 0) {
+#endif
+		throw GwaCacheException("GwaCache", "get_status( const char*, uint64_t&, int64_t& )", __LINE__, 4, file_name);
+	}
+
+	size = (uint64_t)file_status.st_size;
+	mtime = (int64_t)file_status.st_mtime;
+}
+
+bool GwaCache::map() {
+#ifdef WIN32
+	ifstream ifile_stream;
+	struct stat file_status;
+
+	if ((stat(cache_file_name, &file_status) != 0) || ((uint64_t)file_status.st_size < sizeof(file_header))) {
+		return false;
+	}
+
+	data = (char*)malloc(file_status.st_size);
+	if (data == NULL) {
+		return false;
+	}
+	data_size = file_status.st_size;
+
+	ifile_stream.open(cache_file_name, ios::binary);
+	ifile_stream.read(data, data_size);
+	if (ifile_stream.fail()) {
+		unmap();
+		return false;
+	}
+	ifile_stream.close();
+#else
+	int file_descriptor = -1;
+	struct stat file_status;
+	void* address = NULL;
+
+	if ((file_descriptor = ::open(cache_file_name, O_RDONLY)) < 0) {
+		return false;
+	}
+
+	if ((fstat(file_descriptor, &file_status) != 0) || ((uint64_t)file_status.st_size < sizeof(file_header))) {
+		::close(file_descriptor);
+		return false;
+	}
+
+	/* private writable mapping: tokens handed to the consumers may be modified in place without touching the file */
+	address = mmap(NULL, file_status.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, file_descriptor, 0);
+	::close(file_descriptor);
+
+	if (address == MAP_FAILED) {
+		return false;
+	}
+
+	data = (char*)address;
+	data_size = file_status.st_size;
+#endif
+
+	return true;
+}
+
+void GwaCache::unmap() {
+	if (data != NULL) {
+#ifdef WIN32
+		free(data);
+#else
+		munmap(data, data_size);
+#endif
+		data = NULL;
+	}
+
+	data_size = 0;
+}
+
+bool GwaCache::validate() {
+	column c;
+	uint64_t directory_size = 0;
+	uint64_t na_size = 0;
+	uint32_t rows_number = header.rows_number;
+
+	directory_size = sizeof(file_header) + (uint64_t)header.columns_number * sizeof(column_header);
+	if (directory_size > data_size) {
+		return false;
+	}
+
+	na_size = (rows_number + 7u) / 8u;
+
+	for (unsigned int i = 0; i < header.columns_number; i++) {
+		memset(&c, 0, sizeof(column));
+		memcpy(&c.header, data + sizeof(file_header) + i * sizeof(column_header), sizeof(column_header));
+
+		if (!fits(c.header.na_offset, na_size, data_size) ||
+				!fits(c.header.strings_offset, c.header.strings_size, data_size) ||
+				((c.header.values_offset & 7u) != 0)) {
+			return false;
+		}
+
+		c.na_bits = (unsigned char*)(data + c.header.na_offset);
+		c.strings = data + c.header.strings_offset;
+
+		if ((rows_number > 0) && ((c.header.strings_size == 0) || (c.strings[c.header.strings_size - 1] != '\0'))) {
+			return false;
+		}
+
+		if (c.header.encoding == PLAIN) {
+			if (!fits(c.header.values_offset, (uint64_t)rows_number * sizeof(uint32_t), data_size)) {
+				return false;
+			}
+
+			c.offsets = (uint32_t*)(data + c.header.values_offset);
+			for (uint32_t row = 0; row < rows_number; row++) {
+				if (c.offsets[row] >= c.header.strings_size) {
+					return false;
+				}
+			}
+		} else if (c.header.encoding == DICTIONARY) {
+			if ((c.header.dictionary_size > DICTIONARY_SIZE) ||
+					!fits(c.header.values_offset, (uint64_t)c.header.dictionary_size * sizeof(uint32_t) + rows_number, data_size)) {
+				return false;
+			}
+
+			c.dictionary = (uint32_t*)(data + c.header.values_offset);
+			c.codes = (unsigned char*)(c.dictionary + c.header.dictionary_size);
+			for (uint32_t code = 0; code < c.header.dictionary_size; code++) {
+				if (c.dictionary[code] >= c.header.strings_size) {
+					return false;
+				}
+			}
+			for (uint32_t row = 0; row < rows_number; row++) {
+				if (c.codes[row] >= c.header.dictionary_size) {
+					return false;
+				}
+			}
+		} else {
+			return false;
+		}
+
+		columns.push_back(c);
+	}
+
+	return true;
+}
+
+/*
+ * Returns false if there is no valid copy of the GWAS file, which must then be parsed.
+ */
+bool GwaCache::open(const char* file_name, char separator, unsigned int columns_number) throw (GwaCacheException) {
+	uint64_t source_size = 0;
+	int64_t source_mtime = 0;
+
+	if (file_name == NULL) {
+		throw GwaCacheException("GwaCache", "open( const char*, char, unsigned int )", __LINE__, 0, "file_name");
+	}
+
+	close();
+
+	try {
+		get_status(file_name, source_size, source_mtime);
+	} catch (GwaCacheException &e) {
+		return false;
+	}
+
+	cache_file_name = (char*)malloc((strlen(file_name) + strlen(EXTENSION) + 1) * sizeof(char));
+	if (cache_file_name == NULL) {
+		return false;
+	}
+
+	strcpy(cache_file_name, file_name);
+	strcat(cache_file_name, EXTENSION);
+
+	if (!map()) {
+		close();
+		return false;
+	}
+
+	memcpy(&header, data, sizeof(file_header));
+
+	if ((memcmp(header.magic, MAGIC, sizeof(header.magic)) != 0) ||
+			(header.version != FORMAT_VERSION) ||
+			(header.source_size != source_size) ||
+			(header.source_mtime != source_mtime) ||
+			(header.separator != separator) ||
+			(header.columns_number != columns_number) ||
+			!validate()) {
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+void GwaCache::free_columns() {
+	vector<column>::iterator columns_it;
+
+	if (writing) {
+		for (columns_it = columns.begin(); columns_it != columns.end(); columns_it++) {
+			free(columns_it->na_bits);
+			free(columns_it->dictionary);
+			free(columns_it->strings);
+			free(columns_it->slots);
+			free(columns_it->values);
+		}
+	}
+
+	columns.clear();
+	values_chunks.clear();
+	strings_chunks.clear();
+}
+
+void GwaCache::close() {
+	free_columns();
+	unmap();
+
+	if (spill != NULL) {
+		fclose(spill);
+		spill = NULL;
+	}
+
+	if (spill_file_name != NULL) {
+		remove(spill_file_name);
+		free(spill_file_name);
+		spill_file_name = NULL;
+	}
+
+	if (cache_file_name != NULL) {
+		free(cache_file_name);
+		cache_file_name = NULL;
+	}
+
+	if (na_marker != NULL) {
+		free(na_marker);
+		na_marker = NULL;
+	}
+
+	memset(&header, 0, sizeof(file_header));
+	row_columns = 0;
+	rows_heap_size = 0;
+	writing = false;
+}
+
+/*
+ * Gives up the copy which is being written. The partial files are removed.
+ */
+void GwaCache::discard() {
+	if ((writing) && (cache_file_name != NULL)) {
+		remove(cache_file_name);
+	}
+
+	close();
+}
+
+bool GwaCache::is_open() {
+	return data != NULL;
+}
+
+unsigned int GwaCache::get_rows_number() {
+	return header.rows_number;
+}
+
+unsigned int GwaCache::get_columns_number() {
+	return header.columns_number;
+}
+
+void GwaCache::get_row(unsigned int row, char** tokens) {
+	for (unsigned int i = 0; i < header.columns_number; i++) {
+		tokens[i] = get_value(row, i);
+	}
+}
+
+char* GwaCache::get_value(unsigned int row, unsigned int column) {
+	GwaCache::column& c = columns[column];
+
+	if (c.codes != NULL) {
+		return c.strings + c.dictionary[c.codes[row]];
+	}
+
+	return c.strings + c.offsets[row];
+}
+
+bool GwaCache::is_na(unsigned int row, unsigned int column) {
+	return ((columns[column].na_bits[row >> 3] >> (row & 7u)) & 1u) != 0;
+}
+
+unsigned int GwaCache::get_na_number(unsigned int column) {
+	return columns[column].header.na;
+}
+
+double GwaCache::get_min(unsigned int column) {
+	return columns[column].header.min;
+}
+
+double GwaCache::get_max(unsigned int column) {
+	return columns[column].header.max;
+}
+
+/*
+ * Starts writing the copy of the GWAS file. If the copy can't be started, the GWAS file is processed without it.
+ */
+void GwaCache::create(const char* file_name, char separator, unsigned int columns_number, const char* na_marker) throw (GwaCacheException) {
+	column c;
+
+	if (file_name == NULL) {
+		throw GwaCacheException("GwaCache", "create( const char*, char, unsigned int, const char* )", __LINE__, 0, "file_name");
+	}
+
+	if (na_marker == NULL) {
+		throw GwaCacheException("GwaCache", "create( const char*, char, unsigned int, const char* )", __LINE__, 0, "na_marker");
+	}
+
+	close();
+
+	try {
+		get_status(file_name, header.source_size, header.source_mtime);
+	} catch (GwaCacheException &e) {
+		close();
+		return;
+	}
+
+	memcpy(header.magic, MAGIC, sizeof(header.magic));
+	header.version = FORMAT_VERSION;
+	header.columns_number = columns_number;
+	header.rows_number = 0;
+	header.separator = separator;
+
+	cache_file_name = (char*)malloc((strlen(file_name) + strlen(EXTENSION) + 1) * sizeof(char));
+	spill_file_name = (char*)malloc((strlen(file_name) + strlen(EXTENSION) + strlen(SPILL_EXTENSION) + 1) * sizeof(char));
+	this->na_marker = (char*)malloc((strlen(na_marker) + 1) * sizeof(char));
+	if ((cache_file_name == NULL) || (spill_file_name == NULL) || (this->na_marker == NULL)) {
+		close();
+		return;
+	}
+
+	strcpy(cache_file_name, file_name);
+	strcat(cache_file_name, EXTENSION);
+
+	strcpy(spill_file_name, cache_file_name);
+	strcat(spill_file_name, SPILL_EXTENSION);
+
+	strcpy(this->na_marker, na_marker);
+
+	writing = true;
+
+	for (unsigned int i = 0; i < columns_number; i++) {
+		memset(&c, 0, sizeof(column));
+		c.header.encoding = DICTIONARY;
+		c.header.min = numeric_limits<double>::quiet_NaN();
+		c.header.max = numeric_limits<double>::quiet_NaN();
+
+		c.dictionary = (uint32_t*)malloc(DICTIONARY_SIZE * sizeof(uint32_t));
+		c.slots = (int16_t*)malloc(HASH_SLOTS * sizeof(int16_t));
+		c.values = (unsigned char*)malloc(BUFFER_SIZE * sizeof(unsigned char));
+
+		columns.push_back(c);
+
+		if ((c.dictionary == NULL) || (c.slots == NULL) || (c.values == NULL)) {
+			discard();
+			return;
+		}
+
+		memset(c.slots, 0xff, HASH_SLOTS * sizeof(int16_t));
+	}
+
+	values_chunks.resize(columns_number);
+	strings_chunks.resize(columns_number);
+
+	if ((spill = fopen(spill_file_name, "w+b")) == NULL) {
+		discard();
+		return;
+	}
+
+	if (!grow_rows()) {
+		discard();
+	}
+}
+
+bool GwaCache::grow_rows() {
+	vector<column>::iterator columns_it;
+	unsigned int new_rows_heap_size = 0;
+	unsigned char* new_na_bits = NULL;
+
+	/* the heap doubles, so that all rows are copied a constant number of times on average */
+	new_rows_heap_size = (rows_heap_size > 0) ? 2 * rows_heap_size : ROWS_HEAP_SIZE;
+
+	for (columns_it = columns.begin(); columns_it != columns.end(); columns_it++) {
+		new_na_bits = (unsigned char*)realloc(columns_it->na_bits, new_rows_heap_size / 8u);
+		if (new_na_bits == NULL) {
+			return false;
+		}
+		memset(new_na_bits + rows_heap_size / 8u, 0, (new_rows_heap_size - rows_heap_size) / 8u);
+		columns_it->na_bits = new_na_bits;
+	}
+
+	rows_heap_size = new_rows_heap_size;
+
+	return true;
+}
+
+bool GwaCache::move_to_spill(const void* buffer, uint32_t size, vector<chunk>& chunks) {
+	chunk c;
+
+	if (size == 0) {
+		return true;
+	}
+
+	if (fseek(spill, 0, SEEK_END) != 0) {
+		return false;
+	}
+
+#ifdef WIN32
+	c.offset = (uint64_t)_ftelli64(spill);
+#else
+	c.offset = (uint64_t)ftello(spill);
+#endif
+	c.size = size;
+
+	if (fwrite(buffer, 1, size, spill) != size) {
+		return false;
+	}
+
+	chunks.push_back(c);
+
+	return true;
+}
+
+bool GwaCache::copy_from_spill(vector<chunk>& chunks, ofstream& ofile_stream) {
+	vector<chunk>::iterator chunks_it;
+	char* buffer = NULL;
+
+	if (chunks.empty()) {
+		return true;
+	}
+
+	buffer = (char*)malloc(BUFFER_SIZE * sizeof(char));
+	if (buffer == NULL) {
+		return false;
+	}
+
+	for (chunks_it = chunks.begin(); chunks_it != chunks.end(); chunks_it++) {
+		if (!seek(spill, chunks_it->offset) || (fread(buffer, 1, chunks_it->size, spill) != chunks_it->size)) {
+			free(buffer);
+			return false;
+		}
+		ofile_stream.write(buffer, chunks_it->size);
+	}
+
+	free(buffer);
+
+	return true;
+}
+
+bool GwaCache::append_value(unsigned int column, const void* value, uint32_t size) {
+	GwaCache::column& c = columns[column];
+
+	if (c.values_size + size > BUFFER_SIZE) {
+		if (!move_to_spill(c.values, c.values_size, values_chunks[column])) {
+			return false;
+		}
+		c.values_size = 0;
+	}
+
+	memcpy(c.values + c.values_size, value, size);
+	c.values_size += size;
+
+	return true;
+}
+
+/*
+ * Appends the string of a plain column. The offsets are 32-bit: columns with larger strings block are not cached.
+ */
+bool GwaCache::append_string(unsigned int column, const char* value, uint32_t& offset) {
+	GwaCache::column& c = columns[column];
+	uint64_t length = strlen(value) + 1u;
+
+	if (c.header.strings_size + length > numeric_limits<uint32_t>::max()) {
+		return false;
+	}
+
+	offset = (uint32_t)c.header.strings_size;
+	c.header.strings_size += length;
+
+	while (length > 0) {
+		if (c.strings_buffered == BUFFER_SIZE) {
+			if (!move_to_spill(c.strings, c.strings_buffered, strings_chunks[column])) {
+				return false;
+			}
+			c.strings_buffered = 0;
+		}
+
+		if (length <= BUFFER_SIZE - c.strings_buffered) {
+			memcpy(c.strings + c.strings_buffered, value, length);
+			c.strings_buffered += length;
+			break;
+		}
+
+		memcpy(c.strings + c.strings_buffered, value, BUFFER_SIZE - c.strings_buffered);
+		value += BUFFER_SIZE - c.strings_buffered;
+		length -= BUFFER_SIZE - c.strings_buffered;
+		c.strings_buffered = BUFFER_SIZE;
+	}
+
+	return true;
+}
+
+/*
+ * Finds (or adds) the dictionary code of the value. The code is -1 if the dictionary is full.
+ * Returns false if memory can't be allocated.
+ */
+bool GwaCache::find_code(column& c, const char* value, int& code) {
+	uint32_t slot = hash(value) & (HASH_SLOTS - 1u);
+	uint64_t length = 0;
+	uint64_t new_strings_heap_size = 0;
+	char* new_strings = NULL;
+
+	while (c.slots[slot] >= 0) {
+		if (strcmp(c.strings + c.dictionary[c.slots[slot]], value) == 0) {
+			code = c.slots[slot];
+			return true;
+		}
+		slot = (slot + 1u) & (HASH_SLOTS - 1u);
+	}
+
+	if (c.header.dictionary_size >= DICTIONARY_SIZE) {
+		code = -1;
+		return true;
+	}
+
+	length = strlen(value) + 1u;
+
+	if (c.header.strings_size + length > c.strings_heap_size) {
+		new_strings_heap_size = (c.strings_heap_size > 0) ? c.strings_heap_size : STRINGS_HEAP_SIZE;
+		while (new_strings_heap_size < c.header.strings_size + length) {
+			new_strings_heap_size *= 2u;
+		}
+
+		new_strings = (char*)realloc(c.strings, new_strings_heap_size * sizeof(char));
+		if (new_strings == NULL) {
+			return false;
+		}
+
+		c.strings = new_strings;
+		c.strings_heap_size = new_strings_heap_size;
+	}
+
+	code = c.header.dictionary_size;
+
+	c.dictionary[code] = (uint32_t)c.header.strings_size;
+	memcpy(c.strings + c.header.strings_size, value, length);
+	c.header.strings_size += length;
+	c.header.dictionary_size += 1;
+
+	c.slots[slot] = (int16_t)code;
+
+	return true;
+}
+
+/*
+ * Turns the dictionary column into the plain one, when it has more than DICTIONARY_SIZE distinct values.
+ * The codes, which were already moved to the temporary file, are read back.
+ */
+bool GwaCache::expand_dictionary(unsigned int column) {
+	GwaCache::column& c = columns[column];
+	vector<chunk> code_chunks;
+	vector<chunk>::iterator chunks_it;
+	char* dictionary_strings = c.strings;
+	uint32_t* dictionary = c.dictionary;
+	unsigned char* buffered_codes = NULL;
+	unsigned char* codes = NULL;
+	uint32_t buffered_codes_size = 0;
+	uint32_t offset = 0;
+	bool expanded = true;
+
+	buffered_codes = (unsigned char*)malloc(BUFFER_SIZE * sizeof(unsigned char));
+	codes = (unsigned char*)malloc(BUFFER_SIZE * sizeof(unsigned char));
+	c.strings = (char*)malloc(BUFFER_SIZE * sizeof(char));
+	if ((buffered_codes == NULL) || (codes == NULL) || (c.strings == NULL)) {
+		free(buffered_codes);
+		free(codes);
+		free(c.strings);
+		c.strings = dictionary_strings;
+		return false;
+	}
+
+	code_chunks.swap(values_chunks[column]);
+
+	/* the buffered codes follow the moved ones; the buffer of values is refilled with the offsets */
+	memcpy(buffered_codes, c.values, c.values_size);
+	buffered_codes_size = c.values_size;
+	c.values_size = 0;
+
+	c.dictionary = NULL;
+	c.strings_heap_size = 0;
+	c.strings_buffered = 0;
+	c.header.strings_size = 0;
+	c.header.dictionary_size = 0;
+	c.header.encoding = PLAIN;
+
+	free(c.slots);
+	c.slots = NULL;
+
+	for (chunks_it = code_chunks.begin(); expanded && (chunks_it != code_chunks.end()); chunks_it++) {
+		if (!seek(spill, chunks_it->offset) || (fread(codes, 1, chunks_it->size, spill) != chunks_it->size)) {
+			expanded = false;
+			break;
+		}
+
+		for (uint32_t i = 0; expanded && (i < chunks_it->size); i++) {
+			expanded = append_string(column, dictionary_strings + dictionary[codes[i]], offset) &&
+					append_value(column, &offset, sizeof(uint32_t));
+		}
+	}
+
+	for (uint32_t i = 0; expanded && (i < buffered_codes_size); i++) {
+		expanded = append_string(column, dictionary_strings + dictionary[buffered_codes[i]], offset) &&
+				append_value(column, &offset, sizeof(uint32_t));
+	}
+
+	free(dictionary_strings);
+	free(dictionary);
+	free(buffered_codes);
+	free(codes);
+
+	return expanded;
+}
+
+void GwaCache::put(unsigned int column, const char* value) {
+	uint32_t row = header.rows_number;
+	int code = 0;
+	uint32_t offset = 0;
+	unsigned char byte_code = 0;
+	double d_value = 0.0;
+	char* end_ptr = NULL;
+
+	if (!writing || (column >= columns.size())) {
+		return;
+	}
+
+	GwaCache::column& c = columns[column];
+
+	if ((value[0] == '\0') || (strcmp(value, na_marker) == 0)) {
+		c.na_bits[row >> 3] |= (unsigned char)(1u << (row & 7u));
+		c.header.na += 1;
+	} else {
+		d_value = strtod(value, &end_ptr);
+		if ((end_ptr != value) && (*end_ptr == '\0') && !isnan(d_value)) {
+			if (isnan(c.header.min) || (d_value < c.header.min)) {
+				c.header.min = d_value;
+			}
+			if (isnan(c.header.max) || (d_value > c.header.max)) {
+				c.header.max = d_value;
+			}
+		}
+	}
+
+	if (c.header.encoding == DICTIONARY) {
+		if (!find_code(c, value, code)) {
+			discard();
+			return;
+		}
+
+		if (code >= 0) {
+			byte_code = (unsigned char)code;
+			if (!append_value(column, &byte_code, sizeof(unsigned char))) {
+				discard();
+				return;
+			}
+			row_columns += 1;
+			return;
+		}
+
+		if (!expand_dictionary(column)) {
+			discard();
+			return;
+		}
+	}
+
+	if (!append_string(column, value, offset) || !append_value(column, &offset, sizeof(uint32_t))) {
+		discard();
+		return;
+	}
+
+	row_columns += 1;
+}
+
+void GwaCache::complete_row() {
+	if (!writing) {
+		return;
+	}
+
+	/* a malformed line: the file can't be cached */
+	if (row_columns != columns.size()) {
+		discard();
+		return;
+	}
+
+	row_columns = 0;
+	header.rows_number += 1;
+
+	if (header.rows_number >= rows_heap_size) {
+		/* the rows are indexed with 32-bit numbers: larger files are not cached */
+		if ((rows_heap_size > numeric_limits<uint32_t>::max() / 2u) || !grow_rows()) {
+			discard();
+			return;
+		}
+	}
+}
+
+/*
+ * Writes the copy. If it fails, the partial copy is removed.
+ */
+void GwaCache::write() {
+	vector<column>::iterator columns_it;
+	ofstream ofile_stream;
+	file_header incomplete_header;
+	static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+	uint64_t position = 0;
+	uint64_t offset = 0;
+	uint64_t na_size = 0;
+	unsigned int column = 0;
+	bool written = true;
+
+	if (!writing) {
+		return;
+	}
+
+	na_size = (header.rows_number + 7u) / 8u;
+
+	offset = align(sizeof(file_header) + columns.size() * sizeof(column_header));
+	for (columns_it = columns.begin(); columns_it != columns.end(); columns_it++) {
+		columns_it->header.na_offset = offset;
+		offset = align(offset + na_size);
+
+		columns_it->header.values_offset = offset;
+		if (columns_it->header.encoding == PLAIN) {
+			offset = align(offset + (uint64_t)header.rows_number * sizeof(uint32_t));
+		} else {
+			offset = align(offset + (uint64_t)columns_it->header.dictionary_size * sizeof(uint32_t) + header.rows_number);
+		}
+
+		columns_it->header.strings_offset = offset;
+		offset = align(offset + columns_it->header.strings_size);
+	}
+
+	ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
+
+	try {
+		ofile_stream.open(cache_file_name, ios::binary | ios::trunc);
+
+		/* the magic number is written last: an interrupted write leaves an invalid file */
+		memcpy(&incomplete_header, &header, sizeof(file_header));
+		memset(incomplete_header.magic, 0, sizeof(incomplete_header.magic));
+
+		ofile_stream.write((const char*)&incomplete_header, sizeof(file_header));
+		position = sizeof(file_header);
+
+		for (columns_it = columns.begin(); columns_it != columns.end(); columns_it++) {
+			ofile_stream.write((const char*)&(columns_it->header), sizeof(column_header));
+			position += sizeof(column_header);
+		}
+
+		for (columns_it = columns.begin(), column = 0; written && (columns_it != columns.end()); columns_it++, column++) {
+			ofile_stream.write(padding, columns_it->header.na_offset - position);
+			ofile_stream.write((const char*)columns_it->na_bits, na_size);
+			position = columns_it->header.na_offset + na_size;
+
+			ofile_stream.write(padding, columns_it->header.values_offset - position);
+			if (columns_it->header.encoding == PLAIN) {
+				position = columns_it->header.values_offset + (uint64_t)header.rows_number * sizeof(uint32_t);
+			} else {
+				ofile_stream.write((const char*)columns_it->dictionary, (uint64_t)columns_it->header.dictionary_size * sizeof(uint32_t));
+				position = columns_it->header.values_offset + (uint64_t)columns_it->header.dictionary_size * sizeof(uint32_t) + header.rows_number;
+			}
+			written = copy_from_spill(values_chunks[column], ofile_stream);
+			ofile_stream.write((const char*)columns_it->values, columns_it->values_size);
+
+			ofile_stream.write(padding, columns_it->header.strings_offset - position);
+			if (columns_it->header.encoding == PLAIN) {
+				written = written && copy_from_spill(strings_chunks[column], ofile_stream);
+				ofile_stream.write(columns_it->strings, columns_it->strings_buffered);
+			} else {
+				ofile_stream.write(columns_it->strings, columns_it->header.strings_size);
+			}
+			position = columns_it->header.strings_offset + columns_it->header.strings_size;
+		}
+
+		if (written) {
+			ofile_stream.seekp(0);
+			ofile_stream.write(header.magic, sizeof(header.magic));
+		}
+
+		ofile_stream.close();
+	} catch (ofstream::failure &e) {
+		ofile_stream.exceptions(ios_base::goodbit);
+		ofile_stream.close();
+		written = false;
+	}
+
+	if (!written) {
+		discard();
+		return;
+	}
+
+	close();
+}
+
+bool GwaCache::is_writing() {
+	return writing;
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/ResultCache.h"
+
+const char ResultCache::MAGIC[] = {'G', 'W', 'A', 'R'};
+const unsigned int ResultCache::FORMAT_VERSION = 1;
+const unsigned int ResultCache::HASH_BLOCKS = 16;
+const unsigned int ResultCache::HASH_BLOCK_SIZE = 65536;
+
+ResultCache::ResultCache() {
+	memset(&header, 0, sizeof(file_header));
+}
+
+ResultCache::~ResultCache() {
+
+}
+
+/*
+ * Files up to HASH_BLOCKS * HASH_BLOCK_SIZE bytes are hashed completely. Larger files are hashed in HASH_BLOCKS blocks,
+ * from the first to the last byte, so that the changes of the header, of the last lines and of the lines in between
+ * at evenly spaced positions are noticed even when the size and the modification time stay the same.
+ */
+void ResultCache::identify(const char* source_file_name, uint64_t settings_hash, unsigned int results_version) throw (GwaCacheException) {
+#ifdef WIN32
+	/* the size in struct stat is 32-bit on Windows */
+	struct _stati64 file_status;
+#else
+	struct stat file_status;
+#endif
+	ifstream ifile_stream;
+	char* block = NULL;
+	uint64_t block_size = 0;
+	uint64_t offset = 0;
+	uint64_t step = HASH_BLOCK_SIZE;
+	uint64_t hash = 14695981039346656037ULL;
+
+	if (source_file_name == NULL) {
+		throw GwaCacheException("ResultCache", "identify( const char*, uint64_t, unsigned int )", __LINE__, 0, "source_file_name");
+	}
+
+#ifdef WIN32
+	if (_stati64(source_file_name, &file_status) != 0) {
+#else
+	if (stat(source_file_name, &file_status) != 0) {
+#endif
+		throw GwaCacheException("ResultCache", "identify( const char*, uint64_t, unsigned int )", __LINE__, 4, source_file_name);
+	}
+
+	memset(&header, 0, sizeof(file_header));
+	memcpy(header.magic, MAGIC, sizeof(header.magic));
+	header.version = FORMAT_VERSION;
+	header.results_version = results_version;
+	header.source_size = (uint64_t)file_status.st_size;
+	header.source_mtime = (int64_t)file_status.st_mtime;
+	header.settings_hash = settings_hash;
+
+	if (header.source_size > (uint64_t)HASH_BLOCKS * HASH_BLOCK_SIZE) {
+		step = (header.source_size - HASH_BLOCK_SIZE) / (HASH_BLOCKS - 1u);
+	}
+
+	block = (char*)malloc(HASH_BLOCK_SIZE * sizeof(char));
+	if (block == NULL) {
+		throw GwaCacheException("ResultCache", "identify( const char*, uint64_t, unsigned int )", __LINE__, 2, HASH_BLOCK_SIZE * sizeof(char));
+	}
+
+	ifile_stream.open(source_file_name, ios::binary);
+
+	for (unsigned int i = 0; (i < HASH_BLOCKS) && (offset < header.source_size) && (!ifile_stream.fail()); i++) {
+		block_size = header.source_size - offset < HASH_BLOCK_SIZE ? header.source_size - offset : HASH_BLOCK_SIZE;
+
+		ifile_stream.seekg((streamoff)offset);
+		ifile_stream.read(block, block_size);
+
+		for (uint64_t j = 0; j < block_size; j++) {
+			hash ^= (unsigned char)block[j];
+			hash *= 1099511628211ULL;
+		}
+
+		offset += step;
+	}
+
+	free(block);
+	block = NULL;
+
+	if (ifile_stream.fail()) {
+		throw GwaCacheException("ResultCache", "identify( const char*, uint64_t, unsigned int )", __LINE__, 9, source_file_name);
+	}
+
+	ifile_stream.close();
+
+	header.source_hash = hash;
+}
+
+/*
+ * Opens the file of saved results and positions the stream after the header.
+ * Returns false if there is no such file or if it was saved for another GWAS file, other settings or another version.
+ */
+bool ResultCache::load(const char* file_name, ifstream& stream) {
+	file_header saved_header;
+
+	if ((file_name == NULL) || (header.version == 0)) {
+		return false;
+	}
+
+	stream.clear();
+	stream.open(file_name, ios::binary);
+	if (stream.fail()) {
+		stream.clear();
+		return false;
+	}
+
+	stream.read((char*)&saved_header, sizeof(file_header));
+	if ((stream.fail()) || (memcmp(&saved_header, &header, sizeof(file_header)) != 0)) {
+		stream.close();
+		stream.clear();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * Creates the file of saved results and writes the header without the magic number, which is written by complete().
+ * An interrupted write therefore leaves a file that is never loaded.
+ */
+void ResultCache::create(const char* file_name, ofstream& stream) throw (GwaCacheException) {
+	file_header incomplete_header;
+
+	if (file_name == NULL) {
+		throw GwaCacheException("ResultCache", "create( const char*, ofstream& )", __LINE__, 0, "file_name");
+	}
+
+	if (header.version == 0) {
+		throw GwaCacheException("ResultCache", "create( const char*, ofstream& )", __LINE__, 1, "header");
+	}
+
+	stream.open(file_name, ios::binary | ios::trunc);
+	if (stream.fail()) {
+		throw GwaCacheException("ResultCache", "create( const char*, ofstream& )", __LINE__, 5, file_name);
+	}
+
+	memcpy(&incomplete_header, &header, sizeof(file_header));
+	memset(incomplete_header.magic, 0, sizeof(incomplete_header.magic));
+
+	stream.write((const char*)&incomplete_header, sizeof(file_header));
+	if (stream.fail()) {
+		throw GwaCacheException("ResultCache", "create( const char*, ofstream& )", __LINE__, 6, file_name);
+	}
+}
+
+void ResultCache::complete(const char* file_name, ofstream& stream) throw (GwaCacheException) {
+	stream.flush();
+	stream.seekp(0);
+	stream.write(header.magic, sizeof(header.magic));
+	if (stream.fail()) {
+		throw GwaCacheException("ResultCache", "complete( const char*, ofstream& )", __LINE__, 6, file_name);
+	}
+
+	stream.close();
+	if (stream.fail()) {
+		throw GwaCacheException("ResultCache", "complete( const char*, ofstream& )", __LINE__, 7, file_name);
+	}
+}
@@ -0,0 +1,178 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GWACACHE_H_
+#define GWACACHE_H_
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "GwaCacheException.h"
+
+using namespace std;
+
+/*
+ * Columnar binary copy (".gwac" file) of the trimmed data fields of a GWAS file.
+ * Every column stores a NA bitmap, the minimum and maximum of its numeric values, and its values either
+ * as one-byte codes into a dictionary (up to 256 distinct values) or as offsets into a block of strings.
+ * The copy replaces the GWAS file while the size and the modification time of the latter stay unchanged.
+ *
+ * While the copy is written, the values and the strings of every column are buffered in blocks of BUFFER_SIZE
+ * bytes, which are moved to a temporary file (".gwac.tmp") when full. The copy is best-effort: any failure while
+ * writing discards it, and the GWAS file is processed as without the copy.
+ */
+class GwaCache {
+private:
+	struct file_header {
+		char magic[4];
+		uint32_t version;
+		uint64_t source_size;
+		int64_t source_mtime;
+		uint32_t columns_number;
+		uint32_t rows_number;
+		char separator;
+		char padding[7];
+	};
+
+	struct column_header {
+		uint32_t encoding;
+		uint32_t na;
+		double min;
+		double max;
+		uint64_t na_offset;
+		uint64_t values_offset;
+		uint64_t strings_offset;
+		uint64_t strings_size;
+		uint32_t dictionary_size;
+		uint32_t padding;
+	};
+
+	struct chunk {
+		uint64_t offset;
+		uint32_t size;
+	};
+
+	/*
+	 * When the copy is read, the pointers address the mapped file. When it is written, values and strings are the
+	 * buffers of the column (strings of a dictionary column are never moved to the temporary file), and slots is
+	 * a hash table (linear probing) of the dictionary codes.
+	 */
+	struct column {
+		column_header header;
+		unsigned char* na_bits;
+		uint32_t* offsets;
+		unsigned char* codes;
+		uint32_t* dictionary;
+		char* strings;
+		uint64_t strings_heap_size;
+		int16_t* slots;
+		unsigned char* values;
+		uint32_t values_size;
+		uint32_t strings_buffered;
+	};
+
+	char* cache_file_name;
+	char* spill_file_name;
+	char* na_marker;
+
+	FILE* spill;
+	vector< vector<chunk> > values_chunks;
+	vector< vector<chunk> > strings_chunks;
+
+	file_header header;
+	vector<column> columns;
+	unsigned int row_columns;
+	unsigned int rows_heap_size;
+	bool writing;
+
+	char* data;
+	uint64_t data_size;
+
+	void get_status(const char* file_name, uint64_t& size, int64_t& mtime) throw (GwaCacheException);
+	bool map();
+	void unmap();
+	bool validate();
+
+	bool grow_rows();
+	bool move_to_spill(const void* buffer, uint32_t size, vector<chunk>& chunks);
+	bool copy_from_spill(vector<chunk>& chunks, ofstream& ofile_stream);
+	bool append_value(unsigned int column, const void* value, uint32_t size);
+	bool append_string(unsigned int column, const char* value, uint32_t& offset);
+	bool find_code(column& c, const char* value, int& code);
+	bool expand_dictionary(unsigned int column);
+	void discard();
+	void free_columns();
+
+	static uint64_t align(uint64_t offset);
+	static bool fits(uint64_t offset, uint64_t size, uint64_t total_size);
+	static uint32_t hash(const char* value);
+	static bool seek(FILE* file, uint64_t offset);
+
+public:
+	static const char* EXTENSION;
+	static const char MAGIC[];
+	static const unsigned int FORMAT_VERSION;
+	static const unsigned int DICTIONARY_SIZE;
+	static const unsigned int ROWS_HEAP_SIZE;
+	static const unsigned int STRINGS_HEAP_SIZE;
+	static const unsigned int BUFFER_SIZE;
+	static const unsigned int HASH_SLOTS;
+	static const char* SPILL_EXTENSION;
+
+	static const unsigned int PLAIN;
+	static const unsigned int DICTIONARY;
+
+	GwaCache();
+	virtual ~GwaCache();
+
+	bool open(const char* file_name, char separator, unsigned int columns_number) throw (GwaCacheException);
+	void close();
+	bool is_open();
+
+	unsigned int get_rows_number();
+	unsigned int get_columns_number();
+	void get_row(unsigned int row, char** tokens);
+	char* get_value(unsigned int row, unsigned int column);
+	bool is_na(unsigned int row, unsigned int column);
+	unsigned int get_na_number(unsigned int column);
+	double get_min(unsigned int column);
+	double get_max(unsigned int column);
+
+	void create(const char* file_name, char separator, unsigned int columns_number, const char* na_marker) throw (GwaCacheException);
+	void put(unsigned int column, const char* value);
+	void complete_row();
+	void write();
+	bool is_writing();
+};
+
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RESULTCACHE_H_
+#define RESULTCACHE_H_
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "GwaCacheException.h"
+
+using namespace std;
+
+/*
+ * Saved results of processing a GWAS file, which are reused while the GWAS file and the settings stay unchanged.
+ * The header identifies the GWAS file by its size, modification time and a hash of evenly spaced blocks of its content,
+ * and the settings by their hash. The results follow the header and their layout is up to the caller.
+ */
+class ResultCache {
+private:
+	struct file_header {
+		char magic[4];
+		uint32_t version;
+		uint32_t results_version;
+		uint32_t padding;
+		uint64_t source_size;
+		int64_t source_mtime;
+		uint64_t source_hash;
+		uint64_t settings_hash;
+	};
+
+	file_header header;
+
+public:
+	static const char MAGIC[];
+	static const unsigned int FORMAT_VERSION;
+	static const unsigned int HASH_BLOCKS;
+	static const unsigned int HASH_BLOCK_SIZE;
+
+	ResultCache();
+	virtual ~ResultCache();
+
+	void identify(const char* source_file_name, uint64_t settings_hash, unsigned int results_version) throw (GwaCacheException);
+	bool load(const char* file_name, ifstream& stream);
+	void create(const char* file_name, ofstream& stream) throw (GwaCacheException);
+	void complete(const char* file_name, ofstream& stream) throw (GwaCacheException);
+};
+
+#endif
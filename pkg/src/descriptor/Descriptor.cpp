@@ -55,10 +55,22 @@ const char* Descriptor::MISSING = "MISSING";
 const char* Descriptor::ORDER = "ORDER";
 const char* Descriptor::OUTFILE = "OUTFILE";
 const char* Descriptor::PREFIX = "PREFIX";
+const char* Descriptor::FORMATPREFIX = "FORMATPREFIX";
 const char* Descriptor::PROCESS = "PROCESS";
 const char* Descriptor::SEPARATOR = "SEPARATOR";
 const char* Descriptor::VERBOSITY = "VERBOSITY";
 const char* Descriptor::RENAME = "RENAME";
+const char* Descriptor::FINGERPRINT = "FINGERPRINT";
+const char* Descriptor::CACHE = "CACHE";
+const char* Descriptor::RESULTCACHE = "RESULTCACHE";
+const char* Descriptor::PREVIEW = "PREVIEW";
+const char* Descriptor::PARTITION = "PARTITION";
+const char* Descriptor::PARTITIONS = "PARTITIONS";
+const char* Descriptor::LOWMEMORY = "LOWMEMORY";
+const char* Descriptor::RASTER = "RASTER";
+const char* Descriptor::PRECISION = "PRECISION";
+const char* Descriptor::HISTOGRAM = "HISTOGRAM";
+const char* Descriptor::THREADS = "THREADS";
 
 const char* Descriptor::REGIONS_FILE = "REGIONS_FILE";
 const char* Descriptor::REGIONS_FILE_SEPARATOR = "REGIONS_FILE_SEPARATOR";
@@ -88,21 +100,24 @@ const char* Descriptor::SEMICOLON = "SEMICOLON";
 const char* Descriptor::TAB = "TAB";
 const char* Descriptor::TABULATION = "TABULATION";
 const char* Descriptor::WHITESPACE = "WHITESPACE";
+const char* Descriptor::MERGE = "MERGE";
 
 const char* Descriptor::ON_MODES[] = {"ON", "1"};
 const char* Descriptor::OFF_MODES[] = {"OFF", "0"};
 const char* Descriptor::LOW_MODES[] = {"LOW", "1"};
 const char* Descriptor::HIGH_MODES[] = {"HIGH", "2"};
+const char* Descriptor::SINGLE_MODES[] = {"SINGLE", "32"};
+const char* Descriptor::DOUBLE_MODES[] = {"DOUBLE", "64"};
 
 Descriptor::Descriptor():
 	path_separator('\0'), name(NULL), path(NULL), full_path(NULL),
-	abbreviation(NULL), columns(bool_strcmp), properties(bool_strcmp), thresholds(bool_strcmp), renamed_columns(bool_strcmp), ld_files(bool_strcmp) {
+	abbreviation(NULL), columns(bool_strcmp), properties(bool_strcmp), thresholds(bool_strcmp), renamed_columns(bool_strcmp), precisions(bool_strcmp), histograms(bool_strcmp), ld_files(bool_strcmp) {
 
 }
 
 Descriptor::Descriptor(const char* full_path, char path_separator) throw (DescriptorException):
 	path_separator(path_separator), name(NULL), path(NULL), full_path(NULL),
-	abbreviation(NULL),	columns(bool_strcmp), properties(bool_strcmp), thresholds(bool_strcmp), renamed_columns(bool_strcmp), ld_files(bool_strcmp)  {
+	abbreviation(NULL),	columns(bool_strcmp), properties(bool_strcmp), thresholds(bool_strcmp), renamed_columns(bool_strcmp), precisions(bool_strcmp), histograms(bool_strcmp), ld_files(bool_strcmp)  {
 
 	if (full_path == NULL) {
 		throw DescriptorException("Descriptor", "Descriptor( const char*, char )", __LINE__, 0, "full_path");
@@ -122,7 +137,7 @@ Descriptor::Descriptor(const char* full_path, char path_separator) throw (Descri
 
 Descriptor::Descriptor(const char* full_path, Descriptor& file, char path_separator) throw (DescriptorException):
 	path_separator(path_separator), name(NULL), path(NULL), full_path(NULL),
-	abbreviation(NULL), columns(bool_strcmp), properties(bool_strcmp), thresholds(bool_strcmp), renamed_columns(bool_strcmp), ld_files(bool_strcmp)  {
+	abbreviation(NULL), columns(bool_strcmp), properties(bool_strcmp), thresholds(bool_strcmp), renamed_columns(bool_strcmp), precisions(bool_strcmp), histograms(bool_strcmp), ld_files(bool_strcmp)  {
 
 	if (full_path == NULL) {
 		throw DescriptorException("Descriptor", "Descriptor( const char*, Descriptor&, char )", __LINE__, 0, "full_path");
@@ -138,6 +153,8 @@ Descriptor::Descriptor(const char* full_path, Descriptor& file, char path_separa
 		copy(properties, file.properties);
 		copy(thresholds, file.thresholds);
 		copy(renamed_columns, file.renamed_columns);
+		copy(precisions, file.precisions);
+		copy(histograms, file.histograms);
 		copy(reordered_columns, file.reordered_columns);
 		copy(ld_files, file.ld_files);
 	} catch (DescriptorException &e) {
@@ -179,6 +196,16 @@ Descriptor::~Descriptor() {
 		free(map_char_it->second);
 	}
 
+	for (map_char_it = precisions.begin(); map_char_it != precisions.end(); map_char_it++) {
+		free((char*)map_char_it->first);
+		free(map_char_it->second);
+	}
+
+	for (map_vect_it = histograms.begin(); map_vect_it != histograms.end(); map_vect_it++) {
+		free((char*)map_vect_it->first);
+		delete map_vect_it->second;
+	}
+
 	for (vector_char_it = reordered_columns.begin(); vector_char_it != reordered_columns.end(); vector_char_it++) {
 		free((char*)*vector_char_it);
 	}
@@ -191,6 +218,8 @@ Descriptor::~Descriptor() {
 	properties.clear();
 	thresholds.clear();
 	renamed_columns.clear();
+	precisions.clear();
+	histograms.clear();
 	reordered_columns.clear();
 	ld_files.clear();
 }
@@ -669,6 +698,24 @@ const char* Descriptor::get_renamed_column(const char* name) throw (DescriptorEx
 	}
 }
 
+const char* Descriptor::get_precision(const char* name) throw (DescriptorException) {
+	try {
+		return get(precisions, name);
+	} catch (DescriptorException &e) {
+		e.add_message("Descriptor", "const char* get_precision( const char* )", __LINE__, 25);
+		throw;
+	}
+}
+
+vector<double>* Descriptor::get_histogram(const char* name) throw (DescriptorException) {
+	try {
+		return get(histograms, name);
+	} catch (DescriptorException &e) {
+		e.add_message("Descriptor", "vector<double>* get_histogram( const char* )", __LINE__, 28);
+		throw;
+	}
+}
+
 int Descriptor::get_column_order(const char* name, bool case_sensitive) throw (DescriptorException) {
 	if ((name != NULL) && (strlen(name) > 0)) {
 		int position = 0;
@@ -728,6 +775,66 @@ int Descriptor::get_ld_files_number() {
 	return ld_files.size();
 }
 
+/*
+ * Hash of all settings, which may change the results of processing the file. The settings which only change how the file
+ * is processed (threads and caches) are left out. The maps are ordered by their keys, so the hash doesn't depend on
+ * the order of the commands in the script.
+ */
+uint64_t Descriptor::get_settings_hash() {
+	uint64_t hash = 14695981039346656037ULL;
+	char number[32];
+
+	for (map_char_it = columns.begin(); map_char_it != columns.end(); map_char_it++) {
+		hash = (hash ^ hash64(map_char_it->first)) * 1099511628211ULL;
+		hash = (hash ^ hash64(map_char_it->second)) * 1099511628211ULL;
+	}
+
+	for (map_char_it = properties.begin(); map_char_it != properties.end(); map_char_it++) {
+		if ((strcmp(map_char_it->first, THREADS) == 0) || (strcmp(map_char_it->first, CACHE) == 0) ||
+				(strcmp(map_char_it->first, RESULTCACHE) == 0) || (strcmp(map_char_it->first, RASTER) == 0)) {
+			continue;
+		}
+		hash = (hash ^ hash64(map_char_it->first)) * 1099511628211ULL;
+		hash = (hash ^ hash64(map_char_it->second)) * 1099511628211ULL;
+	}
+
+	for (map_vect_it = thresholds.begin(); map_vect_it != thresholds.end(); map_vect_it++) {
+		hash = (hash ^ hash64(map_vect_it->first)) * 1099511628211ULL;
+		for (vector_double_it = map_vect_it->second->begin(); vector_double_it != map_vect_it->second->end(); vector_double_it++) {
+			sprintf(number, "%.17g", *vector_double_it);
+			hash = (hash ^ hash64(number)) * 1099511628211ULL;
+		}
+	}
+
+	for (map_char_it = renamed_columns.begin(); map_char_it != renamed_columns.end(); map_char_it++) {
+		hash = (hash ^ hash64(map_char_it->first)) * 1099511628211ULL;
+		hash = (hash ^ hash64(map_char_it->second)) * 1099511628211ULL;
+	}
+
+	for (map_char_it = precisions.begin(); map_char_it != precisions.end(); map_char_it++) {
+		hash = (hash ^ hash64(map_char_it->first)) * 1099511628211ULL;
+		hash = (hash ^ hash64(map_char_it->second)) * 1099511628211ULL;
+	}
+
+	for (map_vect_it = histograms.begin(); map_vect_it != histograms.end(); map_vect_it++) {
+		hash = (hash ^ hash64(map_vect_it->first)) * 1099511628211ULL;
+		for (vector_double_it = map_vect_it->second->begin(); vector_double_it != map_vect_it->second->end(); vector_double_it++) {
+			sprintf(number, "%.17g", *vector_double_it);
+			hash = (hash ^ hash64(number)) * 1099511628211ULL;
+		}
+	}
+
+	for (vector_char_it = reordered_columns.begin(); vector_char_it != reordered_columns.end(); vector_char_it++) {
+		hash = (hash ^ hash64(*vector_char_it)) * 1099511628211ULL;
+	}
+
+	for (set_char_it = ld_files.begin(); set_char_it != ld_files.end(); set_char_it++) {
+		hash = (hash ^ hash64(*set_char_it)) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
 void Descriptor::set_abbreviation(const char* abbreviation) throw (DescriptorException) {
 	if (abbreviation == NULL) {
 		throw DescriptorException("Descriptor", "set_abbreviation( const char* )", __LINE__, 0, "abbreviation");
@@ -830,6 +937,24 @@ void Descriptor::add_renamed_column(const char* name, const char* new_name) thro
 	}
 }
 
+void Descriptor::add_precision(const char* name, const char* precision) throw (DescriptorException) {
+	try {
+		add(precisions, name, precision);
+	} catch (DescriptorException &e) {
+		e.add_message("Descriptor", "add_precision( const char*, const char* )", __LINE__, 23);
+		throw;
+	}
+}
+
+void Descriptor::add_histogram(const char* name, double value) throw (DescriptorException) {
+	try {
+		add(histograms, name, value);
+	} catch (DescriptorException &e) {
+		e.add_message("Descriptor", "add_histogram( const char*, double )", __LINE__, 26);
+		throw;
+	}
+}
+
 void Descriptor::add_reordered_column(const char* name) throw (DescriptorException) {
 	char* name_copy = NULL;
 
@@ -909,6 +1034,24 @@ bool Descriptor::remove_renamed_column(const char* name) throw (DescriptorExcept
 	}
 }
 
+bool Descriptor::remove_precision(const char* name) throw (DescriptorException) {
+	try {
+		return remove(precisions, name);
+	} catch (DescriptorException &e) {
+		e.add_message("Descriptor", "bool remove_precision( const char* )", __LINE__, 24);
+		throw;
+	}
+}
+
+bool Descriptor::remove_histogram(const char* name) throw (DescriptorException) {
+	try {
+		return remove(histograms, name);
+	} catch (DescriptorException &e) {
+		e.add_message("Descriptor", "bool remove_histogram( const char* )", __LINE__, 27);
+		throw;
+	}
+}
+
 void Descriptor::remove_reordered_columns() {
 	for (vector_char_it = reordered_columns.begin(); vector_char_it != reordered_columns.end(); vector_char_it++) {
 		free((char*)*vector_char_it);
@@ -929,6 +1072,8 @@ void Descriptor::remove_reordered_columns() {
 vector<Descriptor*>* Descriptor::process_instructions(const char* script_name, char path_separator) throw (DescriptorException) {
 	list<char*> tokens;
 	char* token = NULL;
+	const char* precision = NULL;
+	double histogram_range[2] = {0.0, 0.0};
 
 	vector<Descriptor*>* descriptors = new vector<Descriptor*>();
 	Descriptor default_descriptor;
@@ -1199,6 +1344,10 @@ vector<Descriptor*>* Descriptor::process_instructions(const char* script_name, c
 					if (!tokens.empty()) {
 						default_descriptor.add_property(PREFIX, tokens.front());
 					}
+				} else if (strcmp(token, FORMATPREFIX) == 0) {
+					if (!tokens.empty()) {
+						default_descriptor.add_property(FORMATPREFIX, tokens.front());
+					}
 				} else if (strcmp(token, PROCESS) == 0) {
 					if (!tokens.empty()) {
 						new_descriptor = new Descriptor(tokens.front(), default_descriptor, path_separator);
@@ -1238,6 +1387,143 @@ vector<Descriptor*>* Descriptor::process_instructions(const char* script_name, c
 							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), VERBOSITY);
 						}
 					}
+				} else if (strcmp(token, FINGERPRINT) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), ON_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), ON_MODES[1]) == 0)) {
+							default_descriptor.add_property(FINGERPRINT, ON_MODES[0]);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(FINGERPRINT, OFF_MODES[0]);
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), FINGERPRINT);
+						}
+					}
+				} else if (strcmp(token, CACHE) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), ON_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), ON_MODES[1]) == 0)) {
+							default_descriptor.add_property(CACHE, ON_MODES[0]);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(CACHE, OFF_MODES[0]);
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), CACHE);
+						}
+					}
+				} else if (strcmp(token, RESULTCACHE) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), ON_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), ON_MODES[1]) == 0)) {
+							default_descriptor.add_property(RESULTCACHE, ON_MODES[0]);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(RESULTCACHE, OFF_MODES[0]);
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), RESULTCACHE);
+						}
+					}
+				} else if (strcmp(token, PREVIEW) == 0) {
+					if (!tokens.empty()) {
+						if (strcmp_ignore_case(tokens.front(), ON_MODES[0]) == 0) {
+							default_descriptor.add_property(PREVIEW, ON_MODES[0]);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(PREVIEW, OFF_MODES[0]);
+						} else if (is_numeric(tokens.front())) {
+							default_descriptor.add_property(PREVIEW, tokens.front());
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), PREVIEW);
+						}
+					}
+				} else if (strcmp(token, PARTITION) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(PARTITION, OFF_MODES[0]);
+							default_descriptor.remove_property(PARTITIONS);
+						} else if ((is_numeric(tokens.front())) && (tokens.size() >= 2)) {
+							default_descriptor.add_property(PARTITIONS, tokens.front());
+							tokens.pop_front();
+
+							if (strcmp_ignore_case(tokens.front(), MERGE) == 0) {
+								default_descriptor.add_property(PARTITION, MERGE);
+							} else if (is_numeric(tokens.front())) {
+								default_descriptor.add_property(PARTITION, tokens.front());
+							} else {
+								throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), PARTITION);
+							}
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), PARTITION);
+						}
+					}
+				} else if (strcmp(token, LOWMEMORY) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), ON_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), ON_MODES[1]) == 0)) {
+							default_descriptor.add_property(LOWMEMORY, ON_MODES[0]);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(LOWMEMORY, OFF_MODES[0]);
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), LOWMEMORY);
+						}
+					}
+				} else if (strcmp(token, RASTER) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), ON_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), ON_MODES[1]) == 0)) {
+							default_descriptor.add_property(RASTER, ON_MODES[0]);
+						} else if ((strcmp_ignore_case(tokens.front(), OFF_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), OFF_MODES[1]) == 0)) {
+							default_descriptor.add_property(RASTER, OFF_MODES[0]);
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), RASTER);
+						}
+					}
+				} else if (strcmp(token, THREADS) == 0) {
+					if (!tokens.empty()) {
+						if (is_numeric(tokens.front())) {
+							default_descriptor.add_property(THREADS, tokens.front());
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), THREADS);
+						}
+					}
+				} else if (strcmp(token, PRECISION) == 0) {
+					if (!tokens.empty()) {
+						if ((strcmp_ignore_case(tokens.front(), SINGLE_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), SINGLE_MODES[1]) == 0)) {
+							precision = SINGLE_MODES[0];
+						} else if ((strcmp_ignore_case(tokens.front(), DOUBLE_MODES[0]) == 0) ||
+								(strcmp_ignore_case(tokens.front(), DOUBLE_MODES[1]) == 0)) {
+							precision = DOUBLE_MODES[0];
+						} else {
+							throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), PRECISION);
+						}
+						tokens.pop_front();
+
+						while ((!tokens.empty()) && (tokens.front()[0] != SCRIPT_COMMENT_SYMBOL)) {
+							default_descriptor.add_precision(tokens.front(), precision);
+							tokens.pop_front();
+						}
+					}
+				} else if (strcmp(token, HISTOGRAM) == 0) {
+					if (tokens.size() >= 2) {
+						for (unsigned int i = 0; i < 2; i++) {
+							if (!is_numeric(tokens.front())) {
+								throw DescriptorException("Descriptor", "vector<Descriptor*>* process_instructions( const char*, char )", __LINE__, 15, tokens.front(), HISTOGRAM);
+							}
+							histogram_range[i] = strtod(tokens.front(), NULL);
+							tokens.pop_front();
+						}
+
+						while ((!tokens.empty()) && (tokens.front()[0] != SCRIPT_COMMENT_SYMBOL)) {
+							default_descriptor.remove_histogram(tokens.front());
+							default_descriptor.add_histogram(tokens.front(), histogram_range[0]);
+							default_descriptor.add_histogram(tokens.front(), histogram_range[1]);
+							tokens.pop_front();
+						}
+					}
 				} else if (strcmp(token, RENAME) == 0) {
 					if (tokens.size() >= 2) {
 						token = tokens.front();
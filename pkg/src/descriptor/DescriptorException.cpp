@@ -19,7 +19,7 @@
 
 #include "include/DescriptorException.h"
 
-const int DescriptorException::MESSAGE_TEMPLATES_NUMBER = 23;
+const int DescriptorException::MESSAGE_TEMPLATES_NUMBER = 29;
 const char* DescriptorException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -43,7 +43,13 @@ const char* DescriptorException::MESSAGE_TEMPLATES[] = {
 /*19*/	"Error while adding a column to the ordered list of columns in the Descriptor class.",
 /*20*/	"Error while adding an LD file name to an instance of the Descriptor class.",
 /*21*/	"Error while removing an LD file name from an instance of the Descriptor class.",
-/*22*/	"Error while retrieving an LD file path from an instance of the Descriptor class."
+/*22*/	"Error while retrieving an LD file path from an instance of the Descriptor class.",
+/*23*/	"Error while adding a column precision to an instance of the Descriptor class.",
+/*24*/	"Error while removing a column precision from an instance of the Descriptor class.",
+/*25*/	"Error while retrieving a column precision from an instance of the Descriptor class.",
+/*26*/	"Error while adding a histogram range to an instance of the Descriptor class.",
+/*27*/	"Error while removing a histogram range from an instance of the Descriptor class.",
+/*28*/	"Error while retrieving a histogram range from an instance of the Descriptor class."
 };
 
 DescriptorException::DescriptorException() : Exception() {
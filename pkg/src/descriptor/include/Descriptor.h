@@ -61,6 +61,8 @@ private:
 	map<const char* const, char*, bool(*)(const char*, const char*)> properties;
 	map<const char* const, vector<double>*, bool(*)(const char*, const char*)> thresholds;
 	map<const char* const, char*, bool(*)(const char*, const char*)> renamed_columns;
+	map<const char* const, char*, bool(*)(const char*, const char*)> precisions;
+	map<const char* const, vector<double>*, bool(*)(const char*, const char*)> histograms;
 	vector<const char*> reordered_columns;
 	set<const char*, bool(*)(const char*, const char*)> ld_files;
 
@@ -129,10 +131,22 @@ public:
 	static const char* ORDER;
 	static const char* OUTFILE;
 	static const char* PREFIX;
+	static const char* FORMATPREFIX;
 	static const char* PROCESS;
 	static const char* SEPARATOR;
 	static const char* VERBOSITY;
 	static const char* RENAME;
+	static const char* FINGERPRINT;
+	static const char* CACHE;
+	static const char* RESULTCACHE;
+	static const char* PREVIEW;
+	static const char* PARTITION;
+	static const char* PARTITIONS;
+	static const char* LOWMEMORY;
+	static const char* RASTER;
+	static const char* PRECISION;
+	static const char* HISTOGRAM;
+	static const char* THREADS;
 
 	static const char* REGIONS_FILE;
 	static const char* REGIONS_FILE_SEPARATOR;
@@ -162,11 +176,14 @@ public:
 	static const char* TAB;
 	static const char* TABULATION;
 	static const char* WHITESPACE;
+	static const char* MERGE;
 
 	static const char* ON_MODES[];
 	static const char* OFF_MODES[];
 	static const char* LOW_MODES[];
 	static const char* HIGH_MODES[];
+	static const char* SINGLE_MODES[];
+	static const char* DOUBLE_MODES[];
 
 	virtual ~Descriptor();
 
@@ -184,6 +201,8 @@ public:
 	vector<double>* get_threshold(const char* name) throw (DescriptorException);
 	vector<const char*>* get_thresholds();
 	const char* get_renamed_column(const char* name) throw (DescriptorException);
+	const char* get_precision(const char* name) throw (DescriptorException);
+	vector<double>* get_histogram(const char* name) throw (DescriptorException);
 	int get_column_order(const char* name, bool case_sensitive) throw (DescriptorException);
 	vector<const char*>* get_reordered_columns();
 	vector<const char*>* get_ld_files();
@@ -192,6 +211,7 @@ public:
 	int get_thresholds_number();
 	int get_reordered_columns_number();
 	int get_ld_files_number();
+	uint64_t get_settings_hash();
 
 	void set_full_path(const char* full_path, char path_separator = DEFAULT_PATH_SEPARATOR) throw (DescriptorException);
 
@@ -203,6 +223,8 @@ public:
 	void add_threshold(const char* name, double value) throw (DescriptorException);
 	void add_threshold(const char* name, const char* numeric_value) throw (DescriptorException);
 	void add_renamed_column(const char* name, const char* new_name) throw (DescriptorException);
+	void add_precision(const char* name, const char* precision) throw (DescriptorException);
+	void add_histogram(const char* name, double value) throw (DescriptorException);
 	void add_reordered_column(const char* name) throw (DescriptorException);
 	void add_ld_file(const char* path) throw (DescriptorException);
 
@@ -210,6 +232,8 @@ public:
 	bool remove_property(const char* name) throw (DescriptorException);
 	bool remove_threshold(const char* name) throw (DescriptorException);
 	bool remove_renamed_column(const char* name) throw (DescriptorException);
+	bool remove_precision(const char* name) throw (DescriptorException);
+	bool remove_histogram(const char* name) throw (DescriptorException);
 	void remove_reordered_columns();
 	bool remove_ld_file(const char* name) throw (DescriptorException);
 
@@ -24,6 +24,7 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <string>
 #include <cstdarg>
 #include <cstdio>
 #include <cstdlib>
@@ -47,6 +48,9 @@ private:
 
 	list<message*> trace;
 
+	/* Keeps the text returned by what() alive for the lifetime of the exception. */
+	mutable string what_text;
+
 	void format_message_text(char** text, int message_template_index, va_list arguments);
 
 protected:
@@ -19,7 +19,11 @@
 
 #include "include/GwaFile.h"
 
-GwaFile::GwaFile(Descriptor* descriptor) throw (GwaFileException) : descriptor(descriptor) {
+const unsigned int GwaFile::DEFAULT_PREVIEW_ROWS = 100000;
+const unsigned int GwaFile::MAX_THREADS = 64;
+
+GwaFile::GwaFile(Descriptor* descriptor) throw (GwaFileException) : descriptor(descriptor), fingerprint_on(false), cache_on(false), resultcache_on(false), preview_rows(0),
+	partitions(0), partition(0), lowmemory_on(false), raster_on(false), threads(1) {
 	if (descriptor == NULL) {
 		throw GwaFileException("GwaFile", "GwaFile( Descriptor* )", __LINE__, 0, "descriptor");
 	}
@@ -35,7 +39,8 @@ GwaFile::GwaFile(Descriptor* descriptor) throw (GwaFileException) : descriptor(d
 	check_genomiccontrol(descriptor);
 }
 
-GwaFile::GwaFile(Descriptor* descriptor, void (GwaFile::*check_functions[])(Descriptor*), unsigned int check_functions_number) throw (GwaFileException): descriptor(descriptor)  {
+GwaFile::GwaFile(Descriptor* descriptor, void (GwaFile::*check_functions[])(Descriptor*), unsigned int check_functions_number) throw (GwaFileException): descriptor(descriptor), fingerprint_on(false), cache_on(false), resultcache_on(false), preview_rows(0),
+	partitions(0), partition(0), lowmemory_on(false), raster_on(false), threads(1)  {
 	if (descriptor == NULL) {
 		throw GwaFileException("GwaFile", "GwaFile( Descriptor* )", __LINE__, 0, "descriptor");
 	}
@@ -61,6 +66,53 @@ bool GwaFile::is_high_verbosity() {
 	return high_verbosity;
 }
 
+bool GwaFile::is_fingerprint_on() {
+	return fingerprint_on;
+}
+
+bool GwaFile::is_cache_on() {
+	return cache_on;
+}
+
+bool GwaFile::is_resultcache_on() {
+	return resultcache_on;
+}
+
+bool GwaFile::is_preview_on() {
+	return preview_rows > 0;
+}
+
+unsigned int GwaFile::get_preview_rows() {
+	return preview_rows;
+}
+
+bool GwaFile::is_partition_on() {
+	return partitions > 0;
+}
+
+unsigned int GwaFile::get_partitions() {
+	return partitions;
+}
+
+/*
+ * Returns the partition number (from 1), or 0 when the saved partial states are merged.
+ */
+unsigned int GwaFile::get_partition() {
+	return partition;
+}
+
+bool GwaFile::is_lowmemory_on() {
+	return lowmemory_on;
+}
+
+bool GwaFile::is_raster_on() {
+	return raster_on;
+}
+
+unsigned int GwaFile::get_threads() {
+	return threads;
+}
+
 bool GwaFile::is_order_on() {
 	return order_on;
 }
@@ -290,6 +342,44 @@ void GwaFile::check_thresholds(Descriptor* descriptor) throw (GwaFileException)
 	}
 }
 
+/*
+ * The histograms of p-values, allele frequencies, call rates and imputation quality are filled over [0, 1], unless
+ * another range is specified with the HISTOGRAM command. The other numeric columns have no default range.
+ */
+void GwaFile::check_histograms(Descriptor* descriptor) throw (GwaFileException) {
+	const char* columns[] = {
+			Descriptor::PVALUE, Descriptor::FREQLABEL, Descriptor::HWE_PVAL, Descriptor::CALLRATE, Descriptor::OEVAR_IMP,
+			Descriptor::EFFECT, Descriptor::STDERR, Descriptor::N_TOTAL, Descriptor::IMPUTED, Descriptor::USED_FOR_IMP
+	};
+	vector<double>* range = NULL;
+	double swap_value = 0.0;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_histograms( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		for (unsigned int i = 0; i < 10; i++) {
+			if ((range = descriptor->get_histogram(columns[i])) == NULL) {
+				if (i < 5) {
+					descriptor->add_histogram(columns[i], 0.0);
+					descriptor->add_histogram(columns[i], 1.0);
+				}
+			} else if ((range->size() != 2) || (range->at(0) == range->at(1))) {
+				throw GwaFileException("GwaFile", "check_histograms( Descriptor* )", __LINE__, 20, columns[i], Descriptor::HISTOGRAM, descriptor->get_full_path());
+			} else if (range->at(0) > range->at(1)) {
+				swap_value = range->at(0);
+				range->at(0) = range->at(1);
+				range->at(1) = swap_value;
+			}
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_histograms( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
 void GwaFile::check_prefix(Descriptor* descriptor) throw (GwaFileException) {
 	const char* prefix = NULL;
 
@@ -308,6 +398,44 @@ void GwaFile::check_prefix(Descriptor* descriptor) throw (GwaFileException) {
 	}
 }
 
+void GwaFile::check_formatprefix(Descriptor* descriptor) throw (GwaFileException) {
+	const char* prefix = NULL;
+	const char* default_prefix = "formatted_";
+	char* format_prefix = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_formatprefix( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		if (descriptor->get_property(Descriptor::FORMATPREFIX) == NULL) {
+			if ((prefix = descriptor->get_property(Descriptor::PREFIX)) == NULL) {
+				prefix = "";
+			}
+
+			format_prefix = (char*)malloc((strlen(prefix) + strlen(default_prefix) + 1) * sizeof(char));
+			if (format_prefix == NULL) {
+				throw GwaFileException("GwaFile", "check_formatprefix( Descriptor* )", __LINE__, 2, (strlen(prefix) + strlen(default_prefix) + 1) * sizeof(char));
+			}
+			strcpy(format_prefix, prefix);
+			strcat(format_prefix, default_prefix);
+
+			descriptor->add_property(Descriptor::FORMATPREFIX, format_prefix);
+
+			free(format_prefix);
+			format_prefix = NULL;
+		}
+	} catch (DescriptorException &e) {
+		if (format_prefix != NULL) {
+			free(format_prefix);
+			format_prefix = NULL;
+		}
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_formatprefix( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
 void GwaFile::check_casesensitivity(Descriptor* descriptor) throw (GwaFileException) {
 	const char* casesensitive = NULL;
 
@@ -352,6 +480,209 @@ void GwaFile::check_verbosity_level(Descriptor* descriptor) throw (GwaFileExcept
 	}
 }
 
+void GwaFile::check_fingerprint(Descriptor* descriptor) throw (GwaFileException) {
+	const char* fingerprint = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_fingerprint( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		fingerprint_on = false;
+		if ((fingerprint = descriptor->get_property(Descriptor::FINGERPRINT)) == NULL) {
+			descriptor->add_property(Descriptor::FINGERPRINT, Descriptor::OFF_MODES[0]);
+		} else if ((strcmp_ignore_case(fingerprint, Descriptor::ON_MODES[0]) == 0) ||
+				(strcmp_ignore_case(fingerprint, Descriptor::ON_MODES[1]) == 0)) {
+			fingerprint_on = true;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_fingerprint( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_cache(Descriptor* descriptor) throw (GwaFileException) {
+	const char* cache = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_cache( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		cache_on = false;
+		if ((cache = descriptor->get_property(Descriptor::CACHE)) == NULL) {
+			descriptor->add_property(Descriptor::CACHE, Descriptor::OFF_MODES[0]);
+		} else if ((strcmp_ignore_case(cache, Descriptor::ON_MODES[0]) == 0) ||
+				(strcmp_ignore_case(cache, Descriptor::ON_MODES[1]) == 0)) {
+			cache_on = true;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_cache( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_resultcache(Descriptor* descriptor) throw (GwaFileException) {
+	const char* resultcache = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_resultcache( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		resultcache_on = false;
+		if ((resultcache = descriptor->get_property(Descriptor::RESULTCACHE)) == NULL) {
+			descriptor->add_property(Descriptor::RESULTCACHE, Descriptor::OFF_MODES[0]);
+		} else if ((strcmp_ignore_case(resultcache, Descriptor::ON_MODES[0]) == 0) ||
+				(strcmp_ignore_case(resultcache, Descriptor::ON_MODES[1]) == 0)) {
+			resultcache_on = true;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_resultcache( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_preview(Descriptor* descriptor) throw (GwaFileException) {
+	const char* preview = NULL;
+	double rows = 0.0;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_preview( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		preview_rows = 0;
+		if ((preview = descriptor->get_property(Descriptor::PREVIEW)) == NULL) {
+			descriptor->add_property(Descriptor::PREVIEW, Descriptor::OFF_MODES[0]);
+		} else if (strcmp_ignore_case(preview, Descriptor::ON_MODES[0]) == 0) {
+			preview_rows = DEFAULT_PREVIEW_ROWS;
+		} else if (strcmp_ignore_case(preview, Descriptor::OFF_MODES[0]) != 0) {
+			rows = auxiliary::to_double(preview);
+			if ((isnan(rows)) || (rows < 1.0) || (rows > numeric_limits<unsigned int>::max()) || (floor(rows) != rows)) {
+				throw GwaFileException("GwaFile", "check_preview( Descriptor* )", __LINE__, 17, Descriptor::PREVIEW, descriptor->get_full_path());
+			}
+			preview_rows = (unsigned int)rows;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_preview( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_partition(Descriptor* descriptor) throw (GwaFileException) {
+	const char* value = NULL;
+	double number = 0.0;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_partition( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		partitions = 0;
+		partition = 0;
+		if ((value = descriptor->get_property(Descriptor::PARTITION)) == NULL) {
+			descriptor->add_property(Descriptor::PARTITION, Descriptor::OFF_MODES[0]);
+		} else if (strcmp_ignore_case(value, Descriptor::OFF_MODES[0]) != 0) {
+			if (strcmp_ignore_case(value, Descriptor::MERGE) != 0) {
+				number = auxiliary::to_double(value);
+				if ((isnan(number)) || (number < 1.0) || (number > numeric_limits<unsigned int>::max()) || (floor(number) != number)) {
+					throw GwaFileException("GwaFile", "check_partition( Descriptor* )", __LINE__, 18, Descriptor::PARTITION, descriptor->get_full_path());
+				}
+				partition = (unsigned int)number;
+			}
+
+			if ((value = descriptor->get_property(Descriptor::PARTITIONS)) == NULL) {
+				throw GwaFileException("GwaFile", "check_partition( Descriptor* )", __LINE__, 18, Descriptor::PARTITION, descriptor->get_full_path());
+			}
+
+			number = auxiliary::to_double(value);
+			if ((isnan(number)) || (number < 1.0) || (number > numeric_limits<unsigned int>::max()) || (floor(number) != number) || (partition > number)) {
+				throw GwaFileException("GwaFile", "check_partition( Descriptor* )", __LINE__, 18, Descriptor::PARTITION, descriptor->get_full_path());
+			}
+			partitions = (unsigned int)number;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_partition( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_lowmemory(Descriptor* descriptor) throw (GwaFileException) {
+	const char* lowmemory = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_lowmemory( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		lowmemory_on = false;
+		if ((lowmemory = descriptor->get_property(Descriptor::LOWMEMORY)) == NULL) {
+			descriptor->add_property(Descriptor::LOWMEMORY, Descriptor::OFF_MODES[0]);
+		} else if ((strcmp_ignore_case(lowmemory, Descriptor::ON_MODES[0]) == 0) ||
+				(strcmp_ignore_case(lowmemory, Descriptor::ON_MODES[1]) == 0)) {
+			lowmemory_on = true;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_lowmemory( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_raster(Descriptor* descriptor) throw (GwaFileException) {
+	const char* raster = NULL;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_raster( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		raster_on = false;
+		if ((raster = descriptor->get_property(Descriptor::RASTER)) == NULL) {
+			descriptor->add_property(Descriptor::RASTER, Descriptor::OFF_MODES[0]);
+		} else if ((strcmp_ignore_case(raster, Descriptor::ON_MODES[0]) == 0) ||
+				(strcmp_ignore_case(raster, Descriptor::ON_MODES[1]) == 0)) {
+			raster_on = true;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_raster( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
+void GwaFile::check_threads(Descriptor* descriptor) throw (GwaFileException) {
+	const char* value = NULL;
+	double number = 0.0;
+
+	if (descriptor == NULL) {
+		throw GwaFileException("GwaFile", "check_threads( Descriptor* )", __LINE__, 0, "descriptor");
+	}
+
+	try {
+		threads = 1;
+		if ((value = descriptor->get_property(Descriptor::THREADS)) == NULL) {
+			descriptor->add_property(Descriptor::THREADS, "1");
+		} else {
+			number = auxiliary::to_double(value);
+			if ((isnan(number)) || (number < 1.0) || (number > MAX_THREADS) || (floor(number) != number)) {
+				throw GwaFileException("GwaFile", "check_threads( Descriptor* )", __LINE__, 19, Descriptor::THREADS, descriptor->get_full_path(), MAX_THREADS);
+			}
+			threads = (unsigned int)number;
+		}
+	} catch (DescriptorException &e) {
+		GwaFileException new_e(e);
+		new_e.add_message("GwaFile", "check_threads( Descriptor* )", __LINE__, 10, descriptor->get_full_path());
+		throw new_e;
+	}
+}
+
 void GwaFile::check_missing_value(Descriptor* descriptor) throw (GwaFileException) {
 	const char* missing_value = NULL;
 
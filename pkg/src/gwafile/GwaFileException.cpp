@@ -19,7 +19,7 @@
 
 #include "include/GwaFileException.h"
 
-const int GwaFileException::MESSAGE_TEMPLATES_NUMBER = 17;
+const int GwaFileException::MESSAGE_TEMPLATES_NUMBER = 21;
 const char* GwaFileException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -37,7 +37,11 @@ const char* GwaFileException::MESSAGE_TEMPLATES[] = {
 /*13*/	"Negative value is specified in the %s command for the '%s' file. Strictly positive values or 0 are required.",
 /*14*/	"Names of the files with LD values for independent SNPs selection are not specified in the %s commands for the '%s' file.",
 /*15*/	"Field separators in %s file don't match field separators in previously declared files in the %s commands for the '%s' file.",
-/*16*/	"Too many thresholds are specified in the high quality imputation filter %s for the '%s' file. Strictly one threshold is required."
+/*16*/	"Too many thresholds are specified in the high quality imputation filter %s for the '%s' file. Strictly one threshold is required.",
+/*17*/	"Invalid number of rows is specified in the %s command for the '%s' file. Strictly positive integer is required.",
+/*18*/	"Invalid partition is specified in the %s command for the '%s' file. Positive number of partitions followed by the partition number (from 1 to the number of partitions) or MERGE is required.",
+/*19*/	"Invalid number of threads is specified in the %s command for the '%s' file. Integer from 1 to %d is required.",
+/*20*/	"Invalid range is specified for the %s column in the %s command for the '%s' file. Two different boundaries are required."
 };
 
 GwaFileException::GwaFileException() : Exception() {
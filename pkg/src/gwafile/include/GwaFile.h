@@ -31,6 +31,15 @@ private:
 
 	bool casesensitive;
 	bool high_verbosity;
+	bool fingerprint_on;
+	bool cache_on;
+	bool resultcache_on;
+	unsigned int preview_rows;
+	unsigned int partitions;
+	unsigned int partition;
+	bool lowmemory_on;
+	bool raster_on;
+	unsigned int threads;
 	bool order_on;
 	bool gc_on;
 	double inflation_factor;
@@ -46,6 +55,9 @@ private:
 	char ld_file_data_separator;
 
 public:
+	static const unsigned int DEFAULT_PREVIEW_ROWS;
+	static const unsigned int MAX_THREADS;
+
 	GwaFile(Descriptor* descriptor) throw (GwaFileException);
 	GwaFile(Descriptor* descriptor, void (GwaFile::*check_functions[])(Descriptor*), unsigned int check_functions_number) throw (GwaFileException);
 	virtual ~GwaFile();
@@ -53,6 +65,17 @@ public:
 	Descriptor* get_descriptor();
 	bool is_case_sensitive();
 	bool is_high_verbosity();
+	bool is_fingerprint_on();
+	bool is_cache_on();
+	bool is_resultcache_on();
+	bool is_preview_on();
+	unsigned int get_preview_rows();
+	bool is_partition_on();
+	unsigned int get_partitions();
+	unsigned int get_partition();
+	bool is_lowmemory_on();
+	bool is_raster_on();
+	unsigned int get_threads();
 	bool is_order_on();
 	bool is_gc_on();
 	double get_inflation_factor();
@@ -70,9 +93,19 @@ public:
 	void check_filters(Descriptor* descriptor) throw (GwaFileException);
 	void check_re_filters(Descriptor* descriptor) throw (GwaFileException);
 	void check_thresholds(Descriptor* descriptor) throw (GwaFileException);
+	void check_histograms(Descriptor* descriptor) throw (GwaFileException);
 	void check_prefix(Descriptor* descriptor) throw (GwaFileException);
+	void check_formatprefix(Descriptor* descriptor) throw (GwaFileException);
 	void check_casesensitivity(Descriptor* descriptor) throw (GwaFileException);
 	void check_verbosity_level(Descriptor* descriptor) throw (GwaFileException);
+	void check_fingerprint(Descriptor* descriptor) throw (GwaFileException);
+	void check_cache(Descriptor* descriptor) throw (GwaFileException);
+	void check_resultcache(Descriptor* descriptor) throw (GwaFileException);
+	void check_preview(Descriptor* descriptor) throw (GwaFileException);
+	void check_partition(Descriptor* descriptor) throw (GwaFileException);
+	void check_lowmemory(Descriptor* descriptor) throw (GwaFileException);
+	void check_raster(Descriptor* descriptor) throw (GwaFileException);
+	void check_threads(Descriptor* descriptor) throw (GwaFileException);
 	void check_missing_value(Descriptor* descriptor) throw (GwaFileException);
 	void check_separators(Descriptor* descriptor) throw (GwaFileException);
 	void check_filesize(Descriptor* descriptor) throw (GwaFileException);
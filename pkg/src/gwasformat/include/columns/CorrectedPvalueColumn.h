@@ -31,6 +31,8 @@ public:
 	CorrectedPvalueColumn(Column* pvalue_column, double lambda);
 	virtual ~CorrectedPvalueColumn();
 
+	void set_lambda(double lambda);
+
 	void out(ofstream& output_stream) throw (ofstream::failure);
 };
 
@@ -32,6 +32,8 @@ public:
 	CorrectedStandardErrorColumn(Column* stderr_column, double lambda);
 	virtual ~CorrectedStandardErrorColumn();
 
+	void set_lambda(double lambda);
+
 	void out(ofstream& output_stream) throw (ofstream::failure);
 };
 
@@ -24,8 +24,9 @@
 #include <algorithm>
 
 #include "../../../auxiliary/include/auxiliary.h"
-#include "../../../reader/include/TextReader.h"
+#include "../../../reader/include/ReaderFactory.h"
 #include "../../../gwafile/include/GwaFile.h"
+#include "../../../cache/include/ResultCache.h"
 #include "../columns/Column.h"
 #include "../columns/CorrectedPvalueColumn.h"
 #include "../columns/CorrectedStandardErrorColumn.h"
@@ -38,7 +39,7 @@
 
 class Formatter {
 private:
-	TextReader reader;
+	Reader* reader;
 	GwaFile* gwafile;
 
 	vector<Column*> input_columns;
@@ -55,13 +56,45 @@ private:
 	int maf_column_pos;
 	int oevar_imp_column_pos;
 
+	CorrectedStandardErrorColumn* corrected_stderr_column;
+	CorrectedPvalueColumn* corrected_pvalue_column;
+
+	double maf_filter_value;
+	double oevar_imp_filter_value;
+	bool maf_filter;
+	bool oevar_imp_filter;
+
+	double inflation_factor;
+	bool lambda_pending;
+
+	ResultCache results;
+
+	double* pvalues;
+	int pvalues_number;
+	int pvalues_heap_size;
+
+	char* spill_file_name;
+	char spill_separator;
+	int spill_n_total;
+	int spill_n_filtered;
+
+	void initialize_filters() throw (DescriptorException);
+	bool load_lambda(double& lambda, int& n_total, int& n_filtered) throw (FormatterException);
+	void save_lambda(double lambda, int n_total, int n_filtered) throw (FormatterException);
+	bool is_dropped(Column* column);
+	void copy_spill(char new_separator, int& n_total, int& n_filtered) throw (FormatterException);
+
 	static bool compare_columns(Column* first, Column* second);
 	static bool compare_columns_by_name(Column* first, Column* second);
+	static double median_lambda(double* data, int n);
 
 public:
 	static const unsigned int HEAP_SIZE;
 	static const unsigned int HEAP_INCREMENT;
 	static const double EPSILON;
+	static const char* LAMBDA_EXTENSION;
+	static const unsigned int LAMBDA_VERSION;
+	static const char* SPILL_EXTENSION;
 
 	Formatter();
 	virtual ~Formatter();
@@ -70,8 +103,16 @@ public:
 	void close_gwafile() throw (FormatterException);
 
 	void process_header() throw (FormatterException);
-	double calculate_lambda(int& n_total, int& n_filtered) throw (FormatterException);
+	double spill(char new_separator, int& n_total, int& n_filtered) throw (FormatterException);
 	void format(double lambda, char new_separator, int& n_total, int& n_filtered) throw (FormatterException);
+
+	void initialize_output(double lambda, bool gc) throw (FormatterException);
+	bool load_row(char** tokens, unsigned int tokens_number) throw (FormatterException);
+	void write_header(ofstream& output_stream, char new_separator) throw (ofstream::failure);
+	void write_row(ofstream& output_stream, char new_separator) throw (ofstream::failure);
+	double complete_lambda(int& n_filtered);
+	void rewrite_row(char* line, ofstream& output_stream, char new_separator) throw (ofstream::failure);
+	void rewrite_rows(const char* spill_file_name, ofstream& output_stream, char new_separator) throw (FormatterException, ofstream::failure);
 };
 
 #endif
@@ -28,7 +28,16 @@ CorrectedPvalueColumn::~CorrectedPvalueColumn() {
 	pvalue_column = NULL;
 }
 
+void CorrectedPvalueColumn::set_lambda(double lambda) {
+	this->lambda = lambda;
+}
+
 void CorrectedPvalueColumn::out(ofstream& output_stream) throw (ofstream::failure) {
+	if (isnan(lambda)) { // lambda is not known yet
+		output_stream << pvalue_column->char_value;
+		return;
+	}
+
 	numeric_value = R_strtod(pvalue_column->char_value, &end_ptr);
 	if ((*end_ptr != '\0') || (isnan(numeric_value))) {
 		output_stream << "NA";
@@ -28,7 +28,17 @@ CorrectedStandardErrorColumn::~CorrectedStandardErrorColumn() {
 	stderr_column = NULL;
 }
 
+void CorrectedStandardErrorColumn::set_lambda(double lambda) {
+	this->lambda = lambda;
+	this->sqrt_lambda = sqrt(lambda);
+}
+
 void CorrectedStandardErrorColumn::out(ofstream& output_stream) throw (ofstream::failure) {
+	if (isnan(lambda)) { // lambda is not known yet
+		output_stream << stderr_column->char_value;
+		return;
+	}
+
 	numeric_value = R_strtod(stderr_column->char_value, &end_ptr);
 	if ((*end_ptr != '\0') || (isnan(numeric_value))) {
 		output_stream << "NA";
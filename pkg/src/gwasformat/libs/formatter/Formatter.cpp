@@ -22,18 +22,44 @@
 const unsigned int Formatter::HEAP_SIZE = 3500000;
 const unsigned int Formatter::HEAP_INCREMENT = 100000;
 const double Formatter::EPSILON = 0.00000001;
+const char* Formatter::LAMBDA_EXTENSION = ".gclambda";
+const unsigned int Formatter::LAMBDA_VERSION = 1;
+const char* Formatter::SPILL_EXTENSION = ".tmp";
 
-Formatter::Formatter() : gwafile(NULL), maf_column(NULL), pvalue_column(NULL),
+Formatter::Formatter() : reader(NULL), gwafile(NULL), maf_column(NULL), pvalue_column(NULL),
 	stderr_column(NULL), n_total_column(NULL), oevar_imp_column(NULL),
 	pvalue_column_pos(numeric_limits<int>::min()),
 	maf_column_pos(numeric_limits<int>::min()),
-	oevar_imp_column_pos(numeric_limits<int>::min()) {
+	oevar_imp_column_pos(numeric_limits<int>::min()),
+	corrected_stderr_column(NULL), corrected_pvalue_column(NULL),
+	maf_filter_value(-numeric_limits<double>::infinity()),
+	oevar_imp_filter_value(-numeric_limits<double>::infinity()),
+	maf_filter(false), oevar_imp_filter(false),
+	inflation_factor(numeric_limits<double>::quiet_NaN()), lambda_pending(false),
+	pvalues(NULL), pvalues_number(0), pvalues_heap_size(0),
+	spill_file_name(NULL), spill_separator('\t'), spill_n_total(0), spill_n_filtered(0) {
 
 }
 
 Formatter::~Formatter() {
+	if (reader != NULL) {
+		delete reader;
+		reader = NULL;
+	}
+
 	gwafile = NULL;
 
+	if (pvalues != NULL) {
+		free(pvalues);
+		pvalues = NULL;
+	}
+
+	if (spill_file_name != NULL) {
+		remove(spill_file_name);
+		free(spill_file_name);
+		spill_file_name = NULL;
+	}
+
 	input_columns.clear();
 
 	for (columns_it = output_columns.begin(); columns_it != output_columns.end(); columns_it++) {
@@ -50,6 +76,9 @@ Formatter::~Formatter() {
 	pvalue_column_pos = numeric_limits<int>::min();
 	maf_column_pos = numeric_limits<int>::min();
 	oevar_imp_column_pos = numeric_limits<int>::min();
+
+	corrected_stderr_column = NULL;
+	corrected_pvalue_column = NULL;
 }
 
 bool Formatter::compare_columns(Column* first, Column* second) {
@@ -68,8 +97,9 @@ void Formatter::open_gwafile(GwaFile* gwafile) throw (FormatterException) {
 	try {
 		close_gwafile();
 		this->gwafile = gwafile;
-		reader.set_file_name(gwafile->get_descriptor()->get_full_path());
-		reader.open();
+		reader = ReaderFactory::create(gwafile->get_descriptor()->get_full_path());
+		reader->set_file_name(gwafile->get_descriptor()->get_full_path());
+		reader->open();
 	} catch (ReaderException& e) {
 		FormatterException new_e(e);
 		new_e.add_message("Formatter", "open_gwafile( GwaFile* )", __LINE__, 3, gwafile->get_descriptor()->get_full_path());
@@ -82,7 +112,11 @@ void Formatter::open_gwafile(GwaFile* gwafile) throw (FormatterException) {
 
 void Formatter::close_gwafile() throw (FormatterException) {
 	try {
-		reader.close();
+		if (reader != NULL) {
+			reader->close();
+			delete reader;
+			reader = NULL;
+		}
 	} catch (ReaderException &e) {
 		FormatterException new_e(e);
 		new_e.add_message("Formatter", "close_gwafile()", __LINE__, 4, gwafile != NULL ? gwafile->get_descriptor()->get_full_path() : "NULL");
@@ -107,6 +141,30 @@ void Formatter::close_gwafile() throw (FormatterException) {
 	pvalue_column_pos = numeric_limits<int>::min();
 	maf_column_pos = numeric_limits<int>::min();
 	oevar_imp_column_pos = numeric_limits<int>::min();
+
+	corrected_stderr_column = NULL;
+	corrected_pvalue_column = NULL;
+
+	maf_filter = false;
+	oevar_imp_filter = false;
+
+	inflation_factor = numeric_limits<double>::quiet_NaN();
+	lambda_pending = false;
+
+	if (pvalues != NULL) {
+		free(pvalues);
+		pvalues = NULL;
+	}
+	pvalues_number = 0;
+	pvalues_heap_size = 0;
+
+	if (spill_file_name != NULL) {
+		remove(spill_file_name);
+		free(spill_file_name);
+		spill_file_name = NULL;
+	}
+	spill_n_total = 0;
+	spill_n_filtered = 0;
 }
 
 void Formatter::process_header() throw (FormatterException) {
@@ -125,13 +183,13 @@ void Formatter::process_header() throw (FormatterException) {
 	}
 
 	try {
-		if (reader.read_line() <= 0) {
+		if (reader->read_line() <= 0) {
 			throw FormatterException("Formatter", "process_header()", __LINE__, 5, gwafile->get_descriptor()->get_name());
 		}
 
 		descriptor = gwafile->get_descriptor();
 		header_separator = gwafile->get_header_separator();
-		header = *reader.line;
+		header = *(reader->line);
 
 		token = auxiliary::strtok(&header, header_separator);
 		while (token != NULL) {
@@ -191,33 +249,25 @@ void Formatter::process_header() throw (FormatterException) {
 	}
 }
 
-double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (FormatterException) {
+/*
+ * Reads the GWAS file once, estimating the inflation factor. The formatted rows are written to a temporary spill
+ * file next to the output file while the p-values are collected. Columns with the genomic control are spilled
+ * uncorrected and are computed by format() when it copies the spill to the output file.
+ */
+double Formatter::spill(char new_separator, int& n_total, int& n_filtered) throw (FormatterException) {
 	Descriptor* descriptor = NULL;
 
 	char* line = NULL;
 	int line_length = 0;
 	unsigned int line_number = 2;
-	char data_separator = '\0';
-
-	vector<double>* snp_hq = NULL;
-	double maf_filter_value = -numeric_limits<double>::infinity();
-	double oevar_imp_filter_value = -numeric_limits<double>::infinity();
-	bool maf_filter = false;
-	bool oevar_imp_filter = false;
-
 	char* token = NULL;
-	char* pvalue_token = NULL;
-	char* maf_token = NULL;
-	char* oevar_imp_token = NULL;
-	int column_position = 0;
+	char data_separator = '\0';
 
-	char* end_ptr = NULL;
-	double d_value = 0.0;
+	char* o_gwafile_name = NULL;
+	ofstream ofile_stream;
 
-	int n = 0;
-	double* data = NULL;
-	double* new_data = NULL;
-	int current_heap_size = HEAP_SIZE;
+	char** tokens = NULL;
+	unsigned int tokens_number = 0;
 
 	double lambda = numeric_limits<double>::quiet_NaN();
 
@@ -228,315 +278,210 @@ double Formatter::calculate_lambda(int& n_total, int& n_filtered) throw (Formatt
 		return lambda;
 	}
 
+	if ((gwafile->is_resultcache_on()) && (load_lambda(lambda, n_total, n_filtered))) {
+		return lambda;
+	}
+
 	try {
 		descriptor = gwafile->get_descriptor();
-		snp_hq = descriptor->get_threshold(Descriptor::SNP_HQ);
 		data_separator = gwafile->get_data_separator();
 
-		if (((maf_filter_value = snp_hq->at(0)) > 0) && (maf_column_pos >= 0)){
-			maf_filter = true;
-		}
-
-		if (((oevar_imp_filter_value = snp_hq->at(1)) > 0) && (oevar_imp_column_pos >= 0)) {
-			oevar_imp_filter = true;
+		auxiliary::transform_file_name(&o_gwafile_name, descriptor->get_property(Descriptor::PREFIX), descriptor->get_name(), NULL, true);
+		if (o_gwafile_name == NULL) {
+			throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 10);
 		}
 
-		data = (double*)malloc(HEAP_SIZE * sizeof(double));
-		if (data == NULL) {
-			throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 2, HEAP_SIZE * sizeof(double));
+		auxiliary::transform_file_name(&spill_file_name, NULL, o_gwafile_name, SPILL_EXTENSION, true);
+		free(o_gwafile_name);
+		o_gwafile_name = NULL;
+		if (spill_file_name == NULL) {
+			throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 10);
 		}
 
-		if (maf_filter) {
-			if (oevar_imp_filter) {
-				// all filters
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
-
-					column_position = 0;
-					pvalue_token = NULL;
-					maf_token = NULL;
-					oevar_imp_token = NULL;
-					token = auxiliary::strtok(&line, data_separator);
-					while (token != NULL) {
-						if (column_position == pvalue_column_pos) {
-							auxiliary::trim(&token);
-							pvalue_token = token;
-						} else if (column_position == maf_column_pos) {
-							auxiliary::trim(&token);
-							maf_token = token;
-						} else if (column_position == oevar_imp_column_pos) {
-							auxiliary::trim(&token);
-							oevar_imp_token = token;
-						}
-
-						token = auxiliary::strtok(&line, data_separator);
-						column_position += 1;
-					}
-
-					if (pvalue_token == NULL) {
-						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-					}
-
-					if (maf_token == NULL) {
-						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, maf_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-					}
-
-					if (oevar_imp_token == NULL) {
-						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, oevar_imp_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-					}
+		initialize_output(lambda, true);
 
-					d_value = R_strtod(maf_token, &end_ptr);
-					if ((*end_ptr != '\0') || (isnan(d_value))) {
-						line_number += 1;
-						continue;
-					}
-
-					d_value = d_value > 0.5 ? 1.0 - d_value : d_value;
-
-					if (auxiliary::fcmp(d_value, maf_filter_value, EPSILON) == 1) {
-						d_value = R_strtod(oevar_imp_token, &end_ptr);
-						if ((*end_ptr != '\0') || (isnan(d_value))) {
-							line_number += 1;
-							continue;
-						}
+		tokens = (char**)malloc(input_columns.size() * sizeof(char*));
+		if (tokens == NULL) {
+			throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 2, input_columns.size() * sizeof(char*));
+		}
 
-						if (auxiliary::fcmp(d_value, oevar_imp_filter_value, EPSILON) == 1) {
-							d_value = R_strtod(pvalue_token, &end_ptr);
-							if ((*end_ptr != '\0') || (isnan(d_value))) {
-								line_number += 1;
-								continue;
-							}
+		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
+		ofile_stream.precision(numeric_limits<double>::digits10);
 
-							n += 1;
-							if (n > current_heap_size) {
-								current_heap_size += HEAP_INCREMENT;
+		try {
+			ofile_stream.open(spill_file_name);
+		} catch (ofstream::failure &e) {
+			throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 11, spill_file_name);
+		}
 
-								new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-								if (new_data == NULL) {
-									free(data);
-									data = NULL;
-									throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 2, current_heap_size * sizeof(double));
-								}
-								data = new_data;
-							}
+		try {
+			while ((line_length = reader->read_line()) > 0) {
+				line = *(reader->line);
 
-							data[n - 1] = d_value;
-						}
+				for (tokens_number = 0; tokens_number < input_columns.size(); ++tokens_number) {
+					token = auxiliary::strtok(&line, data_separator);
+					if (token == NULL) {
+						break;
 					}
-
-					line_number += 1;
+					auxiliary::trim(&token);
+					tokens[tokens_number] = token;
 				}
-			} else {
-				// only maf filter
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
-
-					column_position = 0;
-					pvalue_token = NULL;
-					maf_token = NULL;
-					token = auxiliary::strtok(&line, data_separator);
-					while (token != NULL) {
-						if (column_position == pvalue_column_pos) {
-							auxiliary::trim(&token);
-							pvalue_token = token;
-						} else if (column_position == maf_column_pos) {
-							auxiliary::trim(&token);
-							maf_token = token;
-						}
 
-						token = auxiliary::strtok(&line, data_separator);
-						column_position += 1;
-					}
+				if (tokens_number <= (unsigned int)pvalue_column_pos) {
+					throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, descriptor->get_name());
+				}
 
-					if (pvalue_token == NULL) {
-						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-					}
+				if ((maf_filter) && (tokens_number <= (unsigned int)maf_column_pos)) {
+					throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 8, maf_column->get_header(), line_number, descriptor->get_name());
+				}
 
-					if (maf_token == NULL) {
-						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, maf_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-					}
+				if ((oevar_imp_filter) && (tokens_number <= (unsigned int)oevar_imp_column_pos)) {
+					throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 8, oevar_imp_column->get_header(), line_number, descriptor->get_name());
+				}
 
-					d_value = R_strtod(maf_token, &end_ptr);
-					if ((*end_ptr != '\0') || (isnan(d_value))) {
-						line_number += 1;
-						continue;
-					}
+				if (load_row(tokens, tokens_number)) {
+					write_row(ofile_stream, new_separator);
+					ofile_stream << "\n";
 
-					d_value = d_value > 0.5 ? 1.0 - d_value : d_value;
+					spill_n_filtered += 1;
+				}
 
-					if (auxiliary::fcmp(d_value, maf_filter_value, EPSILON) == 1) {
-						d_value = R_strtod(pvalue_token, &end_ptr);
-						if ((*end_ptr != '\0') || (isnan(d_value))) {
-							line_number += 1;
-							continue;
-						}
+				line_number += 1;
+			}
+		} catch (ofstream::failure &e) {
+			throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 13, spill_file_name);
+		}
 
-						n += 1;
-						if (n > current_heap_size) {
-							current_heap_size += HEAP_INCREMENT;
+		try {
+			ofile_stream.close();
+		} catch (ofstream::failure &e) {
+			throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 12, spill_file_name);
+		}
 
-							new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-							if (new_data == NULL) {
-								free(data);
-								data = NULL;
-								throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 2, current_heap_size * sizeof(double));
-							}
-							data = new_data;
-						}
+		free(tokens);
+		tokens = NULL;
 
-						data[n - 1] = d_value;
-					}
+		spill_n_total = line_number - 2;
+		spill_separator = new_separator;
 
-					line_number += 1;
-				}
-			}
-		} else if (oevar_imp_filter) {
-			// only oevar_imp_filter
-			while ((line_length = reader.read_line()) > 0) {
-				line = *reader.line;
-
-				column_position = 0;
-				pvalue_token = NULL;
-				oevar_imp_token = NULL;
-				token = auxiliary::strtok(&line, data_separator);
-				while (token != NULL) {
-					if (column_position == pvalue_column_pos) {
-						auxiliary::trim(&token);
-						pvalue_token = token;
-					} else if (column_position == oevar_imp_column_pos) {
-						auxiliary::trim(&token);
-						oevar_imp_token = token;
-					}
-
-					token = auxiliary::strtok(&line, data_separator);
-					column_position += 1;
-				}
-
-				if (pvalue_token == NULL) {
-					throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-				}
+		if (line_length == 0) {
+			throw FormatterException("Formatter", "double spill( char , int& , int& )", __LINE__, 7, line_number, gwafile->get_descriptor()->get_name());
+		}
+	} catch (DescriptorException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "double spill( char , int& , int& )", __LINE__, 9, gwafile->get_descriptor()->get_name());
+		free(tokens);
+		throw new_e;
+	} catch (ReaderException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "double spill( char , int& , int& )", __LINE__, 9, gwafile->get_descriptor()->get_name());
+		free(tokens);
+		throw new_e;
+	} catch (FormatterException &e) {
+		e.add_message("Formatter", "double spill( char , int& , int& )", __LINE__, 9, gwafile->get_descriptor()->get_name());
+		free(tokens);
+		throw;
+	}
 
-				if (oevar_imp_token == NULL) {
-					throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, oevar_imp_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-				}
+	lambda = complete_lambda(n_filtered);
+	n_total = spill_n_total;
 
-				d_value = R_strtod(oevar_imp_token, &end_ptr);
-				if ((*end_ptr != '\0') || (isnan(d_value))) {
-					line_number += 1;
-					continue;
-				}
+	if (gwafile->is_resultcache_on()) {
+		save_lambda(lambda, n_total, n_filtered);
+	}
 
-				if (auxiliary::fcmp(d_value, oevar_imp_filter_value, EPSILON) == 1) {
-					d_value = R_strtod(pvalue_token, &end_ptr);
-					if ((*end_ptr != '\0') || (isnan(d_value))) {
-						line_number += 1;
-						continue;
-					}
+	return lambda;
+}
 
-					n += 1;
-					if (n > current_heap_size) {
-						current_heap_size += HEAP_INCREMENT;
+/*
+ * The inflation factor of the unchanged GWAS file, which was calculated with the same settings, is saved next to the formatted file.
+ */
+bool Formatter::load_lambda(double& lambda, int& n_total, int& n_filtered) throw (FormatterException) {
+	char* i_lambdafile_name = NULL;
+	ifstream i_lambdafile_stream;
+	double saved_lambda = numeric_limits<double>::quiet_NaN();
+	int saved_n[2] = {0, 0};
 
-						new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-						if (new_data == NULL) {
-							free(data);
-							data = NULL;
-							throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 2, current_heap_size * sizeof(double));
-						}
-						data = new_data;
-					}
+	try {
+		results.identify(gwafile->get_descriptor()->get_full_path(), gwafile->get_descriptor()->get_settings_hash(), LAMBDA_VERSION);
 
-					data[n - 1] = d_value;
-				}
+		auxiliary::transform_file_name(&i_lambdafile_name, gwafile->get_descriptor()->get_property(Descriptor::PREFIX), gwafile->get_descriptor()->get_name(), LAMBDA_EXTENSION, true);
+		if (i_lambdafile_name == NULL) {
+			throw FormatterException("Formatter", "bool load_lambda( double&, int&, int& )", __LINE__, 10);
+		}
+	} catch (GwaCacheException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "bool load_lambda( double&, int&, int& )", __LINE__, 16, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	} catch (DescriptorException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "bool load_lambda( double&, int&, int& )", __LINE__, 16, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	}
 
-				line_number += 1;
-			}
-		} else {
-			// no filters
-			while ((line_length = reader.read_line()) > 0) {
-				line = *reader.line;
-
-				column_position = 0;
-				pvalue_token = NULL;
-				token = auxiliary::strtok(&line, data_separator);
-				while (token != NULL) {
-					if (column_position == pvalue_column_pos) {
-						auxiliary::trim(&token);
-						pvalue_token = token;
-						break;
-					}
+	if (!results.load(i_lambdafile_name, i_lambdafile_stream)) {
+		free(i_lambdafile_name);
+		return false;
+	}
 
-					token = auxiliary::strtok(&line, data_separator);
-					column_position += 1;
-				}
+	i_lambdafile_stream.read((char*)&saved_lambda, sizeof(double));
+	i_lambdafile_stream.read((char*)saved_n, 2 * sizeof(int));
+	if (i_lambdafile_stream.fail()) {
+		i_lambdafile_stream.close();
+		free(i_lambdafile_name);
+		return false;
+	}
 
-				if (pvalue_token == NULL) {
-					throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 8, pvalue_column->get_header(), line_number, gwafile->get_descriptor()->get_name());
-				}
+	i_lambdafile_stream.close();
 
-				d_value = R_strtod(pvalue_token, &end_ptr);
-				if ((*end_ptr != '\0') || (isnan(d_value))) {
-					line_number += 1;
-					continue;
-				}
+	free(i_lambdafile_name);
+	i_lambdafile_name = NULL;
 
-				n += 1;
-				if (n > current_heap_size) {
-					current_heap_size += HEAP_INCREMENT;
+	lambda = saved_lambda;
+	n_total = saved_n[0];
+	n_filtered = saved_n[1];
 
-					new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-					if (new_data == NULL) {
-						free(data);
-						data = NULL;
-						throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 2, current_heap_size * sizeof(double));
-					}
-					data = new_data;
-				}
+	return true;
+}
 
-				data[n - 1] = d_value;
+void Formatter::save_lambda(double lambda, int n_total, int n_filtered) throw (FormatterException) {
+	char* o_lambdafile_name = NULL;
+	ofstream o_lambdafile_stream;
+	int saved_n[2] = {n_total, n_filtered};
 
-				line_number += 1;
-			}
+	try {
+		auxiliary::transform_file_name(&o_lambdafile_name, gwafile->get_descriptor()->get_property(Descriptor::PREFIX), gwafile->get_descriptor()->get_name(), LAMBDA_EXTENSION, true);
+		if (o_lambdafile_name == NULL) {
+			throw FormatterException("Formatter", "save_lambda( double, int, int )", __LINE__, 10);
 		}
 
-		n_filtered = n;
-		n_total = line_number - 2;
+		results.create(o_lambdafile_name, o_lambdafile_stream);
 
-		if (line_length == 0) {
-			throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 7, line_number, gwafile->get_descriptor()->get_name());
+		o_lambdafile_stream.write((const char*)&lambda, sizeof(double));
+		o_lambdafile_stream.write((const char*)saved_n, 2 * sizeof(int));
+		if (o_lambdafile_stream.fail()) {
+			throw FormatterException("Formatter", "save_lambda( double, int, int )", __LINE__, 13, o_lambdafile_name);
 		}
 
-		reader.reset();
-		if (reader.read_line() <= 0) {
-			throw FormatterException("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 5, line_number, gwafile->get_descriptor()->get_name());
-		}
-	} catch (DescriptorException &e) {
+		results.complete(o_lambdafile_name, o_lambdafile_stream);
+	} catch (GwaCacheException &e) {
 		FormatterException new_e(e);
-		new_e.add_message("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 9, gwafile->get_descriptor()->get_name());
+		new_e.add_message("Formatter", "save_lambda( double, int, int )", __LINE__, 15, gwafile->get_descriptor()->get_name());
+		free(o_lambdafile_name);
 		throw new_e;
-	} catch (ReaderException &e) {
+	} catch (DescriptorException &e) {
 		FormatterException new_e(e);
-		new_e.add_message("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 9, gwafile->get_descriptor()->get_name());
+		new_e.add_message("Formatter", "save_lambda( double, int, int )", __LINE__, 15, gwafile->get_descriptor()->get_name());
+		free(o_lambdafile_name);
 		throw new_e;
 	} catch (FormatterException &e) {
-		e.add_message("Formatter", "double calculate_lambda( int& , int& )", __LINE__, 9, gwafile->get_descriptor()->get_name());
+		e.add_message("Formatter", "save_lambda( double, int, int )", __LINE__, 15, gwafile->get_descriptor()->get_name());
+		free(o_lambdafile_name);
 		throw;
 	}
 
-	if (n > 0) {
-		for (int i = 0; i < n; i++) {
-			data[i] = pow(Rf_qnorm5(0.5 * data[i], 0.0, 1.0, 0, 0), 2.0);
-		}
-
-		qsort(data, n, sizeof(double), auxiliary::dblcmp);
-
-		lambda =  auxiliary::stats_median_from_sorted_data(data, n) / Rf_qchisq(0.5, 1.0, 0, 0);
-	}
-
-	free(data);
-	data = NULL;
-
-	return lambda;
+	free(o_lambdafile_name);
+	o_lambdafile_name = NULL;
 }
 
 void Formatter::format(double lambda, char new_separator, int& n_total, int& n_filtered) throw (FormatterException) {
@@ -552,14 +497,6 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 	const char* file_name = NULL;
 	char* o_gwafile_name = NULL;
 
-	vector<double>* snp_hq = NULL;
-	double maf_filter_value = -numeric_limits<double>::infinity();
-	double oevar_imp_filter_value = -numeric_limits<double>::infinity();
-	bool maf_filter = false;
-	bool oevar_imp_filter = false;
-
-	Column* column = NULL;
-
 	ofstream ofile_stream;
 
 	double d_value = 0.0;
@@ -571,11 +508,15 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 		return;
 	}
 
+	if (spill_file_name != NULL) {
+		copy_spill(new_separator, n_total, n_filtered);
+		return;
+	}
+
 	try {
 		descriptor = gwafile->get_descriptor();
 		output_prefix = descriptor->get_property(Descriptor::PREFIX);
 		file_name = descriptor->get_name();
-		snp_hq = descriptor->get_threshold(Descriptor::SNP_HQ);
 		data_separator = gwafile->get_data_separator();
 
 		auxiliary::transform_file_name(&o_gwafile_name, output_prefix, file_name, NULL, true);
@@ -583,48 +524,7 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 			throw FormatterException("Formatter", "format( double , char , int& , int& )", __LINE__, 10);
 		}
 
-		if (((maf_filter_value = snp_hq->at(0)) > 0) && (maf_column_pos >= 0)){
-			maf_filter = true;
-		}
-
-		if (((oevar_imp_filter_value = snp_hq->at(1)) > 0) && (oevar_imp_column_pos >= 0)) {
-			oevar_imp_filter = true;
-		}
-
-		for (columns_it = input_columns.begin(); columns_it != input_columns.end(); columns_it++) {
-			output_columns.push_back(*columns_it);
-		}
-
-		if (!isnan(lambda)) {
-			if (stderr_column != NULL) {
-				column = new CorrectedStandardErrorColumn(stderr_column, lambda);
-				column->set_header("%s_gc", stderr_column->get_header());
-				column->set_order(descriptor->get_column_order(column->get_header(), gwafile->is_case_sensitive()));
-				output_columns.push_back(column);
-			}
-
-			if (pvalue_column != NULL) {
-				column = new CorrectedPvalueColumn(pvalue_column, lambda);
-				column->set_header("%s_gc", pvalue_column->get_header());
-				column->set_order(descriptor->get_column_order(column->get_header(), gwafile->is_case_sensitive()));
-				output_columns.push_back(column);
-			}
-		}
-
-		if ((oevar_imp_column != NULL) && (n_total_column != NULL)) {
-			column = new EffectiveSampleSizeColumn(n_total_column, oevar_imp_column);
-			column->set_header("%s_effective", n_total_column->get_header());
-			column->set_order(descriptor->get_column_order(column->get_header(), gwafile->is_case_sensitive()));
-			output_columns.push_back(column);
-		}
-
-		if (gwafile->is_order_on()) {
-			if (descriptor->get_reordered_columns_number() > 0) {
-				stable_sort(output_columns.begin(), output_columns.end(), compare_columns);
-			} else {
-				stable_sort(output_columns.begin(), output_columns.end(), compare_columns_by_name);
-			}
-		}
+		initialize_output(lambda, !isnan(lambda));
 
 		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
 		ofile_stream.precision(numeric_limits<double>::digits10);
@@ -636,20 +536,14 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 		}
 
 		try {
-			columns_it = output_columns.begin();
-			if (columns_it != output_columns.end()) {
-				ofile_stream << (*columns_it)->get_header();
-				while (++columns_it != output_columns.end()) {
-					ofile_stream << new_separator << (*columns_it)->get_header();
-				}
-				ofile_stream << endl;
-			}
+			write_header(ofile_stream, new_separator);
+			ofile_stream << endl;
 
 			if (maf_filter) {
 				if (oevar_imp_filter) {
 					// all filters
-					while ((line_length = reader.read_line()) > 0) {
-						line = *reader.line;
+					while ((line_length = reader->read_line()) > 0) {
+						line = *(reader->line);
 
 //						for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
 						for (columns_it = input_columns.begin(); columns_it != input_columns.end(); ++columns_it) {
@@ -687,8 +581,8 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 					}
 				} else {
 					// only maf filter
-					while ((line_length = reader.read_line()) > 0) {
-						line = *reader.line;
+					while ((line_length = reader->read_line()) > 0) {
+						line = *(reader->line);
 
 //						for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
 						for (columns_it = input_columns.begin(); columns_it != input_columns.end(); ++columns_it) {
@@ -724,8 +618,8 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 				}
 			} else if (oevar_imp_filter) {
 				// only oevar_imp filter
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
+				while ((line_length = reader->read_line()) > 0) {
+					line = *(reader->line);
 
 //					for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
 					for (columns_it = input_columns.begin(); columns_it != input_columns.end(); ++columns_it) {
@@ -759,8 +653,8 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 				}
 			} else {
 				// no filters
-				while ((line_length = reader.read_line()) > 0) {
-					line = *reader.line;
+				while ((line_length = reader->read_line()) > 0) {
+					line = *(reader->line);
 
 //					for (columns_it = input_columns.begin(); columns_it != input_columns.end(); (*columns_it)->char_value = auxiliary::strtok(&line, data_separator), columns_it++);
 					for (columns_it = input_columns.begin(); columns_it != input_columns.end(); ++columns_it) {
@@ -818,3 +712,340 @@ void Formatter::format(double lambda, char new_separator, int& n_total, int& n_f
 		throw;
 	}
 }
+
+/*
+ * Writes the rows spilled by spill() to the output file, computing the columns with the genomic control.
+ */
+void Formatter::copy_spill(char new_separator, int& n_total, int& n_filtered) throw (FormatterException) {
+	char* o_gwafile_name = NULL;
+	ofstream ofile_stream;
+
+	if (new_separator != spill_separator) {
+		throw FormatterException("Formatter", "copy_spill( char , int& , int& )", __LINE__, 1, "new_separator");
+	}
+
+	try {
+		auxiliary::transform_file_name(&o_gwafile_name, gwafile->get_descriptor()->get_property(Descriptor::PREFIX), gwafile->get_descriptor()->get_name(), NULL, true);
+		if (o_gwafile_name == NULL) {
+			throw FormatterException("Formatter", "copy_spill( char , int& , int& )", __LINE__, 10);
+		}
+
+		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
+		ofile_stream.precision(numeric_limits<double>::digits10);
+
+		try {
+			ofile_stream.open(o_gwafile_name);
+		} catch (ofstream::failure &e) {
+			throw FormatterException("Formatter", "copy_spill( char , int& , int& )", __LINE__, 11, o_gwafile_name);
+		}
+
+		try {
+			write_header(ofile_stream, new_separator);
+			ofile_stream << "\n";
+
+			rewrite_rows(spill_file_name, ofile_stream, new_separator);
+		} catch (ofstream::failure &e) {
+			throw FormatterException("Formatter", "copy_spill( char , int& , int& )", __LINE__, 13, o_gwafile_name);
+		}
+
+		try {
+			ofile_stream.close();
+		} catch (ofstream::failure &e) {
+			throw FormatterException("Formatter", "copy_spill( char , int& , int& )", __LINE__, 12, o_gwafile_name);
+		}
+	} catch (DescriptorException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "copy_spill( char , int& , int& )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		free(o_gwafile_name);
+		throw new_e;
+	} catch (ColumnException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "copy_spill( char , int& , int& )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		free(o_gwafile_name);
+		throw new_e;
+	} catch (FormatterException &e) {
+		e.add_message("Formatter", "copy_spill( char , int& , int& )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		free(o_gwafile_name);
+		throw;
+	}
+
+	free(o_gwafile_name);
+	o_gwafile_name = NULL;
+
+	free(spill_file_name);
+	spill_file_name = NULL;
+
+	n_total = spill_n_total;
+	n_filtered = spill_n_filtered;
+}
+
+void Formatter::initialize_filters() throw (DescriptorException) {
+	vector<double>* snp_hq = NULL;
+
+	snp_hq = gwafile->get_descriptor()->get_threshold(Descriptor::SNP_HQ);
+
+	maf_filter = false;
+	if (((maf_filter_value = snp_hq->at(0)) > 0) && (maf_column_pos >= 0)){
+		maf_filter = true;
+	}
+
+	oevar_imp_filter = false;
+	if (((oevar_imp_filter_value = snp_hq->at(1)) > 0) && (oevar_imp_column_pos >= 0)) {
+		oevar_imp_filter = true;
+	}
+}
+
+void Formatter::initialize_output(double lambda, bool gc) throw (FormatterException) {
+	Descriptor* descriptor = NULL;
+	Column* column = NULL;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	try {
+		descriptor = gwafile->get_descriptor();
+
+		initialize_filters();
+
+		inflation_factor = lambda;
+		lambda_pending = gc && isnan(lambda);
+
+		for (columns_it = input_columns.begin(); columns_it != input_columns.end(); columns_it++) {
+			output_columns.push_back(*columns_it);
+		}
+
+		if (gc) {
+			if (stderr_column != NULL) {
+				corrected_stderr_column = new CorrectedStandardErrorColumn(stderr_column, lambda);
+				corrected_stderr_column->set_header("%s_gc", stderr_column->get_header());
+				corrected_stderr_column->set_order(descriptor->get_column_order(corrected_stderr_column->get_header(), gwafile->is_case_sensitive()));
+				output_columns.push_back(corrected_stderr_column);
+			}
+
+			if (pvalue_column != NULL) {
+				corrected_pvalue_column = new CorrectedPvalueColumn(pvalue_column, lambda);
+				corrected_pvalue_column->set_header("%s_gc", pvalue_column->get_header());
+				corrected_pvalue_column->set_order(descriptor->get_column_order(corrected_pvalue_column->get_header(), gwafile->is_case_sensitive()));
+				output_columns.push_back(corrected_pvalue_column);
+			}
+		}
+
+		if ((oevar_imp_column != NULL) && (n_total_column != NULL)) {
+			column = new EffectiveSampleSizeColumn(n_total_column, oevar_imp_column);
+			column->set_header("%s_effective", n_total_column->get_header());
+			column->set_order(descriptor->get_column_order(column->get_header(), gwafile->is_case_sensitive()));
+			output_columns.push_back(column);
+		}
+
+		if (gwafile->is_order_on()) {
+			if (descriptor->get_reordered_columns_number() > 0) {
+				stable_sort(output_columns.begin(), output_columns.end(), compare_columns);
+			} else {
+				stable_sort(output_columns.begin(), output_columns.end(), compare_columns_by_name);
+			}
+		}
+
+		if (lambda_pending && (pvalue_column != NULL)) {
+			pvalues = (double*)malloc(HEAP_SIZE * sizeof(double));
+			if (pvalues == NULL) {
+				throw FormatterException("Formatter", "initialize_output( double , bool )", __LINE__, 2, HEAP_SIZE * sizeof(double));
+			}
+			pvalues_heap_size = HEAP_SIZE;
+			pvalues_number = 0;
+		}
+	} catch (DescriptorException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "initialize_output( double , bool )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	} catch (ColumnException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "initialize_output( double , bool )", __LINE__, 14, gwafile->get_descriptor()->get_name());
+		throw new_e;
+	}
+}
+
+bool Formatter::load_row(char** tokens, unsigned int tokens_number) throw (FormatterException) {
+	unsigned int column_position = 0;
+	double d_value = 0.0;
+	double* new_pvalues = NULL;
+
+	for (columns_it = input_columns.begin(); columns_it != input_columns.end(); ++columns_it) {
+		if (column_position < tokens_number) {
+			(*columns_it)->char_value = tokens[column_position];
+		} else {
+			(*columns_it)->char_value = "";
+		}
+		++column_position;
+	}
+
+	if (maf_filter) {
+		d_value = maf_column->get_numeric_value();
+		d_value = d_value > 0.5 ? 1.0 - d_value : d_value;
+		if (auxiliary::fcmp(d_value, maf_filter_value, EPSILON) != 1) {
+			return false;
+		}
+	}
+
+	if (oevar_imp_filter) {
+		d_value = oevar_imp_column->get_numeric_value();
+		if (auxiliary::fcmp(d_value, oevar_imp_filter_value, EPSILON) != 1) {
+			return false;
+		}
+	}
+
+	if (pvalues != NULL) {
+		d_value = pvalue_column->get_numeric_value();
+		if (!isnan(d_value)) {
+			if (pvalues_number >= pvalues_heap_size) {
+				pvalues_heap_size += HEAP_INCREMENT;
+
+				new_pvalues = (double*)realloc(pvalues, pvalues_heap_size * sizeof(double));
+				if (new_pvalues == NULL) {
+					throw FormatterException("Formatter", "load_row( char** , unsigned int )", __LINE__, 2, pvalues_heap_size * sizeof(double));
+				}
+				pvalues = new_pvalues;
+			}
+
+			pvalues[pvalues_number++] = d_value;
+		}
+	}
+
+	return true;
+}
+
+void Formatter::write_header(ofstream& output_stream, char new_separator) throw (ofstream::failure) {
+	bool first = true;
+
+	for (columns_it = output_columns.begin(); columns_it != output_columns.end(); ++columns_it) {
+		if (is_dropped(*columns_it)) {
+			continue;
+		}
+
+		if (!first) {
+			output_stream << new_separator;
+		}
+		output_stream << (*columns_it)->get_header();
+		first = false;
+	}
+}
+
+void Formatter::write_row(ofstream& output_stream, char new_separator) throw (ofstream::failure) {
+	columns_it = output_columns.begin();
+	if (columns_it != output_columns.end()) {
+		(*columns_it)->out(output_stream);
+		while (++columns_it != output_columns.end()) {
+			output_stream << new_separator;
+			(*columns_it)->out(output_stream);
+		}
+	}
+}
+
+double Formatter::complete_lambda(int& n_filtered) {
+	n_filtered = pvalues_number;
+
+	if (!lambda_pending) {
+		return inflation_factor;
+	}
+
+	inflation_factor = median_lambda(pvalues, pvalues_number);
+	lambda_pending = false;
+
+	if (corrected_stderr_column != NULL) {
+		corrected_stderr_column->set_lambda(inflation_factor);
+	}
+
+	if (corrected_pvalue_column != NULL) {
+		corrected_pvalue_column->set_lambda(inflation_factor);
+	}
+
+	if (pvalues != NULL) {
+		free(pvalues);
+		pvalues = NULL;
+	}
+	pvalues_number = 0;
+	pvalues_heap_size = 0;
+
+	return inflation_factor;
+}
+
+void Formatter::rewrite_row(char* line, ofstream& output_stream, char new_separator) throw (ofstream::failure) {
+	const char* token = NULL;
+	bool first = true;
+
+	// the line was written by write_row() while lambda was pending, so GC columns hold uncorrected values
+	for (columns_it = output_columns.begin(); columns_it != output_columns.end(); ++columns_it) {
+		if ((token = auxiliary::strtok(&line, new_separator)) == NULL) {
+			token = "";
+		}
+
+		if (is_dropped(*columns_it)) {
+			continue;
+		}
+
+		if (!first) {
+			output_stream << new_separator;
+		}
+		first = false;
+
+		if (*columns_it == corrected_stderr_column) {
+			stderr_column->char_value = token;
+			corrected_stderr_column->out(output_stream);
+		} else if (*columns_it == corrected_pvalue_column) {
+			pvalue_column->char_value = token;
+			corrected_pvalue_column->out(output_stream);
+		} else {
+			output_stream << token;
+		}
+	}
+
+	if ((line != NULL) && (*line != '\0')) {
+		output_stream << new_separator << line;
+	}
+}
+
+/*
+ * Copies the rows spilled by write_row() to the output stream, computing the columns with the genomic control, and then
+ * removes the spill file. Used by both the formatter and the pipeline.
+ */
+void Formatter::rewrite_rows(const char* spill_file_name, ofstream& output_stream, char new_separator) throw (FormatterException, ofstream::failure) {
+	TextReader spill_reader;
+
+	try {
+		spill_reader.set_file_name(spill_file_name);
+		spill_reader.open();
+
+		while (spill_reader.read_line() > 0) {
+			rewrite_row(*spill_reader.line, output_stream, new_separator);
+			output_stream << "\n";
+		}
+
+		spill_reader.close();
+	} catch (ReaderException &e) {
+		FormatterException new_e(e);
+		new_e.add_message("Formatter", "rewrite_rows( const char*, ofstream&, char )", __LINE__, 18, spill_file_name);
+		throw new_e;
+	}
+
+	if (remove(spill_file_name) != 0) {
+		throw FormatterException("Formatter", "rewrite_rows( const char*, ofstream&, char )", __LINE__, 17, spill_file_name);
+	}
+}
+
+bool Formatter::is_dropped(Column* column) {
+	return ((column == corrected_stderr_column) || (column == corrected_pvalue_column)) && !lambda_pending && isnan(inflation_factor);
+}
+
+double Formatter::median_lambda(double* data, int n) {
+	if (n <= 0) {
+		return numeric_limits<double>::quiet_NaN();
+	}
+
+	for (int i = 0; i < n; i++) {
+		data[i] = pow(Rf_qnorm5(0.5 * data[i], 0.0, 1.0, 0, 0), 2.0);
+	}
+
+	qsort(data, n, sizeof(double), auxiliary::dblcmp);
+
+	return auxiliary::stats_median_from_sorted_data(data, n) / Rf_qchisq(0.5, 1.0, 0, 0);
+}
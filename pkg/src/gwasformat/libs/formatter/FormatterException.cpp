@@ -19,7 +19,7 @@
 
 #include "../../include/formatter/FormatterException.h"
 
-const int FormatterException::MESSAGE_TEMPLATES_NUMBER = 15;
+const int FormatterException::MESSAGE_TEMPLATES_NUMBER = 19;
 const char* FormatterException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -35,7 +35,11 @@ const char* FormatterException::MESSAGE_TEMPLATES[] = {
 /*11*/	"Error while opening '%s' output file.",
 /*12*/	"Error while closing '%s' output file.",
 /*13*/	"Error while writing '%s' output file.",
-/*14*/	"Error while changing header and column separators in '%s' GWAS file."
+/*14*/	"Error while changing header and column separators in '%s' GWAS file.",
+/*15*/	"Error while saving the inflation factor of '%s' GWAS file for reuse.",
+/*16*/	"Error while reusing the saved inflation factor of '%s' GWAS file.",
+/*17*/	"Error while removing '%s' temporary file.",
+/*18*/	"Error while reading '%s' temporary file."
 };
 
 FormatterException::FormatterException() : Exception() {
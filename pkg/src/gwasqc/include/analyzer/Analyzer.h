@@ -21,17 +21,22 @@
 #define ANALYZER_H_
 
 #include <stdexcept>
+#include <new>
+#include <pthread.h>
 
 #include "../../../GWAtoolbox.h"
 #include "../../../auxiliary/include/auxiliary.h"
 #include "../../../reader/include/TextReader.h"
 #include "../../../gwafile/include/GwaFile.h"
+#include "../../../cache/include/GwaCache.h"
+#include "../../../cache/include/ResultCache.h"
 #include "../metas/MetaCrossTable.h"
 #include "../metas/MetaFiltered.h"
 #include "../metas/MetaFormat.h"
 #include "../metas/MetaGroup.h"
 #include "../metas/MetaImplausible.h"
 #include "../metas/MetaImplausibleStrictAdjusted.h"
+#include "../metas/MetaManhattan.h"
 #include "../metas/MetaRatio.h"
 #include "../metas/MetaUniqueness.h"
 #include "../expressions/Conjunction.h"
@@ -40,6 +45,7 @@
 #include "../expressions/Gt.h"
 #include "../expressions/Let.h"
 #include "../expressions/Lt.h"
+#include "../plots/PlotRenderer.h"
 #include "AnalyzerException.h"
 
 class Analyzer {
@@ -47,16 +53,72 @@ private:
 //	TextReader reader;
 	Reader* reader;
 	GwaFile* gwafile;
+	GwaCache cache;
+	ResultCache results;
 
 	vector<Meta*> metas;
 	vector<MetaNumeric*> numeric_metas;
 	vector<Plottable*> plots;
 	vector<char*> missing_columns;
 	vector<char*> not_required_columns;
-	vector< pair<pair<Meta*, Meta*>, int> > dependencies;
+	vector< pair<pair<Meta*, Meta*>, int64_t> > dependencies;
 	vector<MetaFiltered*> filtered_metas;
 	vector<MetaRatio*> ratio_metas;
 	vector<MetaCrossTable*> cross_table_metas;
+	vector<MetaManhattan*> manhattan_metas;
+
+	/*
+	 * Column plan: an entry for every column of the input file, set when the meta of the column is created. The handler
+	 * calls put() of the concrete class of the meta, so that the values are passed without virtual calls.
+	 */
+	struct column_handler {
+		Meta* meta;
+		void (*put)(Meta* meta, char* value);
+	};
+
+	vector<column_handler> column_plan;
+
+	template <class T> static void put_value(Meta* meta, char* value) {
+		((T*)meta)->T::put(value);
+	}
+
+	unsigned int block_rows;
+	unsigned int sampled_rows;
+	bool low_memory;
+	bool results_on;
+
+	/*
+	 * Columns finalized in parallel: every worker takes the next column until none is left or a column fails.
+	 * When sorting, the workers only sort the values of the columns which have several filtered subsets.
+	 */
+	struct finalize_queue {
+		vector<Meta*>* columns;
+		bool sorting;
+		unsigned int next;
+		AnalyzerException* error;
+		pthread_mutex_t mutex;
+	};
+
+	static void* run_finalize_worker(void* queue);
+	void finalize_columns(vector<Meta*>& columns, bool sorting = false) throw (AnalyzerException);
+
+	void process_line(char* line, uint64_t line_number) throw (AnalyzerException);
+	void process_cache() throw (AnalyzerException);
+	void process_sample() throw (AnalyzerException);
+	void process_strata() throw (AnalyzerException);
+	void process_reservoir() throw (AnalyzerException);
+	void process_partition() throw (AnalyzerException);
+	void merge_states() throw (AnalyzerException);
+	void read_state(istream& stream, const char* file_name, unsigned int partition, unsigned int partitions) throw (AnalyzerException);
+	void write_state(ostream& stream, unsigned int partition, unsigned int partitions) throw (AnalyzerException);
+	char* get_output_file_name(const char* suffix) throw (AnalyzerException);
+	char* get_state_file_name(unsigned int partition) throw (AnalyzerException);
+	bool load_results() throw (AnalyzerException);
+	void save_results() throw (AnalyzerException);
+	void verify_duplicates(MetaUniqueness* meta) throw (AnalyzerException);
+	void refine_data() throw (AnalyzerException);
+	void complete_row() throw (MetaException);
+	void flush_blocks() throw (MetaException);
 
 	Qqplot* create_combined_qqplot(int column_from, int column_to) throw (PlotException);
 
@@ -96,6 +158,10 @@ public:
 	static const char* CSV_EXTENSION;
 	static const char* HTML_EXTENSION;
 	static const char* HTM_EXTENSION;
+	static const char* STATE_EXTENSION;
+	static const char* STATE_SIGNATURE;
+	static const unsigned int STATE_VERSION;
+	static const char* RESULTS_EXTENSION;
 
 	static const char* CONTENT_STYLE;
 	static const char* MENU_STYLE;
@@ -105,6 +171,9 @@ public:
 	static const char* MAIN_FILE;
 	static const char* BOXPLOTS_FILE;
 
+	static const unsigned int STRATUM_ROWS;
+	static const uint64_t SAMPLE_SEED;
+
 	Analyzer();
 	virtual ~Analyzer();
 
@@ -116,8 +185,12 @@ public:
 	void initialize_filtered_columns() throw (AnalyzerException);
 	void initialize_columns_ratios() throw (AnalyzerException);
 	void process_data() throw (AnalyzerException);
+	void process_row(char** tokens, unsigned int tokens_number, uint64_t line_number) throw (AnalyzerException);
+	void complete_data() throw (AnalyzerException);
 	void finalize_processing() throw (AnalyzerException);
 	double get_memory_usage();
+	unsigned int get_sampled_rows();
+	void save_state(char** state_path) throw (AnalyzerException);
 
 	void print_txt_report() throw (AnalyzerException);
 	void print_csv_report() throw (AnalyzerException);
@@ -126,6 +199,7 @@ public:
 	void create_plots(vector<Plot*>& plots) throw (AnalyzerException);
 	void create_combined_qqplots(vector<Plot*>& plots) throw (AnalyzerException);
 	void create_combined_boxplots(vector<Plot*>& plots) throw (AnalyzerException);
+	void render_plots(vector<Plot*>& plots) throw (AnalyzerException);
 
 	static void print_main_html(vector<const char*>& gwa_file_names, vector<const char*>& html_report_paths, vector<const char*>& boxplot_names, const char* resource_path, char path_separator) throw (AnalyzerException);
 };
@@ -0,0 +1,89 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANALYZERPOOL_H_
+#define ANALYZERPOOL_H_
+
+#include <pthread.h>
+#include <new>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <sys/time.h>
+#endif
+
+#include "Analyzer.h"
+
+class AnalyzerPool {
+public:
+	/*
+	 * Job states: QUEUED -> RUNNING -> PROCESSED (plots and reports ready) -> RELEASED (plots converted by the caller) -> DONE.
+	 * The analyzer (and all plots that point into it) stays alive until the job is released.
+	 */
+	enum job_state {QUEUED, RUNNING, PROCESSED, RELEASED, DONE};
+
+	struct job {
+		unsigned int id;
+		Descriptor* descriptor;
+		GwaFile* gwafile;
+		Analyzer* analyzer;
+		vector<Plot*> single_file_plots;
+		vector<Plot*> combined_boxplots;
+		char* html_report_path;
+		double execution_time;
+		double used_memory;
+		char* error_message;
+		bool taken;
+		job_state state;
+	};
+
+private:
+	vector<job*> jobs;
+	vector<pthread_t> workers;
+
+	const char* resource_path;
+	unsigned int threads;
+	unsigned int next_job;
+	bool stopping;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t processed_cond;
+	pthread_cond_t released_cond;
+
+	static void* run_worker(void* pool);
+	static double get_wall_time();
+
+	void process(job* current_job);
+	void close(job* current_job);
+
+public:
+	static void (GwaFile::*check_functions[])(Descriptor*);
+	static const unsigned int CHECK_FUNCTIONS_CNT;
+
+	AnalyzerPool(vector<Descriptor*>& descriptors, const char* resource_path, unsigned int threads) throw (AnalyzerException);
+	virtual ~AnalyzerPool();
+
+	void start() throw (AnalyzerException);
+	job* wait_processed();
+	void release(job* processed_job);
+	void join();
+};
+
+#endif
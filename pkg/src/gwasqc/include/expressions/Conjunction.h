@@ -21,6 +21,7 @@
 #define CONJUNCTION_H_
 
 #include "Evaluable.h"
+#include "Predicate.h"
 
 class Conjunction: public Evaluable {
 	Evaluable* first;
@@ -30,6 +31,7 @@ public:
 	Conjunction(Evaluable& first, Evaluable& second);
 	virtual ~Conjunction();
 	bool evaluate(double value);
+	void compile(Predicate& predicate);
 };
 
 #endif
@@ -21,6 +21,7 @@
 #define DISJUNCTION_H_
 
 #include "Evaluable.h"
+#include "Predicate.h"
 
 class Disjunction: public Evaluable {
 	Evaluable* first;
@@ -30,6 +31,7 @@ public:
 	Disjunction(Evaluable& first, Evaluable& second);
 	virtual ~Disjunction();
 	bool evaluate(double value);
+	void compile(Predicate& predicate);
 };
 
 #endif
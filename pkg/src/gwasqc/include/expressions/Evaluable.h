@@ -22,12 +22,15 @@
 
 #include "../../../auxiliary/include/auxiliary.h"
 
+class Predicate;
+
 class Evaluable {
 public:
 	static const double EPSILON;
 
 	virtual ~Evaluable() = 0;
 	virtual bool evaluate(double value) = 0;
+	virtual void compile(Predicate& predicate) = 0;
 };
 
 #endif
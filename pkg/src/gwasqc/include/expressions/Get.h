@@ -21,6 +21,7 @@
 #define GET_H_
 
 #include "Evaluable.h"
+#include "Predicate.h"
 
 class Get: public Evaluable {
 private:
@@ -30,6 +31,7 @@ public:
 	Get(double value);
 	virtual ~Get();
 	bool evaluate(double value);
+	void compile(Predicate& predicate);
 };
 
 #endif
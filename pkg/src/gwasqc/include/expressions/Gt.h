@@ -21,6 +21,7 @@
 #define GT_H_
 
 #include "Evaluable.h"
+#include "Predicate.h"
 
 class Gt: public Evaluable {
 private:
@@ -30,6 +31,7 @@ public:
 	Gt(double value);
 	virtual ~Gt();
 	bool evaluate(double value);
+	void compile(Predicate& predicate);
 };
 
 #endif
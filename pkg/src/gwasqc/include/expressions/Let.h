@@ -21,6 +21,7 @@
 #define LET_H_
 
 #include "Evaluable.h"
+#include "Predicate.h"
 
 class Let: public Evaluable {
 private:
@@ -30,6 +31,7 @@ public:
 	Let(double value);
 	virtual ~Let();
 	bool evaluate(double value);
+	void compile(Predicate& predicate);
 };
 
 #endif
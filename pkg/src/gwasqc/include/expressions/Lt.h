@@ -21,6 +21,7 @@
 #define LT_H_
 
 #include "Evaluable.h"
+#include "Predicate.h"
 
 class Lt: public Evaluable {
 private:
@@ -30,6 +31,7 @@ public:
 	Lt(double value);
 	virtual ~Lt();
 	bool evaluate(double value);
+	void compile(Predicate& predicate);
 };
 
 #endif
@@ -0,0 +1,64 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Description:
+ * Class Predicate holds an Evaluable expression tree compiled into a flat list of instructions (postfix order).
+ * The list is evaluated over a block of values at once, without a virtual call per value and per tree node.
+ * The result is combined (logical AND) with the selection mask of the block.
+ *
+ */
+
+#ifndef PREDICATE_H_
+#define PREDICATE_H_
+
+#include <vector>
+
+#include "Evaluable.h"
+
+using namespace std;
+
+class Predicate {
+public:
+	enum opcode {
+		GT, LT, GET, LET, AND, OR
+	};
+
+private:
+	struct instruction {
+		opcode code;
+		double operand;
+	};
+
+	vector<instruction> instructions;
+	vector<unsigned char> masks;
+
+	unsigned int depth;
+	unsigned int max_depth;
+	unsigned int block_size;
+
+public:
+	Predicate(Evaluable& expression, unsigned int block_size);
+	virtual ~Predicate();
+
+	void emit(opcode code, double operand = 0.0);
+	void evaluate(const double* values, unsigned char* selection, unsigned int size);
+};
+
+#endif
@@ -35,7 +35,9 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <stdint.h>
 #include <ostream>
+#include <istream>
 #include <map>
 #include "MetaException.h"
 #include "../plots/PlotException.h"
@@ -54,6 +56,27 @@ protected:
 	char* full_name;
 	char* description;
 	char* na_marker;
+	size_t na_marker_length;
+
+	/* Compares the value with the missing value marker. The common short markers (e.g. NA, -, .) are compared without strcmp(). */
+	inline bool is_na_marker(const char* value) {
+		if (value[0] != na_marker[0]) {
+			return false;
+		}
+
+		switch (na_marker_length) {
+			case 1:
+				return value[1] == '\0';
+			case 2:
+				return (value[1] == na_marker[1]) && (value[2] == '\0');
+			default:
+				return strcmp(na_marker + 1, value + 1) == 0;
+		}
+	}
+
+	void save_bytes(ostream& stream, const void* bytes, size_t size);
+	void load_bytes(istream& stream, void* bytes, size_t size) throw (MetaException);
+	void skip_bytes(istream& stream, size_t size) throw (MetaException);
 
 public:
 	Meta();
@@ -80,6 +103,14 @@ public:
 	virtual void print(ostream& stream) = 0;
 	virtual void print_html(ostream& stream, char path_separator) = 0;
 
+	/*
+	 * The state accumulated by put() before finalize() is saved to a binary stream in the native byte order.
+	 * merge_state() adds the saved state to the current one as if the rows were put after the current rows.
+	 * Stream errors while saving are left to the caller to check.
+	 */
+	virtual void save_state(ostream& stream) throw (MetaException) = 0;
+	virtual void merge_state(istream& stream) throw (MetaException) = 0;
+
 };
 
 #endif
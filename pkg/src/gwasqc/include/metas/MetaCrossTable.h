@@ -23,38 +23,72 @@
 #include "Meta.h"
 #include "MetaNumeric.h"
 
-#include <map>
-
 class MetaCrossTable: public Meta {
 private:
+	static const unsigned int INITIAL_SLOTS;
+
+	struct cell_entry {
+		double x;
+		double y;
+		int64_t count;
+		int64_t na_count;
+		bool used;
+	};
+
+	/* Open addressing hash table (linear probing) keyed by the (x, y) pair. */
+	struct cell_table {
+		cell_entry* entries;
+		unsigned int n_entries;
+		unsigned int n_slots;
+	};
+
+	/* Cross table materialized from the hash tables at print time. Rows and columns are sorted by value. */
+	struct cross_matrix {
+		cell_entry** rows;
+		cell_entry** columns;
+		int64_t* counts;
+		unsigned int n_rows;
+		unsigned int n_columns;
+	};
+
 	MetaNumeric* x_meta;
 	MetaNumeric* y_meta;
 
-	map<double, map<double, int>* > table;
+	/* Counts for (x, y), where both x and y are not NA. */
+	cell_table cells;
 
-	map<double, int> x_na;
-	map<double, int> y_na;
-	int xy_na;
+	/* Row totals in count and counts for (x, NA) in na_count. The key is (x, 0). */
+	cell_table x_margins;
 
-	map<double, int> x_total;
-	map<double, int> y_total;
-	int x_na_total;
-	int y_na_total;
-	int xy_total;
+	/* Column totals in count and counts for (NA, y) in na_count. The key is (y, 0). */
+	cell_table y_margins;
 
-	map<double, map<double, int>* >::iterator column_it;
-	map<double, int>::iterator row_it;
-	map<double, int>* row;
+	int64_t xy_na;
+	int64_t x_na_total;
+	int64_t y_na_total;
+	int64_t xy_total;
 
 	double new_x_value;
 	double new_y_value;
 
+	static uint64_t hash_pair(double x, double y);
+	static int qsort_cell_entry_cmp(const void* first, const void* second);
+
+	cell_entry* lookup(cell_table& table, double x, double y) throw (MetaException);
+	void rehash(cell_table& table, unsigned int new_n_slots) throw (MetaException);
+	void materialize(cross_matrix& matrix) throw (MetaException);
+	void release(cross_matrix& matrix);
+	void save_table(ostream& stream, cell_table& table);
+	void merge_table(istream& stream, cell_table& table) throw (MetaException);
+
 public:
 	MetaCrossTable(MetaNumeric* x_meta, MetaNumeric* y_meta);
 	virtual ~MetaCrossTable();
 
 	void put(char* value) throw (MetaException);
 	void finalize() throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
 	bool is_na();
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
@@ -25,6 +25,7 @@
 
 #include "MetaNumeric.h"
 #include "../expressions/Evaluable.h"
+#include "../expressions/Predicate.h"
 #include "../../../bitarray/include/BitArray.h"
 
 #include "R.h"
@@ -32,6 +33,13 @@
 
 class MetaFiltered: public MetaNumeric {
 private:
+	struct condition_entry {
+		MetaNumeric* meta;
+		Evaluable* expression;
+		Predicate* predicate;
+		double* values;
+	};
+
 	MetaNumeric* source;
 
 	vector<MetaNumeric*> affiliates;
@@ -39,24 +47,53 @@ private:
 	vector<MetaNumeric*>::iterator affiliate_begin;
 	vector<MetaNumeric*>::iterator affiliate_end;
 
-	map<MetaNumeric*, Evaluable*> conditions;
-	map<MetaNumeric*, Evaluable*>::iterator condition_it;
-	map<MetaNumeric*, Evaluable*>::iterator condition_begin;
-	map<MetaNumeric*, Evaluable*>::iterator condition_end;
+	vector<condition_entry> conditions;
+	vector<condition_entry>::iterator condition_it;
+	vector<condition_entry>::iterator condition_begin;
+	vector<condition_entry>::iterator condition_end;
+
+	/*
+	 * Rows are collected into blocks and conditions are evaluated when a block is flushed.
+	 * Every input row occupies one block row, so blocks of filtered metas fed from the same rows are aligned.
+	 * For every row in a block: selection mask (1 if all values are present and the source value was saved),
+	 * source value, position of the source value in the source data, and condition values (in condition entries).
+	 */
+	unsigned char* selection;
+	double* block_values;
+	uint64_t* block_positions;
+	unsigned int block_size;
+	bool block_flushed;
 
 	BitArray* bitarray;
 
+	/* Low-memory mode: the p-values below QQPLOT_TAIL, which are plotted exactly in the Q-Q plot. */
+	vector<double> qqplot_tail;
+
+	void select_sorted();
+	void create_binned_qqplot() throw (MetaException);
+
 public:
+	static const unsigned int BLOCK_SIZE;
+	static const double QQPLOT_TAIL;
+
 	MetaFiltered(MetaNumeric* source, unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	virtual ~MetaFiltered();
 
 	void add_dependency(MetaNumeric& meta);
-	void add_dependency(MetaNumeric& meta, Evaluable& condition);
+	void add_dependency(MetaNumeric& meta, Evaluable& condition) throw (MetaException);
 
 	MetaNumeric* get_source();
 
+	unsigned int get_block_size();
+	bool is_selected(unsigned int row);
+	double get_block_value(unsigned int row);
+
 	void put(char* value) throw (MetaException);
+	void flush() throw (MetaException);
 	void finalize() throw (MetaException);
+	void set_low_memory(bool low_memory) throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 
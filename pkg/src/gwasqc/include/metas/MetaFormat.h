@@ -23,6 +23,7 @@
 #include "Meta.h"
 #include <iostream>
 #include <iomanip>
+#include <limits>
 #include "R.h"
 
 using namespace std;
@@ -31,14 +32,18 @@ class MetaFormat: public Meta {
 private:
 	bool numeric;
 	bool na_value;
-	int n;
+	int64_t n;
+	double value;
 
 public:
 	MetaFormat();
 	virtual ~MetaFormat();
 	void put(char* value) throw (MetaException);
 	void finalize() throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
 	bool is_na();
+	double get_value();
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	double get_memory_usage();
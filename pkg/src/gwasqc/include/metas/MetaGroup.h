@@ -32,19 +32,56 @@ using namespace auxiliary;
 
 class MetaGroup: public Meta {
 private:
+	static const unsigned int SMALL_GROUPS;
+	static const unsigned int INITIAL_SLOTS;
+	static const unsigned int POOL_SIZE;
+
+	struct group_entry {
+		uint64_t hash;
+		char* name;
+		int64_t count;
+	};
+
 	bool na_value;
-	char* new_value;
-	map<char*, int, bool(*)(const char*, const char*)> groups;
-	map<char*, int, bool(*)(const char*, const char*)>::iterator groups_it;
+
+	/* Position of the group of the last value put, or -1 if it was missing. */
+	int current_group;
+
+	/* Groups in order of appearance. While there are less than SMALL_GROUPS of them, they are scanned linearly. */
+	group_entry* groups;
+	unsigned int n_groups;
+	unsigned int heap_groups;
+
+	/* Open addressing index (linear probing) over groups: slot holds group position + 1, or 0 if empty. */
+	unsigned int* slots;
+	unsigned int n_slots;
+
+	/* Group names are interned into fixed size pools and never move. */
+	vector<char*> pools;
+	unsigned int pool_used;
 
 	bool trim_output;
 
+	char* intern(const char* value) throw (MetaException);
+	group_entry* find_group(const char* value, uint64_t hash);
+	void add_group(const char* value, uint64_t hash, int64_t count) throw (MetaException);
+	void rehash(unsigned int new_n_slots) throw (MetaException);
+	group_entry** sort_groups() throw (MetaException);
+
+	static int qsort_group_entry_cmp(const void* first, const void* second);
+
 public:
 	MetaGroup(bool trim_output = false);
 	virtual ~MetaGroup();
 	void put(char* value) throw (MetaException);
+	void merge(MetaGroup* other) throw (MetaException);
 	void finalize() throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
 	bool is_na();
+	int get_group();
+	unsigned int get_groups_count();
+	const char* get_group_name(unsigned int group);
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	double get_memory_usage();
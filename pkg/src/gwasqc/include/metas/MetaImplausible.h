@@ -27,14 +27,17 @@ private:
 	double less;
 	double greater;
 
-	int n_less;
-	int n_greater;
+	int64_t n_less;
+	int64_t n_greater;
 
 public:
 	MetaImplausible(unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	MetaImplausible(double less, double greater, unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	virtual ~MetaImplausible();
 	void put(char* value) throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
+	void begin_refinement() throw (MetaException);
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	void set_implausible(double less, double greater);
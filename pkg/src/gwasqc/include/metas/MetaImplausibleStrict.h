@@ -27,14 +27,17 @@ protected:
 	double less;
 	double greater;
 
-	int n_less;
-	int n_greater;
+	int64_t n_less;
+	int64_t n_greater;
 
 public:
 	MetaImplausibleStrict(unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	MetaImplausibleStrict(double less, double greater, unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	virtual ~MetaImplausibleStrict();
 	void put(char* value) throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
+	void begin_refinement() throw (MetaException);
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	void set_implausible(double less, double greater);
@@ -0,0 +1,138 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef METAMANHATTAN_H_
+#define METAMANHATTAN_H_
+
+#include "Meta.h"
+#include "MetaGroup.h"
+#include "MetaFormat.h"
+#include "MetaNumeric.h"
+#include "../plots/Plottable.h"
+
+/*
+ * Collects the data for the Manhattan plot while the CHR, POSITION and PVALUE columns are read. Points with
+ * p-value below THRESHOLD are all kept. The other points are thinned on a grid of (chromosome, position bin,
+ * -log10(p) bin) cells, where only the smallest p-value of every cell is kept. The position bins get wider
+ * whenever the number of cells exceeds MAX_CELLS. The kept points do not depend on the order of the rows, so
+ * the partitions of a file can be merged in any order.
+ */
+class MetaManhattan: public Meta, public Plottable {
+private:
+	static const unsigned int INITIAL_SLOTS;
+	static const unsigned int INITIAL_SHIFT;
+	static const unsigned int MAX_SHIFT;
+	static const unsigned int MAX_CELLS;
+	static const unsigned int Y_BINS;
+
+	struct chromosome_entry {
+		char* name;
+		double length;
+	};
+
+	struct point_entry {
+		double position;
+		double pvalue;
+		int chromosome;
+	};
+
+	struct cell_entry {
+		uint64_t x_bin;
+		double position;
+		double pvalue;
+		int chromosome;
+		unsigned int y_bin;
+		bool used;
+	};
+
+	/* Open addressing hash table (linear probing) keyed by the (chromosome, x_bin, y_bin) triple. */
+	struct cell_table {
+		cell_entry* entries;
+		unsigned int n_entries;
+		unsigned int n_slots;
+	};
+
+	MetaGroup* chr_meta;
+	MetaFormat* position_meta;
+	MetaNumeric* pvalue_meta;
+
+	chromosome_entry* chromosomes;
+	unsigned int n_chromosomes;
+	unsigned int heap_chromosomes;
+
+	/* Chromosome of every group of the CHR column, or -1 if not known yet. */
+	int* group_chromosomes;
+	unsigned int n_group_chromosomes;
+
+	point_entry* significant;
+	int64_t n_significant;
+	int64_t heap_significant;
+
+	cell_table cells;
+	unsigned int shift;
+
+	int64_t n;
+
+	Manhattan* manhattan;
+	Plot* plot;
+	char* color;
+
+	static uint64_t hash_cell(int chromosome, uint64_t x_bin, unsigned int y_bin);
+
+	int find_chromosome(const char* name);
+	int add_chromosome(const char* name, double length) throw (MetaException);
+	int get_chromosome(int group) throw (MetaException);
+	void add_significant(int chromosome, double position, double pvalue) throw (MetaException);
+	void add_cell(int chromosome, double position, double pvalue) throw (MetaException);
+	cell_entry* lookup(cell_table& table, int chromosome, uint64_t x_bin, unsigned int y_bin) throw (MetaException);
+	void rehash(cell_table& table, unsigned int new_n_slots) throw (MetaException);
+	void coarsen() throw (MetaException);
+
+public:
+	static const double THRESHOLD;
+
+	MetaManhattan(MetaGroup* chr_meta, MetaFormat* position_meta, MetaNumeric* pvalue_meta);
+	virtual ~MetaManhattan();
+
+	void put(char* value) throw (MetaException);
+	void finalize() throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
+	bool is_na();
+	void print(ostream& stream);
+	void print_html(ostream& stream, char path_separator);
+	double get_memory_usage();
+
+	const char* get_plot_name();
+	bool is_plottable();
+	void set_color(const char* color) throw (PlotException);
+	const char* get_color();
+	void set_plots(bool histogram, bool boxplot, bool qqplot);
+	void set_plot(Plot* plot);
+	bool plots_histogram();
+	bool plots_boxplot();
+	bool plots_qqplot();
+	Histogram* get_histogram();
+	Boxplot* get_boxplot();
+	Qqplot* get_qqplot();
+	Manhattan* get_manhattan();
+	Plot* get_plot();
+};
+
+#endif
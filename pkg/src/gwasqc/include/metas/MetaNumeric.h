@@ -23,6 +23,9 @@
 #include <string>
 #include <limits>
 #include <iostream>
+#include <vector>
+#include <map>
+#include <algorithm>
 
 #include "../../../auxiliary/include/auxiliary.h"
 #include "Meta.h"
@@ -35,8 +38,8 @@ protected:
 	char* end_ptr;
 	double d_value;
 
-	int n;
-	int na;
+	int64_t n;
+	int64_t na;
 	double mean;
 	double sd;
 	double min;
@@ -46,6 +49,19 @@ protected:
 	double kurtosis;
 	double quantiles[9][2];
 
+	/* Sampled mode: 95% confidence intervals for the quantiles and the rate of NAs in the whole file. */
+	bool sampled;
+	double na_rate;
+	double na_rate_interval[2];
+	double quantile_intervals[9][2];
+
+	/*
+	 * Clustered sample: the numbers of kept values and of NAs before every run of consecutive lines. The runs are
+	 * treated as clusters when the intervals are estimated, since the neighbouring lines are not independent.
+	 */
+	vector<int64_t> cluster_n;
+	vector<int64_t> cluster_na;
+
 	bool numeric;
 	bool na_value;
 	bool value_saved;
@@ -53,7 +69,33 @@ protected:
 
 	double* data;
 	double* new_data;
-	int current_heap_size;
+	int64_t current_heap_size;
+
+	/*
+	 * Single precision: the values are kept as floats, which only serve the order statistics and the plots. The mean and
+	 * the central moments are accumulated in double precision as the values arrive.
+	 */
+	bool single_precision;
+	float* single_data;
+	float* new_single_data;
+
+	/*
+	 * Shared order: the columns with several filtered subsets are sorted before the subsets are finalized. The kept values
+	 * are sorted in place, and the order holds the original position of every sorted value. The subsets take their values
+	 * by one walk over the sorted values, instead of copying and sorting them separately.
+	 */
+	uint64_t* order;
+
+	struct ordered_value {
+		double value;
+		uint64_t position;
+
+		bool operator<(const ordered_value& other) const {
+			return value < other.value;
+		}
+	};
+
+	void calculate_moments() throw (MetaException);
 
 	char* color;
 
@@ -66,7 +108,62 @@ protected:
 	Qqplot* qqplot;
 	Plot* plot;
 
+	/* The declared range of the values for the classes of the histogram, or NaN if the range is unknown. */
+	double histogram_range[2];
+
+	void add_to_histogram(double value) throw (MetaException);
+	void finish_histogram() throw (PlotException);
+
+	/*
+	 * Low-memory mode: the values are not kept. The first pass counts the values in the bins of a sparse histogram over
+	 * their order-preserving bit patterns (sign, exponent and the leading bits of the mantissa). The second pass over the
+	 * same data accumulates the central moments and collects only the values from the bins which contain the required
+	 * order statistics and from the margins around the boxplot fences. The order statistics are then selected exactly.
+	 */
+	bool low_memory;
+	bool refining;
+	uint64_t** bins;
+	int64_t first_pass_n;
+	int64_t n_finite;
+	double sum;
+	double finite_min;
+	double finite_max;
+	double moments[3];
+	map<unsigned int, int64_t> target_bins;
+	map<double, uint64_t>* selected;
+	double fences[4];
+	double whisker_candidates[2];
+	double* outlier_cells;
+	int64_t outside_fences[2];
+
+	void save_value(double value) throw (MetaException);
+	void accumulate_moments(double value);
+	void finalize_moments();
+	void widen_data() throw (MetaException);
+	void release_data();
+	void sketch_value(double value) throw (MetaException);
+	void refine_value(double value);
+	void add_outlier(double value);
+	double select_value(int64_t rank);
+	void finalize_low_memory() throw (MetaException);
+	void release_low_memory();
+
+	static unsigned int get_bin(double value);
+	static double get_bin_lower(unsigned int bin);
+	static double get_bin_upper(unsigned int bin);
+
+	void estimate_intervals(const double* unsorted);
+	static double get_ratio_variance(const vector<int64_t>& numerators, const vector<int64_t>& denominators);
+	void print_intervals(ostream& stream);
+	void print_intervals_html(ostream& stream);
+
 public:
+	static const double CONFIDENCE_Z;
+	static const unsigned int BINS_BLOCKS_CNT;
+	static const unsigned int BINS_BLOCK_SIZE;
+	static const unsigned int OUTLIER_CELLS_CNT;
+	static const int HISTOGRAM_CLASSES;
+
 	bool print_min;
 	bool print_max;
 	bool print_median;
@@ -83,12 +180,26 @@ public:
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
 	double get_memory_usage();
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
+
+	virtual void set_low_memory(bool low_memory) throw (MetaException);
+	bool is_low_memory();
+	virtual void begin_refinement() throw (MetaException);
+
+	void set_single_precision(bool single_precision) throw (MetaException);
+	bool is_single_precision();
+
+	void sort_order() throw (MetaException);
+	const uint64_t* get_order();
 
 	const char* get_plot_name();
 	bool is_plottable();
 	void set_color(const char* color) throw (PlotException);
 	const char* get_color();
 	void set_plots(bool histogram, bool boxplot, bool qqplot);
+	void set_histogram_range(double lower, double upper);
+	const double* get_histogram_range();
 	void set_plot(Plot* plot);
 	bool plots_histogram();
 	bool plots_boxplot();
@@ -96,15 +207,20 @@ public:
 	Histogram* get_histogram();
 	Boxplot* get_boxplot();
 	Qqplot* get_qqplot();
+	Manhattan* get_manhattan();
 	Plot* get_plot();
 
 	bool is_numeric();
 	bool is_value_saved();
 	double get_value();
 	const double* get_data();
+	const float* get_single_data();
 	void set_ouptut(bool min, bool max, bool median, bool skewness, bool kurtosis, bool quantiles);
-	int get_n();
-	int get_na();
+	void set_sampled(bool sampled);
+	bool is_sampled();
+	void begin_cluster();
+	int64_t get_n();
+	int64_t get_na();
 	double get_mean();
 	double get_sd();
 	double get_min();
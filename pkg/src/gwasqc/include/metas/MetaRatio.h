@@ -20,7 +20,7 @@
 #ifndef METARATIO_H_
 #define METARATIO_H_
 
-#include "MetaNumeric.h"
+#include "MetaFiltered.h"
 #include <map>
 
 #include <R.h>
@@ -30,16 +30,16 @@ using namespace std;
 
 class MetaRatio: public Meta {
 private:
-	MetaNumeric* source_a;
-	MetaNumeric* source_b;
+	MetaFiltered* source_a;
+	MetaFiltered* source_b;
 
-	int n;
+	int64_t n;
 
 	double** data;
 	double** new_data;
 	double* new_value;
 
-	int current_heap_size;
+	int64_t current_heap_size;
 
 	double* skewness;
 	double* kurtosis;
@@ -48,17 +48,20 @@ public:
 	static const unsigned int SLICES_CNT;
 	static const double slices[];
 
-	MetaRatio(MetaNumeric* source_a, MetaNumeric* source_b, unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
+	MetaRatio(MetaFiltered* source_a, MetaFiltered* source_b, unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
 	virtual ~MetaRatio();
 
-	MetaNumeric* get_source_a();
-	MetaNumeric* get_source_b();
+	MetaFiltered* get_source_a();
+	MetaFiltered* get_source_b();
 
 	double* get_skewness();
 	double* get_kurtosis();
 
 	void put(char* value) throw (MetaException);
+	void flush() throw (MetaException);
 	void finalize() throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
 	bool is_na();
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
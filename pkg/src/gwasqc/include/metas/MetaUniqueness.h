@@ -32,20 +32,42 @@ using namespace auxiliary;
 
 class MetaUniqueness: public Meta {
 private:
-	int n;
+	static const unsigned int HLL_PRECISION;
+	static const unsigned int HLL_REGISTERS;
+
+	int64_t n;
 	bool na_value;
 	char** data;
 	char** new_data;
 	char* new_value;
-	int current_heap_size;
+	int64_t current_heap_size;
 	vector<char*> duplicates;
 	vector<char*>::iterator duplicates_it;
 
+	/* Fingerprint mode: only 64-bit hashes of the values are kept during the first pass. */
+	bool fingerprint;
+	uint64_t* fingerprints;
+	uint64_t* new_fingerprints;
+	uint64_t* candidates;
+	int64_t n_candidates;
+	unsigned char* registers;
+	double distinct;
+	vector<char*> collisions;
+
+	void put_fingerprint(char* value) throw (MetaException);
+	void finalize_fingerprints() throw (MetaException);
+	void collect_duplicates(char** values, int64_t size) throw (MetaException);
+
 public:
-	MetaUniqueness(unsigned int heap_size = Meta::HEAP_SIZE) throw (MetaException);
+	MetaUniqueness(unsigned int heap_size = Meta::HEAP_SIZE, bool fingerprint = false) throw (MetaException);
 	virtual ~MetaUniqueness();
 	void put(char* value) throw (MetaException);
 	void finalize() throw (MetaException);
+	bool is_verification_required();
+	void verify(char* value) throw (MetaException);
+	void finalize_verification() throw (MetaException);
+	void save_state(ostream& stream) throw (MetaException);
+	void merge_state(istream& stream) throw (MetaException);
 	bool is_na();
 	void print(ostream& stream);
 	void print_html(ostream& stream, char path_separator);
@@ -22,6 +22,7 @@
 
 #include <limits>
 #include <math.h>
+#include <stdint.h>
 #include <iostream>
 #include <iomanip>
 
@@ -38,7 +39,10 @@ class Boxplot {
 private:
 	/* (Tukey's summary) lower whisker, lower hinge, median, upper hinge, upper whisker */
 	double* tukey;
-	int* observations;
+	int64_t* observations;
+
+	/* The numbers of outliers in the groups, before the outliers are thinned */
+	int64_t* outliers_totals;
 
 	/* Lower notch, upper notch */
 	double* notches;
@@ -70,7 +74,8 @@ public:
 	void set_width(int group, double) throw (PlotException);
 	void set_quantiles(double q0, double q25, double q5, double q75, double q1);
 	const double* get_tukey();
-	const int* get_observations();
+	const int64_t* get_observations();
+	const int64_t* get_outliers_totals();
 	const double* get_notches();
 	const double* get_outliers();
 	const int* get_groups();
@@ -83,7 +88,8 @@ public:
 	void set_title(const char* title) throw (PlotException);
 	const char* get_title();
 
-	static Boxplot* create(const char* name, double* sorted_data, int data_size, double median) throw (PlotException);
+	static Boxplot* create(const char* name, double* sorted_data, int64_t data_size, double median) throw (PlotException);
+	static Boxplot* create(const char* name, int64_t data_size, const double* tukey, const double* outliers, int outliers_cnt, int64_t outliers_total) throw (PlotException);
 	static Boxplot* merge(Boxplot* to, Boxplot* from) throw (PlotException);
 
 	friend SEXP Boxplot2Robj(SEXP boxplot);
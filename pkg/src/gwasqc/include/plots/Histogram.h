@@ -20,7 +20,9 @@
 #ifndef HISTOGRAM_H_
 #define HISTOGRAM_H_
 
+#include <limits>
 #include <math.h>
+#include <stdint.h>
 /*#include <R_ext/Applic.h>*/
 #include <iostream>
 
@@ -34,37 +36,67 @@ extern "C" {
 	SEXP Histogram2Robj(SEXP histogram);
 }
 
+/*
+ * The values are counted one by one with add(), in any order, so the data doesn't have to be kept or sorted. While the
+ * values are counted, the classes form a grid of equal classes, whose breaks are multiples of the class width. If a
+ * value falls outside of the grid, the grid is moved or, if the counted values don't fit, the neighbouring classes are
+ * merged and the class width is doubled. The breaks of the known ranges are chosen up front; otherwise the first values
+ * are buffered and the breaks are chosen from their range. The empty classes at both ends are dropped by finish().
+ */
 class Histogram {
 private:
 	double* breaks;
-	int* counts;
+	int64_t* counts;
 	double* density;
 	double* intensities;
 	double* mids;
 	char* xname;
 
 	int nclass;
+	int64_t n_finite;
 
 	char* title;
 
+	int capacity;
+	double start;
+	double unit;
+	double fuzz;
+	double finite_min;
+	double* pending;
+	int pending_n;
+
 	Histogram();
 
+	void set_classes(double lower, double upper) throw (PlotException);
+	void release_pending() throw (PlotException);
+	void count(double value);
+	void rebin(double position);
+
 	static double pretty(double *lo, double *up, int *ndiv, int min_n, double shrink_sml, double high_u_fact[], int eps_correction, int return_bounds);
 
 public:
 	virtual ~Histogram();
 
 	const double* get_breaks();
-	const int* get_counts();
+	const int64_t* get_counts();
 	const double* get_density();
 	const double* get_intensities();
 	const double* get_mids();
 	const char* get_xname();
 	int get_nclass();
+	int64_t get_n_finite();
+	uint64_t get_total_bytes();
 	void set_title(const char* title) throw (PlotException);
 	const char* get_title();
 
-	static Histogram* create(const char* name, double* sorted_data, int data_size, int nclass) throw (PlotException);
+	void add(double value) throw (PlotException);
+	void finish() throw (PlotException);
+
+	static const double TOLERANCE;
+	static const int PENDING_SIZE;
+
+	static Histogram* create(const char* name, int nclass) throw (PlotException);
+	static Histogram* create(const char* name, double lower, double upper, int nclass) throw (PlotException);
 
 	friend SEXP Histogram2Robj(SEXP histogram);
 };
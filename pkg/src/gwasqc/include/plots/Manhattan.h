@@ -0,0 +1,98 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MANHATTAN_H_
+#define MANHATTAN_H_
+
+#include <math.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <algorithm>
+
+#include "PlotException.h"
+
+#include "R.h"
+#include "Rinternals.h"
+
+using namespace std;
+
+extern "C" {
+	SEXP Manhattan2Robj(SEXP manhattan);
+}
+
+class Manhattan {
+private:
+	/* Chromosome names in natural order (1, 2, ..., 22, X, Y, XY, MT, others alphabetically). */
+	char** chromosome_names;
+	int chromosomes_count;
+
+	/* Start of every chromosome on the x axis; the last element is the end of the last chromosome. */
+	double* offsets;
+
+	/* Points ordered by x. The chromosome of every point is an index into chromosome_names. */
+	double* x;
+	double* y;
+	int* chromosomes;
+	int64_t size;
+
+	/* P-values below the threshold are all present; the others are thinned. */
+	double threshold;
+
+	/* Number of variants the plot stands for. */
+	int64_t points;
+
+	struct chromosome_order {
+		const char* const* names;
+
+		int get_class(const char* name, long* number) const;
+		bool operator()(int first, int second) const;
+	};
+
+	struct point_order {
+		const double* x;
+		const double* y;
+
+		bool operator()(int64_t first, int64_t second) const;
+	};
+
+	Manhattan();
+
+public:
+	virtual ~Manhattan();
+
+	const char* const* get_chromosome_names();
+	int get_chromosomes_count();
+	const double* get_offsets();
+	const double* get_x();
+	const double* get_y();
+	const int* get_chromosomes();
+	int64_t get_size();
+	double get_threshold();
+	int64_t get_points();
+
+	static Manhattan* create(const char* const* chromosome_names, const double* chromosome_lengths, int chromosomes_count,
+			const int* chromosomes, const double* positions, const double* pvalues, int64_t size, double threshold, int64_t points) throw (PlotException);
+
+	friend SEXP Manhattan2Robj(SEXP manhattan);
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "Histogram.h"
 #include "Boxplot.h"
 #include "Qqplot.h"
+#include "Manhattan.h"
 
 #include "R.h"
 #include "Rinternals.h"
@@ -41,6 +42,7 @@ private:
 	vector<Histogram*> histograms;
 	vector<Boxplot*> boxplots;
 	vector<Qqplot*> qqplots;
+	vector<Manhattan*> manhattans;
 
 	char* name;
 	char* title;
@@ -52,6 +54,7 @@ public:
 	void add_histogram(Histogram* histogram) throw (PlotException);
 	void add_boxplot(Boxplot* boxplot) throw (PlotException);
 	void add_qqplot(Qqplot* qqplot) throw (PlotException);
+	void add_manhattan(Manhattan* manhattan) throw (PlotException);
 
 	void set_name(const char* name) throw (PlotException);
 	void set_formatted_name(const char* name, ... ) throw (PlotException);
@@ -64,10 +67,12 @@ public:
 	int histograms_count();
 	int boxplots_count();
 	int qqplots_count();
+	int manhattans_count();
 
 	vector<Histogram*>* get_histograms();
 	vector<Boxplot*>* get_boxplots();
 	vector<Qqplot*>* get_qqplots();
+	vector<Manhattan*>* get_manhattans();
 
 	friend SEXP Plot2Robj(SEXP boxplot);
 };
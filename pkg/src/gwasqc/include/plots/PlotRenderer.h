@@ -0,0 +1,96 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PLOTRENDERER_H_
+#define PLOTRENDERER_H_
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <math.h>
+#include <pthread.h>
+
+#include "Plot.h"
+#include "Raster.h"
+
+using namespace std;
+
+/*
+ * Renders plots directly to PNG files, with the same layouts as the plotting functions of the R package.
+ * A plot with the name <name> is written to the file <name>.png.
+ */
+class PlotRenderer {
+private:
+	static const int PLOT_WIDTH;
+	static const int PLOT_HEIGHT;
+	static const int QQPLOT_SIZE;
+	static const int TEXT_SCALE;
+	static const int MAX_TICKS;
+	static const int LEGEND_ENTRY_SIZE;
+	static const double RANGE_EXTENSION;
+	static const unsigned int HISTOGRAM_COLOR;
+	static const unsigned int BOXPLOT_COLOR;
+	static const unsigned int MANHATTAN_COLORS[];
+	static const double GENOME_WIDE_SIGNIFICANCE;
+
+	/* The plotting region of a figure in pixels, and the range of values it shows. */
+	struct frame {
+		int left;
+		int top;
+		int right;
+		int bottom;
+		double x_from;
+		double x_to;
+		double y_from;
+		double y_to;
+
+		void set_range(double x_from, double x_to, double y_from, double y_to);
+		int get_x(double x) const;
+		int get_y(double y) const;
+	};
+
+	/* Plots rendered in parallel: every worker takes the next plot until none is left or a plot fails. */
+	struct render_queue {
+		vector<Plot*>* plots;
+		unsigned int next;
+		PlotException* error;
+		pthread_mutex_t mutex;
+	};
+
+	static void* run_render_worker(void* queue);
+
+	static int get_ticks(double from, double to, double* ticks);
+	static void format_tick(double value, int digits, char* buffer);
+	static void format_legend_entry(const char* name, int64_t points, double lambda, char* buffer);
+
+	static void draw_title(Raster& raster, const frame& plot_frame, const char* title, const char* subtitle);
+	static void draw_x_axis(Raster& raster, const frame& plot_frame, double* ticks, int ticks_cnt, int digits);
+	static void draw_y_axis(Raster& raster, const frame& plot_frame, const double* ticks, int ticks_cnt);
+
+	static void draw_histogram(Raster& raster, int left, int top, int right, int bottom, Histogram* histogram, const char* title, const char* subtitle, bool x_axis, const double* x_range);
+	static void draw_boxplot(Raster& raster, int left, int top, int right, int bottom, Boxplot* boxplot, const char* title, const double* x_range);
+	static void draw_qqplot(Raster& raster, int left, int top, int right, int bottom, Qqplot* qqplot);
+	static void draw_manhattan(Raster& raster, int left, int top, int right, int bottom, Manhattan* manhattan, const char* title);
+
+public:
+	static void render(Plot* plot) throw (PlotException);
+	static void render(vector<Plot*>& plots, unsigned int threads) throw (PlotException);
+};
+
+#endif
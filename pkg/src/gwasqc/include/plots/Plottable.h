@@ -24,6 +24,7 @@
 #include "Histogram.h"
 #include "Boxplot.h"
 #include "Qqplot.h"
+#include "Manhattan.h"
 
 class Plottable {
 public:
@@ -39,6 +40,7 @@ public:
 	virtual Histogram* get_histogram() = 0;
 	virtual Boxplot* get_boxplot() = 0;
 	virtual Qqplot* get_qqplot() = 0;
+	virtual Manhattan* get_manhattan() = 0;
 	virtual Plot* get_plot() = 0;
 };
 
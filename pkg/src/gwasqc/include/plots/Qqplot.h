@@ -22,7 +22,9 @@
 
 #include <limits>
 #include <math.h>
+#include <stdint.h>
 #include <iostream>
+#include <algorithm>
 
 #include "PlotException.h"
 
@@ -38,7 +40,7 @@ private:
 	double* x;
 	double* y;
 	int* size;
-	int* points;
+	int64_t* points;
 	char** names;
 	char** colors;
 	double* lambdas;
@@ -46,8 +48,19 @@ private:
 	int all_size;
 	int count;
 
+	/* The p-values by their rank: either all sorted p-values, or the distinct values with the cumulative counts of their ranks. */
+	struct ranked_values {
+		const double* values;
+		const int64_t* ends;
+		int64_t values_size;
+
+		double get(int64_t rank) const;
+	};
+
 	Qqplot();
 
+	static Qqplot* create(const char* name, const char* color, const ranked_values& data, double lambda, int64_t data_size) throw (PlotException);
+
 public:
 	virtual ~Qqplot();
 
@@ -56,13 +69,14 @@ public:
 	const double* get_x();
 	const double* get_y();
 	const int* get_size();
-	const int* get_points();
+	const int64_t* get_points();
 	int get_count();
 	const char* const* get_names();
 	const char* const* get_colors();
 	const double* get_lambdas();
 
-	static Qqplot* create(const char* name, const char* color, double* sorted_data, double lambda, int data_size) throw (PlotException);
+	static Qqplot* create(const char* name, const char* color, double* sorted_data, double lambda, int64_t data_size) throw (PlotException);
+	static Qqplot* create(const char* name, const char* color, const double* values, const int64_t* counts, int64_t values_size, double lambda) throw (PlotException);
 	static Qqplot* merge(Qqplot* to, Qqplot* from) throw (PlotException);
 
 	friend SEXP Qqplot2Robj(SEXP qqplot);
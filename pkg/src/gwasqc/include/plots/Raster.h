@@ -0,0 +1,88 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RASTER_H_
+#define RASTER_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "PlotException.h"
+#include "../../../zlib/zlib.h"
+
+/*
+ * An RGB image with the few drawing primitives needed by the QC plots. The image is written as a PNG file.
+ * Colors are given as 0xRRGGBB. Everything outside of the image, or outside of the clipping rectangle, is ignored.
+ */
+class Raster {
+private:
+	static const int GLYPH_WIDTH;
+	static const int GLYPH_HEIGHT;
+	static const unsigned char GLYPHS[][5];
+
+	static const int NAMED_COLORS_SIZE;
+	static const char* NAMED_COLORS[];
+	static const unsigned int NAMED_COLORS_RGB[];
+
+	unsigned char* pixels;
+	int width;
+	int height;
+
+	int clip_left;
+	int clip_top;
+	int clip_right;
+	int clip_bottom;
+
+	void set_pixel(int x, int y, unsigned int color);
+	void draw_glyph(int x, int y, char c, unsigned int color, int scale, bool vertical);
+
+	static void write_chunk(FILE* file, const char* type, const unsigned char* data, unsigned int length);
+	static void write_uint32(unsigned char* buffer, unsigned int value);
+
+public:
+	static const unsigned int BLACK;
+	static const unsigned int WHITE;
+
+	Raster(int width, int height) throw (PlotException);
+	virtual ~Raster();
+
+	int get_width();
+	int get_height();
+
+	void set_clip(int left, int top, int right, int bottom);
+	void reset_clip();
+
+	void fill(unsigned int color);
+	void fill_rectangle(int left, int top, int right, int bottom, unsigned int color);
+	void draw_rectangle(int left, int top, int right, int bottom, unsigned int color);
+	void draw_line(int x0, int y0, int x1, int y1, unsigned int color, int thickness = 1, bool dashed = false);
+	void fill_circle(int x, int y, int radius, unsigned int color);
+	void draw_circle(int x, int y, int radius, unsigned int color);
+	void draw_text(int x, int y, const char* text, unsigned int color, int scale = 1, bool vertical = false);
+
+	void write_png(const char* file_name) throw (PlotException);
+
+	static int get_text_width(const char* text, int scale = 1);
+	static int get_text_height(const char* text, int scale = 1);
+	static unsigned int get_color(const char* name);
+};
+
+#endif
@@ -78,6 +78,10 @@ const char* Analyzer::TXT_EXTENSION = ".txt";
 const char* Analyzer::CSV_EXTENSION = ".csv";
 const char* Analyzer::HTML_EXTENSION = ".html";
 const char* Analyzer::HTM_EXTENSION = ".htm";
+const char* Analyzer::STATE_EXTENSION = ".qcstate";
+const char* Analyzer::STATE_SIGNATURE = "GWQS";
+const unsigned int Analyzer::STATE_VERSION = 4;
+const char* Analyzer::RESULTS_EXTENSION = ".qcresult";
 
 const char* Analyzer::CONTENT_STYLE = "content_style.css";
 const char* Analyzer::MENU_STYLE = "menu_style.css";
@@ -87,7 +91,10 @@ const char* Analyzer::MENU_FILE = "menu.html";
 const char* Analyzer::MAIN_FILE = "main.html";
 const char* Analyzer::BOXPLOTS_FILE = "boxplots.html";
 
-Analyzer::Analyzer() : reader(NULL), gwafile(NULL) {
+const unsigned int Analyzer::STRATUM_ROWS = 100;
+const uint64_t Analyzer::SAMPLE_SEED = 88172645463325252ULL;
+
+Analyzer::Analyzer() : reader(NULL), gwafile(NULL), block_rows(0), sampled_rows(0), low_memory(false), results_on(false) {
 
 }
 
@@ -97,6 +104,7 @@ Analyzer::~Analyzer() {
 	vector<MetaFiltered*>::iterator filtered_metas_it;
 	vector<MetaRatio*>::iterator ratio_metas_it;
 	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector<MetaManhattan*>::iterator manhattan_metas_it;
 
 	for (vector_char_it = missing_columns.begin(); vector_char_it != missing_columns.end(); vector_char_it++) {
 		free(*vector_char_it);
@@ -124,14 +132,20 @@ Analyzer::~Analyzer() {
 		delete *cross_table_metas_it;
 	}
 
+	for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+		delete *manhattan_metas_it;
+	}
+
 	missing_columns.clear();
 	not_required_columns.clear();
 	metas.clear();
+	column_plan.clear();
 	plots.clear();
 	dependencies.clear();
 	filtered_metas.clear();
 	ratio_metas.clear();
 	cross_table_metas.clear();
+	manhattan_metas.clear();
 	numeric_metas.clear();
 
 	gwafile = NULL;
@@ -166,6 +180,7 @@ void Analyzer::close_gwafile() throw (AnalyzerException) {
 	vector<MetaFiltered*>::iterator filtered_metas_it;
 	vector<MetaRatio*>::iterator ratio_metas_it;
 	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector<MetaManhattan*>::iterator manhattan_metas_it;
 
 	try {
 		if (reader != NULL) {
@@ -179,6 +194,10 @@ void Analyzer::close_gwafile() throw (AnalyzerException) {
 		throw new_e;
 	}
 
+	cache.close();
+	sampled_rows = 0;
+	low_memory = false;
+
 	for (vector_char_it = missing_columns.begin(); vector_char_it != missing_columns.end(); vector_char_it++) {
 		free(*vector_char_it);
 	}
@@ -205,14 +224,20 @@ void Analyzer::close_gwafile() throw (AnalyzerException) {
 		delete *cross_table_metas_it;
 	}
 
+	for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+		delete *manhattan_metas_it;
+	}
+
 	missing_columns.clear();
 	not_required_columns.clear();
 	metas.clear();
+	column_plan.clear();
 	plots.clear();
 	dependencies.clear();
 	filtered_metas.clear();
 	ratio_metas.clear();
 	cross_table_metas.clear();
+	manhattan_metas.clear();
 	numeric_metas.clear();
 
 	gwafile = NULL;
@@ -224,17 +249,28 @@ void Analyzer::process_header() throw (AnalyzerException) {
 	char* header = NULL;
 	char* token = NULL;
 	const char* column_name = NULL;
+	const char* precision = NULL;
 	char* column_name_copy = NULL;
 	int column_position = 0;
 	Meta* meta = NULL;
+	column_handler column = {NULL, NULL};
 	vector<char*>::iterator vector_char_it;
 	vector<double>* thresholds;
+	vector<double>* histogram_range = NULL;
+	vector<MetaNumeric*>::iterator numeric_metas_it;
 	unsigned int heap_size = 0;
+	unsigned int numeric_heap_size = 0;
 
 	if (gwafile == NULL) {
 		return;
 	}
 
+	/* Preview and partitions take precedence over the low-memory mode, since they need a single pass. */
+	low_memory = gwafile->is_lowmemory_on() && !gwafile->is_preview_on() && !gwafile->is_partition_on();
+
+	/* The results are saved as the state of a single partition, which isn't available in these modes. */
+	results_on = gwafile->is_resultcache_on() && !gwafile->is_preview_on() && !gwafile->is_partition_on() && !low_memory;
+
 	try {
 		if (reader->read_line() <= 0) {
 			throw AnalyzerException("Analyzer", "process_header()", __LINE__, 5, gwafile->get_descriptor()->get_full_path());
@@ -249,6 +285,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 			heap_size = Meta::HEAP_SIZE;
 		}
 
+		numeric_heap_size = low_memory ? 0 : heap_size;
+
 		for (int i = 0; i < MANDATORY_COLUMNS_SIZE; i++) {
 			column_name = descriptor->get_column(mandatory_columns[i]);
 			if (column_name != NULL) {
@@ -266,21 +304,28 @@ void Analyzer::process_header() throw (AnalyzerException) {
 			column_name = descriptor->get_default_column(token, gwafile->is_case_sensitive());
 			if (column_name != NULL) {
 				if (strcmp(column_name, Descriptor::MARKER) == 0) {
-					meta = new MetaUniqueness(heap_size);
+					meta = new MetaUniqueness(heap_size, gwafile->is_fingerprint_on() && !gwafile->is_preview_on());
+					column.put = put_value<MetaUniqueness>;
 				} else if (strcmp(column_name, Descriptor::ALLELE1) == 0) {
 					meta = new MetaGroup(true);
+					column.put = put_value<MetaGroup>;
 				} else if (strcmp(column_name, Descriptor::ALLELE2) == 0) {
 					meta = new MetaGroup(true);
+					column.put = put_value<MetaGroup>;
 				} else if (strcmp(column_name, Descriptor::CHR) == 0) {
 					meta = new MetaGroup();
+					column.put = put_value<MetaGroup>;
 				} else if (strcmp(column_name, Descriptor::POSITION) == 0) {
 					meta = new MetaFormat();
 					meta->set_full_name("Position");
+					column.put = put_value<MetaFormat>;
 				} else if (strcmp(column_name, Descriptor::STRAND) == 0) {
 					meta = new MetaGroup();
+					column.put = put_value<MetaGroup>;
 				} else if (strcmp(column_name, Descriptor::PVALUE) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::PVALUE);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
+					column.put = put_value<MetaImplausibleStrict>;
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausibleStrict*)meta)->set_plots(true, false, false);
 					((MetaImplausibleStrict*)meta)->set_description("All data");
@@ -288,7 +333,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					meta->set_full_name("P-value");
 					plots.push_back((MetaImplausibleStrict*)meta);
 				} else if (strcmp(column_name, Descriptor::EFFECT) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
+					column.put = put_value<MetaNumeric>;
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaNumeric*)meta)->set_description("All data");
 					((MetaNumeric*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -296,7 +342,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::STDERR) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::STDERR);
-					meta = new MetaImplausible(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausible(thresholds->at(0), thresholds->at(1), numeric_heap_size);
+					column.put = put_value<MetaImplausible>;
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausible*)meta)->set_description("All data");
 					((MetaImplausible*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -304,7 +351,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaImplausible*)meta);
 				} else if (strcmp(column_name, Descriptor::FREQLABEL) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::FREQLABEL);
-					meta = new MetaImplausibleStrictAdjusted(thresholds->at(0), thresholds->at(1), 0.5, heap_size);
+					meta = new MetaImplausibleStrictAdjusted(thresholds->at(0), thresholds->at(1), 0.5, numeric_heap_size);
+					column.put = put_value<MetaImplausibleStrictAdjusted>;
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausibleStrictAdjusted*)meta)->set_description(token);
 					((MetaImplausibleStrictAdjusted*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -312,7 +360,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaImplausibleStrictAdjusted*)meta);
 				} else if (strcmp(column_name, Descriptor::HWE_PVAL) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::HWE_PVAL);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
+					column.put = put_value<MetaImplausibleStrict>;
 					if (!gwafile->is_high_verbosity()) {
 						((MetaImplausibleStrict*)meta)->set_plots(false, false, false);
 					}
@@ -323,7 +372,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaImplausibleStrict*)meta);
 				} else if (strcmp(column_name, Descriptor::CALLRATE) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::CALLRATE);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
+					column.put = put_value<MetaImplausibleStrict>;
 					if (!gwafile->is_high_verbosity()) {
 						((MetaImplausibleStrict*)meta)->set_plots(false, false, false);
 					}
@@ -333,7 +383,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					numeric_metas.push_back((MetaNumeric*)meta);
 					plots.push_back((MetaImplausibleStrict*)meta);
 				} else if (strcmp(column_name, Descriptor::N_TOTAL) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
+					column.put = put_value<MetaNumeric>;
 					if (!gwafile->is_high_verbosity()) {
 						((MetaNumeric*)meta)->set_plots(true, false, false);
 					}
@@ -343,7 +394,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					numeric_metas.push_back((MetaNumeric*)meta);
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::IMPUTED) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
+					column.put = put_value<MetaNumeric>;
 					if (!gwafile->is_high_verbosity()) {
 						((MetaNumeric*)meta)->set_plots(false, false, false);
 					}
@@ -351,7 +403,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					numeric_metas.push_back((MetaNumeric*)meta);
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::USED_FOR_IMP) == 0) {
-					meta = new MetaNumeric(heap_size);
+					meta = new MetaNumeric(numeric_heap_size);
+					column.put = put_value<MetaNumeric>;
 					if (!gwafile->is_high_verbosity()) {
 						((MetaNumeric*)meta)->set_plots(false, false, false);
 					}
@@ -360,7 +413,8 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					plots.push_back((MetaNumeric*)meta);
 				} else if (strcmp(column_name, Descriptor::OEVAR_IMP) == 0) {
 					thresholds = descriptor->get_threshold(Descriptor::OEVAR_IMP);
-					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), heap_size);
+					meta = new MetaImplausibleStrict(thresholds->at(0), thresholds->at(1), numeric_heap_size);
+					column.put = put_value<MetaImplausibleStrict>;
 					numeric_metas.push_back((MetaNumeric*)meta);
 					((MetaImplausibleStrict*)meta)->set_description("All data");
 					((MetaImplausibleStrict*)meta)->set_ouptut(false, false, false, true, true, true);
@@ -375,195 +429,1230 @@ void Analyzer::process_header() throw (AnalyzerException) {
 					not_required_columns.push_back(column_name_copy);
 					metas.push_back(NULL);
 
-					token = auxiliary::strtok(&header, header_separator);
-					column_position += 1;
+					column.meta = NULL;
+					column.put = NULL;
+					column_plan.push_back(column);
+
+					token = auxiliary::strtok(&header, header_separator);
+					column_position += 1;
+
+					continue;
+				}
+
+				if (gwafile->is_case_sensitive()) {
+					for (vector_char_it = missing_columns.begin(); vector_char_it != missing_columns.end(); vector_char_it++) {
+						if (strcmp(*vector_char_it, token) == 0) {
+							free(*vector_char_it);
+							missing_columns.erase(vector_char_it);
+							break;
+						}
+					}
+				} else {
+					for (vector_char_it = missing_columns.begin(); vector_char_it != missing_columns.end(); vector_char_it++) {
+						if (auxiliary::strcmp_ignore_case(*vector_char_it, token) == 0) {
+							free(*vector_char_it);
+							missing_columns.erase(vector_char_it);
+							break;
+						}
+					}
+				}
+
+				meta->set_common_name(column_name);
+				meta->set_actual_name(token);
+				meta->set_id(column_position);
+				meta->set_na_marker(descriptor->get_property(Descriptor::MISSING));
+
+				metas.push_back(meta);
+
+				column.meta = meta;
+				column_plan.push_back(column);
+			} else {
+				column_name_copy = (char*)malloc((strlen(token) + 1) * sizeof(char));
+				if (column_name_copy == NULL) {
+					throw AnalyzerException("Analyzer", "process_header()", __LINE__, 2, (strlen(token) + 1) * sizeof(char));
+				}
+				strcpy(column_name_copy, token);
+				not_required_columns.push_back(column_name_copy);
+				metas.push_back(NULL);
+
+				column.meta = NULL;
+				column.put = NULL;
+				column_plan.push_back(column);
+			}
+
+			token = auxiliary::strtok(&header, header_separator);
+			column_position += 1;
+		}
+
+		for (numeric_metas_it = numeric_metas.begin(); numeric_metas_it != numeric_metas.end(); numeric_metas_it++) {
+			histogram_range = descriptor->get_histogram((*numeric_metas_it)->get_common_name());
+			if (histogram_range != NULL) {
+				(*numeric_metas_it)->set_histogram_range(histogram_range->at(0), histogram_range->at(1));
+			}
+		}
+
+		if (low_memory) {
+			for (numeric_metas_it = numeric_metas.begin(); numeric_metas_it != numeric_metas.end(); numeric_metas_it++) {
+				(*numeric_metas_it)->set_low_memory(true);
+			}
+		} else if ((!gwafile->is_partition_on()) || (gwafile->get_partition() == 0)) {
+			/* Partial runs save the values in double precision, so that the merge narrows the original values. */
+			for (numeric_metas_it = numeric_metas.begin(); numeric_metas_it != numeric_metas.end(); numeric_metas_it++) {
+				precision = descriptor->get_precision((*numeric_metas_it)->get_common_name());
+				if ((precision != NULL) && (strcmp(precision, Descriptor::SINGLE_MODES[0]) == 0)) {
+					(*numeric_metas_it)->set_single_precision(true);
+				}
+			}
+		}
+	} catch (DescriptorException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (AnalyzerException &e) {
+		e.add_message("Analyzer", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
+		throw;
+	}
+}
+
+
+void Analyzer::process_data() throw (AnalyzerException) {
+	int line_length = 0;
+	uint64_t line_number = 1;
+	char data_separator = '\0';
+	unsigned int total_columns = 0;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	data_separator = gwafile->get_data_separator();
+	total_columns = metas.size();
+	block_rows = 0;
+	sampled_rows = 0;
+
+	try {
+		if (gwafile->is_partition_on()) {
+			if (gwafile->get_partition() > 0) {
+				process_partition();
+			} else {
+				merge_states();
+			}
+			return;
+		}
+
+		if ((gwafile->is_preview_on()) && (gwafile->get_estimated_size() > 2 * (uint64_t)gwafile->get_preview_rows())) {
+			process_sample();
+			return;
+		}
+
+		if ((results_on) && (load_results())) {
+			return;
+		}
+
+		if (gwafile->is_cache_on()) {
+			if (cache.open(gwafile->get_descriptor()->get_full_path(), data_separator, total_columns)) {
+				process_cache();
+				if (results_on) {
+					save_results();
+				}
+				return;
+			}
+			cache.create(gwafile->get_descriptor()->get_full_path(), data_separator, total_columns, gwafile->get_descriptor()->get_property(Descriptor::MISSING));
+		}
+
+		while ((line_length = reader->read_line()) > 0) {
+			process_line(*(reader->line), line_number);
+			line_number += 1;
+		}
+
+		if (line_length == 0) {
+			throw AnalyzerException("Analyzer", "process_data()", __LINE__, 13, line_number, gwafile->get_descriptor()->get_full_path());
+		}
+
+		flush_blocks();
+
+		cache.write();
+
+		if (results_on) {
+			save_results();
+		}
+	} catch (GwaCacheException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (ReaderException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (AnalyzerException &e) {
+		e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw;
+	} catch (std::out_of_range &e) {
+		AnalyzerException new_e("Analyzer", "process_data()", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
+		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+/*
+ * Splits the line into the tokens, passes them to the Metas and, when the cache is being written, to the cache.
+ * Line number 0 denotes a line whose position in the file is unknown (e.g. sampled line or line inside a partition).
+ */
+void Analyzer::process_line(char* line, uint64_t line_number) throw (AnalyzerException) {
+	char* token = NULL;
+	char data_separator = gwafile->get_data_separator();
+	unsigned int column_number = 0;
+	unsigned int total_columns = column_plan.size();
+
+	column_handler* column = NULL;
+
+	try {
+		while ((token = auxiliary::strtok(&line, data_separator)) != NULL) {
+			if (column_number >= total_columns) {
+				column_number += 1;
+				break;
+			}
+
+			column = &column_plan[column_number];
+			if (column->meta != NULL) {
+				auxiliary::trim(&token);
+				column->put(column->meta, token);
+			} else if (cache.is_writing()) {
+				auxiliary::trim(&token);
+			}
+			cache.put(column_number, token);
+			column_number += 1;
+		}
+
+		if (column_number != total_columns) {
+			if (line_number > 0) {
+				throw AnalyzerException("Analyzer", "process_line( char*, uint64_t )", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
+			}
+			throw AnalyzerException("Analyzer", "process_line( char*, uint64_t )", __LINE__, 22, gwafile->get_descriptor()->get_full_path());
+		}
+
+		complete_row();
+		cache.complete_row();
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_line( char*, uint64_t )", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+/*
+ * Preview mode: only about get_preview_rows() data lines are processed. Plain text files are split into equal strata
+ * and a run of consecutive lines is read at a random position inside every stratum. Files without random access are
+ * sampled uniformly in one pass with the reservoir. The sampling is reproducible, since the seed is fixed.
+ */
+void Analyzer::process_sample() throw (AnalyzerException) {
+	vector<MetaNumeric*>::iterator numeric_metas_it;
+
+	try {
+		if (reader->seek(0.0)) {
+			process_strata();
+		} else {
+			process_reservoir();
+		}
+	} catch (ReaderException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_sample()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+
+	if (sampled_rows > 0) {
+		for (numeric_metas_it = numeric_metas.begin(); numeric_metas_it != numeric_metas.end(); numeric_metas_it++) {
+			if (*numeric_metas_it != NULL) {
+				(*numeric_metas_it)->set_sampled(true);
+			}
+		}
+	}
+}
+
+void Analyzer::process_strata() throw (AnalyzerException) {
+	vector<MetaNumeric*>::iterator numeric_metas_it;
+	unsigned int preview_rows = gwafile->get_preview_rows();
+	unsigned int strata = (preview_rows + STRATUM_ROWS - 1) / STRATUM_ROWS;
+	unsigned int stratum_rows = 0;
+	vector<double> starts;
+	int64_t end = -1;
+	int64_t start = 0;
+	uint64_t state = SAMPLE_SEED;
+
+	/* a run of lines starts at a uniformly random position inside its stratum and may continue into the next one */
+	for (unsigned int stratum = 0; stratum < strata; stratum++) {
+		starts.push_back((stratum + auxiliary::random_uniform(&state)) / strata);
+	}
+
+	try {
+		/* the runs are read from the last one, so that every run stops where the next one starts and no line is read twice */
+		for (unsigned int stratum = strata; (stratum > 0) && (sampled_rows < preview_rows); stratum--) {
+			reader->seek(starts[stratum - 1]);
+			start = reader->get_position();
+
+			for (numeric_metas_it = numeric_metas.begin(); numeric_metas_it != numeric_metas.end(); numeric_metas_it++) {
+				if (*numeric_metas_it != NULL) {
+					(*numeric_metas_it)->begin_cluster();
+				}
+			}
+
+			stratum_rows = 0;
+			while ((stratum_rows < STRATUM_ROWS) && (sampled_rows < preview_rows) && ((end < 0) || (reader->get_position() < end)) && (reader->read_line() > 0)) {
+				process_line(*(reader->line), 0);
+				stratum_rows += 1;
+				sampled_rows += 1;
+			}
+
+			end = start;
+		}
+
+		flush_blocks();
+	} catch (ReaderException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_strata()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_strata()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+void Analyzer::process_reservoir() throw (AnalyzerException) {
+	unsigned int preview_rows = gwafile->get_preview_rows();
+	char** reservoir = NULL;
+	unsigned int reservoir_size = 0;
+	uint64_t lines_number = 0;
+	uint64_t position = 0;
+	int line_length = 0;
+	char* line = NULL;
+	uint64_t state = SAMPLE_SEED;
+
+	reservoir = (char**)malloc(preview_rows * sizeof(char*));
+	if (reservoir == NULL) {
+		throw AnalyzerException("Analyzer", "process_reservoir()", __LINE__, 2, preview_rows * sizeof(char*));
+	}
+
+	try {
+		while ((line_length = reader->read_line()) > 0) {
+			lines_number += 1;
+
+			if (reservoir_size < preview_rows) {
+				position = reservoir_size;
+			} else {
+				position = auxiliary::random64(&state) % lines_number;
+				if (position >= preview_rows) {
+					continue;
+				}
+			}
+
+			line = (char*)malloc((line_length + 1) * sizeof(char));
+			if (line == NULL) {
+				throw AnalyzerException("Analyzer", "process_reservoir()", __LINE__, 2, (line_length + 1) * sizeof(char));
+			}
+			strcpy(line, *(reader->line));
+
+			if (position < reservoir_size) {
+				free(reservoir[position]);
+			} else {
+				reservoir_size += 1;
+			}
+			reservoir[position] = line;
+		}
+
+		if (line_length == 0) {
+			throw AnalyzerException("Analyzer", "process_reservoir()", __LINE__, 13, lines_number + 1, gwafile->get_descriptor()->get_full_path());
+		}
+
+		for (unsigned int i = 0; i < reservoir_size; i++) {
+			process_line(reservoir[i], lines_number > preview_rows ? 0 : i + 1);
+		}
+
+		flush_blocks();
+	} catch (ReaderException &e) {
+		for (unsigned int i = 0; i < reservoir_size; i++) {
+			free(reservoir[i]);
+		}
+		free(reservoir);
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_reservoir()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (MetaException &e) {
+		for (unsigned int i = 0; i < reservoir_size; i++) {
+			free(reservoir[i]);
+		}
+		free(reservoir);
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_reservoir()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (AnalyzerException &e) {
+		for (unsigned int i = 0; i < reservoir_size; i++) {
+			free(reservoir[i]);
+		}
+		free(reservoir);
+		throw;
+	}
+
+	for (unsigned int i = 0; i < reservoir_size; i++) {
+		free(reservoir[i]);
+	}
+	free(reservoir);
+
+	/* the whole file fitted into the reservoir: the results are exact */
+	sampled_rows = lines_number > preview_rows ? reservoir_size : 0;
+}
+
+/*
+ * Partition k of n holds the data lines, which start after k - 1 / n and not after k / n of the file length.
+ * The boundaries are found with Reader::seek(), therefore every line belongs to exactly one partition.
+ */
+void Analyzer::process_partition() throw (AnalyzerException) {
+	unsigned int partitions = gwafile->get_partitions();
+	unsigned int partition = gwafile->get_partition();
+	int64_t end = -1;
+	int line_length = -1;
+
+	try {
+		if (partition < partitions) {
+			if (!reader->seek((double)partition / partitions)) {
+				throw AnalyzerException("Analyzer", "process_partition()", __LINE__, 23, gwafile->get_descriptor()->get_full_path());
+			}
+			end = reader->get_position();
+		}
+
+		if (partition > 1) {
+			if (!reader->seek((double)(partition - 1) / partitions)) {
+				throw AnalyzerException("Analyzer", "process_partition()", __LINE__, 23, gwafile->get_descriptor()->get_full_path());
+			}
+		} else if (end >= 0) {
+			reader->reset();
+			if (reader->read_line() <= 0) {
+				throw AnalyzerException("Analyzer", "process_partition()", __LINE__, 5, gwafile->get_descriptor()->get_full_path());
+			}
+		}
+
+		while (((end < 0) || (reader->get_position() < end)) && ((line_length = reader->read_line()) > 0)) {
+			process_line(*(reader->line), 0);
+		}
+
+		if (line_length == 0) {
+			throw AnalyzerException("Analyzer", "process_partition()", __LINE__, 24, gwafile->get_descriptor()->get_full_path());
+		}
+
+		flush_blocks();
+	} catch (ReaderException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_partition()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_partition()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+/*
+ * The partial states of all partitions are merged in the order of partitions.
+ */
+void Analyzer::merge_states() throw (AnalyzerException) {
+	unsigned int partitions = gwafile->get_partitions();
+	char* i_statefile_name = NULL;
+	ifstream i_statefile_stream;
+
+	for (unsigned int partition = 1; partition <= partitions; partition++) {
+		i_statefile_name = get_state_file_name(partition);
+
+		i_statefile_stream.clear();
+		i_statefile_stream.open(i_statefile_name, ios::binary);
+		if (i_statefile_stream.fail()) {
+			AnalyzerException new_e("Analyzer", "merge_states()", __LINE__, 18, i_statefile_name);
+			free(i_statefile_name);
+			throw new_e;
+		}
+
+		try {
+			read_state(i_statefile_stream, i_statefile_name, partition, partitions);
+		} catch (AnalyzerException &e) {
+			i_statefile_stream.close();
+			free(i_statefile_name);
+			throw;
+		}
+
+		i_statefile_stream.close();
+
+		free(i_statefile_name);
+		i_statefile_name = NULL;
+	}
+}
+
+/*
+ * Merges the state saved by write_state() into the current state of all columns. The stream must end with the state.
+ * Filtered columns are merged before their sources, because they refer to the positions in the data of the sources.
+ */
+void Analyzer::read_state(istream& stream, const char* file_name, unsigned int partition, unsigned int partitions) throw (AnalyzerException) {
+	vector<Meta*>::iterator metas_it;
+	vector<MetaFiltered*>::iterator filtered_metas_it;
+	vector<MetaRatio*>::iterator ratio_metas_it;
+	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector<MetaManhattan*>::iterator manhattan_metas_it;
+	vector< pair<pair<Meta*, Meta*>, int64_t> >::iterator dependencies_it;
+
+	char signature[4];
+	unsigned int header[9];
+	unsigned int expected_header[9];
+	unsigned int name_length = 0;
+	char* name = NULL;
+	int64_t count = 0;
+
+	expected_header[0] = STATE_VERSION;
+	expected_header[1] = partition;
+	expected_header[2] = partitions;
+	expected_header[3] = metas.size();
+	expected_header[4] = filtered_metas.size();
+	expected_header[5] = ratio_metas.size();
+	expected_header[6] = cross_table_metas.size();
+	expected_header[7] = manhattan_metas.size();
+	expected_header[8] = dependencies.size();
+
+	try {
+		stream.read(signature, 4);
+		stream.read((char*)header, 9 * sizeof(unsigned int));
+		if ((stream.fail()) || (strncmp(signature, STATE_SIGNATURE, 4) != 0) ||
+				(memcmp(header, expected_header, 9 * sizeof(unsigned int)) != 0)) {
+			throw AnalyzerException("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 27, file_name, gwafile->get_descriptor()->get_full_path());
+		}
+
+		for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+			(*filtered_metas_it)->merge_state(stream);
+		}
+
+		for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
+			if ((*metas_it) == NULL) {
+				continue;
+			}
+
+			stream.read((char*)&name_length, sizeof(unsigned int));
+			if ((stream.fail()) || (name_length != strlen((*metas_it)->get_common_name()))) {
+				throw AnalyzerException("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 27, file_name, gwafile->get_descriptor()->get_full_path());
+			}
+
+			name = (char*)malloc((name_length + 1) * sizeof(char));
+			if (name == NULL) {
+				throw AnalyzerException("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 2, (name_length + 1) * sizeof(char));
+			}
+
+			stream.read(name, name_length);
+			name[name_length] = '\0';
+			if ((stream.fail()) || (strcmp(name, (*metas_it)->get_common_name()) != 0)) {
+				free(name);
+				name = NULL;
+				throw AnalyzerException("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 27, file_name, gwafile->get_descriptor()->get_full_path());
+			}
+
+			free(name);
+			name = NULL;
+
+			(*metas_it)->merge_state(stream);
+		}
+
+		for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
+			(*ratio_metas_it)->merge_state(stream);
+		}
+
+		for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
+			(*cross_table_metas_it)->merge_state(stream);
+		}
+
+		for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+			(*manhattan_metas_it)->merge_state(stream);
+		}
+
+		for (dependencies_it = dependencies.begin(); dependencies_it != dependencies.end(); dependencies_it++) {
+			stream.read((char*)&count, sizeof(int64_t));
+			if (stream.fail()) {
+				throw AnalyzerException("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 27, file_name, gwafile->get_descriptor()->get_full_path());
+			}
+			dependencies_it->second += count;
+		}
+
+		if (stream.peek() != istream::traits_type::eof()) {
+			throw AnalyzerException("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 27, file_name, gwafile->get_descriptor()->get_full_path());
+		}
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 26, file_name);
+		throw new_e;
+	} catch (AnalyzerException &e) {
+		e.add_message("Analyzer", "read_state( istream&, const char*, unsigned int, unsigned int )", __LINE__, 26, file_name);
+		throw;
+	}
+}
+
+/*
+ * The output files other than reports are named like the text report, but with the specified suffix instead of the extension.
+ */
+char* Analyzer::get_output_file_name(const char* suffix) throw (AnalyzerException) {
+	const char* output_prefix = NULL;
+	const char* file_name = NULL;
+	const char* file_extension = NULL;
+	const char* file_abbreviation = NULL;
+	char* o_file_name = NULL;
+
+	output_prefix = gwafile->get_descriptor()->get_property(Descriptor::PREFIX);
+	file_extension = gwafile->get_descriptor()->get_extension();
+	file_abbreviation = gwafile->get_descriptor()->get_abbreviation();
+
+	if (file_abbreviation == NULL) {
+		file_name = gwafile->get_descriptor()->get_name();
+		if ((file_extension != NULL) &&
+				((auxiliary::strcmp_ignore_case(file_extension, TXT_EXTENSION) == 0) ||
+				(auxiliary::strcmp_ignore_case(file_extension, CSV_EXTENSION) == 0) ||
+				(auxiliary::strcmp_ignore_case(file_extension, HTML_EXTENSION) == 0) ||
+				(auxiliary::strcmp_ignore_case(file_extension, HTM_EXTENSION) == 0))) {
+			auxiliary::transform_file_name(&o_file_name, output_prefix, file_name, suffix, false);
+		} else {
+			auxiliary::transform_file_name(&o_file_name, output_prefix, file_name, suffix, true);
+		}
+	} else {
+		auxiliary::transform_file_name(&o_file_name, output_prefix, file_abbreviation, suffix, true);
+	}
+
+	if (o_file_name == NULL) {
+		throw AnalyzerException("Analyzer", "get_output_file_name( const char* )", __LINE__, 14);
+	}
+
+	return o_file_name;
+}
+
+/*
+ * The partial state file has the partition number and the state extension.
+ */
+char* Analyzer::get_state_file_name(unsigned int partition) throw (AnalyzerException) {
+	char suffix[64];
+
+	sprintf(suffix, "_part%uof%u%s", partition, gwafile->get_partitions(), STATE_EXTENSION);
+
+	return get_output_file_name(suffix);
+}
+
+/*
+ * Writes the state of all columns, which is merged by read_state().
+ */
+void Analyzer::write_state(ostream& stream, unsigned int partition, unsigned int partitions) throw (AnalyzerException) {
+	vector<Meta*>::iterator metas_it;
+	vector<MetaFiltered*>::iterator filtered_metas_it;
+	vector<MetaRatio*>::iterator ratio_metas_it;
+	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector<MetaManhattan*>::iterator manhattan_metas_it;
+	vector< pair<pair<Meta*, Meta*>, int64_t> >::iterator dependencies_it;
+
+	unsigned int header[9];
+	unsigned int name_length = 0;
+
+	header[0] = STATE_VERSION;
+	header[1] = partition;
+	header[2] = partitions;
+	header[3] = metas.size();
+	header[4] = filtered_metas.size();
+	header[5] = ratio_metas.size();
+	header[6] = cross_table_metas.size();
+	header[7] = manhattan_metas.size();
+	header[8] = dependencies.size();
+
+	try {
+		stream.write(STATE_SIGNATURE, 4);
+		stream.write((const char*)header, 9 * sizeof(unsigned int));
+
+		for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+			(*filtered_metas_it)->save_state(stream);
+		}
+
+		for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
+			if ((*metas_it) != NULL) {
+				name_length = strlen((*metas_it)->get_common_name());
+				stream.write((const char*)&name_length, sizeof(unsigned int));
+				stream.write((*metas_it)->get_common_name(), name_length);
+
+				(*metas_it)->save_state(stream);
+			}
+		}
+
+		for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
+			(*ratio_metas_it)->save_state(stream);
+		}
+
+		for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
+			(*cross_table_metas_it)->save_state(stream);
+		}
+
+		for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+			(*manhattan_metas_it)->save_state(stream);
+		}
+
+		for (dependencies_it = dependencies.begin(); dependencies_it != dependencies.end(); dependencies_it++) {
+			stream.write((const char*)&(dependencies_it->second), sizeof(int64_t));
+		}
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "write_state( ostream&, unsigned int, unsigned int )", __LINE__, 25, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+/*
+ * Saves the state of all columns accumulated in the current partition. The state must be saved instead of finalize_processing().
+ */
+void Analyzer::save_state(char** state_path) throw (AnalyzerException) {
+	char* o_statefile_name = NULL;
+	ofstream o_statefile_stream;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	if ((!gwafile->is_partition_on()) || (gwafile->get_partition() == 0)) {
+		throw AnalyzerException("Analyzer", "save_state( char** )", __LINE__, 1, "partition");
+	}
+
+	o_statefile_name = get_state_file_name(gwafile->get_partition());
+
+	o_statefile_stream.open(o_statefile_name, ios::binary);
+	if (o_statefile_stream.fail()) {
+		AnalyzerException new_e("Analyzer", "save_state( char** )", __LINE__, 15, o_statefile_name);
+		free(o_statefile_name);
+		throw new_e;
+	}
+
+	try {
+		write_state(o_statefile_stream, gwafile->get_partition(), gwafile->get_partitions());
+
+		o_statefile_stream.flush();
+		if (o_statefile_stream.fail()) {
+			throw AnalyzerException("Analyzer", "save_state( char** )", __LINE__, 17, o_statefile_name);
+		}
+
+		o_statefile_stream.close();
+		if (o_statefile_stream.fail()) {
+			throw AnalyzerException("Analyzer", "save_state( char** )", __LINE__, 16, o_statefile_name);
+		}
+	} catch (AnalyzerException &e) {
+		e.add_message("Analyzer", "save_state( char** )", __LINE__, 25, gwafile->get_descriptor()->get_full_path());
+		free(o_statefile_name);
+		throw;
+	}
+
+	*state_path = o_statefile_name;
+}
+
+/*
+ * Merges the saved results of the unchanged GWAS file, which was processed with the same settings, instead of reading its data.
+ * Returns false if there are no such results; then the results are saved by save_results() after reading the data.
+ */
+bool Analyzer::load_results() throw (AnalyzerException) {
+	char* i_resultfile_name = NULL;
+	ifstream i_resultfile_stream;
+
+	try {
+		results.identify(gwafile->get_descriptor()->get_full_path(), gwafile->get_descriptor()->get_settings_hash(), STATE_VERSION);
+	} catch (GwaCacheException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "load_results()", __LINE__, 29, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+
+	i_resultfile_name = get_output_file_name(RESULTS_EXTENSION);
+
+	if (!results.load(i_resultfile_name, i_resultfile_stream)) {
+		free(i_resultfile_name);
+		return false;
+	}
+
+	try {
+		read_state(i_resultfile_stream, i_resultfile_name, 0, 0);
+	} catch (AnalyzerException &e) {
+		i_resultfile_stream.close();
+		e.add_message("Analyzer", "load_results()", __LINE__, 29, gwafile->get_descriptor()->get_full_path());
+		free(i_resultfile_name);
+		throw;
+	}
+
+	i_resultfile_stream.close();
+
+	free(i_resultfile_name);
+	i_resultfile_name = NULL;
+
+	return true;
+}
+
+void Analyzer::save_results() throw (AnalyzerException) {
+	char* o_resultfile_name = NULL;
+	ofstream o_resultfile_stream;
+
+	o_resultfile_name = get_output_file_name(RESULTS_EXTENSION);
+
+	try {
+		results.create(o_resultfile_name, o_resultfile_stream);
+		write_state(o_resultfile_stream, 0, 0);
+		results.complete(o_resultfile_name, o_resultfile_stream);
+	} catch (GwaCacheException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "save_results()", __LINE__, 28, gwafile->get_descriptor()->get_full_path());
+		free(o_resultfile_name);
+		throw new_e;
+	} catch (AnalyzerException &e) {
+		e.add_message("Analyzer", "save_results()", __LINE__, 28, gwafile->get_descriptor()->get_full_path());
+		free(o_resultfile_name);
+		throw;
+	}
+
+	free(o_resultfile_name);
+	o_resultfile_name = NULL;
+}
+
+void Analyzer::process_cache() throw (AnalyzerException) {
+	char** tokens = NULL;
+	unsigned int rows_number = cache.get_rows_number();
+	unsigned int columns_number = cache.get_columns_number();
+
+	tokens = (char**)malloc(columns_number * sizeof(char*));
+	if (tokens == NULL) {
+		throw AnalyzerException("Analyzer", "process_cache()", __LINE__, 2, columns_number * sizeof(char*));
+	}
+
+	try {
+		for (unsigned int row = 0; row < rows_number; row++) {
+			cache.get_row(row, tokens);
+			process_row(tokens, columns_number, row + 1);
+		}
+
+		complete_data();
+	} catch (AnalyzerException &e) {
+		free(tokens);
+		throw;
+	}
+
+	free(tokens);
+}
+
+void Analyzer::process_row(char** tokens, unsigned int tokens_number, uint64_t line_number) throw (AnalyzerException) {
+	column_handler* column = NULL;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	if (tokens_number != column_plan.size()) {
+		throw AnalyzerException("Analyzer", "process_row( char**, unsigned int, uint64_t )", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
+	}
+
+	try {
+		for (unsigned int i = 0; i < tokens_number; i++) {
+			column = &column_plan[i];
+			if (column->meta != NULL) {
+				column->put(column->meta, tokens[i]);
+			}
+		}
+
+		complete_row();
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "process_row( char**, unsigned int, uint64_t )", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+void Analyzer::complete_data() throw (AnalyzerException) {
+	if (gwafile == NULL) {
+		return;
+	}
+
+	try {
+		flush_blocks();
+		block_rows = 0;
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "complete_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+void Analyzer::complete_row() throw (MetaException) {
+	vector<MetaFiltered*>::iterator filtered_metas_it;
+	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector<MetaManhattan*>::iterator manhattan_metas_it;
+	vector< pair<pair<Meta*, Meta*>, int64_t> >::iterator dependencies_it;
+
+	for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+		(*filtered_metas_it)->put(NULL);
+	}
+
+	block_rows += 1;
+	if (block_rows == MetaFiltered::BLOCK_SIZE) {
+		flush_blocks();
+		block_rows = 0;
+	}
+
+	for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
+		(*cross_table_metas_it)->put(NULL);
+	}
+
+	for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+		(*manhattan_metas_it)->put(NULL);
+	}
+
+	for (dependencies_it = dependencies.begin(); dependencies_it != dependencies.end(); dependencies_it++) {
+		if (!dependencies_it->first.first->is_na() && dependencies_it->first.second->is_na()) {
+			dependencies_it->second += 1;
+		}
+	}
+}
+
+void Analyzer::flush_blocks() throw (MetaException) {
+	vector<MetaFiltered*>::iterator filtered_metas_it;
+	vector<MetaRatio*>::iterator ratio_metas_it;
+
+	for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+		(*filtered_metas_it)->flush();
+	}
+
+	for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
+		(*ratio_metas_it)->flush();
+	}
+}
+
+void Analyzer::finalize_processing() throw (AnalyzerException) {
+	vector<Meta*>::iterator metas_it;
+	vector<MetaFiltered*>::iterator filtered_metas_it;
+	vector<MetaRatio*>::iterator ratio_metas_it;
+	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector<MetaManhattan*>::iterator manhattan_metas_it;
+	vector<Meta*> columns;
+	vector<Meta*> sources;
+	vector<Meta*> shared_sources;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	if (low_memory) {
+		refine_data();
+	}
+
+	try {
+		for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
+			if ((*metas_it) != NULL) {
+				if (strcmp((*metas_it)->get_common_name(), Descriptor::MARKER) == 0) {
+					(*metas_it)->finalize();
+					if (((MetaUniqueness*)(*metas_it))->is_verification_required()) {
+						verify_duplicates((MetaUniqueness*)(*metas_it));
+					}
+				}
+			}
+		}
+
+		/* The filtered columns read the values of their sources, which are released when the sources are finalized. */
+		for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+			columns.push_back(*filtered_metas_it);
+			if (find(sources.begin(), sources.end(), (*filtered_metas_it)->get_source()) == sources.end()) {
+				sources.push_back((*filtered_metas_it)->get_source());
+			} else if (find(shared_sources.begin(), shared_sources.end(), (*filtered_metas_it)->get_source()) == shared_sources.end()) {
+				shared_sources.push_back((*filtered_metas_it)->get_source());
+			}
+		}
+
+		/* The sources with several filtered subsets are sorted once, and the subsets are taken from them in the sorted order. */
+		finalize_columns(shared_sources, true);
+
+		for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
+			columns.push_back(*ratio_metas_it);
+		}
+
+		for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
+			columns.push_back(*cross_table_metas_it);
+		}
 
-					continue;
-				}
+		for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+			columns.push_back(*manhattan_metas_it);
+		}
 
-				if (gwafile->is_case_sensitive()) {
-					for (vector_char_it = missing_columns.begin(); vector_char_it != missing_columns.end(); vector_char_it++) {
-						if (strcmp(*vector_char_it, token) == 0) {
-							free(*vector_char_it);
-							missing_columns.erase(vector_char_it);
-							break;
-						}
-					}
-				} else {
-					for (vector_char_it = missing_columns.begin(); vector_char_it != missing_columns.end(); vector_char_it++) {
-						if (auxiliary::strcmp_ignore_case(*vector_char_it, token) == 0) {
-							free(*vector_char_it);
-							missing_columns.erase(vector_char_it);
-							break;
-						}
-					}
+		for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
+			if ((*metas_it) != NULL) {
+				if ((strcmp((*metas_it)->get_common_name(), Descriptor::MARKER) != 0) && (find(sources.begin(), sources.end(), *metas_it) == sources.end())) {
+					columns.push_back(*metas_it);
 				}
+			}
+		}
 
-				meta->set_common_name(column_name);
-				meta->set_actual_name(token);
-				meta->set_id(column_position);
-				meta->set_na_marker(descriptor->get_property(Descriptor::MISSING));
+		finalize_columns(columns);
 
-				metas.push_back(meta);
-			} else {
-				column_name_copy = (char*)malloc((strlen(token) + 1) * sizeof(char));
-				if (column_name_copy == NULL) {
-					throw AnalyzerException("Analyzer", "process_header()", __LINE__, 2, (strlen(token) + 1) * sizeof(char));
+		columns.clear();
+		for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
+			if ((*metas_it) != NULL) {
+				if ((strcmp((*metas_it)->get_common_name(), Descriptor::MARKER) != 0) && (find(sources.begin(), sources.end(), *metas_it) != sources.end())) {
+					columns.push_back(*metas_it);
 				}
-				strcpy(column_name_copy, token);
-				not_required_columns.push_back(column_name_copy);
-				metas.push_back(NULL);
 			}
-
-			token = auxiliary::strtok(&header, header_separator);
-			column_position += 1;
 		}
-	} catch (DescriptorException &e) {
-		AnalyzerException new_e(e);
-		new_e.add_message("Analyzer", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
-		throw new_e;
-	} catch (MetaException &e) {
+
+		finalize_columns(columns);
+	} catch (Exception &e) {
 		AnalyzerException new_e(e);
-		new_e.add_message("Analyzer", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
+		new_e.add_message("Analyzer", "finalize_processing()", __LINE__, 10, gwafile->get_descriptor()->get_full_path());
 		throw new_e;
-	} catch (AnalyzerException &e) {
-		e.add_message("Analyzer", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
-		throw;
 	}
 }
 
+/*
+ * Finalizes the independent columns on gwafile->get_threads() workers, one of which is the calling thread.
+ * If a worker can't be started, the other workers finalize its columns.
+ */
+void Analyzer::finalize_columns(vector<Meta*>& columns, bool sorting) throw (AnalyzerException) {
+	finalize_queue queue;
+	vector<pthread_t> workers;
+	vector<pthread_t>::iterator workers_it;
+	pthread_t worker;
+	unsigned int threads = gwafile->get_threads();
+
+	if (threads > columns.size()) {
+		threads = columns.size();
+	}
+
+	queue.columns = &columns;
+	queue.sorting = sorting;
+	queue.next = 0;
+	queue.error = NULL;
+	pthread_mutex_init(&queue.mutex, NULL);
 
-void Analyzer::process_data() throw (AnalyzerException) {
+	for (unsigned int i = 1; i < threads; i++) {
+		if (pthread_create(&worker, NULL, run_finalize_worker, &queue) != 0) {
+			break;
+		}
+		workers.push_back(worker);
+	}
+
+	run_finalize_worker(&queue);
+
+	for (workers_it = workers.begin(); workers_it != workers.end(); workers_it++) {
+		pthread_join(*workers_it, NULL);
+	}
+
+	pthread_mutex_destroy(&queue.mutex);
+
+	if (queue.error != NULL) {
+		AnalyzerException e(*queue.error);
+		delete queue.error;
+		throw e;
+	}
+}
+
+void* Analyzer::run_finalize_worker(void* queue) {
+	finalize_queue* self = (finalize_queue*)queue;
+	Meta* column = NULL;
+
+	while (true) {
+		pthread_mutex_lock(&self->mutex);
+		if ((self->error != NULL) || (self->next >= self->columns->size())) {
+			pthread_mutex_unlock(&self->mutex);
+			break;
+		}
+		column = self->columns->at(self->next);
+		self->next += 1;
+		pthread_mutex_unlock(&self->mutex);
+
+		try {
+			if (self->sorting) {
+				((MetaNumeric*)column)->sort_order();
+			} else {
+				column->finalize();
+			}
+		} catch (Exception &e) {
+			pthread_mutex_lock(&self->mutex);
+			if (self->error == NULL) {
+				self->error = new AnalyzerException(e);
+			}
+			pthread_mutex_unlock(&self->mutex);
+		} catch (std::bad_alloc &e) {
+			pthread_mutex_lock(&self->mutex);
+			if (self->error == NULL) {
+				self->error = new AnalyzerException("Analyzer", "run_finalize_worker( void* )", __LINE__, 2, 0);
+			}
+			pthread_mutex_unlock(&self->mutex);
+		}
+	}
+
+	return NULL;
+}
+
+void Analyzer::verify_duplicates(MetaUniqueness* meta) throw (AnalyzerException) {
 	char* line = NULL;
-	int line_length = 0;
-	unsigned int line_number = 1;
 	char* token = NULL;
 	char data_separator = '\0';
-	unsigned int column_number = 0;
-	unsigned int total_columns = 0;
-
-	Meta* meta = NULL;
-
-	vector<MetaFiltered*>::iterator filtered_metas_it;
-	vector<MetaRatio*>::iterator ratio_metas_it;
-	vector<MetaCrossTable*>::iterator cross_table_metas_it;
-	vector< pair<pair<Meta*, Meta*>, int> >::iterator dependencies_it;
+	int marker_column = 0;
+	int column_number = 0;
 
 	if (gwafile == NULL) {
 		return;
 	}
 
 	data_separator = gwafile->get_data_separator();
-	total_columns = metas.size();
+	marker_column = meta->get_id();
 
 	try {
-		while ((line_length = reader->read_line()) > 0) {
-			column_number = 0;
-			line = *(reader->line);
-			while ((token = auxiliary::strtok(&line, data_separator)) != NULL) {
-				if ((meta = metas.at(column_number)) != NULL) {
-					auxiliary::trim(&token);
-					meta->put(token);
-				}
-				column_number += 1;
-			}
-
-			if (column_number != total_columns) {
-				throw AnalyzerException("Analyzer", "process_data()", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
+		if (cache.is_open()) {
+			for (unsigned int row = 0; row < cache.get_rows_number(); row++) {
+				meta->verify(cache.get_value(row, marker_column));
 			}
 
-			for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
-				(*filtered_metas_it)->put(NULL);
-			}
+			meta->finalize_verification();
+			return;
+		}
 
-			for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
-				(*ratio_metas_it)->put(NULL);
-			}
+		reader->reset();
 
-			for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
-				(*cross_table_metas_it)->put(NULL);
-			}
+		if (reader->read_line() <= 0) {
+			throw AnalyzerException("Analyzer", "verify_duplicates( MetaUniqueness* )", __LINE__, 5, gwafile->get_descriptor()->get_full_path());
+		}
 
-			for (dependencies_it = dependencies.begin(); dependencies_it != dependencies.end(); dependencies_it++) {
-				if (!dependencies_it->first.first->is_na() && dependencies_it->first.second->is_na()) {
-					dependencies_it->second += 1;
+		while (reader->read_line() > 0) {
+			column_number = 0;
+			line = *(reader->line);
+			while ((token = auxiliary::strtok(&line, data_separator)) != NULL) {
+				if (column_number == marker_column) {
+					auxiliary::trim(&token);
+					meta->verify(token);
+					break;
 				}
+				column_number += 1;
 			}
-
-			line_number += 1;
 		}
 
-		if (line_length == 0) {
-			throw AnalyzerException("Analyzer", "process_data()", __LINE__, 13, line_number, gwafile->get_descriptor()->get_full_path());
-		}
+		meta->finalize_verification();
 	} catch (ReaderException &e) {
 		AnalyzerException new_e(e);
-		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		new_e.add_message("Analyzer", "verify_duplicates( MetaUniqueness* )", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
 		throw new_e;
 	} catch (MetaException &e) {
 		AnalyzerException new_e(e);
-		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
-		throw new_e;
-	} catch (AnalyzerException &e) {
-		e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
-		throw;
-	} catch (std::out_of_range &e) {
-		AnalyzerException new_e("Analyzer", "process_data()", __LINE__, 12, line_number, gwafile->get_descriptor()->get_full_path());
-		new_e.add_message("Analyzer", "process_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		new_e.add_message("Analyzer", "verify_duplicates( MetaUniqueness* )", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
 		throw new_e;
 	}
 }
 
-void Analyzer::finalize_processing() throw (AnalyzerException) {
-	vector<Meta*>::iterator metas_it;
+/*
+ * The second pass of the low-memory mode. Only the numeric columns and the filtered columns, which depend on them,
+ * receive the data again; the other columns are already complete.
+ */
+void Analyzer::refine_data() throw (AnalyzerException) {
+	vector<MetaNumeric*>::iterator numeric_metas_it;
 	vector<MetaFiltered*>::iterator filtered_metas_it;
-	vector<MetaRatio*>::iterator ratio_metas_it;
-	vector<MetaCrossTable*>::iterator cross_table_metas_it;
+	vector<MetaNumeric*> columns(metas.size(), (MetaNumeric*)NULL);
+	char* line = NULL;
+	char* token = NULL;
+	char data_separator = '\0';
+	unsigned int column_number = 0;
+	unsigned int total_columns = metas.size();
+	unsigned int rows = 0;
 
 	if (gwafile == NULL) {
 		return;
 	}
 
+	data_separator = gwafile->get_data_separator();
+
 	try {
-		for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
-			if ((*metas_it) != NULL) {
-				if (strcmp((*metas_it)->get_common_name(), Descriptor::MARKER) == 0) {
-					(*metas_it)->finalize();
-				}
-			}
+		for (numeric_metas_it = numeric_metas.begin(); numeric_metas_it != numeric_metas.end(); numeric_metas_it++) {
+			(*numeric_metas_it)->begin_refinement();
+			columns[(*numeric_metas_it)->get_id()] = *numeric_metas_it;
 		}
 
-		for (ratio_metas_it = ratio_metas.begin(); ratio_metas_it != ratio_metas.end(); ratio_metas_it++) {
-			(*ratio_metas_it)->finalize();
+		for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+			(*filtered_metas_it)->begin_refinement();
 		}
 
-		for (cross_table_metas_it = cross_table_metas.begin(); cross_table_metas_it != cross_table_metas.end(); cross_table_metas_it++) {
-			(*cross_table_metas_it)->finalize();
-		}
+		if (cache.is_open()) {
+			for (unsigned int row = 0; row < cache.get_rows_number(); row++) {
+				for (column_number = 0; column_number < total_columns; column_number++) {
+					if (columns[column_number] != NULL) {
+						columns[column_number]->put(cache.get_value(row, column_number));
+					}
+				}
 
-		for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
-			(*filtered_metas_it)->finalize();
-		}
+				for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+					(*filtered_metas_it)->put(NULL);
+				}
 
-		for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
-			if ((*metas_it) != NULL) {
-				if (strcmp((*metas_it)->get_common_name(), Descriptor::MARKER) != 0) {
-					(*metas_it)->finalize();
+				rows += 1;
+				if (rows == MetaFiltered::BLOCK_SIZE) {
+					for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+						(*filtered_metas_it)->flush();
+					}
+					rows = 0;
+				}
+			}
+		} else {
+			reader->reset();
+
+			if (reader->read_line() <= 0) {
+				throw AnalyzerException("Analyzer", "refine_data()", __LINE__, 5, gwafile->get_descriptor()->get_full_path());
+			}
+
+			while (reader->read_line() > 0) {
+				column_number = 0;
+				line = *(reader->line);
+				while (((token = auxiliary::strtok(&line, data_separator)) != NULL) && (column_number < total_columns)) {
+					if (columns[column_number] != NULL) {
+						auxiliary::trim(&token);
+						columns[column_number]->put(token);
+					}
+					column_number += 1;
+				}
+
+				for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+					(*filtered_metas_it)->put(NULL);
+				}
+
+				rows += 1;
+				if (rows == MetaFiltered::BLOCK_SIZE) {
+					for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+						(*filtered_metas_it)->flush();
+					}
+					rows = 0;
 				}
 			}
 		}
-	} catch (Exception &e) {
+
+		for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+			(*filtered_metas_it)->flush();
+		}
+	} catch (ReaderException &e) {
 		AnalyzerException new_e(e);
-		new_e.add_message("Analyzer", "finalize_processing()", __LINE__, 10, gwafile->get_descriptor()->get_full_path());
+		new_e.add_message("Analyzer", "refine_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	} catch (MetaException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "refine_data()", __LINE__, 11, gwafile->get_descriptor()->get_full_path());
 		throw new_e;
 	}
 }
 
+unsigned int Analyzer::get_sampled_rows() {
+	return sampled_rows;
+}
+
 double Analyzer::get_memory_usage() {
 	vector<Meta*>::iterator metas_it;
 	vector<MetaFiltered*>::iterator filtered_metas_it;
 	vector<MetaRatio*>::iterator ratio_metas_it;
 	vector<MetaCrossTable*>::iterator cross_table_meta_it;
+	vector<MetaManhattan*>::iterator manhattan_meta_it;
 
 	double memory_usage = 0.0;
 
@@ -585,6 +1674,10 @@ double Analyzer::get_memory_usage() {
 		memory_usage += (*cross_table_meta_it)->get_memory_usage();
 	}
 
+	for (manhattan_meta_it = manhattan_metas.begin(); manhattan_meta_it != manhattan_metas.end(); manhattan_meta_it++) {
+		memory_usage += (*manhattan_meta_it)->get_memory_usage();
+	}
+
 	return memory_usage;
 }
 
@@ -609,7 +1702,7 @@ void Analyzer::initialize_column_dependencies() {
 				}
 
 				if ((left_dependant != NULL) && (right_dependant != NULL)) {
-					dependencies.push_back(pair<pair<Meta*, Meta*>, int>(pair<Meta*, Meta*>(left_dependant, right_dependant), 0));
+					dependencies.push_back(pair<pair<Meta*, Meta*>, int64_t>(pair<Meta*, Meta*>(left_dependant, right_dependant), 0));
 					break;
 				}
 			}
@@ -621,6 +1714,7 @@ void Analyzer::initialize_column_dependencies() {
 }
 void Analyzer::initialize_filtered_columns() throw (AnalyzerException) {
 	vector<MetaNumeric*>::iterator numeric_metas_it;
+	vector<MetaFiltered*>::iterator filtered_metas_it;
 	MetaFiltered* filtered_meta = NULL;
 	vector<double>* maf_levels = NULL;
 	vector<double>* imp_levels = NULL;
@@ -869,6 +1963,12 @@ void Analyzer::initialize_filtered_columns() throw (AnalyzerException) {
 			filtered_metas.push_back(filtered_meta);
 			plots.push_back(filtered_meta);
 		}
+
+		if (low_memory) {
+			for (filtered_metas_it = filtered_metas.begin(); filtered_metas_it != filtered_metas.end(); filtered_metas_it++) {
+				(*filtered_metas_it)->set_low_memory(true);
+			}
+		}
 	} catch (Exception &e) {
 		AnalyzerException new_e(e);
 		new_e.add_message("Analyzer", "initialize_filtered_columns()", __LINE__, 8, gwafile->get_descriptor()->get_full_path());
@@ -881,10 +1981,15 @@ void Analyzer::initialize_columns_ratios() throw (AnalyzerException) {
 	MetaFiltered* effect_hq = NULL;
 	MetaFiltered* se_hq = NULL;
 	vector<MetaNumeric*>::iterator numeric_metas_it;
+	vector<Meta*>::iterator metas_it;
 	MetaNumeric* imputed = NULL;
 	MetaNumeric* used_for_imp = NULL;
+	MetaNumeric* pvalue = NULL;
+	MetaGroup* chr = NULL;
+	MetaFormat* position = NULL;
 	MetaRatio* ratio_meta = NULL;
 	MetaCrossTable* cross_table_meta = NULL;
+	MetaManhattan* manhattan_meta = NULL;
 
 	unsigned int heap_size = 0;
 
@@ -914,11 +2019,23 @@ void Analyzer::initialize_columns_ratios() throw (AnalyzerException) {
 				imputed = *numeric_metas_it;
 			} else if (strcmp((*numeric_metas_it)->get_common_name(), Descriptor::USED_FOR_IMP) == 0) {
 				used_for_imp = *numeric_metas_it;
+			} else if (strcmp((*numeric_metas_it)->get_common_name(), Descriptor::PVALUE) == 0) {
+				pvalue = *numeric_metas_it;
 			}
 		}
 		numeric_metas_it++;
 	}
 
+	for (metas_it = metas.begin(); metas_it != metas.end(); metas_it++) {
+		if (*metas_it != NULL) {
+			if (strcmp((*metas_it)->get_common_name(), Descriptor::CHR) == 0) {
+				chr = (MetaGroup*)*metas_it;
+			} else if (strcmp((*metas_it)->get_common_name(), Descriptor::POSITION) == 0) {
+				position = (MetaFormat*)*metas_it;
+			}
+		}
+	}
+
 	try {
 		if ((effect_hq != NULL) && (se_hq != NULL)) {
 			ratio_meta = new MetaRatio(effect_hq, se_hq, heap_size);
@@ -930,6 +2047,12 @@ void Analyzer::initialize_columns_ratios() throw (AnalyzerException) {
 			cross_table_meta->set_full_name("SNPs used for imputation vs. imputed SNPs");
 			cross_table_metas.push_back(cross_table_meta);
 		}
+
+		if ((chr != NULL) && (position != NULL) && (pvalue != NULL)) {
+			manhattan_meta = new MetaManhattan(chr, position, pvalue);
+			manhattan_meta->set_full_name("Manhattan plot");
+			manhattan_metas.push_back(manhattan_meta);
+		}
 	} catch (Exception &e) {
 		AnalyzerException new_e(e);
 		new_e.add_message("Analyzer", "initialize_columns_ratios()", __LINE__, 9, gwafile->get_descriptor()->get_full_path());
@@ -981,12 +2104,15 @@ void Analyzer::print_txt_report() throw (AnalyzerException) {
 	}
 
 	try {
-		time_t system_time = time(NULL);
+		char current_time[32];
 
 		const char* version = "Version     : ";
 		const char* scanned = "File scanned: ";
 		const char* date = "Date        : ";
-		char* current_time = strtok(asctime(localtime(&system_time)), "\n");
+		const char* preview = "Preview     : ";
+		char sample[64];
+
+		auxiliary::format_time(time(NULL), current_time);
 
 		unsigned int section = 0, subsection = 0;
 		bool print = true;
@@ -994,7 +2120,8 @@ void Analyzer::print_txt_report() throw (AnalyzerException) {
 		vector<Meta*>::iterator metas_it;
 		vector<MetaNumeric*>::iterator numeric_metas_it;
 		vector<MetaCrossTable*>::iterator cross_table_metas_it;
-		vector< pair<pair<Meta*, Meta*>, int> >::iterator dependency_it;
+		vector<MetaManhattan*>::iterator manhattan_metas_it;
+		vector< pair<pair<Meta*, Meta*>, int64_t> >::iterator dependency_it;
 		vector<char*>::iterator vector_char_it;
 
 		o_textfile_stream << "# " << setfill('-') << setw(76) << " #" << endl;
@@ -1003,6 +2130,10 @@ void Analyzer::print_txt_report() throw (AnalyzerException) {
 		o_textfile_stream << "# " << setfill(' ') << setw(76) << " #" << endl;
 		o_textfile_stream << "# " << scanned << gwafile->get_descriptor()->get_name() << setfill(' ') << setw(76 - strlen(scanned) - strlen(gwafile->get_descriptor()->get_name())) << " #" << endl;
 		o_textfile_stream << "# " << date << current_time << setfill(' ') << setw(76 - strlen(date) - strlen(current_time)) << " #" << endl;
+		if (sampled_rows > 0) {
+			sprintf(sample, "approximate, %u sampled rows", sampled_rows);
+			o_textfile_stream << "# " << preview << sample << setfill(' ') << setw(76 - strlen(preview) - strlen(sample)) << " #" << endl;
+		}
 		o_textfile_stream << "# " << setfill(' ') << setw(76) << " #" << endl;
 		o_textfile_stream << "# " << setfill('-') << setw(76) << " #" << endl;
 
@@ -1303,6 +2434,15 @@ void Analyzer::print_txt_report() throw (AnalyzerException) {
 			o_textfile_stream << endl;
 		}
 
+		for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+			subsection += 1;
+			o_textfile_stream << section << "." << subsection << ")";
+			o_textfile_stream << " " << (*manhattan_metas_it)->get_full_name() << endl;
+			o_textfile_stream << endl;
+			(*manhattan_metas_it)->print(o_textfile_stream);
+			o_textfile_stream << endl;
+		}
+
 		o_textfile_stream << "# " << setfill('-') << setw(76) << " #" << endl;
 		o_textfile_stream << endl;
 
@@ -1758,6 +2898,18 @@ void Analyzer::print_csv_report() throw (AnalyzerException) {
 
 		o_csvfile_stream << endl;
 		/*****************************************************************************/
+
+		/* Preview mode: the number of sampled rows the statistics are based on. Kept last to preserve the rows order. */
+		if (sampled_rows > 0) {
+			o_csvfile_stream << "Sampled";
+			for (int i = 0; i < CSV_COLUMNS_SIZE; i++) {
+				o_csvfile_stream << separator << sampled_rows;
+			}
+			for (unsigned int j = 0; j < MetaRatio::SLICES_CNT; j++) {
+				o_csvfile_stream << separator << sampled_rows;
+			}
+			o_csvfile_stream << endl;
+		}
 	} catch (ofstream::failure &e) {
 		throw AnalyzerException("Analyzer", "print_csv_report()", __LINE__, 17, o_csvfile_name);
 	}
@@ -1782,6 +2934,7 @@ void Analyzer::create_plots(vector<Plot*>& plots) throw (AnalyzerException) {
 	const char* column_name = NULL;
 	Plottable* plottable = NULL;
 	vector<Plottable*>::iterator plottable_it;
+	vector<MetaManhattan*>::iterator manhattan_metas_it;
 
 	if (gwafile == NULL) {
 		return;
@@ -1855,6 +3008,33 @@ void Analyzer::create_plots(vector<Plot*>& plots) throw (AnalyzerException) {
 				}
 			}
 		}
+
+		for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+			plottable = *manhattan_metas_it;
+			if (!plottable->is_plottable()) {
+				continue;
+			}
+
+			plot = new Plot();
+			plots.push_back(plot);
+
+			if (file_abbreviation != NULL) {
+				plot->set_formatted_name("%s%s_manhattan", output_prefix, file_abbreviation);
+			} else if ((file_extension != NULL) &&
+					((auxiliary::strcmp_ignore_case(file_extension, TXT_EXTENSION) == 0) ||
+						(auxiliary::strcmp_ignore_case(file_extension, CSV_EXTENSION) == 0) ||
+							(auxiliary::strcmp_ignore_case(file_extension, HTML_EXTENSION) == 0) ||
+								(auxiliary::strcmp_ignore_case(file_extension, HTM_EXTENSION) == 0))) {
+				plot->set_formatted_name("%s%.*s_manhattan", output_prefix, file_extension - file_name, file_name);
+			} else {
+				plot->set_formatted_name("%s%s_manhattan", output_prefix, file_name);
+			}
+			plot->set_formatted_title("Manhattan plot of %s", descriptor->get_column(Descriptor::PVALUE));
+
+			plot->add_manhattan(plottable->get_manhattan());
+
+			plottable->set_plot(plot);
+		}
 	} catch (Exception &e) {
 		AnalyzerException new_e(e);
 		new_e.add_message("Analyzer", "create_plots( vector<Plot*>& )", __LINE__);
@@ -2031,6 +3211,25 @@ void Analyzer::create_combined_boxplots(vector<Plot*>& plots) throw (AnalyzerExc
 	}
 }
 
+/*
+ * Renders the plots to PNG files on gwafile->get_threads() workers, if RASTER ON was specified.
+ * The rendered plots are removed from the vector, so that only the plots left in it are drawn in R.
+ */
+void Analyzer::render_plots(vector<Plot*>& plots) throw (AnalyzerException) {
+	if ((gwafile == NULL) || (!gwafile->is_raster_on())) {
+		return;
+	}
+
+	try {
+		PlotRenderer::render(plots, gwafile->get_threads());
+		plots.clear();
+	} catch (PlotException &e) {
+		AnalyzerException new_e(e);
+		new_e.add_message("Analyzer", "render_plots( vector<Plot*>& )", __LINE__);
+		throw new_e;
+	}
+}
+
 void Analyzer::print_html_report(char** html_report_path, vector<Plot*>& plots, const char* resource_path) throw (AnalyzerException) {
 	const char* output_prefix = NULL;
 	const char* file_name = NULL;
@@ -2160,15 +3359,17 @@ void Analyzer::print_html_report(char** html_report_path, vector<Plot*>& plots,
 	}
 
 	try {
-		time_t system_time = time(NULL);
-		char* current_time = asctime(localtime(&system_time));
+		char current_time[32];
 		unsigned int section = 0, subsection = 0;
 		bool print = true;
 
+		auxiliary::format_time(time(NULL), current_time);
+
 		vector<Meta*>::iterator metas_it;
 		vector<MetaNumeric*>::iterator numeric_metas_it;
 		vector<MetaCrossTable*>::iterator cross_table_metas_it;
-		vector< pair<pair<Meta*, Meta*>, int> >::iterator dependency_it;
+		vector<MetaManhattan*>::iterator manhattan_metas_it;
+		vector< pair<pair<Meta*, Meta*>, int64_t> >::iterator dependency_it;
 		vector<char*>::iterator vector_char_it;
 
 		stringstream string_stream;
@@ -2179,7 +3380,11 @@ void Analyzer::print_html_report(char** html_report_path, vector<Plot*>& plots,
 
 		o_htmlfile_stream << "<div class = \"header\"><div class = \"headertext\">";
 		o_htmlfile_stream << "<h1>"<< VERSION <<"</h1><hr />";
-		o_htmlfile_stream << "<p>" << gwafile->get_descriptor()->get_name() << "<br />" << current_time << "</p>";
+		o_htmlfile_stream << "<p>" << gwafile->get_descriptor()->get_name() << "<br />" << current_time;
+		if (sampled_rows > 0) {
+			o_htmlfile_stream << "<br />Preview: approximate results from " << sampled_rows << " sampled rows";
+		}
+		o_htmlfile_stream << "</p>";
 		o_htmlfile_stream << "</div></div>";
 
 		o_htmlfile_stream << "<div class = \"section\">";
@@ -2541,6 +3746,17 @@ void Analyzer::print_html_report(char** html_report_path, vector<Plot*>& plots,
 			o_htmlfile_stream << "</div>";
 		}
 
+		for (manhattan_metas_it = manhattan_metas.begin(); manhattan_metas_it != manhattan_metas.end(); manhattan_metas_it++) {
+			subsection += 1;
+			o_htmlfile_stream << "<div class = \"subsection\">";
+			o_htmlfile_stream << "<p class = \"subsectionname\">";
+			o_htmlfile_stream << section << "." << subsection << ") " << (*manhattan_metas_it)->get_full_name();
+			o_htmlfile_stream << "</p>";
+			o_htmlfile_stream << "<button onclick=\"minmax(this);\">-</button>";
+			(*manhattan_metas_it)->print_html(o_htmlfile_stream, gwafile->get_descriptor()->get_path_separator());
+			o_htmlfile_stream << "</div>";
+		}
+
 		o_htmlfile_stream << "</div>";
 
 		section += 1;
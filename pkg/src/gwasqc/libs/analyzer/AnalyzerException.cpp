@@ -17,9 +17,14 @@
  * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+#include <inttypes.h>
+
 #include "../../include/analyzer/AnalyzerException.h"
 
-const int AnalyzerException::MESSAGE_TEMPLATES_NUMBER = 21;
+const int AnalyzerException::MESSAGE_TEMPLATES_NUMBER = 30;
 const char* AnalyzerException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
@@ -33,15 +38,24 @@ const char* AnalyzerException::MESSAGE_TEMPLATES[] = {
 /*09*/	"Error while setting columns ratios for '%s' GWAS file.",
 /*10*/	"Error while finalizing computations for '%s' GWAS file.",
 /*11*/	"Error while processing columns in '%s' GWAS file.",
-/*12*/	"Inconsistent number of columns in %d line in '%s' GWAS file.",
-/*13*/	"Line %d is empty in '%s' GWAS file.",
+/*12*/	"Inconsistent number of columns in %" PRIu64 " line in '%s' GWAS file.",
+/*13*/	"Line %" PRIu64 " is empty in '%s' GWAS file.",
 /*14*/	"Error while initializing an output file name.",
 /*15*/	"Error while opening '%s' output file.",
 /*16*/	"Error while closing '%s' output file.",
 /*17*/	"Error while writing '%s' output file.",
 /*18*/	"Error while opening '%s' input file.",
 /*19*/	"Error while closing '%s' input file.",
-/*20*/	"Error while reading '%s' input file."
+/*20*/	"Error while reading '%s' input file.",
+/*21*/	"Error while starting a worker thread (error code %d).",
+/*22*/	"Inconsistent number of columns in one of the lines in '%s' GWAS file.",
+/*23*/	"The '%s' GWAS file can't be split into partitions, because it doesn't support random access (e.g. compressed file).",
+/*24*/	"One of the lines is empty in '%s' GWAS file.",
+/*25*/	"Error while saving the state of '%s' GWAS file.",
+/*26*/	"Error while merging the state from '%s' file.",
+/*27*/	"The '%s' file doesn't contain a compatible state of '%s' GWAS file.",
+/*28*/	"Error while saving the results of '%s' GWAS file for reuse.",
+/*29*/	"Error while reusing the saved results of '%s' GWAS file."
 };
 
 AnalyzerException::AnalyzerException() : Exception() {
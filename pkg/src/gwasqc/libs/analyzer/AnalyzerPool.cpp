@@ -0,0 +1,298 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../include/analyzer/AnalyzerPool.h"
+
+void (GwaFile::*AnalyzerPool::check_functions[])(Descriptor*) = {
+		&GwaFile::check_filters,
+		&GwaFile::check_thresholds,
+		&GwaFile::check_histograms,
+		&GwaFile::check_prefix,
+		&GwaFile::check_casesensitivity,
+		&GwaFile::check_missing_value,
+		&GwaFile::check_separators,
+		&GwaFile::check_filesize,
+		&GwaFile::check_fingerprint,
+		&GwaFile::check_cache,
+		&GwaFile::check_resultcache,
+		&GwaFile::check_preview,
+		&GwaFile::check_partition,
+		&GwaFile::check_lowmemory,
+		&GwaFile::check_raster,
+		&GwaFile::check_threads,
+		&GwaFile::check_verbosity_level
+};
+
+const unsigned int AnalyzerPool::CHECK_FUNCTIONS_CNT = 17;
+
+AnalyzerPool::AnalyzerPool(vector<Descriptor*>& descriptors, const char* resource_path, unsigned int threads) throw (AnalyzerException) :
+	resource_path(resource_path), threads(threads), next_job(0), stopping(false) {
+
+	vector<Descriptor*>::iterator descriptors_it;
+	job* new_job = NULL;
+
+	if (resource_path == NULL) {
+		throw AnalyzerException("AnalyzerPool", "AnalyzerPool( vector<Descriptor*>&, const char*, unsigned int )", __LINE__, 0, "resource_path");
+	}
+
+	if (threads == 0) {
+		throw AnalyzerException("AnalyzerPool", "AnalyzerPool( vector<Descriptor*>&, const char*, unsigned int )", __LINE__, 1, "threads");
+	}
+
+	for (descriptors_it = descriptors.begin(); descriptors_it != descriptors.end(); descriptors_it++) {
+		if (*descriptors_it == NULL) {
+			throw AnalyzerException("AnalyzerPool", "AnalyzerPool( vector<Descriptor*>&, const char*, unsigned int )", __LINE__, 0, "descriptor");
+		}
+
+		new_job = new job();
+		new_job->id = jobs.size();
+		new_job->descriptor = *descriptors_it;
+		new_job->gwafile = NULL;
+		new_job->analyzer = NULL;
+		new_job->html_report_path = NULL;
+		new_job->execution_time = 0.0;
+		new_job->used_memory = 0.0;
+		new_job->error_message = NULL;
+		new_job->taken = false;
+		new_job->state = QUEUED;
+
+		jobs.push_back(new_job);
+	}
+
+	if (this->threads > jobs.size()) {
+		this->threads = jobs.size();
+	}
+
+	pthread_mutex_init(&mutex, NULL);
+	pthread_cond_init(&processed_cond, NULL);
+	pthread_cond_init(&released_cond, NULL);
+}
+
+AnalyzerPool::~AnalyzerPool() {
+	vector<job*>::iterator jobs_it;
+
+	join();
+
+	for (jobs_it = jobs.begin(); jobs_it != jobs.end(); jobs_it++) {
+		close(*jobs_it);
+		free((*jobs_it)->error_message);
+		(*jobs_it)->error_message = NULL;
+		delete *jobs_it;
+	}
+
+	jobs.clear();
+
+	pthread_cond_destroy(&released_cond);
+	pthread_cond_destroy(&processed_cond);
+	pthread_mutex_destroy(&mutex);
+}
+
+double AnalyzerPool::get_wall_time() {
+#ifdef WIN32
+	return GetTickCount() / 1000.0;
+#else
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+
+	return now.tv_sec + now.tv_usec / 1000000.0;
+#endif
+}
+
+void AnalyzerPool::start() throw (AnalyzerException) {
+	pthread_t worker;
+	int status = 0;
+
+	for (unsigned int i = 0; i < threads; i++) {
+		if ((status = pthread_create(&worker, NULL, run_worker, this)) != 0) {
+			throw AnalyzerException("AnalyzerPool", "start()", __LINE__, 21, status);
+		}
+		workers.push_back(worker);
+	}
+}
+
+void* AnalyzerPool::run_worker(void* pool) {
+	AnalyzerPool* self = (AnalyzerPool*)pool;
+	job* current_job = NULL;
+
+	while (true) {
+		pthread_mutex_lock(&self->mutex);
+		if ((self->stopping) || (self->next_job >= self->jobs.size())) {
+			pthread_mutex_unlock(&self->mutex);
+			break;
+		}
+		current_job = self->jobs.at(self->next_job);
+		current_job->state = RUNNING;
+		self->next_job += 1;
+		pthread_mutex_unlock(&self->mutex);
+
+		self->process(current_job);
+
+		pthread_mutex_lock(&self->mutex);
+		current_job->state = PROCESSED;
+		pthread_cond_broadcast(&self->processed_cond);
+		while ((current_job->state != RELEASED) && (!self->stopping)) {
+			pthread_cond_wait(&self->released_cond, &self->mutex);
+		}
+		pthread_mutex_unlock(&self->mutex);
+
+		self->close(current_job);
+
+		pthread_mutex_lock(&self->mutex);
+		current_job->state = DONE;
+		pthread_mutex_unlock(&self->mutex);
+	}
+
+	return NULL;
+}
+
+void AnalyzerPool::process(job* current_job) {
+	double start_time = get_wall_time();
+
+	try {
+		current_job->analyzer = new Analyzer();
+		current_job->gwafile = new GwaFile(current_job->descriptor, check_functions, CHECK_FUNCTIONS_CNT);
+
+		current_job->analyzer->open_gwafile(current_job->gwafile);
+
+		current_job->analyzer->process_header();
+
+		current_job->analyzer->initialize_column_dependencies();
+		current_job->analyzer->initialize_filtered_columns();
+		current_job->analyzer->initialize_columns_ratios();
+
+		current_job->analyzer->process_data();
+
+		current_job->used_memory = current_job->analyzer->get_memory_usage();
+
+		/* a partition only saves its partial state, which is reported after merging */
+		if ((current_job->gwafile->is_partition_on()) && (current_job->gwafile->get_partition() > 0)) {
+			current_job->analyzer->save_state(&current_job->html_report_path);
+			current_job->execution_time = get_wall_time() - start_time;
+			return;
+		}
+
+		current_job->analyzer->finalize_processing();
+
+		current_job->analyzer->create_plots(current_job->single_file_plots);
+		current_job->analyzer->create_combined_qqplots(current_job->single_file_plots);
+		current_job->analyzer->create_combined_boxplots(current_job->combined_boxplots);
+
+		current_job->analyzer->print_txt_report();
+		current_job->analyzer->print_csv_report();
+		current_job->analyzer->print_html_report(&current_job->html_report_path, current_job->single_file_plots, resource_path);
+
+		current_job->analyzer->render_plots(current_job->single_file_plots);
+	} catch (Exception &e) {
+		current_job->error_message = (char*)malloc((strlen(e.what()) + 1) * sizeof(char));
+		if (current_job->error_message != NULL) {
+			strcpy(current_job->error_message, e.what());
+		}
+	} catch (std::bad_alloc &e) {
+		current_job->error_message = (char*)malloc((strlen(e.what()) + 1) * sizeof(char));
+		if (current_job->error_message != NULL) {
+			strcpy(current_job->error_message, e.what());
+		}
+	}
+
+	current_job->execution_time = get_wall_time() - start_time;
+}
+
+void AnalyzerPool::close(job* current_job) {
+	if (current_job->analyzer != NULL) {
+		try {
+			current_job->analyzer->close_gwafile();
+		} catch (Exception &e) {
+			if (current_job->error_message == NULL) {
+				current_job->error_message = (char*)malloc((strlen(e.what()) + 1) * sizeof(char));
+				if (current_job->error_message != NULL) {
+					strcpy(current_job->error_message, e.what());
+				}
+			}
+		}
+
+		delete current_job->analyzer;
+		current_job->analyzer = NULL;
+	}
+
+	if (current_job->gwafile != NULL) {
+		delete current_job->gwafile;
+		current_job->gwafile = NULL;
+	}
+
+	current_job->single_file_plots.clear();
+	current_job->combined_boxplots.clear();
+}
+
+AnalyzerPool::job* AnalyzerPool::wait_processed() {
+	vector<job*>::iterator jobs_it;
+	job* processed_job = NULL;
+	bool pending = false;
+
+	pthread_mutex_lock(&mutex);
+	while (true) {
+		pending = false;
+		for (jobs_it = jobs.begin(); jobs_it != jobs.end(); jobs_it++) {
+			if (!(*jobs_it)->taken) {
+				pending = true;
+				if ((*jobs_it)->state == PROCESSED) {
+					processed_job = *jobs_it;
+					processed_job->taken = true;
+					break;
+				}
+			}
+		}
+
+		if ((processed_job != NULL) || (!pending)) {
+			break;
+		}
+
+		pthread_cond_wait(&processed_cond, &mutex);
+	}
+	pthread_mutex_unlock(&mutex);
+
+	return processed_job;
+}
+
+void AnalyzerPool::release(job* processed_job) {
+	if (processed_job == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&mutex);
+	processed_job->state = RELEASED;
+	pthread_cond_broadcast(&released_cond);
+	pthread_mutex_unlock(&mutex);
+}
+
+void AnalyzerPool::join() {
+	vector<pthread_t>::iterator workers_it;
+
+	/* Workers wait for their jobs to be released: stop waiting and do not pick up new jobs. */
+	pthread_mutex_lock(&mutex);
+	stopping = true;
+	pthread_cond_broadcast(&released_cond);
+	pthread_mutex_unlock(&mutex);
+
+	for (workers_it = workers.begin(); workers_it != workers.end(); workers_it++) {
+		pthread_join(*workers_it, NULL);
+	}
+
+	workers.clear();
+}
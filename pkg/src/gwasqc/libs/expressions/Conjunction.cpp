@@ -30,3 +30,9 @@ Conjunction::~Conjunction() {
 bool Conjunction::evaluate(double value) {
 	return (first->evaluate(value) && second->evaluate(value));
 }
+
+void Conjunction::compile(Predicate& predicate) {
+	first->compile(predicate);
+	second->compile(predicate);
+	predicate.emit(Predicate::AND);
+}
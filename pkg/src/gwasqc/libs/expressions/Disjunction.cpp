@@ -30,3 +30,9 @@ Disjunction::~Disjunction() {
 bool Disjunction::evaluate(double value) {
 	return (first->evaluate(value) || second->evaluate(value));
 }
+
+void Disjunction::compile(Predicate& predicate) {
+	first->compile(predicate);
+	second->compile(predicate);
+	predicate.emit(Predicate::OR);
+}
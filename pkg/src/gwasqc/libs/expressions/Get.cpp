@@ -30,3 +30,7 @@ Get::~Get() {
 bool Get::evaluate(double value) {
 	return value >= this->value;
 }
+
+void Get::compile(Predicate& predicate) {
+	predicate.emit(Predicate::GET, value);
+}
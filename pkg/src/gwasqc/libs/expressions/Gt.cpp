@@ -30,3 +30,7 @@ Gt::~Gt() {
 bool Gt::evaluate(double value) {
 	return auxiliary::fcmp(value, this->value, EPSILON) == 1;
 }
+
+void Gt::compile(Predicate& predicate) {
+	predicate.emit(Predicate::GT, value);
+}
@@ -30,3 +30,7 @@ Let::~Let() {
 bool Let::evaluate(double value) {
 	return value <= this->value;
 }
+
+void Let::compile(Predicate& predicate) {
+	predicate.emit(Predicate::LET, value);
+}
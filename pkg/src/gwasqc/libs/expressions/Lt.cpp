@@ -30,3 +30,7 @@ Lt::~Lt() {
 bool Lt::evaluate(double value) {
 	return auxiliary::fcmp(value, this->value, EPSILON) == -1;
 }
+
+void Lt::compile(Predicate& predicate) {
+	predicate.emit(Predicate::LT, value);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../include/expressions/Predicate.h"
+
+Predicate::Predicate(Evaluable& expression, unsigned int block_size) : depth(0), max_depth(0), block_size(block_size) {
+	expression.compile(*this);
+
+	masks.resize(max_depth * block_size);
+}
+
+Predicate::~Predicate() {
+	instructions.clear();
+	masks.clear();
+}
+
+void Predicate::emit(opcode code, double operand) {
+	instruction new_instruction;
+
+	new_instruction.code = code;
+	new_instruction.operand = operand;
+
+	instructions.push_back(new_instruction);
+
+	if ((code == AND) || (code == OR)) {
+		depth -= 1;
+	} else {
+		depth += 1;
+		if (depth > max_depth) {
+			max_depth = depth;
+		}
+	}
+}
+
+void Predicate::evaluate(const double* values, unsigned char* selection, unsigned int size) {
+	unsigned char* top = NULL;
+	unsigned char* below = NULL;
+	unsigned int level = 0;
+	double operand = 0.0;
+
+	if (size > block_size) {
+		size = block_size;
+	}
+
+	for (vector<instruction>::iterator it = instructions.begin(); it != instructions.end(); it++) {
+		operand = it->operand;
+
+		switch (it->code) {
+			case GT:
+				top = &masks[level * block_size];
+				for (unsigned int i = 0; i < size; i++) {
+					top[i] = auxiliary::fcmp(values[i], operand, Evaluable::EPSILON) == 1;
+				}
+				level += 1;
+				break;
+			case LT:
+				top = &masks[level * block_size];
+				for (unsigned int i = 0; i < size; i++) {
+					top[i] = auxiliary::fcmp(values[i], operand, Evaluable::EPSILON) == -1;
+				}
+				level += 1;
+				break;
+			case GET:
+				top = &masks[level * block_size];
+				for (unsigned int i = 0; i < size; i++) {
+					top[i] = values[i] >= operand;
+				}
+				level += 1;
+				break;
+			case LET:
+				top = &masks[level * block_size];
+				for (unsigned int i = 0; i < size; i++) {
+					top[i] = values[i] <= operand;
+				}
+				level += 1;
+				break;
+			case AND:
+				level -= 1;
+				top = &masks[level * block_size];
+				below = &masks[(level - 1) * block_size];
+				for (unsigned int i = 0; i < size; i++) {
+					below[i] &= top[i];
+				}
+				break;
+			case OR:
+				level -= 1;
+				top = &masks[level * block_size];
+				below = &masks[(level - 1) * block_size];
+				for (unsigned int i = 0; i < size; i++) {
+					below[i] |= top[i];
+				}
+				break;
+		}
+	}
+
+	if (level > 0) {
+		top = &masks[0];
+		for (unsigned int i = 0; i < size; i++) {
+			selection[i] &= top[i];
+		}
+	}
+}
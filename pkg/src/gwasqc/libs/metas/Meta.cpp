@@ -23,7 +23,7 @@ const unsigned int Meta::HEAP_SIZE = 2800000;
 const unsigned int Meta::HEAP_INCREMENT = 100000;
 
 Meta::Meta():
-	id(0), common_name(NULL), actual_name(NULL), full_name(NULL), description(NULL), na_marker(NULL)  {
+	id(0), common_name(NULL), actual_name(NULL), full_name(NULL), description(NULL), na_marker(NULL), na_marker_length(0)  {
 
 }
 
@@ -133,6 +133,7 @@ void Meta::set_na_marker(const char* na_marker) throw (MetaException) {
 		throw MetaException("Meta", "set_na_marker( const char* )", __LINE__, 2, (strlen(na_marker) + 1) * sizeof(char));
 	}
 	strcpy(this->na_marker, na_marker);
+	na_marker_length = strlen(na_marker);
 }
 
 int Meta::get_id() {
@@ -162,3 +163,21 @@ const char* Meta::get_na_marker() {
 double Meta::get_memory_usage() {
 	return 0.0;
 }
+
+void Meta::save_bytes(ostream& stream, const void* bytes, size_t size) {
+	stream.write((const char*)bytes, size);
+}
+
+void Meta::load_bytes(istream& stream, void* bytes, size_t size) throw (MetaException) {
+	stream.read((char*)bytes, size);
+	if ((size_t)stream.gcount() != size) {
+		throw MetaException("Meta", "load_bytes( istream&, void*, size_t )", __LINE__, 5, common_name != NULL ? common_name : "NULL");
+	}
+}
+
+void Meta::skip_bytes(istream& stream, size_t size) throw (MetaException) {
+	stream.ignore(size);
+	if ((size_t)stream.gcount() != size) {
+		throw MetaException("Meta", "skip_bytes( istream&, size_t )", __LINE__, 5, common_name != NULL ? common_name : "NULL");
+	}
+}
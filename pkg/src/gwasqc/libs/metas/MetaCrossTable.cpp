@@ -19,28 +19,216 @@
 
 #include "../../include/metas/MetaCrossTable.h"
 
+const unsigned int MetaCrossTable::INITIAL_SLOTS = 64;
+
 MetaCrossTable::MetaCrossTable(MetaNumeric* x_meta, MetaNumeric* y_meta) : Meta(),
-	x_meta(x_meta), y_meta(y_meta), xy_na(0), x_na_total(0), y_na_total(0), xy_total(0), row(NULL),
+	x_meta(x_meta), y_meta(y_meta), xy_na(0), x_na_total(0), y_na_total(0), xy_total(0),
 	new_x_value(0), new_y_value(0) {
 
+	cells.entries = NULL;
+	cells.n_entries = 0;
+	cells.n_slots = 0;
+
+	x_margins.entries = NULL;
+	x_margins.n_entries = 0;
+	x_margins.n_slots = 0;
+
+	y_margins.entries = NULL;
+	y_margins.n_entries = 0;
+	y_margins.n_slots = 0;
 }
 
 MetaCrossTable::~MetaCrossTable() {
-	for (column_it = table.begin(); column_it != table.end(); column_it++) {
-		column_it->second->clear();
-		delete column_it->second;
+	free(cells.entries);
+	cells.entries = NULL;
+
+	free(x_margins.entries);
+	x_margins.entries = NULL;
+
+	free(y_margins.entries);
+	y_margins.entries = NULL;
+}
+
+uint64_t MetaCrossTable::hash_pair(double x, double y) {
+	uint64_t x_bits = 0;
+	uint64_t y_bits = 0;
+	uint64_t hash = 0;
+
+	/* -0.0 and 0.0 are the same key. */
+	if (x == 0.0) {
+		x = 0.0;
+	}
+
+	if (y == 0.0) {
+		y = 0.0;
 	}
 
-	table.clear();
-	x_na.clear();
-	y_na.clear();
-	x_total.clear();
-	y_total.clear();
+	memcpy(&x_bits, &x, sizeof(uint64_t));
+	memcpy(&y_bits, &y, sizeof(uint64_t));
+
+	hash = x_bits ^ (y_bits * 0x9e3779b97f4a7c15ULL);
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+int MetaCrossTable::qsort_cell_entry_cmp(const void* first, const void* second) {
+	double d_first = (*(cell_entry**)first)->x;
+	double d_second = (*(cell_entry**)second)->x;
 
-	row = NULL;
+	if (d_first < d_second) {
+		return -1;
+	}
+	else if (d_first > d_second) {
+		return 1;
+	}
+
+	return 0;
+}
+
+MetaCrossTable::cell_entry* MetaCrossTable::lookup(cell_table& table, double x, double y) throw (MetaException) {
+	unsigned int mask = 0;
+	unsigned int position = 0;
+	cell_entry* entry = NULL;
+
+	if (table.entries == NULL) {
+		rehash(table, INITIAL_SLOTS);
+	} else if (2 * (table.n_entries + 1) > table.n_slots) {
+		rehash(table, 2 * table.n_slots);
+	}
+
+	mask = table.n_slots - 1;
+	position = (unsigned int)(hash_pair(x, y) & mask);
+
+	while ((entry = &table.entries[position])->used) {
+		if ((entry->x == x) && (entry->y == y)) {
+			return entry;
+		}
+		position = (position + 1) & mask;
+	}
+
+	entry->x = x;
+	entry->y = y;
+	entry->count = 0;
+	entry->na_count = 0;
+	entry->used = true;
+
+	table.n_entries += 1;
+
+	return entry;
+}
+
+void MetaCrossTable::rehash(cell_table& table, unsigned int new_n_slots) throw (MetaException) {
+	cell_entry* new_entries = NULL;
+	unsigned int mask = new_n_slots - 1;
+	unsigned int position = 0;
+
+	new_entries = (cell_entry*)calloc(new_n_slots, sizeof(cell_entry));
+	if (new_entries == NULL) {
+		throw MetaException("MetaCrossTable", "rehash( cell_table&, unsigned int )", __LINE__, 2, new_n_slots * sizeof(cell_entry));
+	}
+
+	for (unsigned int i = 0; i < table.n_slots; i++) {
+		if (table.entries[i].used) {
+			position = (unsigned int)(hash_pair(table.entries[i].x, table.entries[i].y) & mask);
+			while (new_entries[position].used) {
+				position = (position + 1) & mask;
+			}
+			new_entries[position] = table.entries[i];
+		}
+	}
+
+	free(table.entries);
+	table.entries = new_entries;
+	table.n_slots = new_n_slots;
+}
+
+void MetaCrossTable::materialize(cross_matrix& matrix) throw (MetaException) {
+	cell_entry** row = NULL;
+	cell_entry** column = NULL;
+	cell_entry* key_pointer = NULL;
+	cell_entry key;
+
+	matrix.rows = NULL;
+	matrix.columns = NULL;
+	matrix.counts = NULL;
+	matrix.n_rows = 0;
+	matrix.n_columns = 0;
+
+	if (x_margins.n_entries > 0) {
+		matrix.rows = (cell_entry**)malloc(x_margins.n_entries * sizeof(cell_entry*));
+		if (matrix.rows == NULL) {
+			throw MetaException("MetaCrossTable", "materialize( cross_matrix& )", __LINE__, 2, x_margins.n_entries * sizeof(cell_entry*));
+		}
+
+		for (unsigned int i = 0; i < x_margins.n_slots; i++) {
+			if (x_margins.entries[i].used) {
+				matrix.rows[matrix.n_rows++] = &x_margins.entries[i];
+			}
+		}
+
+		qsort(matrix.rows, matrix.n_rows, sizeof(cell_entry*), qsort_cell_entry_cmp);
+	}
+
+	if (y_margins.n_entries > 0) {
+		matrix.columns = (cell_entry**)malloc(y_margins.n_entries * sizeof(cell_entry*));
+		if (matrix.columns == NULL) {
+			release(matrix);
+			throw MetaException("MetaCrossTable", "materialize( cross_matrix& )", __LINE__, 2, y_margins.n_entries * sizeof(cell_entry*));
+		}
+
+		for (unsigned int i = 0; i < y_margins.n_slots; i++) {
+			if (y_margins.entries[i].used) {
+				matrix.columns[matrix.n_columns++] = &y_margins.entries[i];
+			}
+		}
+
+		qsort(matrix.columns, matrix.n_columns, sizeof(cell_entry*), qsort_cell_entry_cmp);
+	}
+
+	if ((matrix.n_rows > 0) && (matrix.n_columns > 0)) {
+		matrix.counts = (int64_t*)calloc(matrix.n_rows * matrix.n_columns, sizeof(int64_t));
+		if (matrix.counts == NULL) {
+			release(matrix);
+			throw MetaException("MetaCrossTable", "materialize( cross_matrix& )", __LINE__, 2, matrix.n_rows * matrix.n_columns * sizeof(int64_t));
+		}
+
+		key_pointer = &key;
+
+		for (unsigned int i = 0; i < cells.n_slots; i++) {
+			if (cells.entries[i].used) {
+				key.x = cells.entries[i].x;
+				row = (cell_entry**)bsearch(&key_pointer, matrix.rows, matrix.n_rows, sizeof(cell_entry*), qsort_cell_entry_cmp);
+
+				key.x = cells.entries[i].y;
+				column = (cell_entry**)bsearch(&key_pointer, matrix.columns, matrix.n_columns, sizeof(cell_entry*), qsort_cell_entry_cmp);
+
+				matrix.counts[(row - matrix.rows) * matrix.n_columns + (column - matrix.columns)] = cells.entries[i].count;
+			}
+		}
+	}
+}
+
+void MetaCrossTable::release(cross_matrix& matrix) {
+	free(matrix.rows);
+	free(matrix.columns);
+	free(matrix.counts);
+
+	matrix.rows = NULL;
+	matrix.columns = NULL;
+	matrix.counts = NULL;
+	matrix.n_rows = 0;
+	matrix.n_columns = 0;
 }
 
 void MetaCrossTable::put(char* value) throw (MetaException) {
+	cell_entry* entry = NULL;
+
 	if ((!x_meta->is_numeric()) || (!y_meta->is_numeric())) {
 		return;
 	}
@@ -62,79 +250,88 @@ void MetaCrossTable::put(char* value) throw (MetaException) {
 			xy_na += 1;
 		}
 		else {
-			row_it = y_total.find(new_y_value);
-			if (row_it != y_total.end()) {
-				row_it->second += 1;
-			}
-			else {
-				y_total.insert(pair<double, int>(new_y_value, 1));
-
-				for (column_it = table.begin(); column_it != table.end(); column_it++) {
-					column_it->second->insert(pair<double, int>(new_y_value, 0));
-				}
-				x_na.insert(pair<double, int>(new_y_value, 0));
-			}
-
-			x_na.find(new_y_value)->second += 1;
+			entry = lookup(y_margins, new_y_value, 0.0);
+			entry->count += 1;
+			entry->na_count += 1;
 		}
 	}
 	else if (y_meta->is_na()) {
 		y_na_total += 1;
 
-		row_it = x_total.find(new_x_value);
-		if (row_it != x_total.end()) {
-			row_it->second += 1;
-		}
-		else {
-			x_total.insert(pair<double, int>(new_x_value, 1));
-
-			row = new map<double, int>();
-			for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
-				row->insert(pair<double, int>(row_it->first, 0));
-			}
-			y_na.insert(pair<double, int>(new_x_value, 0));
-
-			table.insert(pair<double, map<double, int>* >(new_x_value, row));
-		}
-
-		y_na.find(new_x_value)->second += 1;
+		entry = lookup(x_margins, new_x_value, 0.0);
+		entry->count += 1;
+		entry->na_count += 1;
 	}
 	else {
-		row_it = x_total.find(new_x_value);
-		if (row_it != x_total.end()) {
-			row_it->second += 1;
-		}
-		else {
-			x_total.insert(pair<double, int>(new_x_value, 1));
+		lookup(x_margins, new_x_value, 0.0)->count += 1;
+		lookup(y_margins, new_y_value, 0.0)->count += 1;
+		lookup(cells, new_x_value, new_y_value)->count += 1;
+	}
+}
 
-			row = new map<double, int>();
-			for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
-				row->insert(pair<double, int>(row_it->first, 0));
-			}
-			y_na.insert(pair<double, int>(new_x_value, 0));
+void MetaCrossTable::finalize() throw (MetaException) {
 
-			table.insert(pair<double, map<double, int>* >(new_x_value, row));
-		}
+}
 
-		row_it = y_total.find(new_y_value);
-		if (row_it != y_total.end()) {
-			row_it->second += 1;
-		}
-		else {
-			y_total.insert(pair<double, int>(new_y_value, 1));
+void MetaCrossTable::save_table(ostream& stream, cell_table& table) {
+	save_bytes(stream, &table.n_entries, sizeof(unsigned int));
 
-			for (column_it = table.begin(); column_it != table.end(); column_it++) {
-				column_it->second->insert(pair<double, int>(new_y_value, 0));
-			}
-			x_na.insert(pair<double, int>(new_y_value, 0));
+	for (unsigned int i = 0; (table.entries != NULL) && (i < table.n_slots); i++) {
+		if (table.entries[i].used) {
+			save_bytes(stream, &table.entries[i].x, sizeof(double));
+			save_bytes(stream, &table.entries[i].y, sizeof(double));
+			save_bytes(stream, &table.entries[i].count, sizeof(int64_t));
+			save_bytes(stream, &table.entries[i].na_count, sizeof(int64_t));
 		}
+	}
+}
 
-		table.find(new_x_value)->second->find(new_y_value)->second += 1;
+void MetaCrossTable::merge_table(istream& stream, cell_table& table) throw (MetaException) {
+	cell_entry* entry = NULL;
+	unsigned int saved_n_entries = 0;
+	double x = 0.0;
+	double y = 0.0;
+	int64_t count = 0;
+	int64_t na_count = 0;
+
+	load_bytes(stream, &saved_n_entries, sizeof(unsigned int));
+
+	for (unsigned int i = 0; i < saved_n_entries; i++) {
+		load_bytes(stream, &x, sizeof(double));
+		load_bytes(stream, &y, sizeof(double));
+		load_bytes(stream, &count, sizeof(int64_t));
+		load_bytes(stream, &na_count, sizeof(int64_t));
+
+		entry = lookup(table, x, y);
+		entry->count += count;
+		entry->na_count += na_count;
 	}
 }
 
-void MetaCrossTable::finalize() throw (MetaException) {
+void MetaCrossTable::save_state(ostream& stream) throw (MetaException) {
+	save_bytes(stream, &xy_na, sizeof(int64_t));
+	save_bytes(stream, &x_na_total, sizeof(int64_t));
+	save_bytes(stream, &y_na_total, sizeof(int64_t));
+	save_bytes(stream, &xy_total, sizeof(int64_t));
+
+	save_table(stream, cells);
+	save_table(stream, x_margins);
+	save_table(stream, y_margins);
+}
+
+void MetaCrossTable::merge_state(istream& stream) throw (MetaException) {
+	int64_t saved_counts[4] = {0, 0, 0, 0};
+
+	load_bytes(stream, saved_counts, 4 * sizeof(int64_t));
 
+	xy_na += saved_counts[0];
+	x_na_total += saved_counts[1];
+	y_na_total += saved_counts[2];
+	xy_total += saved_counts[3];
+
+	merge_table(stream, cells);
+	merge_table(stream, x_margins);
+	merge_table(stream, y_margins);
 }
 
 bool MetaCrossTable::is_na() {
@@ -147,6 +344,9 @@ void MetaCrossTable::print(ostream& stream) {
 		const char* y_name = y_meta->get_actual_name();
 		double x_value = 0;
 		int width = strlen(x_name);
+		cross_matrix matrix;
+
+		materialize(matrix);
 
 		if (width < 12) {
 			width = 12;
@@ -157,8 +357,8 @@ void MetaCrossTable::print(ostream& stream) {
 
 		stream << " " << setw(width) << " " << " | " << y_name << endl;
 		stream << " " << setw(width) << x_name << " |";
-		for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
-			stream << setw(12) << row_it->first << " |";
+		for (unsigned int j = 0; j < matrix.n_columns; j++) {
+			stream << setw(12) << matrix.columns[j]->x << " |";
 		}
 		if (y_na_total > 0) {
 			stream << setw(12) << "NA" << " |";
@@ -168,7 +368,7 @@ void MetaCrossTable::print(ostream& stream) {
 		stream << " ";
 		stream << setfill('-');
 		stream << setw(width + 2) << "|";
-		for (unsigned int i = 0; i <= y_total.size(); i++) {
+		for (unsigned int k = 0; k <= matrix.n_columns; k++) {
 			stream << setw(14) << "|";
 		}
 		if (y_na_total > 0) {
@@ -176,26 +376,26 @@ void MetaCrossTable::print(ostream& stream) {
 		}
 		stream << setfill(' ') << endl;
 
-		for (column_it = table.begin(); column_it != table.end(); column_it++) {
-			x_value = column_it->first;
+		for (unsigned int i = 0; i < matrix.n_rows; i++) {
+			x_value = matrix.rows[i]->x;
 
 			/* COUNT */
 			stream << resetiosflags(ios_base::fixed);
 			stream << " ";
 			stream << setw(width) << x_value << " |";
-			for (row_it = column_it->second->begin(); row_it != column_it->second->end(); row_it++) {
-				stream << setw(12) << row_it->second << " |";
+			for (unsigned int j = 0; j < matrix.n_columns; j++) {
+				stream << setw(12) << matrix.counts[i * matrix.n_columns + j] << " |";
 			}
 			if (y_na_total > 0) {
-				stream << setw(12) << y_na.find(x_value)->second << " |";
+				stream << setw(12) << matrix.rows[i]->na_count << " |";
 			}
-			stream << setw(12) << x_total.find(x_value)->second << " |" << endl;
+			stream << setw(12) << matrix.rows[i]->count << " |" << endl;
 
 			/* ROW DELIMITER */
 			stream << " ";
 			stream << setfill('-');
 			stream << setw(width + 2) << "|";
-			for (unsigned int i = 0; i <= y_total.size(); i++) {
+			for (unsigned int k = 0; k <= matrix.n_columns; k++) {
 				stream << setw(14) << "|";
 			}
 			if (y_na_total > 0) {
@@ -208,8 +408,8 @@ void MetaCrossTable::print(ostream& stream) {
 			/* COUNT */
 			stream << " ";
 			stream << setw(width) << "NA" << " |";
-			for (row_it = x_na.begin(); row_it != x_na.end(); row_it++) {
-				stream << setw(12) << row_it->second << " |";
+			for (unsigned int j = 0; j < matrix.n_columns; j++) {
+				stream << setw(12) << matrix.columns[j]->na_count << " |";
 			}
 			if (y_na_total > 0) {
 				stream << setw(12) << xy_na << " |";
@@ -220,7 +420,7 @@ void MetaCrossTable::print(ostream& stream) {
 			stream << " ";
 			stream << setfill('-');
 			stream << setw(width + 2) << "|";
-			for (unsigned int i = 0; i <= y_total.size(); i++) {
+			for (unsigned int k = 0; k <= matrix.n_columns; k++) {
 				stream << setw(14) << "|";
 			}
 			if (y_na_total > 0) {
@@ -232,8 +432,8 @@ void MetaCrossTable::print(ostream& stream) {
 		/* COUNT */
 		stream << " ";
 		stream << setw(width) << "Column Total" << " |";
-		for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
-			stream << setw(12) << row_it->second << " |";
+		for (unsigned int j = 0; j < matrix.n_columns; j++) {
+			stream << setw(12) << matrix.columns[j]->count << " |";
 		}
 		if (y_na_total > 0) {
 			stream << setw(12) << y_na_total << " |";
@@ -245,7 +445,7 @@ void MetaCrossTable::print(ostream& stream) {
 		stream << " ";
 		stream << setfill('-');
 		stream << setw(width + 2) << "|";
-		for (unsigned int i = 0; i <= y_total.size(); i++) {
+		for (unsigned int k = 0; k <= matrix.n_columns; k++) {
 			stream << setw(14) << "|";
 		}
 		if (y_na_total > 0) {
@@ -255,6 +455,8 @@ void MetaCrossTable::print(ostream& stream) {
 
 		stream << resetiosflags(stream.flags());
 		stream << setfill(' ');
+
+		release(matrix);
 	}
 	else {
 		if (!x_meta->is_numeric()) {
@@ -278,8 +480,11 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 		double x_value = 0;
 		int colspan = 0;
 		int width = 0;
+		cross_matrix matrix;
 
-		width = 100 / (y_total.size() + (y_na_total > 0 ? 1 : 0) + 2);
+		materialize(matrix);
+
+		width = 100 / (matrix.n_columns + (y_na_total > 0 ? 1 : 0) + 2);
 
 		stream << "<div class = \"groups\">";
 		stream << "<table class = \"cross\">";
@@ -289,7 +494,7 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 		stream << "<th class = \"header\">";
 		stream << "</th>";
 		stream << "<th class = \"header\">" << y_name << "</th>";
-		for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
+		for (unsigned int j = 0; j < matrix.n_columns; j++) {
 			colspan += 1;
 		}
 		if (y_na_total > 0) {
@@ -300,8 +505,8 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 
 		stream << "<tr>";
 		stream << "<th class = \"header\"  style = \"width: " << width << "%;\">" << x_name << "</th>";
-		for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
-			stream << "<th class = \"header\"  style = \"width: " << width << "%;\">" << row_it->first << "</th>";
+		for (unsigned int j = 0; j < matrix.n_columns; j++) {
+			stream << "<th class = \"header\"  style = \"width: " << width << "%;\">" << matrix.columns[j]->x << "</th>";
 		}
 		if (y_na_total > 0) {
 			stream << "<th class = \"header\"  style = \"width: " << width << "%;\">NA</th>";
@@ -309,18 +514,18 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 		stream << "<th class = \"header\" style = \"width: " << width << "%;\">Row Total</th>";
 		stream << "</tr>";
 
-		for (column_it = table.begin(); column_it != table.end(); column_it++) {
-			x_value = column_it->first;
+		for (unsigned int i = 0; i < matrix.n_rows; i++) {
+			x_value = matrix.rows[i]->x;
 
 			stream << "<tr>";
 			stream << "<td>" << x_value << "</td>";
-			for (row_it = column_it->second->begin(); row_it != column_it->second->end(); row_it++) {
-				stream << "<td>" << row_it->second << "</td>";
+			for (unsigned int j = 0; j < matrix.n_columns; j++) {
+				stream << "<td>" << matrix.counts[i * matrix.n_columns + j] << "</td>";
 			}
 			if (y_na_total > 0) {
-				stream << "<td>" << y_na.find(x_value)->second << "</td>";
+				stream << "<td>" << matrix.rows[i]->na_count << "</td>";
 			}
-			stream << "<td>" << x_total.find(x_value)->second << "</td>";
+			stream << "<td>" << matrix.rows[i]->count << "</td>";
 
 			stream << "</tr>";
 		}
@@ -328,8 +533,8 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 		if (x_na_total > 0) {
 			stream << "<tr>";
 			stream << "<td>NA</td>";
-			for (row_it = x_na.begin(); row_it != x_na.end(); row_it++) {
-				stream << "<td>" << row_it->second << "</td>";
+			for (unsigned int j = 0; j < matrix.n_columns; j++) {
+				stream << "<td>" << matrix.columns[j]->na_count << "</td>";
 			}
 			if (y_na_total > 0) {
 				stream << "<td>" << xy_na << "</td>";
@@ -340,8 +545,8 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 
 		stream << "<tr>";
 		stream << "<td class = \"footer\">Column Total</td>";
-		for (row_it = y_total.begin(); row_it != y_total.end(); row_it++) {
-			stream << "<td class = \"footer\">" << row_it->second << "</td>";
+		for (unsigned int j = 0; j < matrix.n_columns; j++) {
+			stream << "<td class = \"footer\">" << matrix.columns[j]->count << "</td>";
 		}
 		if (y_na_total > 0) {
 			stream << "<td class = \"footer\">" << y_na_total << "</td>";
@@ -351,6 +556,8 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 
 		stream << "</table>";
 		stream << "</div>";
+
+		release(matrix);
 	}
 	else {
 		stream << "<div class = \"result\">";
@@ -366,17 +573,11 @@ void MetaCrossTable::print_html(ostream& stream, char path_separator) {
 }
 
 double MetaCrossTable::get_memory_usage() {
-	unsigned long int memory = 0;
+	uint64_t memory = 0;
 
-	for (column_it = table.begin(); column_it != table.end(); column_it++) {
-		memory += (column_it->second->size() * (sizeof(double) + sizeof(int)));
-		memory += sizeof(map<double, int>*);
-		memory += sizeof(double);
-	}
-	memory += (x_na.size() * (sizeof(double) + sizeof(int)));
-	memory += (y_na.size() * (sizeof(double) + sizeof(int)));
-	memory += (x_total.size() * (sizeof(double) + sizeof(int)));
-	memory += (y_total.size() * (sizeof(double) + sizeof(int)));
+	memory += cells.n_slots * sizeof(cell_entry);
+	memory += x_margins.n_slots * sizeof(cell_entry);
+	memory += y_margins.n_slots * sizeof(cell_entry);
 
 	return memory / 1048576.0;
 }
@@ -19,13 +19,16 @@
 
 #include "../../include/metas/MetaException.h"
 
-const int MetaException::MESSAGE_TEMPLATES_NUMBER = 5;
+const int MetaException::MESSAGE_TEMPLATES_NUMBER = 8;
 const char* MetaException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
 /*02*/	"Memory allocation error (%d bytes).",
 /*03*/	"Memory reallocation error (%d bytes).",
-/*04*/	"Error while calculating statistics for '%s' column."
+/*04*/	"Error while calculating statistics for '%s' column.",
+/*05*/	"Error while reading the saved state of '%s' column.",
+/*06*/	"The saved state of '%s' column is not compatible with the current settings.",
+/*07*/	"The values of '%s' column have changed between the two passes over the input file."
 };
 
 MetaException::MetaException() : Exception() {
@@ -19,23 +19,61 @@
 
 #include "../../include/metas/MetaFiltered.h"
 
-MetaFiltered::MetaFiltered(MetaNumeric* source, unsigned int heap_size) throw (MetaException) : MetaNumeric(0), source(source), bitarray(NULL)  {
+const unsigned int MetaFiltered::BLOCK_SIZE = 1024;
+
+const double MetaFiltered::QQPLOT_TAIL = 0.0001;
+
+MetaFiltered::MetaFiltered(MetaNumeric* source, unsigned int heap_size) throw (MetaException) : MetaNumeric(0), source(source),
+	selection(NULL), block_values(NULL), block_positions(NULL), block_size(0), block_flushed(false), bitarray(NULL)  {
 	affiliate_begin = affiliates.begin();
 	affiliate_end = affiliates.end();
 	condition_begin = conditions.begin();
 	condition_end = conditions.end();
 
+	selection = (unsigned char*)malloc(BLOCK_SIZE * sizeof(unsigned char));
+	if (selection == NULL) {
+		throw MetaException("MetaFiltered", "MetaFiltered( MetaNumeric*, unsigned int )", __LINE__, 2, BLOCK_SIZE * sizeof(unsigned char));
+	}
+
+	block_values = (double*)malloc(BLOCK_SIZE * sizeof(double));
+	if (block_values == NULL) {
+		free(selection);
+		selection = NULL;
+		throw MetaException("MetaFiltered", "MetaFiltered( MetaNumeric*, unsigned int )", __LINE__, 2, BLOCK_SIZE * sizeof(double));
+	}
+
+	block_positions = (uint64_t*)malloc(BLOCK_SIZE * sizeof(uint64_t));
+	if (block_positions == NULL) {
+		free(selection);
+		free(block_values);
+		selection = NULL;
+		block_values = NULL;
+		throw MetaException("MetaFiltered", "MetaFiltered( MetaNumeric*, unsigned int )", __LINE__, 2, BLOCK_SIZE * sizeof(uint64_t));
+	}
+
 	bitarray = new BitArray(heap_size);
+
+	set_histogram_range(source->get_histogram_range()[0], source->get_histogram_range()[1]);
 }
 
 MetaFiltered::~MetaFiltered() {
 	affiliates.clear();
 
 	for (condition_it = condition_begin; condition_it != condition_end; condition_it++) {
-		delete condition_it->second;
+		delete condition_it->expression;
+		delete condition_it->predicate;
+		free(condition_it->values);
 	}
 	conditions.clear();
 
+	free(selection);
+	free(block_values);
+	free(block_positions);
+
+	selection = NULL;
+	block_values = NULL;
+	block_positions = NULL;
+
 	if (bitarray != NULL) {
 		delete bitarray;
 		bitarray = NULL;
@@ -48,8 +86,20 @@ void MetaFiltered::add_dependency(MetaNumeric& meta) {
 	affiliate_end = affiliates.end();
 }
 
-void MetaFiltered::add_dependency(MetaNumeric& meta, Evaluable& condition) {
-	conditions.insert(pair<MetaNumeric*, Evaluable*>(&meta, &condition));
+void MetaFiltered::add_dependency(MetaNumeric& meta, Evaluable& condition) throw (MetaException) {
+	condition_entry new_condition;
+
+	new_condition.meta = &meta;
+	new_condition.expression = &condition;
+	new_condition.predicate = NULL;
+	new_condition.values = (double*)malloc(BLOCK_SIZE * sizeof(double));
+	if (new_condition.values == NULL) {
+		throw MetaException("MetaFiltered", "add_dependency( MetaNumeric&, Evaluable& )", __LINE__, 2, BLOCK_SIZE * sizeof(double));
+	}
+
+	new_condition.predicate = new Predicate(condition, BLOCK_SIZE);
+
+	conditions.push_back(new_condition);
 	condition_begin = conditions.begin();
 	condition_end = conditions.end();
 }
@@ -58,7 +108,26 @@ MetaNumeric* MetaFiltered::get_source() {
 	return source;
 }
 
+unsigned int MetaFiltered::get_block_size() {
+	return block_size;
+}
+
+bool MetaFiltered::is_selected(unsigned int row) {
+	return selection[row] != 0;
+}
+
+double MetaFiltered::get_block_value(unsigned int row) {
+	return block_values[row];
+}
+
 void MetaFiltered::put(char* value) throw (MetaException) {
+	unsigned int row = 0;
+
+	if (block_flushed) {
+		block_size = 0;
+		block_flushed = false;
+	}
+
 	if (numeric) {
 		if (!source->is_numeric()) {
 			numeric = false;
@@ -70,15 +139,21 @@ void MetaFiltered::put(char* value) throw (MetaException) {
 			delete bitarray;
 			bitarray = NULL;
 
+			block_size = 0;
+
 			return;
 		}
 
-		na_value = false;
+		/* Every input row gets a block row, so blocks of different filtered metas stay aligned. */
+		row = block_size;
+		block_size += 1;
+
+		selection[row] = 0;
+		block_values[row] = numeric_limits<double>::quiet_NaN();
+		block_positions[row] = 0;
 
 		if (source->is_na()) {
 			na += 1;
-			na_value = true;
-			this->value = numeric_limits<double>::quiet_NaN();
 			return;
 		}
 
@@ -93,18 +168,18 @@ void MetaFiltered::put(char* value) throw (MetaException) {
 				delete bitarray;
 				bitarray = NULL;
 
+				block_size = 0;
+
 				return;
 			}
 
 			if ((*affiliate_it)->is_na()) {
-				na_value = true;
-				this->value = numeric_limits<double>::quiet_NaN();
 				return;
 			}
 		}
 
 		for (condition_it = condition_begin; condition_it != condition_end; condition_it++) {
-			if (!condition_it->first->is_numeric()) {
+			if (!condition_it->meta->is_numeric()) {
 				numeric = false;
 				this->value = numeric_limits<double>::quiet_NaN();
 
@@ -114,36 +189,113 @@ void MetaFiltered::put(char* value) throw (MetaException) {
 				delete bitarray;
 				bitarray = NULL;
 
+				block_size = 0;
+
 				return;
 			}
 
-			if ((condition_it->first->is_na()) || (!condition_it->second->evaluate(condition_it->first->get_value()))) {
-				na_value = true;
-				this->value = numeric_limits<double>::quiet_NaN();
+			if (condition_it->meta->is_na()) {
 				return;
 			}
+
+			condition_it->values[row] = condition_it->meta->get_value();
 		}
 
 		if (source->is_value_saved()) {
-			n += 1;
+			selection[row] = 1;
+			block_values[row] = source->get_value();
+			block_positions[row] = source->get_n() - 1;
+		}
+	}
+}
+
+void MetaFiltered::flush() throw (MetaException) {
+	if (block_flushed) {
+		return;
+	}
 
-			value_saved = true;
-			bitarray->set_bit(source->get_n() - 1);
-			this->value = source->get_value();
+	block_flushed = true;
+
+	if ((!numeric) || (block_size == 0)) {
+		return;
+	}
+
+	/* Rows rejected before evaluation have arbitrary condition values; the selection mask already excludes them. */
+	for (condition_it = condition_begin; condition_it != condition_end; condition_it++) {
+		condition_it->predicate->evaluate(condition_it->values, selection, block_size);
+	}
+
+	if (low_memory) {
+		double tail_limit = get_bin_lower(get_bin(QQPLOT_TAIL));
+
+		for (unsigned int i = 0; i < block_size; i++) {
+			if (selection[i] != 0) {
+				save_value(block_values[i]);
+				if ((refining) && (create_qqplot) && (block_values[i] < tail_limit)) {
+					qqplot_tail.push_back(block_values[i]);
+				}
+			}
 		}
+		return;
+	}
+
+	/* The positions of the selected values ascend within a block, therefore they are set at once. */
+	for (unsigned int i = 0; i < block_size; i++) {
+		if (selection[i] != 0) {
+			n += 1;
+			if (create_histogram) {
+				add_to_histogram(block_values[i]);
+			}
+		}
+	}
+
+	try {
+		bitarray->set_bits(block_positions, selection, block_size);
+	} catch (BitArrayException &e) {
+		MetaException new_e(e);
+		new_e.add_message("MetaFiltered", "flush()", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
+		throw new_e;
 	}
 }
 
 void MetaFiltered::finalize() throw (MetaException) {
+	flush();
+
 	if (source->get_n() <= 0) {
 		numeric = false;
 
+		delete histogram;
+		histogram = NULL;
+
 		free(data);
 		data = NULL;
 
 		delete bitarray;
 		bitarray = NULL;
 
+		release_low_memory();
+		vector<double>().swap(qqplot_tail);
+
+		return;
+	}
+
+	if ((numeric) && (low_memory)) {
+		try {
+			if (n > 0) {
+				finalize_low_memory();
+			}
+
+			if (create_qqplot) {
+				create_binned_qqplot();
+			}
+		} catch (MetaException &e) {
+			e.add_message("MetaFiltered", "finalize()", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
+			throw;
+		}
+
+		release_low_memory();
+		vector<double>().swap(qqplot_tail);
+
 		return;
 	}
 
@@ -158,14 +310,19 @@ void MetaFiltered::finalize() throw (MetaException) {
 					throw MetaException("MetaFiltered", "MetaFiltered( unsigned int )", __LINE__, 2, (n + 1) * sizeof(double));
 				}
 
-				bitarray->filter(source->get_data(), data, source->get_n());
+				if (source->get_order() != NULL) {
+					select_sorted();
+				} else if (source->is_single_precision()) {
+					bitarray->filter(source->get_single_data(), data, source->get_n());
+				} else {
+					bitarray->filter(source->get_data(), data, source->get_n());
+				}
 
-				mean = auxiliary::stats_mean(data, n);
-				sd = auxiliary::stats_sd(data, n, mean);
-				skew = auxiliary::stats_skewness(data, n, mean, sd);
-				kurtosis = auxiliary::stats_kurtosis(data, n, mean, sd);
+				auxiliary::stats_moments(data, n, mean, sd, skew, kurtosis);
 
-				qsort(data, n, sizeof(double), auxiliary::dblcmp);
+				if (source->get_order() == NULL) {
+					qsort(data, n, sizeof(double), auxiliary::dblcmp);
+				}
 
 				median = auxiliary::stats_median_from_sorted_data(data, n);
 
@@ -176,13 +333,15 @@ void MetaFiltered::finalize() throw (MetaException) {
 				min = data[0];
 				max = data[n - 1];
 
-				if (create_histogram) {
-					histogram = Histogram::create(actual_name, data, n, 1000);
-					if (histogram != NULL) {
-						histogram->set_title(get_description());
+				/* The merged states have no histogram yet, since only the positions of the selected values are saved. */
+				if ((create_histogram) && (histogram == NULL)) {
+					for (int64_t i = 0; i < n; i++) {
+						add_to_histogram(data[i]);
 					}
 				}
 
+				finish_histogram();
+
 				if (create_boxplot) {
 					boxplot = Boxplot::create(actual_name, data, n, median);
 					if (boxplot != NULL) {
@@ -196,12 +355,23 @@ void MetaFiltered::finalize() throw (MetaException) {
 
 					qqplot = Qqplot::create(get_description(), get_color(), data, numeric_limits<double>::quiet_NaN(), n);
 
-					for (int i = 0; i < n; i++) {
-						data[i] = pow(Rf_qnorm5(0.5 * data[i], 0.0, 1.0, 0, 0), 2.0);
+					if ((data[0] >= 0.0) && (data[n - 1] <= 1.0)) {
+						/* The statistic decreases as the p-value grows, so its median lies in the middle of the sorted p-values. */
+						if (n % 2 == 0) {
+							lambda = (pow(Rf_qnorm5(0.5 * data[n / 2], 0.0, 1.0, 0, 0), 2.0) + pow(Rf_qnorm5(0.5 * data[n / 2 - 1], 0.0, 1.0, 0, 0), 2.0)) / 2.0;
+						} else {
+							lambda = pow(Rf_qnorm5(0.5 * data[(n - 1) / 2], 0.0, 1.0, 0, 0), 2.0);
+						}
+					} else {
+						for (int64_t i = 0; i < n; i++) {
+							data[i] = pow(Rf_qnorm5(0.5 * data[i], 0.0, 1.0, 0, 0), 2.0);
+						}
+
+						qsort(data, n, sizeof(double), auxiliary::dblcmp);
+						lambda = auxiliary::stats_median_from_sorted_data(data, n);
 					}
 
-					qsort(data, n, sizeof(double), auxiliary::dblcmp);
-					lambda = auxiliary::stats_median_from_sorted_data(data, n) / Rf_qchisq(0.5, 1.0, 0, 0);
+					lambda /= Rf_qchisq(0.5, 1.0, 0, 0);
 
 					qqplot->set_lambda(1, lambda);
 				}
@@ -216,6 +386,9 @@ void MetaFiltered::finalize() throw (MetaException) {
 			e.add_message("MetaFiltered", "finalize()", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
 			throw;
 		}
+	} else {
+		delete histogram;
+		histogram = NULL;
 	}
 
 	if (bitarray != NULL) {
@@ -229,6 +402,184 @@ void MetaFiltered::finalize() throw (MetaException) {
 	}
 }
 
+/*
+ * Takes the selected values from the sorted values of the source by one walk over the original positions of the sorted values.
+ */
+void MetaFiltered::select_sorted() {
+	const uint64_t* order = source->get_order();
+	const double* source_data = source->get_data();
+	int64_t source_n = source->get_n();
+	int64_t selected_n = 0;
+
+	for (int64_t i = 0; (i < source_n) && (selected_n < n); i++) {
+		if (bitarray->get_bit(order[i]) != 0) {
+			data[selected_n] = source_data[i];
+			selected_n += 1;
+		}
+	}
+}
+
+/*
+ * Low-memory mode: the Q-Q plot is built from the bins of the first pass. The p-values below QQPLOT_TAIL are plotted exactly,
+ * every other bin is plotted at its middle, which differs from the values in the bin by less than 0.1%. The median p-value is
+ * selected exactly, therefore the inflation factor is the same as in the default mode, if all p-values are within [0, 1].
+ */
+void MetaFiltered::create_binned_qqplot() throw (MetaException) {
+	vector<double> values;
+	vector<int64_t> counts;
+	vector<double>::iterator tail_it;
+	unsigned int tail_bin = get_bin(QQPLOT_TAIL);
+	unsigned int bin = 0;
+	double lower = 0.0, upper = 0.0;
+	double lambda = numeric_limits<double>::quiet_NaN();
+
+	try {
+		if (n <= 0) {
+			qqplot = Qqplot::create(get_description(), get_color(), NULL, numeric_limits<double>::quiet_NaN(), 0);
+			return;
+		}
+
+		sort(qqplot_tail.begin(), qqplot_tail.end());
+
+		for (tail_it = qqplot_tail.begin(); tail_it != qqplot_tail.end(); tail_it++) {
+			if ((!values.empty()) && (values.back() == *tail_it)) {
+				counts.back() += 1;
+			} else {
+				values.push_back(*tail_it);
+				counts.push_back(1);
+			}
+		}
+
+		for (unsigned int block = tail_bin / BINS_BLOCK_SIZE; block < BINS_BLOCKS_CNT; block++) {
+			if (bins[block] == NULL) {
+				continue;
+			}
+
+			for (unsigned int offset = 0; offset < BINS_BLOCK_SIZE; offset++) {
+				bin = block * BINS_BLOCK_SIZE + offset;
+				if ((bin < tail_bin) || (bins[block][offset] == 0)) {
+					continue;
+				}
+
+				lower = get_bin_lower(bin);
+				upper = get_bin_upper(bin);
+
+				if (lower < min) {
+					lower = min;
+				}
+
+				if (upper > max) {
+					upper = max;
+				}
+
+				values.push_back(lower == upper ? lower : lower + (upper - lower) / 2.0);
+				counts.push_back((int64_t)bins[block][offset]);
+			}
+		}
+
+		qqplot = Qqplot::create(get_description(), get_color(), &values[0], &counts[0], values.size(), numeric_limits<double>::quiet_NaN());
+
+		if ((min >= 0.0) && (max <= 1.0)) {
+			if (n % 2 == 0) {
+				lambda = (pow(Rf_qnorm5(0.5 * select_value(n / 2), 0.0, 1.0, 0, 0), 2.0) + pow(Rf_qnorm5(0.5 * select_value(n / 2 - 1), 0.0, 1.0, 0, 0), 2.0)) / 2.0;
+			} else {
+				lambda = pow(Rf_qnorm5(0.5 * select_value((n - 1) / 2), 0.0, 1.0, 0, 0), 2.0);
+			}
+
+			lambda /= Rf_qchisq(0.5, 1.0, 0, 0);
+		}
+
+		qqplot->set_lambda(1, lambda);
+	} catch (PlotException &e) {
+		MetaException new_e(e);
+		new_e.add_message("MetaFiltered", "create_binned_qqplot()", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
+		throw new_e;
+	}
+}
+
+void MetaFiltered::set_low_memory(bool low_memory) throw (MetaException) {
+	MetaNumeric::set_low_memory(low_memory);
+
+	if ((low_memory) && (bitarray != NULL)) {
+		delete bitarray;
+		bitarray = NULL;
+	}
+}
+
+/*
+ * The selected values are saved as their positions in the data of the source.
+ * The state must be merged before the state of the source, since the positions are shifted by the current size of the source.
+ */
+void MetaFiltered::save_state(ostream& stream) throw (MetaException) {
+	unsigned char saved_numeric = 0;
+	uint64_t source_n = 0;
+
+	flush();
+
+	saved_numeric = numeric ? 1 : 0;
+
+	save_bytes(stream, &saved_numeric, sizeof(unsigned char));
+	save_bytes(stream, &n, sizeof(int64_t));
+	save_bytes(stream, &na, sizeof(int64_t));
+
+	if ((numeric) && (n > 0)) {
+		source_n = bitarray->get_total_bytes() * 8;
+		if (source_n > (uint64_t)source->get_n()) {
+			source_n = source->get_n();
+		}
+
+		for (uint64_t i = 0; i < source_n; i++) {
+			if (bitarray->get_bit(i) != 0) {
+				save_bytes(stream, &i, sizeof(uint64_t));
+			}
+		}
+	}
+}
+
+void MetaFiltered::merge_state(istream& stream) throw (MetaException) {
+	unsigned char saved_numeric = 0;
+	int64_t saved_n = 0;
+	int64_t saved_na = 0;
+	uint64_t position = 0;
+	uint64_t offset = (uint64_t)source->get_n();
+
+	load_bytes(stream, &saved_numeric, sizeof(unsigned char));
+	load_bytes(stream, &saved_n, sizeof(int64_t));
+	load_bytes(stream, &saved_na, sizeof(int64_t));
+
+	if ((saved_n < 0) || (saved_na < 0)) {
+		throw MetaException("MetaFiltered", "merge_state( istream& )", __LINE__, 5, actual_name != NULL ? actual_name : "NULL");
+	}
+
+	if ((saved_numeric == 0) || (saved_n == 0)) {
+		if ((numeric) && (saved_numeric == 0)) {
+			numeric = false;
+
+			free(data);
+			data = NULL;
+
+			delete bitarray;
+			bitarray = NULL;
+		}
+	} else if (!numeric) {
+		skip_bytes(stream, saved_n * sizeof(uint64_t));
+	} else {
+		try {
+			for (int64_t i = 0; i < saved_n; i++) {
+				load_bytes(stream, &position, sizeof(uint64_t));
+				bitarray->set_bit(offset + position);
+			}
+		} catch (BitArrayException &e) {
+			MetaException new_e(e);
+			new_e.add_message("MetaFiltered", "merge_state( istream& )", __LINE__, 5, actual_name != NULL ? actual_name : "NULL");
+			throw new_e;
+		}
+	}
+
+	n += saved_n;
+	na += saved_na;
+}
+
 void MetaFiltered::print(ostream& stream) {
 
 }
@@ -238,12 +589,14 @@ void MetaFiltered::print_html(ostream& stream, char path_separator) {
 }
 
 double MetaFiltered::get_memory_usage() {
-	unsigned long int memory = 0;
+	uint64_t memory = 0;
 
 	if (bitarray != NULL) {
 		memory += bitarray->get_total_bytes() * sizeof(unsigned char);
 	}
 
-	return memory / 1048576.0;
+	memory += qqplot_tail.capacity() * sizeof(double);
+
+	return memory / 1048576.0 + MetaNumeric::get_memory_usage();
 }
 
@@ -19,7 +19,7 @@
 
 #include "../../include/metas/MetaFormat.h"
 
-MetaFormat::MetaFormat(): Meta(), numeric(true), na_value(false), n(0) {
+MetaFormat::MetaFormat(): Meta(), numeric(true), na_value(false), n(0), value(numeric_limits<double>::quiet_NaN()) {
 
 }
 
@@ -28,24 +28,26 @@ MetaFormat::~MetaFormat() {
 }
 
 void MetaFormat::put(char* value) throw (MetaException) {
-	if (numeric) {
-		if (strcmp(na_marker, value) == 0) {
-			na_value = true;
-			return;
-		}
-		else {
-			na_value = false;
-		}
+	char* end_ptr = NULL;
 
-		char* end_ptr = NULL;
-		double d_value = 0.0;
+	if (is_na_marker(value)) {
+		na_value = true;
+		this->value = numeric_limits<double>::quiet_NaN();
+		return;
+	}
+	else {
+		na_value = false;
+	}
 
-		d_value = R_strtod(value, &end_ptr);
+	/* The value is parsed even after the column was found non-numeric, since other metas read it row by row. */
+	this->value = R_strtod(value, &end_ptr);
 
-		if (*end_ptr != '\0') {
-			numeric = false;
-		}
+	if (*end_ptr != '\0') {
+		this->value = numeric_limits<double>::quiet_NaN();
+		numeric = false;
+	}
 
+	if (numeric) {
 		n += 1;
 	}
 }
@@ -57,10 +59,35 @@ void MetaFormat::finalize() throw (MetaException) {
 	}
 }
 
+void MetaFormat::save_state(ostream& stream) throw (MetaException) {
+	unsigned char saved_numeric = numeric ? 1 : 0;
+
+	save_bytes(stream, &saved_numeric, sizeof(unsigned char));
+	save_bytes(stream, &n, sizeof(int64_t));
+}
+
+void MetaFormat::merge_state(istream& stream) throw (MetaException) {
+	unsigned char saved_numeric = 0;
+	int64_t saved_n = 0;
+
+	load_bytes(stream, &saved_numeric, sizeof(unsigned char));
+	load_bytes(stream, &saved_n, sizeof(int64_t));
+
+	if (saved_numeric == 0) {
+		numeric = false;
+	}
+
+	n += saved_n;
+}
+
 bool MetaFormat::is_na() {
 	return na_value;
 }
 
+double MetaFormat::get_value() {
+	return value;
+}
+
 void MetaFormat::print(ostream& stream) {
 	stream << resetiosflags(stream.flags());
 	stream << setfill(' ');
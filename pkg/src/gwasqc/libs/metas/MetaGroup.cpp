@@ -19,39 +19,216 @@
 
 #include "../../include/metas/MetaGroup.h"
 
-MetaGroup::MetaGroup(bool trim_output): Meta(), na_value(false), new_value(NULL), groups(bool_strcmp), trim_output(trim_output) {
+const unsigned int MetaGroup::SMALL_GROUPS = 32;
+const unsigned int MetaGroup::INITIAL_SLOTS = 128;
+const unsigned int MetaGroup::POOL_SIZE = 65536;
+
+MetaGroup::MetaGroup(bool trim_output): Meta(), na_value(false), current_group(-1), groups(NULL), n_groups(0), heap_groups(0),
+	slots(NULL), n_slots(0), pool_used(0), trim_output(trim_output) {
 }
 
 MetaGroup::~MetaGroup() {
-	for (groups_it = groups.begin(); groups_it != groups.end(); groups_it++) {
-		free(groups_it->first);
+	vector<char*>::iterator pools_it;
+
+	if (groups != NULL) {
+		free(groups);
+		groups = NULL;
+	}
+
+	if (slots != NULL) {
+		free(slots);
+		slots = NULL;
+	}
+
+	for (pools_it = pools.begin(); pools_it != pools.end(); pools_it++) {
+		free(*pools_it);
+	}
+
+	pools.clear();
+}
+
+char* MetaGroup::intern(const char* value) throw (MetaException) {
+	unsigned int length = strlen(value) + 1;
+	char* pool = NULL;
+	char* name = NULL;
+
+	if (length > POOL_SIZE) {
+		pool = (char*)malloc(length * sizeof(char));
+		if (pool == NULL) {
+			throw MetaException("MetaGroup", "intern( const char* )", __LINE__, 2, length * sizeof(char));
+		}
+		strcpy(pool, value);
+
+		/* Dedicated pool is inserted before the current one, which keeps its free space. */
+		pools.insert(pools.empty() ? pools.end() : pools.end() - 1, pool);
+
+		return pool;
+	}
+
+	if ((pools.empty()) || (pool_used + length > POOL_SIZE)) {
+		pool = (char*)malloc(POOL_SIZE * sizeof(char));
+		if (pool == NULL) {
+			throw MetaException("MetaGroup", "intern( const char* )", __LINE__, 2, POOL_SIZE * sizeof(char));
+		}
+		pools.push_back(pool);
+		pool_used = 0;
+	}
+
+	name = pools.back() + pool_used;
+	strcpy(name, value);
+	pool_used += length;
+
+	return name;
+}
+
+MetaGroup::group_entry* MetaGroup::find_group(const char* value, uint64_t hash) {
+	unsigned int mask = 0;
+	unsigned int position = 0;
+	group_entry* group = NULL;
+
+	if (slots == NULL) {
+		for (unsigned int i = 0; i < n_groups; i++) {
+			if ((groups[i].hash == hash) && (strcmp(groups[i].name, value) == 0)) {
+				return &groups[i];
+			}
+		}
+
+		return NULL;
+	}
+
+	mask = n_slots - 1;
+	position = (unsigned int)(hash & mask);
+
+	while (slots[position] != 0) {
+		group = &groups[slots[position] - 1];
+		if ((group->hash == hash) && (strcmp(group->name, value) == 0)) {
+			return group;
+		}
+		position = (position + 1) & mask;
+	}
+
+	return NULL;
+}
+
+void MetaGroup::add_group(const char* value, uint64_t hash, int64_t count) throw (MetaException) {
+	group_entry* new_groups = NULL;
+	unsigned int mask = 0;
+	unsigned int position = 0;
+
+	if (n_groups >= heap_groups) {
+		heap_groups = (heap_groups == 0) ? SMALL_GROUPS : heap_groups * 2;
+
+		new_groups = (group_entry*)realloc(groups, heap_groups * sizeof(group_entry));
+		if (new_groups == NULL) {
+			throw MetaException("MetaGroup", "add_group( const char*, uint64_t, int64_t )", __LINE__, 3, heap_groups * sizeof(group_entry));
+		}
+		groups = new_groups;
+	}
+
+	groups[n_groups].hash = hash;
+	groups[n_groups].name = intern(value);
+	groups[n_groups].count = count;
+	n_groups += 1;
+
+	if (slots == NULL) {
+		if (n_groups >= SMALL_GROUPS) {
+			rehash(INITIAL_SLOTS);
+		}
+	} else if (2 * n_groups > n_slots) {
+		rehash(2 * n_slots);
+	} else {
+		mask = n_slots - 1;
+		position = (unsigned int)(hash & mask);
+		while (slots[position] != 0) {
+			position = (position + 1) & mask;
+		}
+		slots[position] = n_groups;
+	}
+}
+
+void MetaGroup::rehash(unsigned int new_n_slots) throw (MetaException) {
+	unsigned int* new_slots = NULL;
+	unsigned int mask = new_n_slots - 1;
+	unsigned int position = 0;
+
+	new_slots = (unsigned int*)calloc(new_n_slots, sizeof(unsigned int));
+	if (new_slots == NULL) {
+		throw MetaException("MetaGroup", "rehash( unsigned int )", __LINE__, 2, new_n_slots * sizeof(unsigned int));
+	}
+
+	for (unsigned int i = 0; i < n_groups; i++) {
+		position = (unsigned int)(groups[i].hash & mask);
+		while (new_slots[position] != 0) {
+			position = (position + 1) & mask;
+		}
+		new_slots[position] = i + 1;
+	}
+
+	free(slots);
+	slots = new_slots;
+	n_slots = new_n_slots;
+}
+
+int MetaGroup::qsort_group_entry_cmp(const void* first, const void* second) {
+	return strcmp((*(group_entry**)first)->name, (*(group_entry**)second)->name);
+}
+
+MetaGroup::group_entry** MetaGroup::sort_groups() throw (MetaException) {
+	group_entry** sorted_groups = NULL;
+
+	sorted_groups = (group_entry**)malloc(n_groups * sizeof(group_entry*));
+	if (sorted_groups == NULL) {
+		throw MetaException("MetaGroup", "sort_groups()", __LINE__, 2, n_groups * sizeof(group_entry*));
+	}
+
+	for (unsigned int i = 0; i < n_groups; i++) {
+		sorted_groups[i] = &groups[i];
 	}
 
-	groups.clear();
+	qsort(sorted_groups, n_groups, sizeof(group_entry*), qsort_group_entry_cmp);
+
+	return sorted_groups;
 }
 
 void MetaGroup::put(char* value) throw (MetaException) {
-	if (strcmp(na_marker, value) == 0) {
+	uint64_t hash = 0;
+	group_entry* group = NULL;
+
+	if (is_na_marker(value)) {
 		na_value = true;
+		current_group = -1;
 		return;
 	}
 	else {
 		na_value = false;
 	}
 
-	groups_it = groups.find(value);
+	hash = auxiliary::hash64(value);
 
-	if (groups_it != groups.end()) {
-		groups_it->second += 1;
+	if ((group = find_group(value, hash)) != NULL) {
+		group->count += 1;
+		current_group = group - groups;
 	}
 	else {
-		new_value = (char*)malloc((strlen(value) + 1) * sizeof(char));
-		if (new_value == NULL) {
-			throw MetaException("MetaGroup", "put( char* )", __LINE__, 2, (strlen(value) + 1) * sizeof(char));
-		}
-		strcpy(new_value, value);
+		add_group(value, hash, 1);
+		current_group = n_groups - 1;
+	}
+}
+
+void MetaGroup::merge(MetaGroup* other) throw (MetaException) {
+	group_entry* group = NULL;
 
-		groups.insert(pair<char*, int>(new_value, 1));
+	if (other == NULL) {
+		throw MetaException("MetaGroup", "merge( MetaGroup* )", __LINE__, 0, "other");
+	}
+
+	for (unsigned int i = 0; i < other->n_groups; i++) {
+		if ((group = find_group(other->groups[i].name, other->groups[i].hash)) != NULL) {
+			group->count += other->groups[i].count;
+		}
+		else {
+			add_group(other->groups[i].name, other->groups[i].hash, other->groups[i].count);
+		}
 	}
 }
 
@@ -59,16 +236,88 @@ void MetaGroup::finalize() throw (MetaException) {
 
 }
 
+void MetaGroup::save_state(ostream& stream) throw (MetaException) {
+	unsigned int length = 0;
+
+	save_bytes(stream, &n_groups, sizeof(unsigned int));
+
+	for (unsigned int i = 0; i < n_groups; i++) {
+		length = strlen(groups[i].name);
+		save_bytes(stream, &groups[i].count, sizeof(int64_t));
+		save_bytes(stream, &length, sizeof(unsigned int));
+		save_bytes(stream, groups[i].name, length * sizeof(char));
+	}
+}
+
+void MetaGroup::merge_state(istream& stream) throw (MetaException) {
+	group_entry* group = NULL;
+	unsigned int saved_n_groups = 0;
+	unsigned int length = 0;
+	int64_t count = 0;
+	char* name = NULL;
+	uint64_t hash = 0;
+
+	load_bytes(stream, &saved_n_groups, sizeof(unsigned int));
+
+	for (unsigned int i = 0; i < saved_n_groups; i++) {
+		load_bytes(stream, &count, sizeof(int64_t));
+		load_bytes(stream, &length, sizeof(unsigned int));
+
+		name = (char*)malloc((length + 1) * sizeof(char));
+		if (name == NULL) {
+			throw MetaException("MetaGroup", "merge_state( istream& )", __LINE__, 2, (length + 1) * sizeof(char));
+		}
+
+		try {
+			load_bytes(stream, name, length * sizeof(char));
+			name[length] = '\0';
+
+			hash = auxiliary::hash64(name);
+
+			if ((group = find_group(name, hash)) != NULL) {
+				group->count += count;
+			}
+			else {
+				add_group(name, hash, count);
+			}
+		} catch (MetaException &e) {
+			free(name);
+			throw;
+		}
+
+		free(name);
+		name = NULL;
+	}
+}
+
 bool MetaGroup::is_na() {
 	return na_value;
 }
 
+int MetaGroup::get_group() {
+	return current_group;
+}
+
+unsigned int MetaGroup::get_groups_count() {
+	return n_groups;
+}
+
+const char* MetaGroup::get_group_name(unsigned int group) {
+	if (group >= n_groups) {
+		return NULL;
+	}
+
+	return groups[group].name;
+}
+
 void MetaGroup::print(ostream& stream) {
-	if (!groups.empty()) {
-		map<int, int> numeric_groups;
-		map<int, int>::iterator numeric_groups_it;
-		vector< pair<const char*, int> > non_numeric_groups;
-		vector< pair<const char*, int> >::iterator non_numeric_groups_it;
+	if (n_groups > 0) {
+		group_entry** sorted_groups = sort_groups();
+		group_entry* group = NULL;
+		map<int, int64_t> numeric_groups;
+		map<int, int64_t>::iterator numeric_groups_it;
+		vector< pair<const char*, int64_t> > non_numeric_groups;
+		vector< pair<const char*, int64_t> >::iterator non_numeric_groups_it;
 		int numeric_value = 0;
 		char* end_ptr = NULL;
 
@@ -76,19 +325,21 @@ void MetaGroup::print(ostream& stream) {
 		unsigned int other_non_numerics = 0u;
 
 		if (trim_output) {
-			for (groups_it = groups.begin(); groups_it != groups.end(); groups_it++) {
-				numeric_value = strtol(groups_it->first, &end_ptr, 10);
+			for (unsigned int i = 0; i < n_groups; i++) {
+				group = sorted_groups[i];
+
+				numeric_value = strtol(group->name, &end_ptr, 10);
 				if (*end_ptr == '\0') {
-					if (max_length < strlen(groups_it->first)) {
-						max_length = strlen(groups_it->first);
+					if (max_length < strlen(group->name)) {
+						max_length = strlen(group->name);
 					}
 
-					numeric_groups.insert(pair<int, int>(numeric_value, groups_it->second));
+					numeric_groups.insert(pair<int, int64_t>(numeric_value, group->count));
 				} else {
-					if (strlen(groups_it->first) > 1u) {
+					if (strlen(group->name) > 1u) {
 						other_non_numerics += 1u;
 					} else {
-						non_numeric_groups.push_back(pair<const char*, int>(groups_it->first, groups_it->second));
+						non_numeric_groups.push_back(pair<const char*, int64_t>(group->name, group->count));
 					}
 				}
 			}
@@ -97,19 +348,21 @@ void MetaGroup::print(ostream& stream) {
 				if (max_length < strlen("OTHERS (LENGTH > 1)")) {
 					max_length = strlen("OTHERS (LENGTH > 1)");
 				}
-				non_numeric_groups.push_back(pair<const char*, int>("OTHERS (LENGTH > 1)", other_non_numerics));
+				non_numeric_groups.push_back(pair<const char*, int64_t>("OTHERS (LENGTH > 1)", other_non_numerics));
 			}
 		} else {
-			for (groups_it = groups.begin(); groups_it != groups.end(); groups_it++) {
-				if (max_length < strlen(groups_it->first)) {
-					max_length = strlen(groups_it->first);
+			for (unsigned int i = 0; i < n_groups; i++) {
+				group = sorted_groups[i];
+
+				if (max_length < strlen(group->name)) {
+					max_length = strlen(group->name);
 				}
 
-				numeric_value = strtol(groups_it->first, &end_ptr, 10);
+				numeric_value = strtol(group->name, &end_ptr, 10);
 				if (*end_ptr == '\0') {
-					numeric_groups.insert(pair<int, int>(numeric_value, groups_it->second));
+					numeric_groups.insert(pair<int, int64_t>(numeric_value, group->count));
 				} else {
-					non_numeric_groups.push_back(pair<const char*, int>(groups_it->first, groups_it->second));
+					non_numeric_groups.push_back(pair<const char*, int64_t>(group->name, group->count));
 				}
 			}
 		}
@@ -129,45 +382,53 @@ void MetaGroup::print(ostream& stream) {
 
 		numeric_groups.clear();
 		non_numeric_groups.clear();
+
+		free(sorted_groups);
 	}
 }
 
 void MetaGroup::print_html(ostream& stream, char path_separator) {
-	if (!groups.empty()) {
-		map<int, int> numeric_groups;
-		map<int, int>::iterator numeric_groups_it;
-		vector< pair<const char*, int> > non_numeric_groups;
-		vector< pair<const char*, int> >::iterator non_numeric_groups_it;
+	if (n_groups > 0) {
+		group_entry** sorted_groups = sort_groups();
+		group_entry* group = NULL;
+		map<int, int64_t> numeric_groups;
+		map<int, int64_t>::iterator numeric_groups_it;
+		vector< pair<const char*, int64_t> > non_numeric_groups;
+		vector< pair<const char*, int64_t> >::iterator non_numeric_groups_it;
 		int numeric_value = 0;
 		char* end_ptr = NULL;
 
 		unsigned int other_non_numerics = 0u;
 
 		if (trim_output) {
-			for (groups_it = groups.begin(); groups_it != groups.end(); groups_it++) {
-				numeric_value = strtol(groups_it->first, &end_ptr, 10);
+			for (unsigned int i = 0; i < n_groups; i++) {
+				group = sorted_groups[i];
+
+				numeric_value = strtol(group->name, &end_ptr, 10);
 				if (*end_ptr == '\0') {
-					numeric_groups.insert(pair<int, int>(numeric_value, groups_it->second));
+					numeric_groups.insert(pair<int, int64_t>(numeric_value, group->count));
 				} else {
-					if (strlen(groups_it->first) > 1u) {
+					if (strlen(group->name) > 1u) {
 						other_non_numerics += 1u;
 					} else {
-						non_numeric_groups.push_back(pair<const char*, int>(groups_it->first, groups_it->second));
+						non_numeric_groups.push_back(pair<const char*, int64_t>(group->name, group->count));
 					}
 				}
 			}
 
 			if (other_non_numerics > 1u) {
-				non_numeric_groups.push_back(pair<const char*, int>("OTHERS (LENGTH > 1)", other_non_numerics));
+				non_numeric_groups.push_back(pair<const char*, int64_t>("OTHERS (LENGTH > 1)", other_non_numerics));
 			}
 		} else {
-			for (groups_it = groups.begin(); groups_it != groups.end(); groups_it++) {
-				numeric_value = strtol(groups_it->first, &end_ptr, 10);
+			for (unsigned int i = 0; i < n_groups; i++) {
+				group = sorted_groups[i];
+
+				numeric_value = strtol(group->name, &end_ptr, 10);
 				if (*end_ptr == '\0') {
-					numeric_groups.insert(pair<int, int>(numeric_value, groups_it->second));
+					numeric_groups.insert(pair<int, int64_t>(numeric_value, group->count));
 				}
 				else {
-					non_numeric_groups.push_back(pair<const char*, int>(groups_it->first, groups_it->second));
+					non_numeric_groups.push_back(pair<const char*, int64_t>(group->name, group->count));
 				}
 			}
 		}
@@ -193,17 +454,17 @@ void MetaGroup::print_html(ostream& stream, char path_separator) {
 
 		numeric_groups.clear();
 		non_numeric_groups.clear();
+
+		free(sorted_groups);
 	}
 }
 
 double MetaGroup::get_memory_usage() {
-	unsigned long int memory = 0;
+	uint64_t memory = 0;
 
-	for (groups_it = groups.begin(); groups_it != groups.end(); groups_it++) {
-		memory += (strlen(groups_it->first) + 1) * sizeof(char);
-		memory += sizeof(int);
-		memory += sizeof(char*);
-	}
+	memory += pools.size() * POOL_SIZE * sizeof(char);
+	memory += heap_groups * sizeof(group_entry);
+	memory += n_slots * sizeof(unsigned int);
 
 	return memory / 1048576.0;
 }
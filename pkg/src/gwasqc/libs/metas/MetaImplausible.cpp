@@ -37,7 +37,7 @@ MetaImplausible::~MetaImplausible() {
 
 void MetaImplausible::put(char* value) throw (MetaException) {
 	if (numeric) {
-		if (strcmp(na_marker, value) == 0) {
+		if (is_na_marker(value)) {
 			na_value = true;
 			na += 1;
 			value_saved = false;
@@ -54,8 +54,7 @@ void MetaImplausible::put(char* value) throw (MetaException) {
 			numeric = false;
 			value_saved = false;
 			this->value = numeric_limits<double>::quiet_NaN();
-			free(data);
-			data = NULL;
+			release_data();
 			return;
 		}
 
@@ -81,26 +80,42 @@ void MetaImplausible::put(char* value) throw (MetaException) {
 			return;
 		}
 
-		n += 1;
-
-		if (n > current_heap_size) {
-			current_heap_size += Meta::HEAP_INCREMENT;
-
-			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-			if (new_data == NULL) {
-				free(data);
-				data = NULL;
-				throw MetaException("MetaImplausible", "put( char* )", __LINE__, 3, current_heap_size * sizeof(double));
-			}
-			data = new_data;
-		}
+		save_value(d_value);
 
 		value_saved = true;
-		data[n - 1] = d_value;
 	}
 }
 
 
+void MetaImplausible::save_state(ostream& stream) throw (MetaException) {
+	MetaNumeric::save_state(stream);
+
+	save_bytes(stream, &n_less, sizeof(int64_t));
+	save_bytes(stream, &n_greater, sizeof(int64_t));
+}
+
+void MetaImplausible::merge_state(istream& stream) throw (MetaException) {
+	int64_t saved_n_less = 0;
+	int64_t saved_n_greater = 0;
+
+	MetaNumeric::merge_state(stream);
+
+	load_bytes(stream, &saved_n_less, sizeof(int64_t));
+	load_bytes(stream, &saved_n_greater, sizeof(int64_t));
+
+	n_less += saved_n_less;
+	n_greater += saved_n_greater;
+}
+
+void MetaImplausible::begin_refinement() throw (MetaException) {
+	MetaNumeric::begin_refinement();
+
+	if (low_memory) {
+		n_less = 0;
+		n_greater = 0;
+	}
+}
+
 void MetaImplausible::print(ostream& stream) {
 	stream << resetiosflags(stream.flags());
 	stream << setfill(' ');
@@ -161,6 +176,8 @@ void MetaImplausible::print(ostream& stream) {
 			stream << "\t = " << setprecision(3) << quantiles[8][1] << endl;
 		}
 
+		print_intervals(stream);
+
 		stream << resetiosflags(stream.flags());
 		stream << setfill(' ');
 	}
@@ -237,6 +254,8 @@ void MetaImplausible::print_html(ostream& stream, char path_separator) {
 			stream << "</div>";
 		}
 
+		print_intervals_html(stream);
+
 		if (get_plot() != NULL)  {
 			stream << "<div class = \"float\">";
 			stream << "<a href = \"" << (auxiliary::is_absolute_path(get_plot()->get_name(), path_separator) ? "file:///" : "") << get_plot()->get_name() << ".png\">";
@@ -30,7 +30,7 @@ MetaImplausibleStrictAdjusted::~MetaImplausibleStrictAdjusted() {
 
 void MetaImplausibleStrictAdjusted::put(char* value) throw (MetaException) {
 	if (numeric) {
-		if (strcmp(na_marker, value) == 0) {
+		if (is_na_marker(value)) {
 			na_value = true;
 			na += 1;
 			value_saved = false;
@@ -47,8 +47,7 @@ void MetaImplausibleStrictAdjusted::put(char* value) throw (MetaException) {
 			numeric = false;
 			value_saved = false;
 			this->value = numeric_limits<double>::quiet_NaN();
-			free(data);
-			data = NULL;
+			release_data();
 			return;
 		}
 
@@ -74,22 +73,9 @@ void MetaImplausibleStrictAdjusted::put(char* value) throw (MetaException) {
 			return;
 		}
 
-		n += 1;
-
-		if (n > current_heap_size) {
-			current_heap_size += Meta::HEAP_INCREMENT;
-
-			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-			if (new_data == NULL) {
-				free(data);
-				data = NULL;
-				throw MetaException("MetaImplausibleStrictAdjusted", "put( char* )", __LINE__, 3, current_heap_size * sizeof(double));
-			}
-			data = new_data;
-		}
+		save_value(this->value);
 
 		value_saved = true;
-		data[n - 1] = this->value;
 	}
 }
 
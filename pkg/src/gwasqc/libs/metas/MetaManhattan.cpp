@@ -0,0 +1,637 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../include/metas/MetaManhattan.h"
+
+const unsigned int MetaManhattan::INITIAL_SLOTS = 1024;
+const unsigned int MetaManhattan::INITIAL_SHIFT = 12;
+const unsigned int MetaManhattan::MAX_SHIFT = 40;
+const unsigned int MetaManhattan::MAX_CELLS = 131072;
+const unsigned int MetaManhattan::Y_BINS = 250;
+const double MetaManhattan::THRESHOLD = 0.00001;
+
+MetaManhattan::MetaManhattan(MetaGroup* chr_meta, MetaFormat* position_meta, MetaNumeric* pvalue_meta) : Meta(),
+	chr_meta(chr_meta), position_meta(position_meta), pvalue_meta(pvalue_meta),
+	chromosomes(NULL), n_chromosomes(0), heap_chromosomes(0),
+	group_chromosomes(NULL), n_group_chromosomes(0),
+	significant(NULL), n_significant(0), heap_significant(0),
+	shift(INITIAL_SHIFT), n(0), manhattan(NULL), plot(NULL), color(NULL) {
+
+	cells.entries = NULL;
+	cells.n_entries = 0;
+	cells.n_slots = 0;
+}
+
+MetaManhattan::~MetaManhattan() {
+	for (unsigned int i = 0; i < n_chromosomes; i++) {
+		free(chromosomes[i].name);
+	}
+
+	free(chromosomes);
+	free(group_chromosomes);
+	free(significant);
+	free(cells.entries);
+	free(color);
+
+	delete manhattan;
+
+	chromosomes = NULL;
+	group_chromosomes = NULL;
+	significant = NULL;
+	cells.entries = NULL;
+	color = NULL;
+	manhattan = NULL;
+}
+
+uint64_t MetaManhattan::hash_cell(int chromosome, uint64_t x_bin, unsigned int y_bin) {
+	uint64_t hash = 0;
+
+	hash = x_bin ^ ((uint64_t)chromosome << 40) ^ ((uint64_t)y_bin * 0x9e3779b97f4a7c15ULL);
+
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+
+	return hash;
+}
+
+int MetaManhattan::find_chromosome(const char* name) {
+	for (unsigned int i = 0; i < n_chromosomes; i++) {
+		if (strcmp(chromosomes[i].name, name) == 0) {
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+int MetaManhattan::add_chromosome(const char* name, double length) throw (MetaException) {
+	chromosome_entry* new_chromosomes = NULL;
+
+	if (n_chromosomes >= heap_chromosomes) {
+		heap_chromosomes = heap_chromosomes == 0 ? 32 : 2 * heap_chromosomes;
+		new_chromosomes = (chromosome_entry*)realloc(chromosomes, heap_chromosomes * sizeof(chromosome_entry));
+		if (new_chromosomes == NULL) {
+			throw MetaException("MetaManhattan", "add_chromosome( const char*, double )", __LINE__, 3, heap_chromosomes * sizeof(chromosome_entry));
+		}
+		chromosomes = new_chromosomes;
+	}
+
+	chromosomes[n_chromosomes].name = (char*)malloc((strlen(name) + 1) * sizeof(char));
+	if (chromosomes[n_chromosomes].name == NULL) {
+		throw MetaException("MetaManhattan", "add_chromosome( const char*, double )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
+	}
+	strcpy(chromosomes[n_chromosomes].name, name);
+	chromosomes[n_chromosomes].length = length;
+
+	return n_chromosomes++;
+}
+
+/*
+ * Maps the group of the CHR column to the chromosome of the plot. Groups never change their positions, so the
+ * chromosome names are compared only once per group.
+ */
+int MetaManhattan::get_chromosome(int group) throw (MetaException) {
+	int* new_group_chromosomes = NULL;
+	unsigned int new_n_group_chromosomes = 0;
+	const char* name = NULL;
+	int chromosome = -1;
+
+	if ((unsigned int)group >= n_group_chromosomes) {
+		new_n_group_chromosomes = chr_meta->get_groups_count();
+		new_group_chromosomes = (int*)realloc(group_chromosomes, new_n_group_chromosomes * sizeof(int));
+		if (new_group_chromosomes == NULL) {
+			throw MetaException("MetaManhattan", "get_chromosome( int )", __LINE__, 3, new_n_group_chromosomes * sizeof(int));
+		}
+
+		for (unsigned int i = n_group_chromosomes; i < new_n_group_chromosomes; i++) {
+			new_group_chromosomes[i] = -1;
+		}
+
+		group_chromosomes = new_group_chromosomes;
+		n_group_chromosomes = new_n_group_chromosomes;
+	}
+
+	if ((chromosome = group_chromosomes[group]) < 0) {
+		name = chr_meta->get_group_name(group);
+		if ((chromosome = find_chromosome(name)) < 0) {
+			chromosome = add_chromosome(name, 0.0);
+		}
+		group_chromosomes[group] = chromosome;
+	}
+
+	return chromosome;
+}
+
+void MetaManhattan::add_significant(int chromosome, double position, double pvalue) throw (MetaException) {
+	point_entry* new_significant = NULL;
+
+	if (n_significant >= heap_significant) {
+		heap_significant = heap_significant == 0 ? 1024 : 2 * heap_significant;
+		new_significant = (point_entry*)realloc(significant, heap_significant * sizeof(point_entry));
+		if (new_significant == NULL) {
+			throw MetaException("MetaManhattan", "add_significant( int, double, double )", __LINE__, 3, heap_significant * sizeof(point_entry));
+		}
+		significant = new_significant;
+	}
+
+	significant[n_significant].position = position;
+	significant[n_significant].pvalue = pvalue;
+	significant[n_significant].chromosome = chromosome;
+
+	n_significant += 1;
+}
+
+void MetaManhattan::add_cell(int chromosome, double position, double pvalue) throw (MetaException) {
+	cell_entry* entry = NULL;
+	uint64_t x_bin = (uint64_t)position >> shift;
+	unsigned int y_bin = (unsigned int)(-log10(pvalue) / -log10(THRESHOLD) * Y_BINS);
+
+	if (y_bin >= Y_BINS) {
+		y_bin = Y_BINS - 1;
+	}
+
+	entry = lookup(cells, chromosome, x_bin, y_bin);
+
+	/* The smallest p-value (and then the smallest position) wins, whatever the order of the rows. */
+	if ((pvalue < entry->pvalue) || ((pvalue == entry->pvalue) && (position < entry->position))) {
+		entry->position = position;
+		entry->pvalue = pvalue;
+	}
+
+	while ((cells.n_entries > MAX_CELLS) && (shift < MAX_SHIFT)) {
+		coarsen();
+	}
+}
+
+MetaManhattan::cell_entry* MetaManhattan::lookup(cell_table& table, int chromosome, uint64_t x_bin, unsigned int y_bin) throw (MetaException) {
+	unsigned int mask = 0;
+	unsigned int position = 0;
+	cell_entry* entry = NULL;
+
+	if (table.entries == NULL) {
+		rehash(table, INITIAL_SLOTS);
+	} else if (2 * (table.n_entries + 1) > table.n_slots) {
+		rehash(table, 2 * table.n_slots);
+	}
+
+	mask = table.n_slots - 1;
+	position = (unsigned int)(hash_cell(chromosome, x_bin, y_bin) & mask);
+
+	while ((entry = &table.entries[position])->used) {
+		if ((entry->chromosome == chromosome) && (entry->x_bin == x_bin) && (entry->y_bin == y_bin)) {
+			return entry;
+		}
+		position = (position + 1) & mask;
+	}
+
+	entry->x_bin = x_bin;
+	entry->y_bin = y_bin;
+	entry->chromosome = chromosome;
+	entry->position = numeric_limits<double>::infinity();
+	entry->pvalue = numeric_limits<double>::infinity();
+	entry->used = true;
+
+	table.n_entries += 1;
+
+	return entry;
+}
+
+void MetaManhattan::rehash(cell_table& table, unsigned int new_n_slots) throw (MetaException) {
+	cell_entry* new_entries = NULL;
+	unsigned int mask = new_n_slots - 1;
+	unsigned int position = 0;
+
+	new_entries = (cell_entry*)calloc(new_n_slots, sizeof(cell_entry));
+	if (new_entries == NULL) {
+		throw MetaException("MetaManhattan", "rehash( cell_table&, unsigned int )", __LINE__, 2, new_n_slots * sizeof(cell_entry));
+	}
+
+	for (unsigned int i = 0; i < table.n_slots; i++) {
+		if (table.entries[i].used) {
+			position = (unsigned int)(hash_cell(table.entries[i].chromosome, table.entries[i].x_bin, table.entries[i].y_bin) & mask);
+			while (new_entries[position].used) {
+				position = (position + 1) & mask;
+			}
+			new_entries[position] = table.entries[i];
+		}
+	}
+
+	free(table.entries);
+	table.entries = new_entries;
+	table.n_slots = new_n_slots;
+}
+
+/* Doubles the width of the position bins. Neighbouring cells are joined and keep the smallest p-value. */
+void MetaManhattan::coarsen() throw (MetaException) {
+	cell_table old_cells = cells;
+	cell_entry* entry = NULL;
+
+	cells.entries = NULL;
+	cells.n_entries = 0;
+	cells.n_slots = 0;
+
+	shift += 1;
+
+	try {
+		for (unsigned int i = 0; i < old_cells.n_slots; i++) {
+			if (old_cells.entries[i].used) {
+				entry = lookup(cells, old_cells.entries[i].chromosome, old_cells.entries[i].x_bin >> 1, old_cells.entries[i].y_bin);
+				if ((old_cells.entries[i].pvalue < entry->pvalue) ||
+						((old_cells.entries[i].pvalue == entry->pvalue) && (old_cells.entries[i].position < entry->position))) {
+					entry->position = old_cells.entries[i].position;
+					entry->pvalue = old_cells.entries[i].pvalue;
+				}
+			}
+		}
+	} catch (MetaException &e) {
+		free(old_cells.entries);
+		throw;
+	}
+
+	free(old_cells.entries);
+}
+
+void MetaManhattan::put(char* value) throw (MetaException) {
+	int group = 0;
+	int chromosome = 0;
+	double position = 0.0;
+	double pvalue = 0.0;
+
+	if (!pvalue_meta->is_numeric()) {
+		return;
+	}
+
+	if ((group = chr_meta->get_group()) < 0) {
+		return;
+	}
+
+	position = position_meta->get_value();
+	if (isnan(position) || isinf(position) || (position < 0.0)) {
+		return;
+	}
+
+	pvalue = pvalue_meta->get_value();
+	if (isnan(pvalue) || (pvalue < 0.0) || (pvalue > 1.0)) {
+		return;
+	}
+
+	/* P-values which underflowed to 0 are plotted at the top of the range of doubles. */
+	if (pvalue == 0.0) {
+		pvalue = numeric_limits<double>::min();
+	}
+
+	chromosome = get_chromosome(group);
+
+	if (position > chromosomes[chromosome].length) {
+		chromosomes[chromosome].length = position;
+	}
+
+	n += 1;
+
+	if (pvalue < THRESHOLD) {
+		add_significant(chromosome, position, pvalue);
+	} else {
+		add_cell(chromosome, position, pvalue);
+	}
+}
+
+void MetaManhattan::finalize() throw (MetaException) {
+	const char** names = NULL;
+	double* lengths = NULL;
+	int* point_chromosomes = NULL;
+	double* positions = NULL;
+	double* pvalues = NULL;
+	int64_t size = n_significant + cells.n_entries;
+	int64_t point = 0;
+
+	delete manhattan;
+	manhattan = NULL;
+
+	if (n == 0) {
+		return;
+	}
+
+	names = (const char**)malloc(n_chromosomes * sizeof(const char*));
+	lengths = (double*)malloc(n_chromosomes * sizeof(double));
+	point_chromosomes = (int*)malloc(size * sizeof(int));
+	positions = (double*)malloc(size * sizeof(double));
+	pvalues = (double*)malloc(size * sizeof(double));
+	if ((names == NULL) || (lengths == NULL) || (point_chromosomes == NULL) || (positions == NULL) || (pvalues == NULL)) {
+		free(names);
+		free(lengths);
+		free(point_chromosomes);
+		free(positions);
+		free(pvalues);
+		throw MetaException("MetaManhattan", "finalize()", __LINE__, 2, size * sizeof(double));
+	}
+
+	for (unsigned int i = 0; i < n_chromosomes; i++) {
+		names[i] = chromosomes[i].name;
+		lengths[i] = chromosomes[i].length;
+	}
+
+	for (int64_t i = 0; i < n_significant; i++, point++) {
+		point_chromosomes[point] = significant[i].chromosome;
+		positions[point] = significant[i].position;
+		pvalues[point] = significant[i].pvalue;
+	}
+
+	for (unsigned int i = 0; i < cells.n_slots; i++) {
+		if (cells.entries[i].used) {
+			point_chromosomes[point] = cells.entries[i].chromosome;
+			positions[point] = cells.entries[i].position;
+			pvalues[point] = cells.entries[i].pvalue;
+			point += 1;
+		}
+	}
+
+	try {
+		manhattan = Manhattan::create(names, lengths, n_chromosomes, point_chromosomes, positions, pvalues, size, THRESHOLD, n);
+	} catch (PlotException &e) {
+		free(names);
+		free(lengths);
+		free(point_chromosomes);
+		free(positions);
+		free(pvalues);
+
+		MetaException new_e(e);
+		new_e.add_message("MetaManhattan", "finalize()", __LINE__, 4, pvalue_meta->get_actual_name());
+		throw new_e;
+	}
+
+	free(names);
+	free(lengths);
+	free(point_chromosomes);
+	free(positions);
+	free(pvalues);
+}
+
+void MetaManhattan::save_state(ostream& stream) throw (MetaException) {
+	unsigned int length = 0;
+
+	save_bytes(stream, &n, sizeof(int64_t));
+	save_bytes(stream, &shift, sizeof(unsigned int));
+
+	save_bytes(stream, &n_chromosomes, sizeof(unsigned int));
+	for (unsigned int i = 0; i < n_chromosomes; i++) {
+		length = strlen(chromosomes[i].name);
+		save_bytes(stream, &chromosomes[i].length, sizeof(double));
+		save_bytes(stream, &length, sizeof(unsigned int));
+		save_bytes(stream, chromosomes[i].name, length * sizeof(char));
+	}
+
+	save_bytes(stream, &n_significant, sizeof(int64_t));
+	for (int64_t i = 0; i < n_significant; i++) {
+		save_bytes(stream, &significant[i].chromosome, sizeof(int));
+		save_bytes(stream, &significant[i].position, sizeof(double));
+		save_bytes(stream, &significant[i].pvalue, sizeof(double));
+	}
+
+	save_bytes(stream, &cells.n_entries, sizeof(unsigned int));
+	for (unsigned int i = 0; (cells.entries != NULL) && (i < cells.n_slots); i++) {
+		if (cells.entries[i].used) {
+			save_bytes(stream, &cells.entries[i].chromosome, sizeof(int));
+			save_bytes(stream, &cells.entries[i].position, sizeof(double));
+			save_bytes(stream, &cells.entries[i].pvalue, sizeof(double));
+		}
+	}
+}
+
+void MetaManhattan::merge_state(istream& stream) throw (MetaException) {
+	int64_t saved_n = 0;
+	unsigned int saved_shift = 0;
+	unsigned int saved_n_chromosomes = 0;
+	int64_t saved_n_significant = 0;
+	unsigned int saved_n_cells = 0;
+	int* saved_chromosomes = NULL;
+	char* name = NULL;
+	unsigned int length = 0;
+	double chromosome_length = 0.0;
+	int chromosome = 0;
+	double position = 0.0;
+	double pvalue = 0.0;
+
+	load_bytes(stream, &saved_n, sizeof(int64_t));
+	load_bytes(stream, &saved_shift, sizeof(unsigned int));
+	load_bytes(stream, &saved_n_chromosomes, sizeof(unsigned int));
+
+	if (saved_n_chromosomes > 0) {
+		saved_chromosomes = (int*)malloc(saved_n_chromosomes * sizeof(int));
+		if (saved_chromosomes == NULL) {
+			throw MetaException("MetaManhattan", "merge_state( istream& )", __LINE__, 2, saved_n_chromosomes * sizeof(int));
+		}
+	}
+
+	try {
+		/* Chromosomes are matched by name, since every partition numbers them in the order of appearance. */
+		for (unsigned int i = 0; i < saved_n_chromosomes; i++) {
+			load_bytes(stream, &chromosome_length, sizeof(double));
+			load_bytes(stream, &length, sizeof(unsigned int));
+
+			name = (char*)malloc((length + 1) * sizeof(char));
+			if (name == NULL) {
+				throw MetaException("MetaManhattan", "merge_state( istream& )", __LINE__, 2, (length + 1) * sizeof(char));
+			}
+
+			load_bytes(stream, name, length * sizeof(char));
+			name[length] = '\0';
+
+			if ((saved_chromosomes[i] = find_chromosome(name)) < 0) {
+				saved_chromosomes[i] = add_chromosome(name, chromosome_length);
+			} else if (chromosome_length > chromosomes[saved_chromosomes[i]].length) {
+				chromosomes[saved_chromosomes[i]].length = chromosome_length;
+			}
+
+			free(name);
+			name = NULL;
+		}
+
+		load_bytes(stream, &saved_n_significant, sizeof(int64_t));
+		for (int64_t i = 0; i < saved_n_significant; i++) {
+			load_bytes(stream, &chromosome, sizeof(int));
+			load_bytes(stream, &position, sizeof(double));
+			load_bytes(stream, &pvalue, sizeof(double));
+
+			if ((chromosome < 0) || ((unsigned int)chromosome >= saved_n_chromosomes)) {
+				throw MetaException("MetaManhattan", "merge_state( istream& )", __LINE__, 5, pvalue_meta->get_actual_name());
+			}
+
+			add_significant(saved_chromosomes[chromosome], position, pvalue);
+		}
+
+		while (shift < saved_shift) {
+			coarsen();
+		}
+
+		load_bytes(stream, &saved_n_cells, sizeof(unsigned int));
+		for (unsigned int i = 0; i < saved_n_cells; i++) {
+			load_bytes(stream, &chromosome, sizeof(int));
+			load_bytes(stream, &position, sizeof(double));
+			load_bytes(stream, &pvalue, sizeof(double));
+
+			if ((chromosome < 0) || ((unsigned int)chromosome >= saved_n_chromosomes)) {
+				throw MetaException("MetaManhattan", "merge_state( istream& )", __LINE__, 5, pvalue_meta->get_actual_name());
+			}
+
+			add_cell(saved_chromosomes[chromosome], position, pvalue);
+		}
+	} catch (MetaException &e) {
+		free(name);
+		free(saved_chromosomes);
+		throw;
+	}
+
+	free(saved_chromosomes);
+
+	n += saved_n;
+}
+
+bool MetaManhattan::is_na() {
+	return false;
+}
+
+void MetaManhattan::print(ostream& stream) {
+	stream << resetiosflags(stream.flags());
+	stream << setfill(' ');
+
+	if (is_plottable()) {
+		stream << setw(16) << left << " N" << " = " << manhattan->get_points() << endl;
+		stream << setw(16) << left << " Chromosomes" << " = " << manhattan->get_chromosomes_count() << endl;
+		stream << setw(16) << left << " Plotted points" << " = " << manhattan->get_size() << endl;
+		stream << setw(16) << left << " Significant" << " = " << n_significant << " (P-value < " << THRESHOLD << ")" << endl;
+	} else {
+		stream << " '" << pvalue_meta->get_actual_name() << "' : no p-values with known chromosome and position" << endl;
+	}
+
+	stream << resetiosflags(stream.flags());
+}
+
+void MetaManhattan::print_html(ostream& stream, char path_separator) {
+	stream << resetiosflags(stream.flags());
+
+	if (is_plottable()) {
+		stream << "<div class = \"float\">";
+		stream << "<table class = \"groups\">";
+		stream << "<tr><th>Name</th><th>Value</th></tr>";
+		stream << "<tr><td>N</td><td>" << manhattan->get_points() << "</td></tr>";
+		stream << "<tr><td>Chromosomes</td><td>" << manhattan->get_chromosomes_count() << "</td></tr>";
+		stream << "<tr><td>Plotted points</td><td>" << manhattan->get_size() << "</td></tr>";
+		stream << "<tr><td>P-value &lt; " << THRESHOLD << "</td><td>" << n_significant << "</td></tr>";
+		stream << "</table>";
+		stream << "</div>";
+
+		if (get_plot() != NULL)  {
+			stream << "<div class = \"float\">";
+			stream << "<a href = \"" << (auxiliary::is_absolute_path(get_plot()->get_name(), path_separator) ? "file:///" : "") << get_plot()->get_name() << ".png\">";
+			stream << "<img src = \"" << (auxiliary::is_absolute_path(get_plot()->get_name(), path_separator) ? "file:///" : "") << get_plot()->get_name() << ".png\" alt = \"" << get_plot()->get_name() << ".png\" title = \"Click to enlarge the figure\" width = \"600\" height = \"300\" />";
+			stream << "</a>";
+			stream << "</div>";
+		}
+
+		stream << "<div class = \"spacer\">&nbsp;</div>";
+	} else {
+		stream << "<div class = \"result\">";
+		stream << "'" << pvalue_meta->get_actual_name() << "' : no p-values with known chromosome and position";
+		stream << "</div>";
+	}
+}
+
+double MetaManhattan::get_memory_usage() {
+	uint64_t memory = 0;
+
+	memory += heap_chromosomes * sizeof(chromosome_entry);
+	memory += n_group_chromosomes * sizeof(int);
+	memory += heap_significant * sizeof(point_entry);
+	memory += cells.n_slots * sizeof(cell_entry);
+
+	return memory / 1048576.0;
+}
+
+const char* MetaManhattan::get_plot_name() {
+	return full_name;
+}
+
+bool MetaManhattan::is_plottable() {
+	return (manhattan != NULL) && (pvalue_meta->is_numeric());
+}
+
+void MetaManhattan::set_color(const char* color) throw (PlotException) {
+	if (color == NULL) {
+		throw PlotException("MetaManhattan", "set_color( const char* )", __LINE__, 0, "color");
+	}
+
+	if (strlen(color) <= 0) {
+		throw PlotException("MetaManhattan", "set_color( const char* )", __LINE__, 1, "color");
+	}
+
+	free(this->color);
+	this->color = NULL;
+	this->color = (char*)malloc((strlen(color) + 1) * sizeof(char));
+	if (this->color == NULL) {
+		throw PlotException("MetaManhattan", "set_color( const char* )", __LINE__, 2, (strlen(color) + 1) * sizeof(char));
+	}
+	strcpy(this->color, color);
+}
+
+const char* MetaManhattan::get_color() {
+	return color;
+}
+
+void MetaManhattan::set_plots(bool histogram, bool boxplot, bool qqplot) {
+
+}
+
+void MetaManhattan::set_plot(Plot* plot) {
+	this->plot = plot;
+}
+
+bool MetaManhattan::plots_histogram() {
+	return false;
+}
+
+bool MetaManhattan::plots_boxplot() {
+	return false;
+}
+
+bool MetaManhattan::plots_qqplot() {
+	return false;
+}
+
+Histogram* MetaManhattan::get_histogram() {
+	return NULL;
+}
+
+Boxplot* MetaManhattan::get_boxplot() {
+	return NULL;
+}
+
+Qqplot* MetaManhattan::get_qqplot() {
+	return NULL;
+}
+
+Manhattan* MetaManhattan::get_manhattan() {
+	return manhattan;
+}
+
+Plot* MetaManhattan::get_plot() {
+	return plot;
+}
@@ -19,6 +19,17 @@
 
 #include "../../include/metas/MetaNumeric.h"
 
+const double MetaNumeric::CONFIDENCE_Z = 1.959964;
+
+/* The bins are indexed by the top 22 bits of the order-preserving bit pattern: 12 bits of sign and exponent, and 10 bits of mantissa. */
+const unsigned int MetaNumeric::BINS_BLOCKS_CNT = 4096;
+const unsigned int MetaNumeric::BINS_BLOCK_SIZE = 1024;
+
+/* The outliers on a boxplot are thinned to one per 1/1000 of the range of finite values. */
+const unsigned int MetaNumeric::OUTLIER_CELLS_CNT = 1001;
+
+const int MetaNumeric::HISTOGRAM_CLASSES = 1000;
+
 MetaNumeric::MetaNumeric(unsigned int heap_size) throw (MetaException) : Meta(),
 	end_ptr(NULL), d_value(0.0),
 	n(0), na(0), mean(0.0), sd(0.0),
@@ -26,10 +37,16 @@ MetaNumeric::MetaNumeric(unsigned int heap_size) throw (MetaException) : Meta(),
 	max(-numeric_limits<double>::infinity()),
 	median(numeric_limits<double>::quiet_NaN()),
 	skew(0.0), kurtosis(0.0),
+	sampled(false), na_rate(numeric_limits<double>::quiet_NaN()),
 	numeric(true), na_value(false), value_saved(false), value(numeric_limits<double>::quiet_NaN()),
 	data(NULL), new_data(NULL), current_heap_size(heap_size),
+	single_precision(false), single_data(NULL), new_single_data(NULL), order(NULL),
 	color(NULL), create_histogram(true), create_boxplot(true), create_qqplot(true),
-	histogram(NULL), boxplot(NULL), qqplot(NULL), plot(NULL), print_min(true),
+	histogram(NULL), boxplot(NULL), qqplot(NULL), plot(NULL),
+	low_memory(false), refining(false), bins(NULL), first_pass_n(0), n_finite(0), sum(0.0),
+	finite_min(numeric_limits<double>::infinity()),
+	finite_max(-numeric_limits<double>::infinity()),
+	selected(NULL), outlier_cells(NULL), print_min(true),
 	print_max(true), print_median(true), print_skewness(true), print_kurtosis(true),
 	print_quantiles(true) {
 
@@ -43,6 +60,23 @@ MetaNumeric::MetaNumeric(unsigned int heap_size) throw (MetaException) : Meta(),
 	quantiles[7][0] = 0.99;
 	quantiles[8][0] = 1.00;
 
+	for (unsigned int i = 0; i < 3; i++) {
+		moments[i] = 0.0;
+	}
+
+	for (unsigned int i = 0; i < 4; i++) {
+		fences[i] = numeric_limits<double>::quiet_NaN();
+	}
+
+	whisker_candidates[0] = numeric_limits<double>::quiet_NaN();
+	whisker_candidates[1] = numeric_limits<double>::quiet_NaN();
+
+	outside_fences[0] = 0;
+	outside_fences[1] = 0;
+
+	histogram_range[0] = numeric_limits<double>::quiet_NaN();
+	histogram_range[1] = numeric_limits<double>::quiet_NaN();
+
 	if (heap_size > 0) {
 		data = (double*)malloc(heap_size * sizeof(double));
 		if (data == NULL) {
@@ -57,18 +91,19 @@ MetaNumeric::~MetaNumeric() {
 	delete qqplot;
 
 	free(color);
-	free(data);
+
+	release_data();
+	release_low_memory();
 
 	boxplot = NULL;
 	histogram = NULL;
 	qqplot = NULL;
 	color = NULL;
-	data = NULL;
 }
 
 void MetaNumeric::put(char* value) throw (MetaException) {
 	if (numeric) {
-		if (strcmp(na_marker, value) == 0) {
+		if (is_na_marker(value)) {
 			na_value = true;
 			na += 1;
 			value_saved = false;
@@ -85,8 +120,7 @@ void MetaNumeric::put(char* value) throw (MetaException) {
 			numeric = false;
 			value_saved = false;
 			this->value = numeric_limits<double>::quiet_NaN();
-			free(data);
-			data = NULL;
+			release_data();
 			return;
 		}
 
@@ -98,41 +132,736 @@ void MetaNumeric::put(char* value) throw (MetaException) {
 			return;
 		}
 
-		n += 1;
+		save_value(d_value);
+
+		value_saved = true;
+		this->value = d_value;
+	}
+}
+
+/*
+ * Counts the non-missing value in the histogram and keeps it, or, in the low-memory mode, passes it to the current pass.
+ */
+void MetaNumeric::save_value(double value) throw (MetaException) {
+	n += 1;
+
+	if ((create_histogram) && (!refining)) {
+		add_to_histogram(value);
+	}
+
+	if (low_memory) {
+		if (refining) {
+			refine_value(value);
+		} else {
+			sketch_value(value);
+		}
+		return;
+	}
+
+	if (single_precision) {
+		accumulate_moments(value);
 
 		if (n > current_heap_size) {
 			current_heap_size += Meta::HEAP_INCREMENT;
 
-			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
-			if (new_data == NULL) {
-				free(data);
-				data = NULL;
-				throw MetaException("MetaNumeric", "put( char* )", __LINE__, 3, current_heap_size * sizeof(double));
+			new_single_data = (float*)realloc(single_data, current_heap_size * sizeof(float));
+			if (new_single_data == NULL) {
+				free(single_data);
+				single_data = NULL;
+				throw MetaException("MetaNumeric", "save_value( double )", __LINE__, 3, current_heap_size * sizeof(float));
 			}
 
-			data = new_data;
+			single_data = new_single_data;
 		}
 
-		value_saved = true;
-		this->value = d_value;
-		data[n - 1] = d_value;
+		single_data[n - 1] = (float)value;
+		return;
+	}
+
+	if (n > current_heap_size) {
+		current_heap_size += Meta::HEAP_INCREMENT;
+
+		new_data = (double*)realloc(data, current_heap_size * sizeof(double));
+		if (new_data == NULL) {
+			free(data);
+			data = NULL;
+			throw MetaException("MetaNumeric", "save_value( double )", __LINE__, 3, current_heap_size * sizeof(double));
+		}
+
+		data = new_data;
+	}
+
+	data[n - 1] = value;
+}
+
+/*
+ * The histogram is created with the first value, over the declared range of the column, if any, or with the classes
+ * chosen from the first values.
+ */
+void MetaNumeric::add_to_histogram(double value) throw (MetaException) {
+	try {
+		if (histogram == NULL) {
+			if (isnan(histogram_range[0])) {
+				histogram = Histogram::create(actual_name, HISTOGRAM_CLASSES);
+			} else {
+				histogram = Histogram::create(actual_name, histogram_range[0], histogram_range[1], HISTOGRAM_CLASSES);
+			}
+		}
+
+		histogram->add(value);
+	} catch (PlotException &e) {
+		MetaException new_e(e);
+		new_e.add_message("MetaNumeric", "add_to_histogram( double )", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
+		throw new_e;
+	}
+}
+
+/*
+ * Completes the histogram after all values are counted. Without finite values there is no histogram.
+ */
+void MetaNumeric::finish_histogram() throw (PlotException) {
+	if (histogram == NULL) {
+		return;
+	}
+
+	if (histogram->get_n_finite() <= 0) {
+		delete histogram;
+		histogram = NULL;
+		return;
+	}
+
+	histogram->finish();
+	histogram->set_title(get_description());
+}
+
+/*
+ * Updates the running mean and the sums of the powers of the deviations from it with a new value (single-pass update
+ * formulas of Pebay, 2008). The mean itself is reported as the plain sum divided by n.
+ */
+void MetaNumeric::accumulate_moments(double value) {
+	double delta = value - mean;
+	double delta_n = delta / n;
+	double delta_n2 = delta_n * delta_n;
+	double term = delta * delta_n * (n - 1.0);
+
+	sum += value;
+	mean += delta_n;
+
+	moments[2] += term * delta_n2 * ((double)n * n - 3.0 * n + 3.0) + 6.0 * delta_n2 * moments[0] - 4.0 * delta_n * moments[1];
+	moments[1] += term * delta_n * (n - 2.0) - 3.0 * delta_n * moments[0];
+	moments[0] += term;
+}
+
+/*
+ * Derives the standard deviation, skewness and kurtosis from the sums of the 2nd, 3rd and 4th powers of the deviations.
+ */
+void MetaNumeric::finalize_moments() {
+	sd = sqrt(moments[0] / (n - 1));
+	skew = moments[1] / pow(sd, 3.0) / n;
+	kurtosis = moments[2] / pow(sd, 4.0) / n - 3.0;
+}
+
+/*
+ * Replaces the values kept in single precision with their copies in double precision.
+ */
+void MetaNumeric::widen_data() throw (MetaException) {
+	free(data);
+
+	data = (double*)malloc(n * sizeof(double));
+	if (data == NULL) {
+		release_data();
+		throw MetaException("MetaNumeric", "widen_data()", __LINE__, 2, n * sizeof(double));
+	}
+
+	for (int64_t i = 0; i < n; i++) {
+		data[i] = single_data[i];
+	}
+
+	free(single_data);
+	single_data = NULL;
+	current_heap_size = n;
+}
+
+void MetaNumeric::release_data() {
+	free(data);
+	data = NULL;
+
+	free(single_data);
+	single_data = NULL;
+
+	free(order);
+	order = NULL;
+}
+
+/*
+ * Calculates the mean and the central moments. In the single precision the kept values are replaced with their copies
+ * in double precision.
+ */
+void MetaNumeric::calculate_moments() throw (MetaException) {
+	if (single_precision) {
+		mean = sum / n;
+		finalize_moments();
+		widen_data();
+	} else {
+		auxiliary::stats_moments(data, n, mean, sd, skew, kurtosis);
 	}
 }
+
+/*
+ * The first pass of the low-memory mode.
+ */
+void MetaNumeric::sketch_value(double value) throw (MetaException) {
+	unsigned int bin = get_bin(value);
+	unsigned int block = bin / BINS_BLOCK_SIZE;
+
+	sum += value;
+
+	if (value < min) {
+		min = value;
+	}
+
+	if (value > max) {
+		max = value;
+	}
+
+	if (!isinf(value)) {
+		n_finite += 1;
+
+		if (value < finite_min) {
+			finite_min = value;
+		}
+
+		if (value > finite_max) {
+			finite_max = value;
+		}
+	}
+
+	if (bins[block] == NULL) {
+		bins[block] = (uint64_t*)calloc(BINS_BLOCK_SIZE, sizeof(uint64_t));
+		if (bins[block] == NULL) {
+			throw MetaException("MetaNumeric", "sketch_value( double )", __LINE__, 2, BINS_BLOCK_SIZE * sizeof(uint64_t));
+		}
+	}
+
+	bins[block][bin % BINS_BLOCK_SIZE] += 1;
+}
+
+/*
+ * The second pass of the low-memory mode. The deviations from the mean are summed in the same order as in the default mode.
+ */
+void MetaNumeric::refine_value(double value) {
+	double deviation = value - mean;
+
+	moments[0] += pow(deviation, 2.0);
+	moments[1] += pow(deviation, 3.0);
+	moments[2] += pow(deviation, 4.0);
+
+	if ((target_bins.count(get_bin(value)) > 0) ||
+			((value >= fences[0]) && (value < fences[1])) ||
+			((value > fences[2]) && (value <= fences[3]))) {
+		(*selected)[value] += 1;
+	}
+
+	if (value < fences[0]) {
+		outside_fences[0] += 1;
+		add_outlier(value);
+	} else if ((value >= fences[1]) && ((isnan(whisker_candidates[0])) || (value < whisker_candidates[0]))) {
+		whisker_candidates[0] = value;
+	}
+
+	if (value > fences[3]) {
+		outside_fences[1] += 1;
+		add_outlier(value);
+	} else if ((value <= fences[2]) && ((isnan(whisker_candidates[1])) || (value > whisker_candidates[1]))) {
+		whisker_candidates[1] = value;
+	}
+}
+
+/*
+ * Keeps the smallest outlier within every 1/1000 of the range of finite values.
+ */
+void MetaNumeric::add_outlier(double value) {
+	double delta = (finite_max - finite_min) / (OUTLIER_CELLS_CNT - 1);
+	double position = 0.0;
+	unsigned int cell = 0;
+
+	if (outlier_cells == NULL) {
+		return;
+	}
+
+	if (value > finite_max) {
+		cell = OUTLIER_CELLS_CNT - 1;
+	} else if ((value > finite_min) && (delta > 0.0)) {
+		position = floor((value - finite_min) / delta);
+		cell = position >= OUTLIER_CELLS_CNT - 1 ? OUTLIER_CELLS_CNT - 1 : (unsigned int)position;
+	}
+
+	if ((isnan(outlier_cells[cell])) || (value < outlier_cells[cell])) {
+		outlier_cells[cell] = value;
+	}
+}
+
+/*
+ * Returns the value with the given rank (from 0) in the sorted data. The rank must be one of the targets of the second pass.
+ */
+double MetaNumeric::select_value(int64_t rank) {
+	map<unsigned int, int64_t>::iterator target_bins_it;
+	map<unsigned int, int64_t>::iterator found_it = target_bins.end();
+	map<double, uint64_t>::iterator selected_it;
+	uint64_t skip = 0;
+
+	for (target_bins_it = target_bins.begin(); target_bins_it != target_bins.end(); target_bins_it++) {
+		if (target_bins_it->second > rank) {
+			break;
+		}
+		found_it = target_bins_it;
+	}
+
+	if ((found_it == target_bins.end()) || (selected == NULL)) {
+		return numeric_limits<double>::quiet_NaN();
+	}
+
+	skip = rank - found_it->second;
+	selected_it = selected->lower_bound(get_bin_lower(found_it->first));
+
+	while ((selected_it != selected->end()) && (skip >= selected_it->second)) {
+		skip -= selected_it->second;
+		selected_it++;
+	}
+
+	if (selected_it == selected->end()) {
+		return numeric_limits<double>::quiet_NaN();
+	}
+
+	return selected_it->first;
+}
+
+/*
+ * Prepares the second pass of the low-memory mode: finds the bins with the order statistics for the median, the quantiles
+ * and the hinges, and the margins around the boxplot fences. The counters are restarted, since all values are passed again.
+ */
+void MetaNumeric::begin_refinement() throw (MetaException) {
+	vector<int64_t> ranks;
+	vector<int64_t>::iterator ranks_it;
+	map<unsigned int, int64_t>::iterator target_bins_it;
+	unsigned int hinge_bins[4] = {0, 0, 0, 0};
+	double hinge_bounds[4];
+	double positions[2];
+	double integer = 0.0;
+	uint64_t count = 0;
+	unsigned int last_bin = BINS_BLOCKS_CNT * BINS_BLOCK_SIZE - 1;
+	int64_t before = 0;
+	int64_t rank = 0;
+
+	if (!low_memory) {
+		return;
+	}
+
+	first_pass_n = n;
+	n = 0;
+	na = 0;
+	refining = true;
+
+	if ((!numeric) || (first_pass_n <= 0)) {
+		return;
+	}
+
+	mean = sum / first_pass_n;
+
+	if (first_pass_n % 2 == 0) {
+		ranks.push_back(first_pass_n / 2 - 1);
+		ranks.push_back(first_pass_n / 2);
+		positions[0] = (double)(first_pass_n + 2) / 4;
+		positions[1] = (double)(3 * first_pass_n + 2) / 4;
+	} else {
+		ranks.push_back((first_pass_n - 1) / 2);
+		positions[0] = (double)(first_pass_n + 3) / 4;
+		positions[1] = (double)(3 * first_pass_n + 1) / 4;
+	}
+
+	for (unsigned int j = 0; j < 9; j++) {
+		rank = (int64_t)floor((first_pass_n - 1) * quantiles[j][0]);
+		ranks.push_back(rank);
+		if (rank + 1 < first_pass_n) {
+			ranks.push_back(rank + 1);
+		}
+	}
+
+	for (unsigned int j = 0; j < 2; j++) {
+		modf(positions[j], &integer);
+		ranks.push_back((int64_t)integer - 1);
+		if ((int64_t)integer < first_pass_n) {
+			ranks.push_back((int64_t)integer);
+		}
+	}
+
+	sort(ranks.begin(), ranks.end());
+
+	target_bins.clear();
+	ranks_it = ranks.begin();
+	for (unsigned int block = 0; (block < BINS_BLOCKS_CNT) && (ranks_it != ranks.end()); block++) {
+		if (bins[block] == NULL) {
+			continue;
+		}
+
+		for (unsigned int offset = 0; offset < BINS_BLOCK_SIZE; offset++) {
+			count = bins[block][offset];
+			while ((ranks_it != ranks.end()) && (*ranks_it < before + (int64_t)count)) {
+				target_bins[block * BINS_BLOCK_SIZE + offset] = before;
+				ranks_it++;
+			}
+			before += count;
+		}
+	}
+
+	selected = new map<double, uint64_t>();
+
+	if (!create_boxplot) {
+		return;
+	}
+
+	/* One more place for the largest outlier, which is plotted besides the thinned ones. */
+	outlier_cells = (double*)malloc((OUTLIER_CELLS_CNT + 1) * sizeof(double));
+	if (outlier_cells == NULL) {
+		throw MetaException("MetaNumeric", "begin_refinement()", __LINE__, 2, (OUTLIER_CELLS_CNT + 1) * sizeof(double));
+	}
+
+	for (unsigned int i = 0; i < OUTLIER_CELLS_CNT; i++) {
+		outlier_cells[i] = numeric_limits<double>::quiet_NaN();
+	}
+
+	outside_fences[0] = 0;
+	outside_fences[1] = 0;
+
+	/* The bins of the values, which are interpolated into the hinges, widened by one bin to absorb the rounding. */
+	for (unsigned int j = 0; j < 2; j++) {
+		modf(positions[j], &integer);
+		for (unsigned int k = 0; k < 2; k++) {
+			rank = (k == 0) || ((int64_t)integer == first_pass_n) ? (int64_t)integer - 1 : (int64_t)integer;
+			for (target_bins_it = target_bins.begin(); target_bins_it != target_bins.end(); target_bins_it++) {
+				if (target_bins_it->second > rank) {
+					break;
+				}
+				hinge_bins[2 * j + k] = target_bins_it->first;
+			}
+		}
+	}
+
+	hinge_bounds[0] = get_bin_lower(hinge_bins[0] > 0 ? hinge_bins[0] - 1 : 0);
+	hinge_bounds[1] = get_bin_upper(hinge_bins[1] < last_bin ? hinge_bins[1] + 1 : last_bin);
+	hinge_bounds[2] = get_bin_lower(hinge_bins[2] > 0 ? hinge_bins[2] - 1 : 0);
+	hinge_bounds[3] = get_bin_upper(hinge_bins[3] < last_bin ? hinge_bins[3] + 1 : last_bin);
+
+	for (unsigned int i = 0; i < 4; i++) {
+		if (hinge_bounds[i] < -numeric_limits<double>::max()) {
+			hinge_bounds[i] = -numeric_limits<double>::max();
+		} else if (hinge_bounds[i] > numeric_limits<double>::max()) {
+			hinge_bounds[i] = numeric_limits<double>::max();
+		}
+	}
+
+	/* The fences are monotone in the hinges, so the exact fences will be within these bounds. */
+	fences[0] = hinge_bounds[0] - 1.5 * (hinge_bounds[3] - hinge_bounds[0]);
+	fences[1] = hinge_bounds[1] - 1.5 * (hinge_bounds[2] - hinge_bounds[1]);
+	fences[2] = hinge_bounds[2] + 1.5 * (hinge_bounds[2] - hinge_bounds[1]);
+	fences[3] = hinge_bounds[3] + 1.5 * (hinge_bounds[3] - hinge_bounds[0]);
+}
+
+/*
+ * Completes the statistics of the low-memory mode after the second pass. The mean, the standard deviation and the order
+ * statistics are the same as in the default mode; the skewness and the kurtosis may differ in the last digits due to rounding.
+ */
+void MetaNumeric::finalize_low_memory() throw (MetaException) {
+	map<double, uint64_t>::iterator selected_it;
+	double tukey[5];
+	double positions[2];
+	double integer = 0.0, fraction = 0.0;
+	double iqr = 0.0;
+	double lower = 0.0, upper = 0.0;
+	int64_t i = 0;
+	int64_t outliers_total = 0;
+	int outliers_cnt = 0;
+
+	if (n != first_pass_n) {
+		throw MetaException("MetaNumeric", "finalize_low_memory()", __LINE__, 7, actual_name != NULL ? actual_name : "NULL");
+	}
+
+	finalize_moments();
+
+	if (n % 2 == 0) {
+		median = (select_value(n / 2 - 1) + select_value(n / 2)) / 2.0;
+	} else {
+		median = select_value((n - 1) / 2);
+	}
+
+	for (unsigned int j = 0; j < 9; j++) {
+		i = (int64_t)floor((n - 1) * quantiles[j][0]);
+		fraction = (n - 1) * quantiles[j][0] - i;
+
+		if (fraction == 0) {
+			quantiles[j][1] = select_value(i);
+		} else if (fraction == 1) {
+			quantiles[j][1] = select_value(i + 1);
+		} else {
+			quantiles[j][1] = (1 - fraction) * select_value(i) + fraction * select_value(i + 1);
+		}
+	}
+
+	try {
+		finish_histogram();
+
+		if (create_boxplot) {
+			if (n % 2 == 0) {
+				positions[0] = (double)(n + 2) / 4;
+				positions[1] = (double)(3 * n + 2) / 4;
+			} else {
+				positions[0] = (double)(n + 3) / 4;
+				positions[1] = (double)(3 * n + 1) / 4;
+			}
+
+			tukey[2] = median;
+
+			for (unsigned int j = 0; j < 2; j++) {
+				fraction = modf(positions[j], &integer);
+				if ((int64_t)integer == n) {
+					tukey[2 * j + 1] = select_value((int64_t)integer - 1);
+				} else {
+					tukey[2 * j + 1] = (1 - fraction) * select_value((int64_t)integer - 1) + fraction * select_value((int64_t)integer);
+					if (isnan(tukey[2 * j + 1])) {
+						tukey[2 * j + 1] = select_value((int64_t)integer - 1);
+					}
+				}
+			}
+
+			iqr = tukey[3] - tukey[1];
+			lower = tukey[1] - 1.5 * iqr;
+			upper = tukey[3] + 1.5 * iqr;
+
+			/* Lower whisker: the smallest value not below the lower fence. */
+			if ((isnan(lower)) || (lower <= min)) {
+				tukey[0] = min;
+			} else {
+				tukey[0] = whisker_candidates[0];
+				selected_it = selected->lower_bound(lower);
+				if ((selected_it != selected->end()) && ((isnan(tukey[0])) || (selected_it->first < tukey[0]))) {
+					tukey[0] = selected_it->first;
+				}
+				if (isnan(tukey[0])) {
+					tukey[0] = max;
+				}
+			}
+
+			/* Upper whisker: the largest value not above the upper fence. */
+			if ((isnan(upper)) || (upper >= max)) {
+				tukey[4] = max;
+			} else {
+				tukey[4] = whisker_candidates[1];
+				selected_it = selected->upper_bound(upper);
+				if (selected_it != selected->begin()) {
+					selected_it--;
+					if ((isnan(tukey[4])) || (selected_it->first > tukey[4])) {
+						tukey[4] = selected_it->first;
+					}
+				}
+				if (isnan(tukey[4])) {
+					tukey[4] = min;
+				}
+			}
+
+			/* The values from the margins, which turned out to be outside the exact fences. */
+			outliers_total = isnan(lower) ? 0 : outside_fences[0];
+			for (selected_it = selected->lower_bound(fences[0]); (selected_it != selected->end()) && (selected_it->first < lower); selected_it++) {
+				add_outlier(selected_it->first);
+				outliers_total += selected_it->second;
+			}
+
+			outliers_total += isnan(upper) ? 0 : outside_fences[1];
+			for (selected_it = selected->upper_bound(upper); (selected_it != selected->end()) && (selected_it->first <= fences[3]); selected_it++) {
+				add_outlier(selected_it->first);
+				outliers_total += selected_it->second;
+			}
+
+			for (i = 0; i < OUTLIER_CELLS_CNT; i++) {
+				if ((outlier_cells[i] < lower) || (outlier_cells[i] > upper)) {
+					outlier_cells[outliers_cnt] = outlier_cells[i];
+					outliers_cnt += 1;
+				}
+			}
+
+			/* The cells keep their smallest values, so the largest outlier is added to show the exact range. */
+			if ((max > upper) && ((outliers_cnt == 0) || (max > outlier_cells[outliers_cnt - 1]))) {
+				outlier_cells[outliers_cnt] = max;
+				outliers_cnt += 1;
+			}
+
+			boxplot = Boxplot::create(actual_name, n, tukey, outlier_cells, outliers_cnt, outliers_total);
+			if (boxplot != NULL) {
+				boxplot->set_quantiles(quantiles[0][1], quantiles[3][1], quantiles[4][1], quantiles[5][1], quantiles[8][1]);
+				boxplot->set_title(get_description());
+			}
+		}
+	} catch (PlotException &e) {
+		MetaException new_e(e);
+		new_e.add_message("MetaNumeric", "finalize_low_memory()", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
+		throw new_e;
+	}
+}
+
+void MetaNumeric::release_low_memory() {
+	if (bins != NULL) {
+		for (unsigned int block = 0; block < BINS_BLOCKS_CNT; block++) {
+			free(bins[block]);
+		}
+		free(bins);
+		bins = NULL;
+	}
+
+	if (selected != NULL) {
+		delete selected;
+		selected = NULL;
+	}
+
+	free(outlier_cells);
+	outlier_cells = NULL;
+
+	target_bins.clear();
+}
+
+/*
+ * The bit patterns of the values are mapped to unsigned integers, which are ordered as the values themselves.
+ */
+unsigned int MetaNumeric::get_bin(double value) {
+	uint64_t bits = 0;
+
+	if (value == 0.0) {
+		value = 0.0;
+	}
+
+	memcpy(&bits, &value, sizeof(double));
+	bits = (bits & 0x8000000000000000ULL) != 0 ? ~bits : bits | 0x8000000000000000ULL;
+
+	return (unsigned int)(bits >> 42);
+}
+
+double MetaNumeric::get_bin_lower(unsigned int bin) {
+	uint64_t bits = (uint64_t)bin << 42;
+	double value = 0.0;
+
+	bits = (bits & 0x8000000000000000ULL) != 0 ? bits & ~0x8000000000000000ULL : ~bits;
+	memcpy(&value, &bits, sizeof(double));
+
+	return isnan(value) ? -numeric_limits<double>::infinity() : value;
+}
+
+double MetaNumeric::get_bin_upper(unsigned int bin) {
+	uint64_t bits = ((uint64_t)bin << 42) | 0x000003FFFFFFFFFFULL;
+	double value = 0.0;
+
+	bits = (bits & 0x8000000000000000ULL) != 0 ? bits & ~0x8000000000000000ULL : ~bits;
+	memcpy(&value, &bits, sizeof(double));
+
+	return isnan(value) ? numeric_limits<double>::infinity() : value;
+}
+
+void MetaNumeric::set_low_memory(bool low_memory) throw (MetaException) {
+	if (low_memory) {
+		if (bins == NULL) {
+			bins = (uint64_t**)calloc(BINS_BLOCKS_CNT, sizeof(uint64_t*));
+			if (bins == NULL) {
+				throw MetaException("MetaNumeric", "set_low_memory( bool )", __LINE__, 2, BINS_BLOCKS_CNT * sizeof(uint64_t*));
+			}
+		}
+
+		release_data();
+		current_heap_size = 0;
+	} else {
+		release_low_memory();
+	}
+
+	this->low_memory = low_memory;
+}
+
+bool MetaNumeric::is_low_memory() {
+	return low_memory;
+}
+
+/*
+ * Must be called before the first value is saved.
+ */
+void MetaNumeric::set_single_precision(bool single_precision) throw (MetaException) {
+	if (single_precision == this->single_precision) {
+		return;
+	}
+
+	release_data();
+
+	if (current_heap_size > 0) {
+		if (single_precision) {
+			single_data = (float*)malloc(current_heap_size * sizeof(float));
+			if (single_data == NULL) {
+				throw MetaException("MetaNumeric", "set_single_precision( bool )", __LINE__, 2, current_heap_size * sizeof(float));
+			}
+		} else {
+			data = (double*)malloc(current_heap_size * sizeof(double));
+			if (data == NULL) {
+				throw MetaException("MetaNumeric", "set_single_precision( bool )", __LINE__, 2, current_heap_size * sizeof(double));
+			}
+		}
+	}
+
+	this->single_precision = single_precision;
+}
+
+bool MetaNumeric::is_single_precision() {
+	return single_precision;
+}
+
 void MetaNumeric::finalize() throw (MetaException) {
+	double* unsorted = NULL;
+
 	if (n <= 0) {
 		numeric = false;
-		free(data);
-		data = NULL;
+		delete histogram;
+		histogram = NULL;
+		release_data();
+		release_low_memory();
+		return;
+	}
+
+	if ((numeric) && (low_memory)) {
+		finalize_low_memory();
+		release_low_memory();
 		return;
 	}
 
 	if (numeric) {
-		mean = auxiliary::stats_mean(data, n);
-		sd = auxiliary::stats_sd(data, n, mean);
-		skew = auxiliary::stats_skewness(data, n, mean, sd);
-		kurtosis = auxiliary::stats_kurtosis(data, n, mean, sd);
+		/* With the shared order, the moments are calculated and the values are sorted already. */
+		if (order == NULL) {
+			calculate_moments();
+		}
+
+		/* The intervals of a clustered sample need the values in the order of lines. */
+		if ((sampled) && (cluster_n.size() > 1)) {
+			unsorted = (double*)malloc(n * sizeof(double));
+			if (unsorted == NULL) {
+				throw MetaException("MetaNumeric", "finalize()", __LINE__, 2, n * sizeof(double));
+			}
 
-		qsort(data, n, sizeof(double), dblcmp);
+			if (order != NULL) {
+				for (int64_t i = 0; i < n; i++) {
+					unsorted[order[i]] = data[i];
+				}
+			} else {
+				memcpy(unsorted, data, n * sizeof(double));
+			}
+		}
+
+		if (order != NULL) {
+			free(order);
+			order = NULL;
+		} else {
+			qsort(data, n, sizeof(double), dblcmp);
+		}
 
 		median = auxiliary::stats_median_from_sorted_data(data, n);
 
@@ -143,13 +872,14 @@ void MetaNumeric::finalize() throw (MetaException) {
 		min = data[0];
 		max = data[n - 1];
 
+		if (sampled) {
+			estimate_intervals(unsorted);
+			free(unsorted);
+			unsorted = NULL;
+		}
+
 		try {
-			if (create_histogram) {
-				histogram = Histogram::create(actual_name, data, n, 1000);
-				if (histogram != NULL) {
-					histogram->set_title(get_description());
-				}
-			}
+			finish_histogram();
 
 			if (create_boxplot) {
 				boxplot = Boxplot::create(actual_name, data, n, median);
@@ -163,16 +893,212 @@ void MetaNumeric::finalize() throw (MetaException) {
 			new_e.add_message("MetaNumeric", "finalize()", __LINE__, 4, actual_name != NULL ? actual_name : "NULL");
 			throw new_e;
 		}
+	} else {
+		delete histogram;
+		histogram = NULL;
 	}
 
-	free(data);
-	data = NULL;
+	release_data();
+}
+
+/*
+ * Must be called on sorted data. The intervals for the quantiles are distribution-free and are formed by the
+ * order statistics around the rank n * p (normal approximation to the binomial); the interval for the rate
+ * of NAs is the Wilson score interval. In a clustered sample (the values in the order of lines are given),
+ * the variances are estimated from the runs of lines as from a sample of clusters (Woodruff interval for the
+ * quantiles, and the effective sample size in the Wilson interval). The variances never fall below those of
+ * independent values.
+ */
+void MetaNumeric::estimate_intervals(const double* unsorted) {
+	vector<int64_t> counts;
+	vector<int64_t> sizes;
+	double p = 0.0;
+	double h = 0.0;
+	double variance = 0.0;
+	int64_t total = n + na;
+	double effective_total = total;
+	double z2 = CONFIDENCE_Z * CONFIDENCE_Z;
+	double center = 0.0;
+	double denominator = 0.0;
+	int64_t rank = 0;
+	size_t clusters = unsorted != NULL ? cluster_n.size() : 0;
+
+	for (size_t k = 0; k < clusters; k++) {
+		sizes.push_back((k + 1 < clusters ? cluster_n[k + 1] : n) - (k > 0 ? cluster_n[k] : 0));
+	}
+
+	for (unsigned int j = 0; j < 9; j++) {
+		p = quantiles[j][0];
+		if (p <= 0.0) {
+			quantile_intervals[j][0] = -numeric_limits<double>::infinity();
+			quantile_intervals[j][1] = data[0];
+		} else if (p >= 1.0) {
+			quantile_intervals[j][0] = data[n - 1];
+			quantile_intervals[j][1] = numeric_limits<double>::infinity();
+		} else {
+			h = CONFIDENCE_Z * sqrt(n * p * (1.0 - p));
+
+			if (clusters > 1) {
+				counts.assign(clusters, 0);
+				for (size_t k = 0; k < clusters; k++) {
+					for (int64_t i = (k > 0 ? cluster_n[k] : 0); i < (k + 1 < clusters ? cluster_n[k + 1] : n); i++) {
+						if (unsorted[i] <= quantiles[j][1]) {
+							counts[k] += 1;
+						}
+					}
+				}
+
+				variance = get_ratio_variance(counts, sizes);
+				if (CONFIDENCE_Z * n * sqrt(variance) > h) {
+					h = CONFIDENCE_Z * n * sqrt(variance);
+				}
+			}
+
+			rank = (int64_t)floor(n * p - h);
+			quantile_intervals[j][0] = data[rank < 1 ? 0 : (rank > n ? n - 1 : rank - 1)];
+
+			rank = (int64_t)ceil(n * p + h);
+			quantile_intervals[j][1] = data[rank < 1 ? 0 : (rank > n ? n - 1 : rank - 1)];
+		}
+	}
+
+	na_rate = na / (double)total;
+
+	if ((clusters > 1) && (na > 0) && (na < total)) {
+		counts.clear();
+		for (size_t k = 0; k < clusters; k++) {
+			counts.push_back((k + 1 < clusters ? cluster_na[k + 1] : na) - (k > 0 ? cluster_na[k] : 0));
+			sizes[k] += counts[k];
+		}
+
+		variance = get_ratio_variance(counts, sizes);
+		if (na_rate * (1.0 - na_rate) < variance * total) {
+			effective_total = na_rate * (1.0 - na_rate) / variance;
+		}
+	}
+
+	denominator = 1.0 + z2 / effective_total;
+	center = (na_rate + z2 / (2.0 * effective_total)) / denominator;
+	h = CONFIDENCE_Z * sqrt(na_rate * (1.0 - na_rate) / effective_total + z2 / (4.0 * effective_total * effective_total)) / denominator;
+	na_rate_interval[0] = center - h < 0.0 ? 0.0 : center - h;
+	na_rate_interval[1] = center + h > 1.0 ? 1.0 : center + h;
+}
+
+/*
+ * Variance of the ratio sum(numerators) / sum(denominators) over a sample of clusters (linearization, with replacement).
+ * The clusters with zero denominator are left out.
+ */
+double MetaNumeric::get_ratio_variance(const vector<int64_t>& numerators, const vector<int64_t>& denominators) {
+	double ratio = 0.0;
+	double residual = 0.0;
+	double sum = 0.0;
+	int64_t numerators_sum = 0;
+	int64_t denominators_sum = 0;
+	size_t clusters = 0;
+
+	for (size_t k = 0; k < numerators.size(); k++) {
+		if (denominators[k] > 0) {
+			numerators_sum += numerators[k];
+			denominators_sum += denominators[k];
+			clusters += 1;
+		}
+	}
+
+	if (clusters < 2) {
+		return 0.0;
+	}
+
+	ratio = numerators_sum / (double)denominators_sum;
+
+	for (size_t k = 0; k < numerators.size(); k++) {
+		if (denominators[k] > 0) {
+			residual = numerators[k] - ratio * denominators[k];
+			sum += residual * residual;
+		}
+	}
+
+	return clusters / (clusters - 1.0) * sum / ((double)denominators_sum * denominators_sum);
 }
 
 bool MetaNumeric::is_na() {
 	return na_value;
 }
 
+void MetaNumeric::save_state(ostream& stream) throw (MetaException) {
+	unsigned char saved_numeric = numeric ? 1 : 0;
+
+	save_bytes(stream, &saved_numeric, sizeof(unsigned char));
+	save_bytes(stream, &n, sizeof(int64_t));
+	save_bytes(stream, &na, sizeof(int64_t));
+
+	if ((numeric) && (n > 0)) {
+		if (single_precision) {
+			for (int64_t i = 0; i < n; i++) {
+				d_value = single_data[i];
+				save_bytes(stream, &d_value, sizeof(double));
+			}
+		} else {
+			save_bytes(stream, data, n * sizeof(double));
+		}
+	}
+}
+
+void MetaNumeric::merge_state(istream& stream) throw (MetaException) {
+	unsigned char saved_numeric = 0;
+	int64_t saved_n = 0;
+	int64_t saved_na = 0;
+
+	load_bytes(stream, &saved_numeric, sizeof(unsigned char));
+	load_bytes(stream, &saved_n, sizeof(int64_t));
+	load_bytes(stream, &saved_na, sizeof(int64_t));
+
+	if ((saved_n < 0) || (saved_na < 0)) {
+		throw MetaException("MetaNumeric", "merge_state( istream& )", __LINE__, 5, actual_name != NULL ? actual_name : "NULL");
+	}
+
+	if ((saved_numeric == 0) || (saved_n == 0)) {
+		if ((numeric) && (saved_numeric == 0)) {
+			numeric = false;
+			release_data();
+		}
+	} else if (!numeric) {
+		skip_bytes(stream, saved_n * sizeof(double));
+	} else if (single_precision) {
+		/* The values pass through save_value(), which also counts them and accumulates the moments. */
+		for (int64_t i = 0; i < saved_n; i++) {
+			load_bytes(stream, &d_value, sizeof(double));
+			save_value(d_value);
+		}
+
+		na += saved_na;
+		return;
+	} else {
+		if (n + saved_n > current_heap_size) {
+			current_heap_size = n + saved_n;
+
+			new_data = (double*)realloc(data, current_heap_size * sizeof(double));
+			if (new_data == NULL) {
+				free(data);
+				data = NULL;
+				throw MetaException("MetaNumeric", "merge_state( istream& )", __LINE__, 3, current_heap_size * sizeof(double));
+			}
+
+			data = new_data;
+		}
+
+		load_bytes(stream, data + n, saved_n * sizeof(double));
+
+		if (create_histogram) {
+			for (int64_t i = n; i < n + saved_n; i++) {
+				add_to_histogram(data[i]);
+			}
+		}
+	}
+
+	n += saved_n;
+	na += saved_na;
+}
+
 const char* MetaNumeric::get_plot_name() {
 	return common_name;
 }
@@ -187,6 +1113,18 @@ void MetaNumeric::set_plots(bool histogram, bool boxplot, bool qqplot) {
 	create_qqplot = qqplot;
 }
 
+/*
+ * Declares the range of the values, over which the classes of the histogram are chosen before the first value arrives.
+ */
+void MetaNumeric::set_histogram_range(double lower, double upper) {
+	histogram_range[0] = lower;
+	histogram_range[1] = upper;
+}
+
+const double* MetaNumeric::get_histogram_range() {
+	return histogram_range;
+}
+
 void MetaNumeric::set_ouptut(bool min, bool max, bool median, bool skewness, bool kurtosis, bool quantiles) {
 	this->print_min = min;
 	this->print_max = max;
@@ -196,6 +1134,22 @@ void MetaNumeric::set_ouptut(bool min, bool max, bool median, bool skewness, boo
 	this->print_quantiles = quantiles;
 }
 
+void MetaNumeric::set_sampled(bool sampled) {
+	this->sampled = sampled;
+}
+
+bool MetaNumeric::is_sampled() {
+	return sampled;
+}
+
+/*
+ * Marks the start of the next run of consecutive lines in a clustered sample.
+ */
+void MetaNumeric::begin_cluster() {
+	cluster_n.push_back(n);
+	cluster_na.push_back(na);
+}
+
 void MetaNumeric::set_plot(Plot* plot) {
 	this->plot = plot;
 }
@@ -224,6 +1178,10 @@ Qqplot* MetaNumeric::get_qqplot() {
 	return qqplot;
 }
 
+Manhattan* MetaNumeric::get_manhattan() {
+	return NULL;
+}
+
 Plot* MetaNumeric::get_plot() {
 	return plot;
 }
@@ -283,11 +1241,55 @@ void MetaNumeric::print(ostream& stream) {
 			stream << "\t = " << setprecision(3) << quantiles[8][1] << endl;
 		}
 
+		print_intervals(stream);
+
 		stream << resetiosflags(stream.flags());
 		stream << setfill(' ');
 	}
 }
 
+void MetaNumeric::print_intervals(ostream& stream) {
+	if (!sampled) {
+		return;
+	}
+
+	stream << resetiosflags(stream.flags());
+	stream << endl;
+	stream << " Approximate 95% confidence intervals:" << endl;
+	stream << fixed << setprecision(4);
+	stream << " NA rate\t = " << na_rate << " [" << na_rate_interval[0] << ", " << na_rate_interval[1] << "]" << endl;
+
+	if (print_quantiles == true) {
+		for (unsigned int j = 0; j < 9; j++) {
+			stream << setprecision(0);
+			if (j == 0) {
+				stream << " Min (" << quantiles[j][0] * 100 << "%)\t";
+			} else if (j == 4) {
+				stream << " Median (" << quantiles[j][0] * 100 << "%)\t";
+			} else if (j == 8) {
+				stream << " Max (" << quantiles[j][0] * 100 << "%)\t";
+			} else {
+				stream << " " << quantiles[j][0] * 100 << "%\t\t";
+			}
+			stream << setprecision(3) << " = [";
+			if (isinf(quantile_intervals[j][0])) {
+				stream << "-Inf";
+			} else {
+				stream << quantile_intervals[j][0];
+			}
+			stream << ", ";
+			if (isinf(quantile_intervals[j][1])) {
+				stream << "Inf";
+			} else {
+				stream << quantile_intervals[j][1];
+			}
+			stream << "]" << endl;
+		}
+	}
+
+	stream << resetiosflags(stream.flags());
+}
+
 void MetaNumeric::print_html(ostream& stream, char path_separator) {
 	if (!numeric) {
 		stream << "<div class = \"result\">";
@@ -348,6 +1350,8 @@ void MetaNumeric::print_html(ostream& stream, char path_separator) {
 			stream << "</div>";
 		}
 
+		print_intervals_html(stream);
+
 		if (get_plot() != NULL)  {
 			stream << "<div class = \"float\">";
 			stream << "<a href = \"" << (auxiliary::is_absolute_path(get_plot()->get_name(), path_separator) ? "file:///" : "") << get_plot()->get_name() << ".png\">";
@@ -363,6 +1367,49 @@ void MetaNumeric::print_html(ostream& stream, char path_separator) {
 	}
 }
 
+void MetaNumeric::print_intervals_html(ostream& stream) {
+	if (!sampled) {
+		return;
+	}
+
+	stream << "<div class = \"float\">";
+	stream << "<table class = \"groups\">";
+	stream << "<tr><th colspan = \"2\">Approximate 95% CI</th></tr>";
+	stream << fixed << setprecision(4);
+	stream << "<tr><td>NA rate</td><td>" << na_rate << " [" << na_rate_interval[0] << ", " << na_rate_interval[1] << "]</td></tr>";
+
+	if (print_quantiles == true) {
+		for (unsigned int j = 0; j < 9; j++) {
+			stream << setprecision(0);
+			if (j == 0) {
+				stream << "<tr><td>Min (" << quantiles[j][0] * 100 << "%)</td>";
+			} else if (j == 4) {
+				stream << "<tr><td>Median (" << quantiles[j][0] * 100 << "%)</td>";
+			} else if (j == 8) {
+				stream << "<tr><td>Max (" << quantiles[j][0] * 100 << "%)</td>";
+			} else {
+				stream << "<tr><td>" << quantiles[j][0] * 100 << "%</td>";
+			}
+			stream << setprecision(3) << "<td>[";
+			if (isinf(quantile_intervals[j][0])) {
+				stream << "-&infin;";
+			} else {
+				stream << quantile_intervals[j][0];
+			}
+			stream << ", ";
+			if (isinf(quantile_intervals[j][1])) {
+				stream << "&infin;";
+			} else {
+				stream << quantile_intervals[j][1];
+			}
+			stream << "]</td></tr>";
+		}
+	}
+
+	stream << "</table>";
+	stream << "</div>";
+}
+
 void MetaNumeric::set_color(const char* color) throw (PlotException) {
 	if (color == NULL) {
 		throw PlotException("MetaNumeric", "set_color( const char* )", __LINE__, 0, "color");
@@ -401,11 +1448,58 @@ const double* MetaNumeric::get_data() {
 	return data;
 }
 
-int MetaNumeric::get_n() {
+const float* MetaNumeric::get_single_data() {
+	return single_data;
+}
+
+/*
+ * Calculates the moments and sorts the kept values together with their original positions. Must be called before the
+ * filtered subsets of the column are finalized. The values in single precision are sorted when the column is finalized.
+ */
+void MetaNumeric::sort_order() throw (MetaException) {
+	ordered_value* ordered_values = NULL;
+
+	if ((!numeric) || (low_memory) || (single_precision) || (n <= 0) || (order != NULL)) {
+		return;
+	}
+
+	ordered_values = (ordered_value*)malloc(n * sizeof(ordered_value));
+	if (ordered_values == NULL) {
+		throw MetaException("MetaNumeric", "sort_order()", __LINE__, 2, n * sizeof(ordered_value));
+	}
+
+	order = (uint64_t*)malloc(n * sizeof(uint64_t));
+	if (order == NULL) {
+		free(ordered_values);
+		throw MetaException("MetaNumeric", "sort_order()", __LINE__, 2, n * sizeof(uint64_t));
+	}
+
+	calculate_moments();
+
+	for (int64_t i = 0; i < n; i++) {
+		ordered_values[i].value = data[i];
+		ordered_values[i].position = i;
+	}
+
+	std::sort(ordered_values, ordered_values + n);
+
+	for (int64_t i = 0; i < n; i++) {
+		data[i] = ordered_values[i].value;
+		order[i] = ordered_values[i].position;
+	}
+
+	free(ordered_values);
+}
+
+const uint64_t* MetaNumeric::get_order() {
+	return order;
+}
+
+int64_t MetaNumeric::get_n() {
 	return n;
 }
 
-int MetaNumeric::get_na() {
+int64_t MetaNumeric::get_na() {
 	return na;
 }
 
@@ -448,9 +1542,30 @@ double MetaNumeric::get_quantile(double quantile) {
 }
 
 double MetaNumeric::get_memory_usage() {
-	unsigned long int memory = 0;
+	uint64_t memory = 0;
+
+	memory += current_heap_size * (single_precision ? sizeof(float) : sizeof(double));
 
-	memory += current_heap_size * sizeof(double);
+	if (order != NULL) {
+		memory += n * sizeof(uint64_t);
+	}
+
+	if (bins != NULL) {
+		memory += BINS_BLOCKS_CNT * sizeof(uint64_t*);
+		for (unsigned int block = 0; block < BINS_BLOCKS_CNT; block++) {
+			if (bins[block] != NULL) {
+				memory += BINS_BLOCK_SIZE * sizeof(uint64_t);
+			}
+		}
+	}
+
+	if (selected != NULL) {
+		memory += selected->size() * (sizeof(double) + sizeof(uint64_t));
+	}
+
+	if (histogram != NULL) {
+		memory += histogram->get_total_bytes();
+	}
 
 	return memory / 1048576.0;
 }
@@ -24,33 +24,33 @@ const double MetaRatio::slices[SLICES_CNT] = {
 		0.5, 0.75, 0.95, 0.99, 1.0
 };
 
-MetaRatio::MetaRatio(MetaNumeric* source_a, MetaNumeric* source_b, unsigned int heap_size) throw (MetaException) : Meta(),
+MetaRatio::MetaRatio(MetaFiltered* source_a, MetaFiltered* source_b, unsigned int heap_size) throw (MetaException) : Meta(),
 	source_a(source_a), source_b(source_b), n(0), data(NULL), new_data(NULL), new_value(NULL),
 	current_heap_size(heap_size), skewness(NULL), kurtosis(NULL) {
 
 	if (heap_size == 0) {
-		throw MetaException("MetaRatio", "MetaRatio( MetaNumeric*, MetaNumeric*, unsigned int )", __LINE__, 1, "heap_size");
+		throw MetaException("MetaRatio", "MetaRatio( MetaFiltered*, MetaFiltered*, unsigned int )", __LINE__, 1, "heap_size");
 	}
 
 	data = (double**)malloc(heap_size * sizeof(double*));
 	if (data == NULL) {
-		throw MetaException("MetaRatio", "MetaRatio( MetaNumeric*, MetaNumeric*, unsigned int )", __LINE__, 2, heap_size * sizeof(double*));
+		throw MetaException("MetaRatio", "MetaRatio( MetaFiltered*, MetaFiltered*, unsigned int )", __LINE__, 2, heap_size * sizeof(double*));
 	}
 
 	skewness = (double*)malloc(MetaRatio::SLICES_CNT * sizeof(double));
 	if (skewness == NULL) {
-		throw MetaException("MetaRatio", "MetaRatio( MetaNumeric*, MetaNumeric*, unsigned int )", __LINE__, 2, MetaRatio::SLICES_CNT * sizeof(double));
+		throw MetaException("MetaRatio", "MetaRatio( MetaFiltered*, MetaFiltered*, unsigned int )", __LINE__, 2, MetaRatio::SLICES_CNT * sizeof(double));
 	}
 
 	kurtosis = (double*)malloc(MetaRatio::SLICES_CNT * sizeof(double));
 	if (kurtosis == NULL) {
-		throw MetaException("MetaRatio", "MetaRatio( MetaNumeric*, MetaNumeric*, unsigned int )", __LINE__, 2, MetaRatio::SLICES_CNT * sizeof(double));
+		throw MetaException("MetaRatio", "MetaRatio( MetaFiltered*, MetaFiltered*, unsigned int )", __LINE__, 2, MetaRatio::SLICES_CNT * sizeof(double));
 	}
 }
 
 MetaRatio::~MetaRatio() {
 	if (data != NULL) {
-		for (int i = 0; i < n; i++) {
+		for (int64_t i = 0; i < n; i++) {
 			free(data[i]);
 			data[i] = NULL;
 		}
@@ -67,11 +67,11 @@ MetaRatio::~MetaRatio() {
 	kurtosis = NULL;
 }
 
-MetaNumeric* MetaRatio::get_source_a() {
+MetaFiltered* MetaRatio::get_source_a() {
 	return source_a;
 }
 
-MetaNumeric* MetaRatio::get_source_b() {
+MetaFiltered* MetaRatio::get_source_b() {
 	return source_b;
 }
 
@@ -84,50 +84,67 @@ double* MetaRatio::get_kurtosis() {
 }
 
 void MetaRatio::put(char* value) throw (MetaException) {
+
+}
+
+void MetaRatio::flush() throw (MetaException) {
+	unsigned int block_size = 0;
+	double value_a = 0.0;
+	double ratio = 0.0;
+	double p_wald = 0.0;
+
 	if (!source_a->is_numeric() || !source_b->is_numeric()) {
 		return;
 	}
 
-	if (source_a->is_na() || source_b->is_na()) {
-		return;
+	block_size = source_a->get_block_size();
+	if (source_b->get_block_size() < block_size) {
+		block_size = source_b->get_block_size();
 	}
 
-	double ratio = source_a->get_value() / source_b->get_value();
-	double p_wald = Rf_pchisq(ratio * ratio, 1.0, 0, 0);
-
-	new_value = (double*)malloc(2 * sizeof(double));
-	if (new_value == NULL) {
-		throw MetaException("MetaRatio", "put( char* )", __LINE__, 2, (2 * sizeof(double)));
-	}
+	for (unsigned int i = 0; i < block_size; i++) {
+		if (!source_a->is_selected(i) || !source_b->is_selected(i)) {
+			continue;
+		}
 
-	new_value[0] = p_wald;
-	new_value[1] = source_a->get_value();
+		value_a = source_a->get_block_value(i);
+		ratio = value_a / source_b->get_block_value(i);
+		p_wald = Rf_pchisq(ratio * ratio, 1.0, 0, 0);
 
-	n += 1;
-	if (n > current_heap_size) {
-		current_heap_size += Meta::HEAP_INCREMENT;
+		new_value = (double*)malloc(2 * sizeof(double));
+		if (new_value == NULL) {
+			throw MetaException("MetaRatio", "flush()", __LINE__, 2, (2 * sizeof(double)));
+		}
 
-		new_data = (double**)realloc(data, current_heap_size * sizeof(double*));
-		if (new_data == NULL) {
-			for (int i = 0; i < n; i++) {
-				free(data[i]);
+		new_value[0] = p_wald;
+		new_value[1] = value_a;
+
+		n += 1;
+		if (n > current_heap_size) {
+			current_heap_size += Meta::HEAP_INCREMENT;
+
+			new_data = (double**)realloc(data, current_heap_size * sizeof(double*));
+			if (new_data == NULL) {
+				for (int64_t j = 0; j < n - 1; j++) {
+					free(data[j]);
+				}
+				free(data);
+				free(new_value);
+				data = NULL;
+				throw MetaException("MetaRatio", "flush()", __LINE__, 3, current_heap_size * sizeof(double*));
 			}
-			free(data);
-			free(new_value);
-			data = NULL;
-			throw MetaException("MetaRatio", "put( char* )", __LINE__, 3, current_heap_size * sizeof(double*));
+
+			data = new_data;
 		}
 
-		data = new_data;
+		data[n - 1] = new_value;
 	}
-
-	data[n - 1] = new_value;
 }
 
 void MetaRatio::finalize() throw (MetaException) {
 	if ((data != NULL) && (n > 0)) {
 		double* values = NULL;
-		int slice = 0;
+		int64_t slice = 0;
 		double mean = 0.0;
 		double sd = 0.0;
 
@@ -138,19 +155,16 @@ void MetaRatio::finalize() throw (MetaException) {
 			throw MetaException("MetaRatio", "finalize()", __LINE__, 2, n * sizeof(double));
 		}
 
-		for (int i = n - 1; i >= 0; i--) {
+		for (int64_t i = n - 1; i >= 0; i--) {
 			values[n - 1 - i] = data[i][1];
 			free(data[i]);
 			data[i] = NULL;
 		}
 
 		for (unsigned int i = 0; i < MetaRatio::SLICES_CNT; i++) {
-			slice = (int)(n * MetaRatio::slices[i]);
+			slice = (int64_t)(n * MetaRatio::slices[i]);
 
-			mean = auxiliary::stats_mean(values, slice);
-			sd = auxiliary::stats_sd(values, slice, mean);
-			skewness[i] = auxiliary::stats_skewness(values, slice, mean, sd);
-			kurtosis[i] = auxiliary::stats_kurtosis(values, slice, mean, sd);
+			auxiliary::stats_moments(values, slice, mean, sd, skewness[i], kurtosis[i]);
 		}
 
 		free(values);
@@ -166,6 +180,52 @@ void MetaRatio::finalize() throw (MetaException) {
 	}
 }
 
+void MetaRatio::save_state(ostream& stream) throw (MetaException) {
+	save_bytes(stream, &n, sizeof(int64_t));
+
+	for (int64_t i = 0; i < n; i++) {
+		save_bytes(stream, data[i], 2 * sizeof(double));
+	}
+}
+
+void MetaRatio::merge_state(istream& stream) throw (MetaException) {
+	int64_t saved_n = 0;
+
+	load_bytes(stream, &saved_n, sizeof(int64_t));
+
+	if (saved_n < 0) {
+		throw MetaException("MetaRatio", "merge_state( istream& )", __LINE__, 5, "ratio");
+	}
+
+	if (n + saved_n > current_heap_size) {
+		new_data = (double**)realloc(data, (n + saved_n) * sizeof(double*));
+		if (new_data == NULL) {
+			throw MetaException("MetaRatio", "merge_state( istream& )", __LINE__, 3, (n + saved_n) * sizeof(double*));
+		}
+
+		data = new_data;
+		current_heap_size = n + saved_n;
+	}
+
+	for (int64_t i = 0; i < saved_n; i++) {
+		new_value = (double*)malloc(2 * sizeof(double));
+		if (new_value == NULL) {
+			throw MetaException("MetaRatio", "merge_state( istream& )", __LINE__, 2, (2 * sizeof(double)));
+		}
+
+		try {
+			load_bytes(stream, new_value, 2 * sizeof(double));
+		} catch (MetaException &e) {
+			free(new_value);
+			new_value = NULL;
+			throw;
+		}
+
+		data[n] = new_value;
+		n += 1;
+	}
+}
+
 bool MetaRatio::is_na() {
 	return false;
 }
@@ -179,7 +239,7 @@ void MetaRatio::print_html(ostream& stream, char path_separator) {
 }
 
 double MetaRatio::get_memory_usage() {
-	unsigned long int memory = 0;
+	uint64_t memory = 0;
 
 	memory += current_heap_size * sizeof(double*);
 	memory += n * sizeof(double) * 2;
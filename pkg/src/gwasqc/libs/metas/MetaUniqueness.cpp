@@ -19,36 +19,74 @@
 
 #include "../../include/metas/MetaUniqueness.h"
 
-MetaUniqueness::MetaUniqueness(unsigned int heap_size) throw (MetaException) : Meta(),
+const unsigned int MetaUniqueness::HLL_PRECISION = 14;
+const unsigned int MetaUniqueness::HLL_REGISTERS = 16384;
+
+MetaUniqueness::MetaUniqueness(unsigned int heap_size, bool fingerprint) throw (MetaException) : Meta(),
 	n(0), na_value(false), data(NULL), new_data(NULL), new_value(NULL),
-	current_heap_size(heap_size) {
+	current_heap_size(heap_size), fingerprint(fingerprint), fingerprints(NULL), new_fingerprints(NULL),
+	candidates(NULL), n_candidates(0), registers(NULL), distinct(0.0) {
+
+	if (fingerprint) {
+		registers = (unsigned char*)calloc(HLL_REGISTERS, sizeof(unsigned char));
+		if (registers == NULL) {
+			throw MetaException("MetaUniqueness", "MetaUniqueness( unsigned int, bool )", __LINE__, 2, HLL_REGISTERS * sizeof(unsigned char));
+		}
 
-	if (heap_size > 0) {
+		if (heap_size > 0) {
+			fingerprints = (uint64_t*)malloc(heap_size * sizeof(uint64_t));
+			if (fingerprints == NULL) {
+				free(registers);
+				registers = NULL;
+				throw MetaException("MetaUniqueness", "MetaUniqueness( unsigned int, bool )", __LINE__, 2, heap_size * sizeof(uint64_t));
+			}
+		}
+	} else if (heap_size > 0) {
 		data = (char**)malloc(heap_size * sizeof(char*));
 		if (data == NULL) {
-			throw MetaException("MetaUniqueness", "MetaUniqueness( unsigned int )", __LINE__, 2, heap_size * sizeof(char*));
+			throw MetaException("MetaUniqueness", "MetaUniqueness( unsigned int, bool )", __LINE__, 2, heap_size * sizeof(char*));
 		}
 	}
 }
 
 MetaUniqueness::~MetaUniqueness() {
 	if (data != NULL) {
-		for (int i = 0; i < n; i++) {
+		for (int64_t i = 0; i < n; i++) {
 			free(data[i]);
 		}
 		free(data);
 		data = NULL;
 	}
 
+	if (fingerprints != NULL) {
+		free(fingerprints);
+		fingerprints = NULL;
+	}
+
+	if (candidates != NULL) {
+		free(candidates);
+		candidates = NULL;
+	}
+
+	if (registers != NULL) {
+		free(registers);
+		registers = NULL;
+	}
+
 	for (duplicates_it = duplicates.begin(); duplicates_it != duplicates.end(); duplicates_it++) {
 		free(*duplicates_it);
 	}
 
+	for (duplicates_it = collisions.begin(); duplicates_it != collisions.end(); duplicates_it++) {
+		free(*duplicates_it);
+	}
+
 	duplicates.clear();
+	collisions.clear();
 }
 
 void MetaUniqueness::put(char* value) throw (MetaException) {
-	if (strcmp(na_marker, value) == 0) {
+	if (is_na_marker(value)) {
 		na_value = true;
 		return;
 	}
@@ -56,6 +94,11 @@ void MetaUniqueness::put(char* value) throw (MetaException) {
 		na_value = false;
 	}
 
+	if (fingerprint) {
+		put_fingerprint(value);
+		return;
+	}
+
 	new_value = (char*)malloc((strlen(value) + 1) * sizeof(char));
 	if (new_value == NULL) {
 		throw MetaException("MetaUniqueness", "put( char* )", __LINE__, 2, (strlen(value) + 1) * sizeof(char));
@@ -69,7 +112,7 @@ void MetaUniqueness::put(char* value) throw (MetaException) {
 
 		new_data = (char**)realloc(data, current_heap_size * sizeof(char*));
 		if (new_data == NULL) {
-			for (int i = 0; i < n; i++) {
+			for (int64_t i = 0; i < n; i++) {
 				free(data[i]);
 			}
 			free(data);
@@ -83,36 +126,278 @@ void MetaUniqueness::put(char* value) throw (MetaException) {
 	data[n - 1] = new_value;
 }
 
+void MetaUniqueness::put_fingerprint(char* value) throw (MetaException) {
+	uint64_t hash = auxiliary::hash64(value);
+	uint64_t rest = 0;
+	unsigned int index = 0;
+	unsigned char rank = 1;
+
+	/* HyperLogLog: the first HLL_PRECISION bits select a register, the rest give the rank of the first 1-bit. */
+	index = (unsigned int)(hash >> (64 - HLL_PRECISION));
+	rest = hash << HLL_PRECISION;
+	while ((rank <= 64 - HLL_PRECISION) && ((rest & 0x8000000000000000ULL) == 0)) {
+		rest <<= 1;
+		rank += 1;
+	}
+
+	if (registers[index] < rank) {
+		registers[index] = rank;
+	}
+
+	n += 1;
+
+	if (n > current_heap_size) {
+		current_heap_size += Meta::HEAP_INCREMENT;
+
+		new_fingerprints = (uint64_t*)realloc(fingerprints, current_heap_size * sizeof(uint64_t));
+		if (new_fingerprints == NULL) {
+			free(fingerprints);
+			fingerprints = NULL;
+			throw MetaException("MetaUniqueness", "put_fingerprint( char* )", __LINE__, 3, current_heap_size * sizeof(uint64_t));
+		}
+		fingerprints = new_fingerprints;
+	}
+
+	fingerprints[n - 1] = hash;
+}
+
 void MetaUniqueness::finalize() throw (MetaException) {
-	if ((data != NULL) && (n > 0)) {
-		char* prev_duplicate = NULL;
-		char* new_string = NULL;
+	if (fingerprint) {
+		finalize_fingerprints();
+		return;
+	}
 
+	if ((data != NULL) && (n > 0)) {
 		qsort(data, n, sizeof(char*), qsort_strcmp);
+		collect_duplicates(data, n);
+	}
+
+	free(data);
+	data = NULL;
+}
+
+void MetaUniqueness::finalize_fingerprints() throw (MetaException) {
+	double alpha = 0.7213 / (1.0 + 1.079 / HLL_REGISTERS);
+	double sum = 0.0;
+	unsigned int zeros = 0;
+
+	if (registers != NULL) {
+		for (unsigned int i = 0; i < HLL_REGISTERS; i++) {
+			sum += ldexp(1.0, -registers[i]);
+			if (registers[i] == 0) {
+				zeros += 1;
+			}
+		}
+
+		distinct = alpha * HLL_REGISTERS * HLL_REGISTERS / sum;
+		if ((distinct <= 2.5 * HLL_REGISTERS) && (zeros > 0)) {
+			distinct = HLL_REGISTERS * log(HLL_REGISTERS / (double)zeros);
+		}
 
-		for (int i = 0; i < n - 1; i++) {
-			if (strcmp(data[i], data[i + 1]) == 0) {
-				if ((prev_duplicate == NULL) || (strcmp(prev_duplicate, data[i + 1]) != 0)) {
-					new_string = (char*)malloc((strlen(data[i + 1]) + 1) * sizeof(char));
-					if (new_string == NULL) {
-						throw MetaException("MetaUniqueness", "finalize()", __LINE__, 2, (strlen(data[i + 1]) + 1) * sizeof(char));
-					}
-					strcpy(new_string, data[i + 1]);
+		free(registers);
+		registers = NULL;
+	}
 
-					duplicates.push_back(new_string);
+	if ((fingerprints != NULL) && (n > 0)) {
+		qsort(fingerprints, n, sizeof(uint64_t), uint64cmp);
 
-					prev_duplicate = new_string;
+		/* Colliding fingerprints are compacted in place to the front of the array. */
+		for (int64_t i = 0; i < n - 1; i++) {
+			if (fingerprints[i] == fingerprints[i + 1]) {
+				if ((n_candidates == 0) || (fingerprints[n_candidates - 1] != fingerprints[i])) {
+					fingerprints[n_candidates] = fingerprints[i];
+					n_candidates += 1;
 				}
 			}
+		}
 
-			free(data[i]);
+		if (n_candidates > 0) {
+			candidates = (uint64_t*)realloc(fingerprints, n_candidates * sizeof(uint64_t));
+			if (candidates == NULL) {
+				free(fingerprints);
+				fingerprints = NULL;
+				throw MetaException("MetaUniqueness", "finalize_fingerprints()", __LINE__, 3, n_candidates * sizeof(uint64_t));
+			}
+			fingerprints = NULL;
 		}
+	}
+
+	free(fingerprints);
+	fingerprints = NULL;
+}
+
+bool MetaUniqueness::is_verification_required() {
+	return fingerprint && (candidates != NULL);
+}
 
-		free(data[n - 1]);
+void MetaUniqueness::verify(char* value) throw (MetaException) {
+	uint64_t hash = 0;
+	char* new_string = NULL;
+
+	if ((candidates == NULL) || (is_na_marker(value))) {
+		return;
 	}
 
-	free(data);
-	data = NULL;
+	hash = auxiliary::hash64(value);
+
+	if (bsearch(&hash, candidates, n_candidates, sizeof(uint64_t), uint64cmp) != NULL) {
+		new_string = (char*)malloc((strlen(value) + 1) * sizeof(char));
+		if (new_string == NULL) {
+			throw MetaException("MetaUniqueness", "verify( char* )", __LINE__, 2, (strlen(value) + 1) * sizeof(char));
+		}
+		strcpy(new_string, value);
+
+		collisions.push_back(new_string);
+	}
+}
+
+void MetaUniqueness::finalize_verification() throw (MetaException) {
+	if (!collisions.empty()) {
+		qsort(&collisions[0], collisions.size(), sizeof(char*), qsort_strcmp);
+		collect_duplicates(&collisions[0], collisions.size());
+	}
+
+	collisions.clear();
+
+	free(candidates);
+	candidates = NULL;
+	n_candidates = 0;
+}
+
+void MetaUniqueness::collect_duplicates(char** values, int64_t size) throw (MetaException) {
+	char* prev_duplicate = NULL;
+	char* new_string = NULL;
+
+	for (int64_t i = 0; i < size - 1; i++) {
+		if (strcmp(values[i], values[i + 1]) == 0) {
+			if ((prev_duplicate == NULL) || (strcmp(prev_duplicate, values[i + 1]) != 0)) {
+				new_string = (char*)malloc((strlen(values[i + 1]) + 1) * sizeof(char));
+				if (new_string == NULL) {
+					throw MetaException("MetaUniqueness", "collect_duplicates( char**, int64_t )", __LINE__, 2, (strlen(values[i + 1]) + 1) * sizeof(char));
+				}
+				strcpy(new_string, values[i + 1]);
+
+				duplicates.push_back(new_string);
+
+				prev_duplicate = new_string;
+			}
+		}
+
+		free(values[i]);
+		values[i] = NULL;
+	}
+
+	free(values[size - 1]);
+	values[size - 1] = NULL;
+}
+
+/*
+ * In fingerprint mode only the HyperLogLog registers and the fingerprints are saved, otherwise the values themselves.
+ */
+void MetaUniqueness::save_state(ostream& stream) throw (MetaException) {
+	unsigned char saved_fingerprint = fingerprint ? 1 : 0;
+	unsigned int length = 0;
+
+	save_bytes(stream, &saved_fingerprint, sizeof(unsigned char));
+	save_bytes(stream, &n, sizeof(int64_t));
+
+	if (fingerprint) {
+		save_bytes(stream, registers, HLL_REGISTERS * sizeof(unsigned char));
+		if (n > 0) {
+			save_bytes(stream, fingerprints, n * sizeof(uint64_t));
+		}
+	} else {
+		for (int64_t i = 0; i < n; i++) {
+			length = strlen(data[i]);
+			save_bytes(stream, &length, sizeof(unsigned int));
+			save_bytes(stream, data[i], length * sizeof(char));
+		}
+	}
+}
+
+void MetaUniqueness::merge_state(istream& stream) throw (MetaException) {
+	unsigned char saved_fingerprint = 0;
+	unsigned char* saved_registers = NULL;
+	int64_t saved_n = 0;
+	unsigned int length = 0;
+
+	load_bytes(stream, &saved_fingerprint, sizeof(unsigned char));
+	load_bytes(stream, &saved_n, sizeof(int64_t));
+
+	if (saved_n < 0) {
+		throw MetaException("MetaUniqueness", "merge_state( istream& )", __LINE__, 5, actual_name != NULL ? actual_name : "NULL");
+	}
+
+	if ((saved_fingerprint != 0) != fingerprint) {
+		throw MetaException("MetaUniqueness", "merge_state( istream& )", __LINE__, 6, actual_name != NULL ? actual_name : "NULL");
+	}
+
+	if (fingerprint) {
+		saved_registers = (unsigned char*)malloc(HLL_REGISTERS * sizeof(unsigned char));
+		if (saved_registers == NULL) {
+			throw MetaException("MetaUniqueness", "merge_state( istream& )", __LINE__, 2, HLL_REGISTERS * sizeof(unsigned char));
+		}
+
+		try {
+			load_bytes(stream, saved_registers, HLL_REGISTERS * sizeof(unsigned char));
+		} catch (MetaException &e) {
+			free(saved_registers);
+			throw;
+		}
+
+		for (unsigned int i = 0; i < HLL_REGISTERS; i++) {
+			if (registers[i] < saved_registers[i]) {
+				registers[i] = saved_registers[i];
+			}
+		}
+
+		free(saved_registers);
+		saved_registers = NULL;
+
+		if (saved_n > 0) {
+			if (n + saved_n > current_heap_size) {
+				new_fingerprints = (uint64_t*)realloc(fingerprints, (n + saved_n) * sizeof(uint64_t));
+				if (new_fingerprints == NULL) {
+					throw MetaException("MetaUniqueness", "merge_state( istream& )", __LINE__, 3, (n + saved_n) * sizeof(uint64_t));
+				}
+				fingerprints = new_fingerprints;
+				current_heap_size = n + saved_n;
+			}
+
+			load_bytes(stream, fingerprints + n, saved_n * sizeof(uint64_t));
+			n += saved_n;
+		}
+	} else {
+		if (n + saved_n > current_heap_size) {
+			new_data = (char**)realloc(data, (n + saved_n) * sizeof(char*));
+			if (new_data == NULL) {
+				throw MetaException("MetaUniqueness", "merge_state( istream& )", __LINE__, 3, (n + saved_n) * sizeof(char*));
+			}
+			data = new_data;
+			current_heap_size = n + saved_n;
+		}
+
+		for (int64_t i = 0; i < saved_n; i++) {
+			load_bytes(stream, &length, sizeof(unsigned int));
+
+			new_value = (char*)malloc((length + 1) * sizeof(char));
+			if (new_value == NULL) {
+				throw MetaException("MetaUniqueness", "merge_state( istream& )", __LINE__, 2, (length + 1) * sizeof(char));
+			}
+
+			try {
+				load_bytes(stream, new_value, length * sizeof(char));
+			} catch (MetaException &e) {
+				free(new_value);
+				new_value = NULL;
+				throw;
+			}
+			new_value[length] = '\0';
+
+			data[n] = new_value;
+			n += 1;
+		}
+	}
 }
 
 bool MetaUniqueness::is_na() {
@@ -123,6 +408,10 @@ void MetaUniqueness::print(ostream& stream) {
 	stream << resetiosflags(stream.flags());
 	stream << setfill(' ');
 
+	if (fingerprint) {
+		stream << " Distinct (approx.): " << (uint64_t)(distinct + 0.5) << endl;
+	}
+
 	if (duplicates.empty()) {
 		stream << " None" << endl;
 	}
@@ -136,6 +425,12 @@ void MetaUniqueness::print(ostream& stream) {
 void MetaUniqueness::print_html(ostream& stream, char path_separator) {
 	stream << resetiosflags(stream.flags());
 
+	if (fingerprint) {
+		stream << "<div class = \"result\">";
+		stream << "Distinct (approx.): " << (uint64_t)(distinct + 0.5);
+		stream << "</div>";
+	}
+
 	if (duplicates.empty()) {
 		stream << "<div class = \"result\">";
 		stream << "None";
@@ -154,10 +449,17 @@ void MetaUniqueness::print_html(ostream& stream, char path_separator) {
 }
 
 double MetaUniqueness::get_memory_usage() {
-	unsigned long int memory = 0;
+	uint64_t memory = 0;
+
+	if (fingerprint) {
+		memory += current_heap_size * sizeof(uint64_t);
+		memory += HLL_REGISTERS * sizeof(unsigned char);
+
+		return memory / 1048576.0;
+	}
 
 	if (data != NULL) {
-		for (int i = 0; i < n; i++) {
+		for (int64_t i = 0; i < n; i++) {
 			memory += ((strlen(data[i]) + 1) * sizeof(char));
 		}
 	}
@@ -23,7 +23,7 @@ const int Boxplot::TUKEY_SIZE = 5;
 const int Boxplot::NOTCHES_SIZE = 2;
 
 Boxplot::Boxplot():
-	tukey(NULL), observations(NULL), notches(NULL), outliers(NULL),
+	tukey(NULL), observations(NULL), outliers_totals(NULL), notches(NULL), outliers(NULL),
 	groups(NULL), names(NULL), widths(NULL), outliers_cnt(0), groups_cnt(0), common_name(NULL), title(NULL) {
 
 }
@@ -31,6 +31,7 @@ Boxplot::Boxplot():
 Boxplot::~Boxplot() {
 	free(tukey);
 	free(observations);
+	free(outliers_totals);
 	free(notches);
 	free(outliers);
 	free(groups);
@@ -45,6 +46,7 @@ Boxplot::~Boxplot() {
 
 	tukey = NULL;
 	observations = NULL;
+	outliers_totals = NULL;
 	notches = NULL;
 	outliers = NULL;
 	groups = NULL;
@@ -54,28 +56,28 @@ Boxplot::~Boxplot() {
 	names = NULL;
 }
 
-Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, double median) throw (PlotException) {
+Boxplot* Boxplot::create(const char* name, double* sorted_data, int64_t data_size, double median) throw (PlotException) {
 	Boxplot* boxplot = NULL;
 	double lower_q_position = 0.0, upper_q_position = 0.0;
 	double integer = 0.0, fraction = 0.0;
 	double iqr = 0.0;
 	double lower_outliers = 0.0, upper_outliers = 0.0;
-	int lower_outliers_cnt = 0, upper_outliers_cnt = 0;
+	int64_t lower_outliers_cnt = 0, upper_outliers_cnt = 0;
 
 	if (name == NULL) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 0, "name");
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 0, "name");
 	}
 
 	if (strlen(name) <= 0) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 1, "name");
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 1, "name");
 	}
 
 	if (sorted_data == NULL) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 0, "sorted_data");
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 0, "sorted_data");
 	}
 
 	if (data_size <= 0) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 1, "data_size");
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 1, "data_size");
 	}
 
 	if (isnan(median) || isinf(median)) {
@@ -86,23 +88,27 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 	boxplot = new Boxplot();
 
 	if ((boxplot->tukey = (double*)malloc(TUKEY_SIZE * sizeof(double))) == NULL) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 2, TUKEY_SIZE * sizeof(double));
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, TUKEY_SIZE * sizeof(double));
 	}
 
-	if ((boxplot->observations = (int*)malloc(sizeof(int))) == NULL) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 2, sizeof(int));
+	if ((boxplot->observations = (int64_t*)malloc(sizeof(int64_t))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, sizeof(int64_t));
+	}
+
+	if ((boxplot->outliers_totals = (int64_t*)malloc(sizeof(int64_t))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, sizeof(int64_t));
 	}
 
 	if ((boxplot->names = (char**)malloc(sizeof(char*))) == NULL) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 2, sizeof(char*));
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, sizeof(char*));
 	}
 
 	if ((boxplot->names[0] = (char*)malloc((strlen(name) + 1) * sizeof(char))) == NULL) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
 	}
 
 	if ((boxplot->widths = (double*)malloc(sizeof(double))) == NULL) {
-		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 2, sizeof(double));
+		throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, sizeof(double));
 	}
 
 	strcpy(boxplot->names[0], name);
@@ -121,23 +127,23 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 
 	fraction = modf(lower_q_position, &integer);
 
-	if ((int)integer == data_size) {
-		boxplot->tukey[1] = sorted_data[(int)integer - 1];
+	if ((int64_t)integer == data_size) {
+		boxplot->tukey[1] = sorted_data[(int64_t)integer - 1];
 	} else {
-		boxplot->tukey[1]  = (1 - fraction) * sorted_data[(int)integer - 1] + fraction * sorted_data[(int)integer];
+		boxplot->tukey[1]  = (1 - fraction) * sorted_data[(int64_t)integer - 1] + fraction * sorted_data[(int64_t)integer];
 		if (isnan(boxplot->tukey[1])) {
-			boxplot->tukey[1] = sorted_data[(int)integer - 1];
+			boxplot->tukey[1] = sorted_data[(int64_t)integer - 1];
 		}
 	}
 
 	fraction = modf(upper_q_position, &integer);
 
-	if ((int)integer == data_size) {
-		boxplot->tukey[3] = sorted_data[(int)integer - 1];
+	if ((int64_t)integer == data_size) {
+		boxplot->tukey[3] = sorted_data[(int64_t)integer - 1];
 	} else {
-		boxplot->tukey[3] = (1 - fraction) * sorted_data[(int)integer - 1] + fraction * sorted_data[(int)integer];
+		boxplot->tukey[3] = (1 - fraction) * sorted_data[(int64_t)integer - 1] + fraction * sorted_data[(int64_t)integer];
 		if (isnan(boxplot->tukey[3])) {
-			boxplot->tukey[3] = sorted_data[(int)integer - 1];
+			boxplot->tukey[3] = sorted_data[(int64_t)integer - 1];
 		}
 	}
 
@@ -176,18 +182,19 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 
 	upper_outliers_cnt = data_size - upper_outliers_cnt - 1;
 
-	/* Set total outliers' count */
-	boxplot->outliers_cnt = lower_outliers_cnt + upper_outliers_cnt;
-
 	/* Set observations' number */
 	boxplot->observations[0] = data_size;
+	boxplot->outliers_totals[0] = lower_outliers_cnt + upper_outliers_cnt;
 
-	/* If there exist outliers, then copy them */
-	if (boxplot->outliers_cnt > 0) {
+	/*
+	 * If there exist outliers, then copy them. At most about a thousand of them don't overlap, so their count fits an int.
+	 * The largest outlier is kept even if it overlaps, so that the plotted range of outliers is exact.
+	 */
+	if (lower_outliers_cnt + upper_outliers_cnt > 0) {
 		int new_outliers_cnt = 0;
 		double previous_value = -numeric_limits<double>::infinity();
 		double delta = (sorted_data[data_size - 1] - sorted_data[0]) / 1000;
-		int i = 0, j = 0;
+		int64_t i = 0, j = 0;
 
 		/* BUG FIX: handle infinities */
 		while ((i < data_size) && (isinf(sorted_data[i]))) {
@@ -216,7 +223,8 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 
 		i = 0;
 		while (i < upper_outliers_cnt) {
-			if (sorted_data[data_size - upper_outliers_cnt + i] >= previous_value + delta) {
+			if ((sorted_data[data_size - upper_outliers_cnt + i] >= previous_value + delta) ||
+					((i == upper_outliers_cnt - 1) && (sorted_data[data_size - 1] > previous_value))) {
 				new_outliers_cnt += 1;
 				previous_value = sorted_data[data_size - upper_outliers_cnt + i];
 			}
@@ -226,7 +234,7 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 		/* Copy non-overlapping outliers. Intuitively the check for > 0 is not necessary, however we keep it. */
 		if (new_outliers_cnt > 0) {
 			if ((boxplot->outliers = (double*)malloc(new_outliers_cnt * sizeof(double))) == NULL) {
-				throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 2, new_outliers_cnt * sizeof(double));
+				throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, new_outliers_cnt * sizeof(double));
 			}
 
 			previous_value = -numeric_limits<double>::infinity();
@@ -242,7 +250,8 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 
 			i = 0;
 			while (i < upper_outliers_cnt) {
-				if (sorted_data[data_size - upper_outliers_cnt + i] >= previous_value + delta) {
+				if ((sorted_data[data_size - upper_outliers_cnt + i] >= previous_value + delta) ||
+						((i == upper_outliers_cnt - 1) && (sorted_data[data_size - 1] > previous_value))) {
 					boxplot->outliers[j] = sorted_data[data_size - upper_outliers_cnt + i];
 					j += 1;
 					previous_value = sorted_data[data_size - upper_outliers_cnt + i];
@@ -254,7 +263,7 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 
 			/* Create and fill the groups array (Only for compatibility with R) */
 			if ((boxplot->groups = (int*)malloc(boxplot->outliers_cnt * sizeof(int))) == NULL) {
-				throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int, double )", __LINE__, 2, boxplot->outliers_cnt * sizeof(int));
+				throw PlotException("Boxplot", "Boxplot* create( const char*, double*, int64_t, double )", __LINE__, 2, boxplot->outliers_cnt * sizeof(int));
 			}
 
 			for (int i = 0; i < boxplot->outliers_cnt; i++) {
@@ -266,6 +275,95 @@ Boxplot* Boxplot::create(const char* name, double* sorted_data, int data_size, d
 	return boxplot;
 }
 
+/*
+ * Creates a boxplot from the precomputed Tukey's summary (lower whisker, lower hinge, median, upper hinge, upper whisker)
+ * and the sorted outliers, which are already thinned from outliers_total values. Used when the data is not kept in memory.
+ */
+Boxplot* Boxplot::create(const char* name, int64_t data_size, const double* tukey, const double* outliers, int outliers_cnt, int64_t outliers_total) throw (PlotException) {
+	Boxplot* boxplot = NULL;
+
+	if (name == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 0, "name");
+	}
+
+	if (strlen(name) <= 0) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 1, "name");
+	}
+
+	if (tukey == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 0, "tukey");
+	}
+
+	if (data_size <= 0) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 1, "data_size");
+	}
+
+	if ((outliers_cnt < 0) || ((outliers_cnt > 0) && (outliers == NULL))) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 1, "outliers_cnt");
+	}
+
+	if (outliers_total < outliers_cnt) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 1, "outliers_total");
+	}
+
+	if (isnan(tukey[2]) || isinf(tukey[2])) {
+		return NULL;
+	}
+
+	boxplot = new Boxplot();
+
+	if ((boxplot->tukey = (double*)malloc(TUKEY_SIZE * sizeof(double))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, TUKEY_SIZE * sizeof(double));
+	}
+
+	if ((boxplot->observations = (int64_t*)malloc(sizeof(int64_t))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, sizeof(int64_t));
+	}
+
+	if ((boxplot->outliers_totals = (int64_t*)malloc(sizeof(int64_t))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, sizeof(int64_t));
+	}
+
+	if ((boxplot->names = (char**)malloc(sizeof(char*))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, sizeof(char*));
+	}
+
+	if ((boxplot->names[0] = (char*)malloc((strlen(name) + 1) * sizeof(char))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
+	}
+
+	if ((boxplot->widths = (double*)malloc(sizeof(double))) == NULL) {
+		throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, sizeof(double));
+	}
+
+	strcpy(boxplot->names[0], name);
+	for (int i = 0; i < TUKEY_SIZE; i++) {
+		boxplot->tukey[i] = tukey[i];
+	}
+	boxplot->widths[0] = numeric_limits<double>::quiet_NaN();
+	boxplot->groups_cnt = 1;
+	boxplot->observations[0] = data_size;
+	boxplot->outliers_totals[0] = outliers_total;
+	boxplot->outliers_cnt = outliers_cnt;
+
+	if (outliers_cnt > 0) {
+		if ((boxplot->outliers = (double*)malloc(outliers_cnt * sizeof(double))) == NULL) {
+			throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, outliers_cnt * sizeof(double));
+		}
+
+		if ((boxplot->groups = (int*)malloc(outliers_cnt * sizeof(int))) == NULL) {
+			throw PlotException("Boxplot", "Boxplot* create( const char*, int64_t, const double*, const double*, int, int64_t )", __LINE__, 2, outliers_cnt * sizeof(int));
+		}
+
+		for (int i = 0; i < outliers_cnt; i++) {
+			boxplot->outliers[i] = outliers[i];
+			boxplot->groups[i] = 1;
+		}
+	}
+
+	return boxplot;
+}
+
 Boxplot* Boxplot::merge(Boxplot* to, Boxplot* from) throw (PlotException) {
 	Boxplot* boxplot = to;
 
@@ -293,13 +391,20 @@ Boxplot* Boxplot::merge(Boxplot* to, Boxplot* from) throw (PlotException) {
 			boxplot->tukey[j++] = from->tukey[i++];
 		}
 
-		new_memory = realloc(boxplot->observations, new_group * sizeof(int));
+		new_memory = realloc(boxplot->observations, new_group * sizeof(int64_t));
 		if (new_memory == NULL) {
-			throw PlotException("Boxplot", "Boxplot* merge( Boxplot*, Boxplot* )", __LINE__, 3, new_group * sizeof(int));
+			throw PlotException("Boxplot", "Boxplot* merge( Boxplot*, Boxplot* )", __LINE__, 3, new_group * sizeof(int64_t));
 		}
-		boxplot->observations = (int*)new_memory;
+		boxplot->observations = (int64_t*)new_memory;
 		boxplot->observations[boxplot->groups_cnt] = from->observations[0];
 
+		new_memory = realloc(boxplot->outliers_totals, new_group * sizeof(int64_t));
+		if (new_memory == NULL) {
+			throw PlotException("Boxplot", "Boxplot* merge( Boxplot*, Boxplot* )", __LINE__, 3, new_group * sizeof(int64_t));
+		}
+		boxplot->outliers_totals = (int64_t*)new_memory;
+		boxplot->outliers_totals[boxplot->groups_cnt] = from->outliers_totals[0];
+
 		new_memory = realloc(boxplot->outliers, (boxplot->outliers_cnt + from->outliers_cnt) * sizeof(double));
 		if (new_memory == NULL) {
 			throw PlotException("Boxplot", "Boxplot* merge( Boxplot*, Boxplot* )", __LINE__, 3, (boxplot->outliers_cnt + from->outliers_cnt) * sizeof(double));
@@ -435,10 +540,14 @@ const double* Boxplot::get_tukey() {
 	return tukey;
 }
 
-const int* Boxplot::get_observations() {
+const int64_t* Boxplot::get_observations() {
 	return observations;
 }
 
+const int64_t* Boxplot::get_outliers_totals() {
+	return outliers_totals;
+}
+
 const double* Boxplot::get_notches() {
 	return notches;
 }
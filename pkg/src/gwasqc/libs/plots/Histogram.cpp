@@ -19,9 +19,15 @@
 
 #include "../../include/plots/Histogram.h"
 
+const double Histogram::TOLERANCE = 1e-07;
+
+const int Histogram::PENDING_SIZE = 10000;
+
 Histogram::Histogram():
 	breaks(NULL), counts(NULL), density(NULL), intensities(NULL),
-	mids(NULL), xname(NULL), nclass(0), title(NULL) {
+	mids(NULL), xname(NULL), nclass(0), n_finite(0), title(NULL),
+	capacity(0), start(0.0), unit(0.0), fuzz(0.0), finite_min(numeric_limits<double>::infinity()),
+	pending(NULL), pending_n(0) {
 
 }
 
@@ -32,6 +38,7 @@ Histogram::~Histogram() {
 	free(mids);
 	free(xname);
 	free(title);
+	free(pending);
 
 	breaks = NULL;
 	counts = NULL;
@@ -40,24 +47,16 @@ Histogram::~Histogram() {
 	mids = NULL;
 	xname = NULL;
 	title = NULL;
+	pending = NULL;
 }
 
-Histogram* Histogram::create(const char* name, double* sorted_data, int data_size, int nclass) throw (PlotException) {
+/*
+ * Creates an empty histogram for the values of unknown range. The first PENDING_SIZE values are buffered, and the classes
+ * are chosen from their range.
+ */
+Histogram* Histogram::create(const char* name, int nclass) throw (PlotException) {
 	Histogram* histogram = NULL;
 
-	double* lower_finite = NULL;
-	double*	upper_finite = NULL;
-	int n_finite = 0;
-
-	double range[2];
-	double bias[] = {1.5, 0.5 + 1.5 * 1.5};
-	double tolerance = 1e-07;
-	double unit = 0.0;
-
-	int i = 0, j = 0;
-	double start = 0.0, end = 0.0;
-	double denominator = 0.0;
-
 	if (name == NULL) {
 		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 0, "name");
 	}
@@ -66,115 +65,269 @@ Histogram* Histogram::create(const char* name, double* sorted_data, int data_siz
 		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 1, "name");
 	}
 
-	if (sorted_data == NULL) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 0, "sorted_data");
+	if (nclass <= 0) {
+		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 1, "nclass");
 	}
 
-	if (data_size <= 0) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 1, "data_size");
+	histogram = new Histogram();
+	histogram->nclass = nclass;
+
+	if ((histogram->xname = (char*)malloc((strlen(name) + 1) * sizeof(char))) == NULL) {
+		delete histogram;
+		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
 	}
+	strcpy(histogram->xname, name);
 
-	if (nclass <= 0) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 1, "nclass");
+	if ((histogram->pending = (double*)malloc(PENDING_SIZE * sizeof(double))) == NULL) {
+		delete histogram;
+		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 2, PENDING_SIZE * sizeof(double));
 	}
 
-	/* BEGIN: Determine finite data boundaries, ranges, breaks and etc. See R help(pretty). */
-	while ((i < data_size) && (isinf(sorted_data[i]))) {
-		i += 1;
+	return histogram;
+}
+
+/*
+ * Creates an empty histogram for the values of known range. The classes are chosen for the given boundaries at once, and
+ * the values outside of them are still counted.
+ */
+Histogram* Histogram::create(const char* name, double lower, double upper, int nclass) throw (PlotException) {
+	Histogram* histogram = NULL;
+
+	if ((isnan(lower)) || (isinf(lower))) {
+		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 1, "lower");
 	}
 
-	if (i >= data_size) {
-		return NULL;
+	if ((isnan(upper)) || (isinf(upper)) || (upper <= lower)) {
+		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 1, "upper");
 	}
 
-	lower_finite = sorted_data + i;
-	n_finite = data_size - i;
+	histogram = create(name, nclass);
+
+	try {
+		free(histogram->pending);
+		histogram->pending = NULL;
 
-	i = data_size - 1;
-	while ((i >= 0) && (isinf(sorted_data[i]))) {
-		i -= 1;
+		histogram->set_classes(lower, upper);
+	} catch (PlotException &e) {
+		delete histogram;
+		throw;
 	}
 
-	if (i < 0) {
-		return NULL;
+	return histogram;
+}
+
+/*
+ * Chooses the class width and the breaks for the given boundaries. See R help(pretty). The grid has room for as many
+ * classes again, half of them on each side. The values up to 1e-7 of the class width above a break are counted below it,
+ * as in R. The same tolerance is kept after the classes are merged, so that the counts do not depend on the order of values.
+ */
+void Histogram::set_classes(double lower, double upper) throw (PlotException) {
+	double range[2];
+	double bias[] = {1.5, 0.5 + 1.5 * 1.5};
+	int ndiv = nclass;
+
+	range[0] = lower;
+	range[1] = upper;
+
+	unit = pretty(range, range + 1, &ndiv, 1, 0.75, bias, 0, 0);
+	/* unit = R_pretty0(range, range + 1, &ndiv, 1, 0.75, bias, 0, 0); */
+
+	fuzz = TOLERANCE * unit;
+
+	capacity = 2 * (ndiv > nclass ? ndiv : nclass);
+	start = range[0] - (capacity - ndiv) / 2;
+
+	if ((counts = (int64_t*)calloc(capacity, sizeof(int64_t))) == NULL) {
+		throw PlotException("Histogram", "set_classes( double, double )", __LINE__, 2, capacity * sizeof(int64_t));
 	}
+}
 
-	upper_finite = sorted_data + i;
-	n_finite = n_finite - data_size + i + 1;
+/*
+ * Chooses the classes from the range of the buffered values and counts them.
+ */
+void Histogram::release_pending() throw (PlotException) {
+	double lower = pending[0];
+	double upper = pending[0];
+
+	for (int i = 1; i < pending_n; i++) {
+		if (pending[i] < lower) {
+			lower = pending[i];
+		} else if (pending[i] > upper) {
+			upper = pending[i];
+		}
+	}
 
-	range[0] = *lower_finite;
-	range[1] = *upper_finite;
+	set_classes(lower, upper);
 
-	unit = pretty(range, range + 1, &nclass, 1, 0.75, bias, 0, 1);
-	/* unit = R_pretty0(range, range + 1, &nclass, 1, 0.75, bias, 0, 1); */
-	/* END: Determine finite data boundaries, ranges, breaks and etc. See R help(pretty). */
+	for (int i = 0; i < pending_n; i++) {
+		count(pending[i]);
+	}
 
-	/* BEGIN: Initialize new histogram object */
-	histogram = new Histogram();
+	free(pending);
+	pending = NULL;
+	pending_n = 0;
+}
 
-	if ((histogram->breaks = (double*)malloc((nclass + 1) * sizeof(double))) == NULL) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 2, (nclass + 1) * sizeof(double));
+/*
+ * Counts a finite value. The classes are closed on the right, i.e. (start, end], as in R with right = TRUE.
+ */
+void Histogram::add(double value) throw (PlotException) {
+	if ((isnan(value)) || (isinf(value))) {
+		return;
 	}
 
-	if ((histogram->counts = (int*)malloc(nclass * sizeof(int))) == NULL) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 2, nclass * sizeof(int));
+	n_finite += 1;
+
+	if (value < finite_min) {
+		finite_min = value;
 	}
 
-	if ((histogram->density = (double*)malloc(nclass * sizeof(double))) == NULL) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 2, nclass * sizeof(double));
+	if (counts == NULL) {
+		pending[pending_n] = value;
+		pending_n += 1;
+
+		if (pending_n >= PENDING_SIZE) {
+			release_pending();
+		}
+		return;
 	}
 
-	if ((histogram->mids = (double*)malloc(nclass * sizeof(double))) == NULL) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 2, nclass * sizeof(double));
+	count(value);
+}
+
+void Histogram::count(double value) {
+	double position = ceil((value - fuzz) / unit - start) - 1.0;
+
+	while ((position < 0.0) || (position >= capacity)) {
+		rebin(position);
+		position = ceil((value - fuzz) / unit - start) - 1.0;
 	}
 
-	if ((histogram->xname = (char*)malloc((strlen(name) + 1) * sizeof(char))) == NULL) {
-		throw PlotException("Histogram", "Histogram* create( ... )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
+	counts[(int)position] += 1;
+}
+
+/*
+ * Makes room for a value in the class at the given position of the grid. If the counted classes and the new one fit
+ * into the grid, the grid is moved to center them. Otherwise every two neighbouring classes are merged, which keeps
+ * every second break.
+ */
+void Histogram::rebin(double position) {
+	int first = 0, last = capacity - 1;
+	int shift = 0;
+	int merged = 0;
+	double lowest = 0.0, highest = 0.0;
+	int64_t class_count = 0;
+
+	while ((first < capacity) && (counts[first] == 0)) {
+		first += 1;
 	}
 
-	histogram->intensities = histogram->density;
-	histogram->nclass = nclass;
-	strcpy(histogram->xname, name);
-	/* END: Initialize new histogram object */
-
-	/* BEGIN: Calculate counts, densities and etc. */
-	for (i = 0; i <= nclass; i++) {
-		histogram->breaks[i] = range[0] + unit * i;
-	}
-
-	i = j = 0;
-	start = histogram->breaks[j] - tolerance;
-	do {
-		end = histogram->breaks[j + 1] + tolerance;
-		denominator = n_finite * (end - start);
-
-		histogram->counts[j] = 0;
-		while (i < n_finite) {
-			if ((start < lower_finite[i]) && (lower_finite[i] <= end)) {
-				histogram->counts[j] += 1;
-				i += 1;
-			}
-			else {
-				break;
-			}
+	if (first >= capacity) {
+		start += position - capacity / 2;
+		return;
+	}
+
+	while (counts[last] == 0) {
+		last -= 1;
+	}
+
+	lowest = position < first ? position : first;
+	highest = position > last ? position : last;
+
+	if (highest - lowest < capacity) {
+		shift = (int)lowest - (capacity - (int)(highest - lowest) - 1) / 2;
+
+		if (shift > 0) {
+			memmove(counts, counts + shift, (capacity - shift) * sizeof(int64_t));
+			memset(counts + capacity - shift, 0, shift * sizeof(int64_t));
+		} else if (shift < 0) {
+			memmove(counts - shift, counts, (capacity + shift) * sizeof(int64_t));
+			memset(counts, 0, -shift * sizeof(int64_t));
 		}
 
-		histogram->density[j] = histogram->counts[j] / denominator;
-		histogram->mids[j] = 0.5 * (histogram->breaks[j] + histogram->breaks[j + 1]);
+		start += shift;
+		return;
+	}
 
-		start = end;
-		j += 1;
-	} while (j < nclass);
-	/* END: Calculate breaks, counts, densities and etc. See R help(pretty). */
+	/* The merged classes never move to the right, so the counts are merged in place. */
+	for (int i = first; i <= last; i++) {
+		merged = (int)(floor((start + i) / 2.0) - floor(start / 2.0));
+		class_count = counts[i];
+		counts[i] = 0;
+		counts[merged] += class_count;
+	}
 
-	return histogram;
+	start = floor(start / 2.0);
+	unit *= 2.0;
+}
+
+/*
+ * Completes the histogram: drops the empty classes at both ends and calculates the densities. The lowest values, which
+ * lie on the upper break of the first class, are moved to the next class, since the first class includes its lower break,
+ * as in R with include.lowest = TRUE. When all values are equal, they stay in the single class below them, as in R.
+ */
+void Histogram::finish() throw (PlotException) {
+	int first = 0, last = 0;
+
+	if ((breaks != NULL) || (n_finite <= 0)) {
+		return;
+	}
+
+	if (counts == NULL) {
+		release_pending();
+	}
+
+	while (counts[first] == 0) {
+		first += 1;
+	}
+
+	last = capacity - 1;
+	while (counts[last] == 0) {
+		last -= 1;
+	}
+
+	if ((first < last) && ((finite_min + fuzz) / unit - start > first + 1)) {
+		counts[first + 1] += counts[first];
+		counts[first] = 0;
+		first += 1;
+	}
+
+	nclass = last - first + 1;
+
+	memmove(counts, counts + first, nclass * sizeof(int64_t));
+
+	if ((breaks = (double*)malloc((nclass + 1) * sizeof(double))) == NULL) {
+		throw PlotException("Histogram", "finish()", __LINE__, 2, (nclass + 1) * sizeof(double));
+	}
+
+	if ((density = (double*)malloc(nclass * sizeof(double))) == NULL) {
+		throw PlotException("Histogram", "finish()", __LINE__, 2, nclass * sizeof(double));
+	}
+
+	if ((mids = (double*)malloc(nclass * sizeof(double))) == NULL) {
+		throw PlotException("Histogram", "finish()", __LINE__, 2, nclass * sizeof(double));
+	}
+
+	intensities = density;
+
+	for (int i = 0; i <= nclass; i++) {
+		breaks[i] = (start + first + i) * unit;
+	}
+
+	for (int j = 0; j < nclass; j++) {
+		density[j] = counts[j] / (n_finite * unit);
+		mids[j] = 0.5 * (breaks[j] + breaks[j + 1]);
+	}
+
+	capacity = nclass;
+	start += first;
 }
 
 const double* Histogram::get_breaks() {
 	return breaks;
 }
 
-const int* Histogram::get_counts() {
+const int64_t* Histogram::get_counts() {
 	return counts;
 }
 
@@ -198,6 +351,24 @@ int Histogram::get_nclass() {
 	return nclass;
 }
 
+int64_t Histogram::get_n_finite() {
+	return n_finite;
+}
+
+uint64_t Histogram::get_total_bytes() {
+	uint64_t bytes = capacity * sizeof(int64_t);
+
+	if (pending != NULL) {
+		bytes += PENDING_SIZE * sizeof(double);
+	}
+
+	if (breaks != NULL) {
+		bytes += (3 * nclass + 1) * sizeof(double);
+	}
+
+	return bytes;
+}
+
 void Histogram::set_title(const char* title) throw (PlotException) {
 	if (title == NULL) {
 		throw PlotException("Histogram", "set_title( const char* )", __LINE__, 0, "title");
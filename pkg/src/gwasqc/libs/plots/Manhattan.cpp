@@ -0,0 +1,274 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../include/plots/Manhattan.h"
+
+Manhattan::Manhattan():
+	chromosome_names(NULL), chromosomes_count(0), offsets(NULL), x(NULL), y(NULL), chromosomes(NULL),
+	size(0), threshold(0.0), points(0) {
+
+}
+
+Manhattan::~Manhattan() {
+	for (int i = 0; i < chromosomes_count; i++) {
+		free(chromosome_names[i]);
+	}
+	free(chromosome_names);
+	free(offsets);
+	free(x);
+	free(y);
+	free(chromosomes);
+
+	chromosome_names = NULL;
+	offsets = NULL;
+	x = NULL;
+	y = NULL;
+	chromosomes = NULL;
+}
+
+/*
+ * Numbered chromosomes go first, then X, Y, XY and the mitochondrial one. Anything else (e.g. unplaced contigs)
+ * goes last. The optional "chr" prefix is ignored.
+ */
+int Manhattan::chromosome_order::get_class(const char* name, long* number) const {
+	const char* digit = NULL;
+
+	if ((tolower(name[0]) == 'c') && (tolower(name[1]) == 'h') && (tolower(name[2]) == 'r')) {
+		name += 3;
+	}
+
+	digit = name;
+	while (isdigit(*digit)) {
+		digit += 1;
+	}
+
+	if ((digit != name) && (*digit == '\0')) {
+		*number = strtol(name, NULL, 10);
+		return 0;
+	}
+
+	*number = 0;
+
+	if (((name[0] == 'X') || (name[0] == 'x')) && (name[1] == '\0')) {
+		return 1;
+	}
+
+	if (((name[0] == 'Y') || (name[0] == 'y')) && (name[1] == '\0')) {
+		return 2;
+	}
+
+	if ((toupper(name[0]) == 'X') && (toupper(name[1]) == 'Y') && (name[2] == '\0')) {
+		return 3;
+	}
+
+	if ((toupper(name[0]) == 'M') && ((name[1] == '\0') || ((toupper(name[1]) == 'T') && (name[2] == '\0')))) {
+		return 4;
+	}
+
+	return 5;
+}
+
+bool Manhattan::chromosome_order::operator()(int first, int second) const {
+	long first_number = 0;
+	long second_number = 0;
+	int first_class = get_class(names[first], &first_number);
+	int second_class = get_class(names[second], &second_number);
+
+	if (first_class != second_class) {
+		return first_class < second_class;
+	}
+
+	if (first_number != second_number) {
+		return first_number < second_number;
+	}
+
+	return strcmp(names[first], names[second]) < 0;
+}
+
+bool Manhattan::point_order::operator()(int64_t first, int64_t second) const {
+	if (x[first] != x[second]) {
+		return x[first] < x[second];
+	}
+
+	return y[first] < y[second];
+}
+
+const char* const* Manhattan::get_chromosome_names() {
+	return chromosome_names;
+}
+
+int Manhattan::get_chromosomes_count() {
+	return chromosomes_count;
+}
+
+const double* Manhattan::get_offsets() {
+	return offsets;
+}
+
+const double* Manhattan::get_x() {
+	return x;
+}
+
+const double* Manhattan::get_y() {
+	return y;
+}
+
+const int* Manhattan::get_chromosomes() {
+	return chromosomes;
+}
+
+int64_t Manhattan::get_size() {
+	return size;
+}
+
+double Manhattan::get_threshold() {
+	return threshold;
+}
+
+int64_t Manhattan::get_points() {
+	return points;
+}
+
+/*
+ * Creates the plot from the points kept while reading the file. The chromosome of every point is an index into
+ * chromosome_names, and chromosome_lengths are the largest positions seen on every chromosome. Positions are
+ * turned into cumulative x coordinates and p-values into -log10(p).
+ */
+Manhattan* Manhattan::create(const char* const* chromosome_names, const double* chromosome_lengths, int chromosomes_count,
+		const int* chromosomes, const double* positions, const double* pvalues, int64_t size, double threshold, int64_t points) throw (PlotException) {
+	Manhattan* manhattan = NULL;
+	int* order = NULL;
+	int* ranks = NULL;
+	int64_t* point_indices = NULL;
+	double* x = NULL;
+	double* y = NULL;
+	chromosome_order chromosomes_comparator;
+	point_order points_comparator;
+
+	if (chromosomes_count < 0) {
+		throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 1, "chromosomes_count");
+	}
+
+	if ((chromosomes_count > 0) && ((chromosome_names == NULL) || (chromosome_lengths == NULL))) {
+		throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 0, chromosome_names == NULL ? "chromosome_names" : "chromosome_lengths");
+	}
+
+	if (size < 0) {
+		throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 1, "size");
+	}
+
+	if ((size > 0) && ((chromosomes == NULL) || (positions == NULL) || (pvalues == NULL))) {
+		throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 0, chromosomes == NULL ? "chromosomes" : (positions == NULL ? "positions" : "pvalues"));
+	}
+
+	manhattan = new Manhattan();
+	manhattan->threshold = threshold;
+	manhattan->points = points;
+
+	manhattan->offsets = (double*)malloc((chromosomes_count + 1) * sizeof(double));
+	if (manhattan->offsets == NULL) {
+		delete manhattan;
+		throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 2, (chromosomes_count + 1) * sizeof(double));
+	}
+	manhattan->offsets[0] = 0.0;
+
+	if (chromosomes_count > 0) {
+		order = (int*)malloc(chromosomes_count * sizeof(int));
+		ranks = (int*)malloc(chromosomes_count * sizeof(int));
+		manhattan->chromosome_names = (char**)calloc(chromosomes_count, sizeof(char*));
+		if ((order == NULL) || (ranks == NULL) || (manhattan->chromosome_names == NULL)) {
+			free(order);
+			free(ranks);
+			delete manhattan;
+			throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 2, chromosomes_count * sizeof(int));
+		}
+
+		for (int i = 0; i < chromosomes_count; i++) {
+			order[i] = i;
+		}
+
+		chromosomes_comparator.names = chromosome_names;
+		sort(order, order + chromosomes_count, chromosomes_comparator);
+
+		for (int i = 0; i < chromosomes_count; i++) {
+			ranks[order[i]] = i;
+
+			manhattan->chromosome_names[i] = (char*)malloc((strlen(chromosome_names[order[i]]) + 1) * sizeof(char));
+			if (manhattan->chromosome_names[i] == NULL) {
+				free(order);
+				free(ranks);
+				manhattan->chromosomes_count = i;
+				delete manhattan;
+				throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 2, (strlen(chromosome_names[order[i]]) + 1) * sizeof(char));
+			}
+			strcpy(manhattan->chromosome_names[i], chromosome_names[order[i]]);
+
+			manhattan->offsets[i + 1] = manhattan->offsets[i] + chromosome_lengths[order[i]];
+		}
+
+		manhattan->chromosomes_count = chromosomes_count;
+
+		free(order);
+		order = NULL;
+	}
+
+	if (size > 0) {
+		x = (double*)malloc(size * sizeof(double));
+		y = (double*)malloc(size * sizeof(double));
+		point_indices = (int64_t*)malloc(size * sizeof(int64_t));
+		manhattan->x = (double*)malloc(size * sizeof(double));
+		manhattan->y = (double*)malloc(size * sizeof(double));
+		manhattan->chromosomes = (int*)malloc(size * sizeof(int));
+		if ((x == NULL) || (y == NULL) || (point_indices == NULL) || (manhattan->x == NULL) || (manhattan->y == NULL) || (manhattan->chromosomes == NULL)) {
+			free(ranks);
+			free(x);
+			free(y);
+			free(point_indices);
+			delete manhattan;
+			throw PlotException("Manhattan", "Manhattan* create( const char* const*, const double*, int, const int*, const double*, const double*, int64_t, double, int64_t )", __LINE__, 2, size * sizeof(double));
+		}
+
+		for (int64_t i = 0; i < size; i++) {
+			x[i] = manhattan->offsets[ranks[chromosomes[i]]] + positions[i];
+			y[i] = -log10(pvalues[i]);
+			point_indices[i] = i;
+		}
+
+		/* Points are kept in the order they were met, which differs between partitions. Sorting makes the plot data reproducible. */
+		points_comparator.x = x;
+		points_comparator.y = y;
+		sort(point_indices, point_indices + size, points_comparator);
+
+		for (int64_t i = 0; i < size; i++) {
+			manhattan->x[i] = x[point_indices[i]];
+			manhattan->y[i] = y[point_indices[i]];
+			manhattan->chromosomes[i] = ranks[chromosomes[point_indices[i]]];
+		}
+
+		manhattan->size = size;
+
+		free(x);
+		free(y);
+		free(point_indices);
+	}
+
+	free(ranks);
+
+	return manhattan;
+}
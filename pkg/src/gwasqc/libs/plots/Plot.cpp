@@ -29,6 +29,7 @@ Plot::~Plot() {
 	histograms.clear();
 	boxplots.clear();
 	qqplots.clear();
+	manhattans.clear();
 
 	free(name);
 	free(title);
@@ -61,6 +62,14 @@ void Plot::add_qqplot(Qqplot* qqplot) throw (PlotException) {
 	qqplots.push_back(qqplot);
 }
 
+void Plot::add_manhattan(Manhattan* manhattan) throw (PlotException) {
+	if (manhattan == NULL) {
+		throw PlotException("Plot", "add_manhattan( Manhattan* )", __LINE__, 0, "manhattan");
+	}
+
+	manhattans.push_back(manhattan);
+}
+
 void Plot::set_name(const char* name) throw (PlotException) {
 	if (name == NULL) {
 		throw PlotException("Plot", "set_name( const char* )", __LINE__, 0, "name");
@@ -177,6 +186,10 @@ int Plot::qqplots_count() {
 	return qqplots.size();
 }
 
+int Plot::manhattans_count() {
+	return manhattans.size();
+}
+
 vector<Histogram*>* Plot::get_histograms() {
 	return &histograms;
 }
@@ -188,3 +201,7 @@ vector<Boxplot*>* Plot::get_boxplots() {
 vector<Qqplot*>* Plot::get_qqplots() {
 	return &qqplots;
 }
+
+vector<Manhattan*>* Plot::get_manhattans() {
+	return &manhattans;
+}
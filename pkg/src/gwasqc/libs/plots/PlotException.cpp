@@ -19,13 +19,15 @@
 
 #include "../../include/plots/PlotException.h"
 
-const int PlotException::MESSAGE_TEMPLATES_NUMBER = 5;
+const int PlotException::MESSAGE_TEMPLATES_NUMBER = 7;
 const char* PlotException::MESSAGE_TEMPLATES[] = {
 /*00*/	"The '%s' argument has NULL value.",
 /*01*/	"The '%s' argument has an invalid value.",
 /*02*/	"Memory allocation error (%d bytes).",
 /*03*/	"Memory reallocation error (%d bytes).",
-/*04*/	"Error while setting formatted string."
+/*04*/	"Error while setting formatted string.",
+/*05*/	"Error while writing the '%s' image file.",
+/*06*/	"Error while compressing an image (zlib error %d)."
 };
 
 PlotException::PlotException() : Exception() {
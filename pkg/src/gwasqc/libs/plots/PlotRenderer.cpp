@@ -0,0 +1,789 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../include/plots/PlotRenderer.h"
+
+const int PlotRenderer::PLOT_WIDTH = 1000;
+const int PlotRenderer::PLOT_HEIGHT = 600;
+const int PlotRenderer::QQPLOT_SIZE = 500;
+const int PlotRenderer::TEXT_SCALE = 2;
+const int PlotRenderer::MAX_TICKS = 16;
+const int PlotRenderer::LEGEND_ENTRY_SIZE = 256;
+const double PlotRenderer::RANGE_EXTENSION = 0.04;
+const unsigned int PlotRenderer::HISTOGRAM_COLOR = 0xFF0000;
+const unsigned int PlotRenderer::BOXPLOT_COLOR = 0x00CD00;
+const unsigned int PlotRenderer::MANHATTAN_COLORS[] = {0x00008B, 0x6495ED};
+const double PlotRenderer::GENOME_WIDE_SIGNIFICANCE = 5e-8;
+
+/*
+ * Sets the range of values, extended by 4% at both ends like in R. An empty range is widened around its only value.
+ */
+void PlotRenderer::frame::set_range(double x_from, double x_to, double y_from, double y_to) {
+	double extension = 0.0;
+
+	if (isnan(x_from) || isinf(x_from) || isnan(x_to) || isinf(x_to)) {
+		x_from = 0.0;
+		x_to = 1.0;
+	} else if (x_to <= x_from) {
+		extension = x_from == 0.0 ? 1.0 : 0.4 * fabs(x_from);
+		x_from -= extension;
+		x_to += extension;
+	}
+
+	if (isnan(y_from) || isinf(y_from) || isnan(y_to) || isinf(y_to)) {
+		y_from = 0.0;
+		y_to = 1.0;
+	} else if (y_to <= y_from) {
+		extension = y_from == 0.0 ? 1.0 : 0.4 * fabs(y_from);
+		y_from -= extension;
+		y_to += extension;
+	}
+
+	extension = (x_to - x_from) * RANGE_EXTENSION;
+	this->x_from = x_from - extension;
+	this->x_to = x_to + extension;
+
+	extension = (y_to - y_from) * RANGE_EXTENSION;
+	this->y_from = y_from - extension;
+	this->y_to = y_to + extension;
+}
+
+int PlotRenderer::frame::get_x(double x) const {
+	double pixel = left + (x - x_from) / (x_to - x_from) * (right - left);
+
+	if (pixel < -PLOT_WIDTH) {
+		return -PLOT_WIDTH;
+	} else if (pixel > 2 * PLOT_WIDTH) {
+		return 2 * PLOT_WIDTH;
+	}
+
+	return (int)floor(pixel + 0.5);
+}
+
+int PlotRenderer::frame::get_y(double y) const {
+	double pixel = bottom - (y - y_from) / (y_to - y_from) * (bottom - top);
+
+	if (pixel < -PLOT_WIDTH) {
+		return -PLOT_WIDTH;
+	} else if (pixel > 2 * PLOT_WIDTH) {
+		return 2 * PLOT_WIDTH;
+	}
+
+	return (int)floor(pixel + 0.5);
+}
+
+/*
+ * Places about five ticks at round values (1, 2 or 5 times a power of ten) between from and to. Returns the number of ticks.
+ */
+int PlotRenderer::get_ticks(double from, double to, double* ticks) {
+	double step = 0.0;
+	double magnitude = 0.0;
+	double residual = 0.0;
+	double first = 0.0;
+	int ticks_cnt = 0;
+
+	if (isnan(from) || isinf(from) || isnan(to) || isinf(to) || (to < from)) {
+		return 0;
+	}
+
+	if (to == from) {
+		ticks[0] = from;
+		return 1;
+	}
+
+	step = (to - from) / 5.0;
+	magnitude = pow(10.0, floor(log10(step)));
+	residual = step / magnitude;
+
+	if (residual < 1.5) {
+		step = magnitude;
+	} else if (residual < 3.0) {
+		step = 2.0 * magnitude;
+	} else if (residual < 7.0) {
+		step = 5.0 * magnitude;
+	} else {
+		step = 10.0 * magnitude;
+	}
+
+	first = ceil(from / step - 1e-10);
+	while ((ticks_cnt < MAX_TICKS) && ((first + ticks_cnt) * step <= to + step * 1e-10)) {
+		ticks[ticks_cnt] = (first + ticks_cnt) * step;
+		ticks_cnt += 1;
+	}
+
+	return ticks_cnt;
+}
+
+/*
+ * Formats the value with at most the given number of decimal digits, or with six significant digits if digits is negative.
+ */
+void PlotRenderer::format_tick(double value, int digits, char* buffer) {
+	int length = 0;
+
+	if ((digits < 0) || (fabs(value) >= 1e9)) {
+		sprintf(buffer, "%.6g", value);
+		return;
+	}
+
+	sprintf(buffer, "%.*f", digits, value);
+
+	length = strlen(buffer);
+	if (strchr(buffer, '.') != NULL) {
+		while (buffer[length - 1] == '0') {
+			buffer[--length] = '\0';
+		}
+		if (buffer[length - 1] == '.') {
+			buffer[--length] = '\0';
+		}
+	}
+
+	if (strcmp(buffer, "-0") == 0) {
+		strcpy(buffer, "0");
+	}
+}
+
+/*
+ * Formats the legend entry of a group of the Q-Q plot: its name, the number of p-values and the inflation factor with 2 decimals.
+ */
+void PlotRenderer::format_legend_entry(const char* name, int64_t points, double lambda, char* buffer) {
+	char formatted_lambda[64];
+
+	if (!isnan(lambda) && !isinf(lambda)) {
+		sprintf(formatted_lambda, "%.2f", lambda);
+	} else {
+		format_tick(lambda, -1, formatted_lambda);
+	}
+
+	snprintf(buffer, LEGEND_ENTRY_SIZE, "%s; N=%lld; lambda=%s", name, (long long)points, formatted_lambda);
+}
+
+void PlotRenderer::draw_title(Raster& raster, const frame& plot_frame, const char* title, const char* subtitle) {
+	int title_height = title != NULL ? Raster::get_text_height(title, TEXT_SCALE) : 0;
+	int subtitle_height = subtitle != NULL ? Raster::get_text_height(subtitle, TEXT_SCALE) : 0;
+	int center = (plot_frame.left + plot_frame.right) / 2;
+	int y = plot_frame.top - 10 - subtitle_height - (subtitle != NULL ? 6 : 0) - title_height;
+
+	if (title != NULL) {
+		raster.draw_text(center - Raster::get_text_width(title, TEXT_SCALE) / 2, y, title, Raster::BLACK, TEXT_SCALE);
+		y += title_height + 6;
+	}
+
+	if (subtitle != NULL) {
+		raster.draw_text(center - Raster::get_text_width(subtitle, TEXT_SCALE) / 2, y, subtitle, Raster::BLACK, TEXT_SCALE);
+	}
+}
+
+/*
+ * Draws the x axis below the frame. A label which would overlap the previous one is left out, like in R.
+ */
+void PlotRenderer::draw_x_axis(Raster& raster, const frame& plot_frame, double* ticks, int ticks_cnt, int digits) {
+	char label[64];
+	int label_width = 0;
+	int last_label_end = numeric_limits<int>::min();
+	int first_x = 0;
+	int last_x = 0;
+	int x = 0;
+	int drawn = 0;
+
+	sort(ticks, ticks + ticks_cnt);
+
+	for (int i = 0; i < ticks_cnt; i++) {
+		if (isnan(ticks[i]) || isinf(ticks[i]) || (ticks[i] < plot_frame.x_from) || (ticks[i] > plot_frame.x_to)) {
+			continue;
+		}
+
+		x = plot_frame.get_x(ticks[i]);
+		if (drawn == 0) {
+			first_x = x;
+		}
+		last_x = x;
+		drawn += 1;
+
+		raster.draw_line(x, plot_frame.bottom, x, plot_frame.bottom + 5, Raster::BLACK);
+
+		format_tick(ticks[i], digits, label);
+		label_width = Raster::get_text_width(label, TEXT_SCALE);
+		if (x - label_width / 2 > last_label_end + 4) {
+			raster.draw_text(x - label_width / 2, plot_frame.bottom + 9, label, Raster::BLACK, TEXT_SCALE);
+			last_label_end = x - label_width / 2 + label_width;
+		}
+	}
+
+	if (drawn > 0) {
+		raster.draw_line(first_x, plot_frame.bottom, last_x, plot_frame.bottom, Raster::BLACK);
+	}
+}
+
+/*
+ * Draws the y axis left of the frame. The labels are parallel to the axis, like in R, and the ticks must be ascending.
+ */
+void PlotRenderer::draw_y_axis(Raster& raster, const frame& plot_frame, const double* ticks, int ticks_cnt) {
+	char label[64];
+	int label_width = 0;
+	int label_height = Raster::get_text_height("0", TEXT_SCALE);
+	int last_label_end = numeric_limits<int>::max();
+	int first_y = 0;
+	int last_y = 0;
+	int y = 0;
+	int drawn = 0;
+
+	for (int i = 0; i < ticks_cnt; i++) {
+		if (isnan(ticks[i]) || isinf(ticks[i]) || (ticks[i] < plot_frame.y_from) || (ticks[i] > plot_frame.y_to)) {
+			continue;
+		}
+
+		y = plot_frame.get_y(ticks[i]);
+		if (drawn == 0) {
+			first_y = y;
+		}
+		last_y = y;
+		drawn += 1;
+
+		raster.draw_line(plot_frame.left - 5, y, plot_frame.left, y, Raster::BLACK);
+
+		format_tick(ticks[i], -1, label);
+		label_width = Raster::get_text_width(label, TEXT_SCALE);
+		if (y + label_width / 2 < last_label_end - 4) {
+			raster.draw_text(plot_frame.left - 9 - label_height, y + label_width / 2, label, Raster::BLACK, TEXT_SCALE, true);
+			last_label_end = y + label_width / 2 - label_width;
+		}
+	}
+
+	if (drawn > 0) {
+		raster.draw_line(plot_frame.left, first_y, plot_frame.left, last_y, Raster::BLACK);
+	}
+}
+
+/*
+ * Draws the histogram with red bars, like plot.histogram in R. The x axis is optional and the range of x values can be fixed.
+ */
+void PlotRenderer::draw_histogram(Raster& raster, int left, int top, int right, int bottom, Histogram* histogram, const char* title, const char* subtitle, bool x_axis, const double* x_range) {
+	const double* breaks = histogram->get_breaks();
+	const int64_t* counts = histogram->get_counts();
+	int nclass = histogram->get_nclass();
+	double ticks[MAX_TICKS + 2];
+	int ticks_cnt = 0;
+	int64_t max_count = 0;
+	int bar_left = 0;
+	int bar_right = 0;
+	int bar_top = 0;
+	frame plot_frame;
+
+	if ((nclass <= 0) || (breaks == NULL) || (counts == NULL)) {
+		return;
+	}
+
+	for (int i = 0; i < nclass; i++) {
+		if (counts[i] > max_count) {
+			max_count = counts[i];
+		}
+	}
+
+	plot_frame.left = left + 50;
+	plot_frame.right = right - 20;
+	plot_frame.top = top + 10;
+	if (title != NULL) {
+		plot_frame.top += Raster::get_text_height(title, TEXT_SCALE) + 10;
+	}
+	if (subtitle != NULL) {
+		plot_frame.top += Raster::get_text_height(subtitle, TEXT_SCALE) + 6;
+	}
+	plot_frame.bottom = bottom - (x_axis ? 35 : 10);
+
+	if (x_range != NULL) {
+		plot_frame.set_range(x_range[0], x_range[1], 0.0, (double)max_count);
+	} else {
+		plot_frame.set_range(breaks[0], breaks[nclass], 0.0, (double)max_count);
+	}
+
+	raster.set_clip(plot_frame.left, plot_frame.top, plot_frame.right, plot_frame.bottom);
+	for (int i = 0; i < nclass; i++) {
+		bar_left = plot_frame.get_x(breaks[i]);
+		bar_right = plot_frame.get_x(breaks[i + 1]);
+		bar_top = plot_frame.get_y((double)counts[i]);
+
+		/* Borders of narrow bars would hide their color. */
+		if (bar_right - bar_left > 2) {
+			raster.fill_rectangle(bar_left, bar_top, bar_right, plot_frame.get_y(0.0), HISTOGRAM_COLOR);
+			raster.draw_rectangle(bar_left, bar_top, bar_right, plot_frame.get_y(0.0), Raster::BLACK);
+		} else if (counts[i] > 0) {
+			raster.fill_rectangle(bar_left, bar_top, bar_right, plot_frame.get_y(0.0), HISTOGRAM_COLOR);
+		}
+	}
+	raster.draw_line(plot_frame.get_x(breaks[0]), plot_frame.get_y(0.0), plot_frame.get_x(breaks[nclass]), plot_frame.get_y(0.0), Raster::BLACK);
+	raster.reset_clip();
+
+	ticks_cnt = get_ticks(0.0, (double)max_count, ticks);
+	draw_y_axis(raster, plot_frame, ticks, ticks_cnt);
+	raster.draw_text(left + 4, (plot_frame.top + plot_frame.bottom) / 2 + Raster::get_text_width("Frequency", TEXT_SCALE) / 2, "Frequency", Raster::BLACK, TEXT_SCALE, true);
+
+	if (x_axis) {
+		ticks_cnt = get_ticks(plot_frame.x_from, plot_frame.x_to, ticks);
+		draw_x_axis(raster, plot_frame, ticks, ticks_cnt, -1);
+	}
+
+	draw_title(raster, plot_frame, title, subtitle);
+}
+
+/*
+ * Draws the horizontal boxplot with green boxes, like bxp in R. The x axis is labeled at the quantiles (rounded to 3 decimals),
+ * and at the ends of the range of x values, if the range is fixed.
+ */
+void PlotRenderer::draw_boxplot(Raster& raster, int left, int top, int right, int bottom, Boxplot* boxplot, const char* title, const double* x_range) {
+	const double* tukey = boxplot->get_tukey();
+	const double* outliers = boxplot->get_outliers();
+	const int* groups = boxplot->get_groups();
+	int groups_cnt = boxplot->get_groups_cnt();
+	int outliers_cnt = boxplot->get_outliers_cnt();
+	double ticks[Boxplot::TUKEY_SIZE + 2];
+	int ticks_cnt = 0;
+	double min = numeric_limits<double>::infinity();
+	double max = -numeric_limits<double>::infinity();
+	int box_height = 0;
+	int y = 0;
+	frame plot_frame;
+
+	if (groups_cnt <= 0) {
+		return;
+	}
+
+	for (int i = 0; i < Boxplot::TUKEY_SIZE * groups_cnt; i++) {
+		if (!isnan(tukey[i]) && !isinf(tukey[i])) {
+			min = tukey[i] < min ? tukey[i] : min;
+			max = tukey[i] > max ? tukey[i] : max;
+		}
+	}
+
+	for (int i = 0; i < outliers_cnt; i++) {
+		if (!isnan(outliers[i]) && !isinf(outliers[i])) {
+			min = outliers[i] < min ? outliers[i] : min;
+			max = outliers[i] > max ? outliers[i] : max;
+		}
+	}
+
+	plot_frame.left = left + 50;
+	plot_frame.right = right - 20;
+	plot_frame.top = top + 10;
+	if (title != NULL) {
+		plot_frame.top += Raster::get_text_height(title, TEXT_SCALE) + 10;
+	}
+	plot_frame.bottom = bottom - 35;
+
+	if (x_range != NULL) {
+		plot_frame.set_range(x_range[0], x_range[1], 0.5, groups_cnt + 0.5);
+	} else {
+		plot_frame.set_range(min, max, 0.5, groups_cnt + 0.5);
+	}
+
+	box_height = (int)(0.4 * (plot_frame.bottom - plot_frame.top) / groups_cnt);
+
+	raster.set_clip(plot_frame.left, plot_frame.top, plot_frame.right, plot_frame.bottom);
+	for (int g = 0; g < groups_cnt; g++) {
+		const double* stats = tukey + Boxplot::TUKEY_SIZE * g;
+
+		if (isnan(stats[2])) {
+			continue;
+		}
+
+		y = plot_frame.get_y(g + 1.0);
+
+		raster.draw_line(plot_frame.get_x(stats[0]), y, plot_frame.get_x(stats[1]), y, Raster::BLACK, 1, true);
+		raster.draw_line(plot_frame.get_x(stats[3]), y, plot_frame.get_x(stats[4]), y, Raster::BLACK, 1, true);
+		raster.draw_line(plot_frame.get_x(stats[0]), y - box_height / 2, plot_frame.get_x(stats[0]), y + box_height / 2, Raster::BLACK);
+		raster.draw_line(plot_frame.get_x(stats[4]), y - box_height / 2, plot_frame.get_x(stats[4]), y + box_height / 2, Raster::BLACK);
+
+		raster.fill_rectangle(plot_frame.get_x(stats[1]), y - box_height, plot_frame.get_x(stats[3]), y + box_height, BOXPLOT_COLOR);
+		raster.draw_rectangle(plot_frame.get_x(stats[1]), y - box_height, plot_frame.get_x(stats[3]), y + box_height, Raster::BLACK);
+		raster.draw_line(plot_frame.get_x(stats[2]), y - box_height, plot_frame.get_x(stats[2]), y + box_height, Raster::BLACK, 3);
+	}
+
+	for (int i = 0; i < outliers_cnt; i++) {
+		if (!isnan(outliers[i]) && !isinf(outliers[i]) && (groups[i] >= 1) && (groups[i] <= groups_cnt)) {
+			raster.draw_circle(plot_frame.get_x(outliers[i]), plot_frame.get_y((double)groups[i]), 3, Raster::BLACK);
+		}
+	}
+	raster.reset_clip();
+
+	for (int q = 0; q <= 100; q += 25) {
+		ticks[ticks_cnt++] = boxplot->get_quantile(q);
+	}
+
+	if (x_range != NULL) {
+		ticks[ticks_cnt++] = x_range[0];
+		ticks[ticks_cnt++] = x_range[1];
+	}
+
+	draw_x_axis(raster, plot_frame, ticks, ticks_cnt, 3);
+	draw_title(raster, plot_frame, title, NULL);
+}
+
+/*
+ * Draws the Q-Q plot of -log10(p-values), with one color per group of points, the diagonal, and the legend with the inflation factors.
+ */
+void PlotRenderer::draw_qqplot(Raster& raster, int left, int top, int right, int bottom, Qqplot* qqplot) {
+	static const char* X_LABEL = "Expected distribution, -log10(p-value)";
+	static const char* Y_LABEL = "Observed distribution, -log10(p-value)";
+
+	const double* x = qqplot->get_x();
+	const double* y = qqplot->get_y();
+	const int* size = qqplot->get_size();
+	const int64_t* points = qqplot->get_points();
+	const char* const* names = qqplot->get_names();
+	const char* const* colors = qqplot->get_colors();
+	const double* lambdas = qqplot->get_lambdas();
+	int count = qqplot->get_count();
+	double ticks[MAX_TICKS + 2];
+	int ticks_cnt = 0;
+	double x_max = 0.0;
+	double y_max = 0.0;
+	int all_size = 0;
+	int offset = 0;
+	char entry[LEGEND_ENTRY_SIZE];
+	int entry_width = 0;
+	int entry_height = Raster::get_text_height("0", 1);
+	int legend_width = 0;
+	int legend_height = 0;
+	int legend_left = 0;
+	int legend_top = 0;
+	frame plot_frame;
+
+	if (count <= 0) {
+		return;
+	}
+
+	for (int k = 0; k < count; k++) {
+		all_size += size[k];
+	}
+
+	for (int i = 0; i < all_size; i++) {
+		if (!isnan(x[i]) && !isinf(x[i]) && (x[i] > x_max)) {
+			x_max = x[i];
+		}
+		if (!isnan(y[i]) && !isinf(y[i]) && (y[i] > y_max)) {
+			y_max = y[i];
+		}
+	}
+
+	plot_frame.left = left + 50;
+	plot_frame.right = right - 20;
+	plot_frame.top = top + 20;
+	plot_frame.bottom = bottom - 60;
+	plot_frame.set_range(0.0, x_max, 0.0, y_max);
+
+	raster.set_clip(plot_frame.left, plot_frame.top, plot_frame.right, plot_frame.bottom);
+	for (int k = 0; k < count; k++) {
+		for (int i = offset; i < offset + size[k]; i++) {
+			if (!isnan(x[i]) && !isinf(x[i]) && !isnan(y[i]) && !isinf(y[i])) {
+				raster.fill_circle(plot_frame.get_x(x[i]), plot_frame.get_y(y[i]), 2, Raster::get_color(colors[k]));
+			}
+		}
+		offset += size[k];
+	}
+
+	raster.draw_line(plot_frame.get_x(plot_frame.x_from), plot_frame.get_y(plot_frame.x_from), plot_frame.get_x(plot_frame.x_to), plot_frame.get_y(plot_frame.x_to), Raster::BLACK, 1, true);
+	raster.reset_clip();
+
+	raster.draw_rectangle(plot_frame.left, plot_frame.top, plot_frame.right, plot_frame.bottom, Raster::BLACK);
+
+	ticks_cnt = get_ticks(plot_frame.x_from, plot_frame.x_to, ticks);
+	draw_x_axis(raster, plot_frame, ticks, ticks_cnt, -1);
+	ticks_cnt = get_ticks(plot_frame.y_from, plot_frame.y_to, ticks);
+	draw_y_axis(raster, plot_frame, ticks, ticks_cnt);
+
+	raster.draw_text((plot_frame.left + plot_frame.right - Raster::get_text_width(X_LABEL, TEXT_SCALE)) / 2, plot_frame.bottom + 35, X_LABEL, Raster::BLACK, TEXT_SCALE);
+	raster.draw_text(left + 4, (plot_frame.top + plot_frame.bottom + Raster::get_text_width(Y_LABEL, TEXT_SCALE)) / 2, Y_LABEL, Raster::BLACK, TEXT_SCALE, true);
+
+	/* The legend lists the groups in reverse order, in the bottom right corner. */
+	for (int k = 0; k < count; k++) {
+		format_legend_entry(names[k], points[k], lambdas[k], entry);
+		entry_width = Raster::get_text_width(entry, 1);
+		if (entry_width > legend_width) {
+			legend_width = entry_width;
+		}
+	}
+
+	legend_width += 30;
+	legend_height = count * (entry_height + 8) + 8;
+	legend_left = plot_frame.right - (int)(0.05 * (plot_frame.right - plot_frame.left)) - legend_width;
+	legend_top = plot_frame.bottom - (int)(0.05 * (plot_frame.bottom - plot_frame.top)) - legend_height;
+
+	raster.draw_rectangle(legend_left, legend_top, legend_left + legend_width, legend_top + legend_height, Raster::BLACK);
+	for (int k = count - 1, line = 0; k >= 0; k--, line++) {
+		format_legend_entry(names[k], points[k], lambdas[k], entry);
+		raster.fill_circle(legend_left + 12, legend_top + 8 + line * (entry_height + 8) + entry_height / 2, 4, Raster::get_color(colors[k]));
+		raster.draw_circle(legend_left + 12, legend_top + 8 + line * (entry_height + 8) + entry_height / 2, 4, Raster::BLACK);
+		raster.draw_text(legend_left + 24, legend_top + 8 + line * (entry_height + 8), entry, Raster::BLACK, 1);
+	}
+}
+
+/*
+ * Draws the Manhattan plot with the chromosomes in alternating colors, and the genome-wide significance level as a dashed line.
+ * The chromosome names are placed below their middles, leaving out the names which would overlap.
+ */
+void PlotRenderer::draw_manhattan(Raster& raster, int left, int top, int right, int bottom, Manhattan* manhattan, const char* title) {
+	static const char* X_LABEL = "Chromosome";
+	static const char* Y_LABEL = "-log10(p-value)";
+
+	const double* x = manhattan->get_x();
+	const double* y = manhattan->get_y();
+	const int* chromosomes = manhattan->get_chromosomes();
+	const double* offsets = manhattan->get_offsets();
+	const char* const* names = manhattan->get_chromosome_names();
+	int chromosomes_count = manhattan->get_chromosomes_count();
+	int64_t size = manhattan->get_size();
+	double ticks[MAX_TICKS + 2];
+	int ticks_cnt = 0;
+	double y_max = -log10(GENOME_WIDE_SIGNIFICANCE);
+	int label_width = 0;
+	int last_label_end = numeric_limits<int>::min();
+	int center = 0;
+	frame plot_frame;
+
+	for (int64_t i = 0; i < size; i++) {
+		if (!isnan(y[i]) && !isinf(y[i]) && (y[i] > y_max)) {
+			y_max = y[i];
+		}
+	}
+
+	plot_frame.left = left + 50;
+	plot_frame.right = right - 20;
+	plot_frame.top = top + 50;
+	plot_frame.bottom = bottom - 60;
+	plot_frame.set_range(0.0, offsets[chromosomes_count], 0.0, y_max);
+
+	raster.set_clip(plot_frame.left, plot_frame.top, plot_frame.right, plot_frame.bottom);
+	for (int64_t i = 0; i < size; i++) {
+		if (!isnan(x[i]) && !isinf(x[i]) && !isnan(y[i]) && !isinf(y[i])) {
+			raster.fill_circle(plot_frame.get_x(x[i]), plot_frame.get_y(y[i]), 1, MANHATTAN_COLORS[chromosomes[i] % 2]);
+		}
+	}
+
+	raster.draw_line(plot_frame.left, plot_frame.get_y(-log10(GENOME_WIDE_SIGNIFICANCE)), plot_frame.right, plot_frame.get_y(-log10(GENOME_WIDE_SIGNIFICANCE)), 0xFF0000, 1, true);
+	raster.reset_clip();
+
+	raster.draw_rectangle(plot_frame.left, plot_frame.top, plot_frame.right, plot_frame.bottom, Raster::BLACK);
+
+	draw_title(raster, plot_frame, title, NULL);
+
+	for (int k = 0; k < chromosomes_count; k++) {
+		center = plot_frame.get_x((offsets[k] + offsets[k + 1]) / 2.0);
+		label_width = Raster::get_text_width(names[k], TEXT_SCALE);
+
+		raster.draw_line(center, plot_frame.bottom, center, plot_frame.bottom + 5, Raster::BLACK);
+		if (center - label_width / 2 > last_label_end + 4) {
+			raster.draw_text(center - label_width / 2, plot_frame.bottom + 9, names[k], Raster::BLACK, TEXT_SCALE);
+			last_label_end = center - label_width / 2 + label_width;
+		}
+	}
+
+	ticks_cnt = get_ticks(plot_frame.y_from, plot_frame.y_to, ticks);
+	draw_y_axis(raster, plot_frame, ticks, ticks_cnt);
+
+	raster.draw_text((plot_frame.left + plot_frame.right - Raster::get_text_width(X_LABEL, TEXT_SCALE)) / 2, plot_frame.bottom + 35, X_LABEL, Raster::BLACK, TEXT_SCALE);
+	raster.draw_text(left + 4, (plot_frame.top + plot_frame.bottom + Raster::get_text_width(Y_LABEL, TEXT_SCALE)) / 2, Y_LABEL, Raster::BLACK, TEXT_SCALE, true);
+}
+
+/*
+ * Renders the plot to <name>.png. The layout depends on the number of histograms, boxplots, Q-Q plots and Manhattan plots, like in the R package.
+ * Other combinations are not rendered.
+ */
+void PlotRenderer::render(Plot* plot) throw (PlotException) {
+	vector<Histogram*>* histograms = NULL;
+	vector<Boxplot*>* boxplots = NULL;
+	vector<Qqplot*>* qqplots = NULL;
+	vector<Manhattan*>* manhattans = NULL;
+	Raster* raster = NULL;
+	Histogram* histogram = NULL;
+	Boxplot* boxplot = NULL;
+	const double* breaks = NULL;
+	const double* outliers = NULL;
+	const double* tukey = NULL;
+	double x_range[2];
+	double min = 0.0;
+	double max = 0.0;
+	char* file_name = NULL;
+
+	if (plot == NULL) {
+		throw PlotException("PlotRenderer", "render( Plot* )", __LINE__, 0, "plot");
+	}
+
+	if (plot->get_name() == NULL) {
+		throw PlotException("PlotRenderer", "render( Plot* )", __LINE__, 1, "plot");
+	}
+
+	histograms = plot->get_histograms();
+	boxplots = plot->get_boxplots();
+	qqplots = plot->get_qqplots();
+	manhattans = plot->get_manhattans();
+
+	try {
+		if (histograms->size() == 2) {
+			raster = new Raster(PLOT_WIDTH, PLOT_HEIGHT);
+			draw_histogram(*raster, 0, 0, PLOT_WIDTH - 1, PLOT_HEIGHT / 2 - 1, histograms->at(0), plot->get_title(), histograms->at(0)->get_title(), true, NULL);
+			draw_histogram(*raster, 0, PLOT_HEIGHT / 2, PLOT_WIDTH - 1, PLOT_HEIGHT - 1, histograms->at(1), histograms->at(1)->get_title(), NULL, true, NULL);
+		} else if ((histograms->size() == 1) && (boxplots->size() == 0)) {
+			raster = new Raster(PLOT_WIDTH, PLOT_HEIGHT);
+			draw_histogram(*raster, 0, 0, PLOT_WIDTH - 1, PLOT_HEIGHT - 1, histograms->at(0), plot->get_title(), NULL, true, NULL);
+		} else if ((histograms->size() == 1) && (boxplots->size() == 1)) {
+			raster = new Raster(PLOT_WIDTH, PLOT_HEIGHT);
+			draw_histogram(*raster, 0, 0, PLOT_WIDTH - 1, PLOT_HEIGHT / 2 - 1, histograms->at(0), plot->get_title(), NULL, false, NULL);
+			draw_boxplot(*raster, 0, PLOT_HEIGHT / 2, PLOT_WIDTH - 1, PLOT_HEIGHT - 1, boxplots->at(0), NULL, NULL);
+		} else if ((histograms->size() == 1) && (boxplots->size() == 2)) {
+			raster = new Raster(PLOT_WIDTH, PLOT_HEIGHT);
+
+			/* The ranges are symmetric around 0, to show how the values are centered. */
+			histogram = histograms->at(0);
+			breaks = histogram->get_breaks();
+			min = breaks[0];
+			max = breaks[histogram->get_nclass()];
+			x_range[0] = fabs(min) > fabs(max) ? min : -max;
+			x_range[1] = fabs(min) > fabs(max) ? fabs(min) : max;
+
+			draw_histogram(*raster, 0, 0, PLOT_WIDTH - 1, PLOT_HEIGHT / 3 - 1, histogram, plot->get_title(), NULL, true, x_range);
+
+			for (unsigned int j = 0; j < boxplots->size(); j++) {
+				boxplot = boxplots->at(j);
+				tukey = boxplot->get_tukey();
+				outliers = boxplot->get_outliers();
+
+				min = numeric_limits<double>::infinity();
+				max = -numeric_limits<double>::infinity();
+				for (int i = 0; i < boxplot->get_outliers_cnt(); i++) {
+					if (!isnan(outliers[i]) && !isinf(outliers[i])) {
+						min = outliers[i] < min ? outliers[i] : min;
+						max = outliers[i] > max ? outliers[i] : max;
+					}
+				}
+
+				if (min > max) {
+					min = tukey[0];
+					max = tukey[Boxplot::TUKEY_SIZE - 1];
+				}
+
+				x_range[0] = fabs(min) > fabs(max) ? min : -max;
+				x_range[1] = fabs(min) > fabs(max) ? fabs(min) : max;
+
+				draw_boxplot(*raster, 0, (j + 1) * PLOT_HEIGHT / 3, PLOT_WIDTH - 1, (j + 2) * PLOT_HEIGHT / 3 - 1, boxplot, boxplot->get_title(), boxplot->get_outliers_cnt() > 0 ? x_range : NULL);
+			}
+		} else if (qqplots->size() == 1) {
+			raster = new Raster(QQPLOT_SIZE, QQPLOT_SIZE);
+			draw_qqplot(*raster, 0, 0, QQPLOT_SIZE - 1, QQPLOT_SIZE - 1, qqplots->at(0));
+		} else if (manhattans->size() == 1) {
+			raster = new Raster(PLOT_WIDTH, PLOT_HEIGHT);
+			draw_manhattan(*raster, 0, 0, PLOT_WIDTH - 1, PLOT_HEIGHT - 1, manhattans->at(0), plot->get_title());
+		} else {
+			return;
+		}
+
+		file_name = (char*)malloc((strlen(plot->get_name()) + 5) * sizeof(char));
+		if (file_name == NULL) {
+			throw PlotException("PlotRenderer", "render( Plot* )", __LINE__, 2, (strlen(plot->get_name()) + 5) * sizeof(char));
+		}
+
+		strcpy(file_name, plot->get_name());
+		strcat(file_name, ".png");
+
+		raster->write_png(file_name);
+
+		free(file_name);
+		file_name = NULL;
+
+		delete raster;
+		raster = NULL;
+	} catch (PlotException &e) {
+		free(file_name);
+		delete raster;
+		throw;
+	}
+}
+
+/*
+ * Renders the plots on the given number of workers, one of which is the calling thread.
+ * If a worker can't be started, the other workers render its plots.
+ */
+void PlotRenderer::render(vector<Plot*>& plots, unsigned int threads) throw (PlotException) {
+	render_queue queue;
+	vector<pthread_t> workers;
+	vector<pthread_t>::iterator workers_it;
+	pthread_t worker;
+
+	if (threads > plots.size()) {
+		threads = plots.size();
+	}
+
+	queue.plots = &plots;
+	queue.next = 0;
+	queue.error = NULL;
+	pthread_mutex_init(&queue.mutex, NULL);
+
+	for (unsigned int i = 1; i < threads; i++) {
+		if (pthread_create(&worker, NULL, run_render_worker, &queue) != 0) {
+			break;
+		}
+		workers.push_back(worker);
+	}
+
+	run_render_worker(&queue);
+
+	for (workers_it = workers.begin(); workers_it != workers.end(); workers_it++) {
+		pthread_join(*workers_it, NULL);
+	}
+
+	pthread_mutex_destroy(&queue.mutex);
+
+	if (queue.error != NULL) {
+		PlotException e(*queue.error);
+		delete queue.error;
+		throw e;
+	}
+}
+
+void* PlotRenderer::run_render_worker(void* queue) {
+	render_queue* self = (render_queue*)queue;
+	Plot* plot = NULL;
+
+	while (true) {
+		pthread_mutex_lock(&self->mutex);
+		if ((self->error != NULL) || (self->next >= self->plots->size())) {
+			pthread_mutex_unlock(&self->mutex);
+			break;
+		}
+		plot = self->plots->at(self->next);
+		self->next += 1;
+		pthread_mutex_unlock(&self->mutex);
+
+		try {
+			render(plot);
+		} catch (PlotException &e) {
+			pthread_mutex_lock(&self->mutex);
+			if (self->error == NULL) {
+				self->error = new PlotException(e);
+			}
+			pthread_mutex_unlock(&self->mutex);
+		} catch (std::bad_alloc &e) {
+			pthread_mutex_lock(&self->mutex);
+			if (self->error == NULL) {
+				self->error = new PlotException("PlotRenderer", "run_render_worker( void* )", __LINE__, 2, 0);
+			}
+			pthread_mutex_unlock(&self->mutex);
+		}
+	}
+
+	return NULL;
+}
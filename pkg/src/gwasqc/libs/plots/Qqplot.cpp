@@ -47,115 +47,235 @@ Qqplot::~Qqplot() {
 	colors = NULL;
 }
 
-Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data, double lambda, int data_size) throw (PlotException) {
+Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data, double lambda, int64_t data_size) throw (PlotException) {
+	ranked_values data;
+
 	if (name == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 0, "name");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int64_t )", __LINE__, 0, "name");
 	}
 
 	if (strlen(name) <= 0) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 1, "name");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int64_t )", __LINE__, 1, "name");
 	}
 
 	if (color == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 0, "color");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int64_t )", __LINE__, 0, "color");
 	}
 
 	if (strlen(color) <= 0) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 1, "color");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int64_t )", __LINE__, 1, "color");
 	}
 
 	if (data_size < 0) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 1, "data_size");
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int64_t )", __LINE__, 1, "data_size");
 	}
 
-	Qqplot* qqplot = new Qqplot();
-	int new_data_size = 0;
+	if ((data_size > 0) && (sorted_data == NULL)) {
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int64_t )", __LINE__, 0, "sorted_data");
+	}
 
-	if (data_size > 0) {
-		if (sorted_data == NULL) {
-			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 0, "sorted_data");
-		}
+	data.values = sorted_data;
+	data.ends = NULL;
+	data.values_size = data_size;
 
-		int i = 0, j = 0;
+	return create(name, color, data, lambda, data_size);
+}
 
-		double x_delta = (-log10(1 / (double)data_size)) / 500;
-		double y_delta = (-log10(sorted_data[0]) + log10(sorted_data[data_size - 1])) / 500;
+/*
+ * Creates the plot from the distinct p-values (or the representatives of small intervals) in ascending order and the
+ * numbers of their occurrences.
+ */
+Qqplot* Qqplot::create(const char* name, const char* color, const double* values, const int64_t* counts, int64_t values_size, double lambda) throw (PlotException) {
+	ranked_values data;
+	int64_t* ends = NULL;
+	int64_t data_size = 0;
+	Qqplot* qqplot = NULL;
 
-		double x_previous_value = numeric_limits<double>::infinity();
-		double y_previous_value = numeric_limits<double>::infinity();
+	if (name == NULL) {
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 0, "name");
+	}
 
-		double x_value = 0.0, y_value = 0.0;
+	if (strlen(name) <= 0) {
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 1, "name");
+	}
 
-		while (i < data_size) {
-			x_value = -log10((i + 1) / (double)data_size);
-			y_value = -log10(sorted_data[i]);
+	if (color == NULL) {
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 0, "color");
+	}
 
-			if ((x_value < x_previous_value - x_delta) || (y_value < y_previous_value - y_delta)) {
-				x_previous_value = x_value;
-				y_previous_value = y_value;
-				new_data_size += 1;
-			}
+	if (strlen(color) <= 0) {
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 1, "color");
+	}
 
-			i += 1;
+	if (values_size < 0) {
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 1, "values_size");
+	}
+
+	if (values_size > 0) {
+		if (values == NULL) {
+			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 0, "values");
 		}
 
-		if ((qqplot->x = (double*)malloc(new_data_size * sizeof(double))) == NULL) {
-			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, new_data_size * sizeof(double));
+		if (counts == NULL) {
+			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 0, "counts");
 		}
 
-		if ((qqplot->y = (double*)malloc(new_data_size * sizeof(double))) == NULL) {
-			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, new_data_size * sizeof(double));
+		if ((ends = (int64_t*)malloc(values_size * sizeof(int64_t))) == NULL) {
+			throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 2, values_size * sizeof(int64_t));
 		}
 
-		x_previous_value = numeric_limits<double>::infinity();
-		y_previous_value = numeric_limits<double>::infinity();
-		x_value = 0.0;
-		y_value = 0.0;
-		i = 0;
+		for (int64_t i = 0; i < values_size; i++) {
+			if (counts[i] <= 0) {
+				free(ends);
+				throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const double*, const int64_t*, int64_t, double )", __LINE__, 1, "counts");
+			}
+			data_size += counts[i];
+			ends[i] = data_size;
+		}
+	}
+
+	data.values = values;
+	data.ends = ends;
+	data.values_size = values_size;
+
+	try {
+		qqplot = create(name, color, data, lambda, data_size);
+	} catch (PlotException &e) {
+		free(ends);
+		throw;
+	}
+
+	free(ends);
+
+	return qqplot;
+}
+
+double Qqplot::ranked_values::get(int64_t rank) const {
+	if (ends == NULL) {
+		return values[rank];
+	}
+
+	return values[upper_bound(ends, ends + values_size, rank) - ends];
+}
+
+/*
+ * A point is plotted when it is farther than 1/500 of the axis range from the last plotted point along any axis. Both
+ * coordinates do not increase with the rank, therefore the next plotted point is found by bisection of the ranks.
+ * Both the sorted p-values (the default mode) and the binned p-values (the low-memory mode) are thinned here.
+ */
+Qqplot* Qqplot::create(const char* name, const char* color, const ranked_values& data, double lambda, int64_t data_size) throw (PlotException) {
+	Qqplot* qqplot = new Qqplot();
+	int new_data_size = 0;
+	int heap_size = 0;
+	void* new_memory = NULL;
+
+	if (data_size > 0) {
+		int64_t i = 0, low = 0, high = 0, middle = 0;
+
+		double x_delta = (-log10(1 / (double)data_size)) / 500;
+		double y_delta = (-log10(data.get(0)) + log10(data.get(data_size - 1))) / 500;
+
+		double x_previous_value = numeric_limits<double>::infinity();
+		double y_previous_value = numeric_limits<double>::infinity();
+
+		double x_value = 0.0, y_value = 0.0;
 
 		while (i < data_size) {
 			x_value = -log10((i + 1) / (double)data_size);
-			y_value = -log10(sorted_data[i]);
+			y_value = -log10(data.get(i));
+
+			if (!((x_value < x_previous_value - x_delta) || (y_value < y_previous_value - y_delta))) {
+				low = i;
+				high = data_size;
+
+				while (high - low > 1) {
+					middle = low + (high - low) / 2;
+					x_value = -log10((middle + 1) / (double)data_size);
+					y_value = -log10(data.get(middle));
+
+					if ((x_value < x_previous_value - x_delta) || (y_value < y_previous_value - y_delta)) {
+						high = middle;
+					} else {
+						low = middle;
+					}
+				}
+
+				if (high >= data_size) {
+					break;
+				}
+
+				i = high;
+				x_value = -log10((i + 1) / (double)data_size);
+				y_value = -log10(data.get(i));
+			}
 
-			if ((x_value < x_previous_value - x_delta) || (y_value < y_previous_value - y_delta)) {
-				qqplot->x[j] = x_value;
-				qqplot->y[j] = y_value;
-				x_previous_value = x_value;
-				y_previous_value = y_value;
-				j += 1;
+			if (new_data_size >= heap_size) {
+				heap_size = heap_size > 0 ? 2 * heap_size : 1024;
+
+				new_memory = realloc(qqplot->x, heap_size * sizeof(double));
+				if (new_memory == NULL) {
+					delete qqplot;
+					throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 3, heap_size * sizeof(double));
+				}
+				qqplot->x = (double*)new_memory;
+
+				new_memory = realloc(qqplot->y, heap_size * sizeof(double));
+				if (new_memory == NULL) {
+					delete qqplot;
+					throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 3, heap_size * sizeof(double));
+				}
+				qqplot->y = (double*)new_memory;
 			}
 
+			qqplot->x[new_data_size] = x_value;
+			qqplot->y[new_data_size] = y_value;
+			x_previous_value = x_value;
+			y_previous_value = y_value;
+			new_data_size += 1;
+
 			i += 1;
 		}
 	}
 
 	if ((qqplot->size = (int*)malloc(sizeof(int))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(int));
+		delete qqplot;
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 2, sizeof(int));
 	}
 
-	if ((qqplot->points = (int*)malloc(sizeof(int))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(int));
+	if ((qqplot->points = (int64_t*)malloc(sizeof(int64_t))) == NULL) {
+		delete qqplot;
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 2, sizeof(int64_t));
 	}
 
 	if ((qqplot->names = (char**)malloc(sizeof(char*))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(char*));
+		delete qqplot;
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 2, sizeof(char*));
 	}
 
 	if ((qqplot->colors = (char**)malloc(sizeof(char*))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(char*));
+		delete qqplot;
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 2, sizeof(char*));
 	}
 
+	/* The destructor frees the name and the color from now on. */
+	qqplot->names[0] = NULL;
+	qqplot->colors[0] = NULL;
+	qqplot->count = 1;
+
 	if ((qqplot->lambdas = (double*)malloc(sizeof(double))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, sizeof(double));
+		delete qqplot;
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 2, sizeof(double));
 	}
 
 	if ((qqplot->names[0] = (char*)malloc((strlen(name) + 1) * sizeof(char))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
+		delete qqplot;
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 2, (strlen(name) + 1) * sizeof(char));
 	}
 	strcpy(qqplot->names[0], name);
 
 	if ((qqplot->colors[0] = (char*)malloc((strlen(color) + 1) * sizeof(char))) == NULL) {
-		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, double*, double, int )", __LINE__, 2, (strlen(color) + 1) * sizeof(char));
+		delete qqplot;
+		throw PlotException("Qqplot", "Qqplot* create( const char*, const char*, const ranked_values&, double, int64_t )", __LINE__, 2, (strlen(color) + 1) * sizeof(char));
 	}
 	strcpy(qqplot->colors[0], color);
 
@@ -163,7 +283,6 @@ Qqplot* Qqplot::create(const char* name, const char* color, double* sorted_data,
 	qqplot->points[0] = data_size;
 	qqplot->lambdas[0] = lambda;
 	qqplot->all_size = new_data_size;
-	qqplot->count = 1;
 
 	return qqplot;
 }
@@ -213,11 +332,11 @@ Qqplot* Qqplot::merge(Qqplot* to, Qqplot* from) throw (PlotException) {
 		}
 		qqplot->size = (int*)new_memory;
 
-		new_memory = realloc(qqplot->points, new_count * sizeof(int));
+		new_memory = realloc(qqplot->points, new_count * sizeof(int64_t));
 		if (new_memory == NULL) {
-			throw PlotException("Qqplot", "Qqplot* merge( Qqplot*, Qqplot* )", __LINE__, 3, new_count * sizeof(int));
+			throw PlotException("Qqplot", "Qqplot* merge( Qqplot*, Qqplot* )", __LINE__, 3, new_count * sizeof(int64_t));
 		}
-		qqplot->points = (int*)new_memory;
+		qqplot->points = (int64_t*)new_memory;
 
 		new_memory = realloc(qqplot->names, new_count * sizeof(char*));
 		if (new_memory == NULL) {
@@ -278,7 +397,7 @@ const int* Qqplot::get_size() {
 	return size;
 }
 
-const int* Qqplot::get_points() {
+const int64_t* Qqplot::get_points() {
 	return points;
 }
 
@@ -0,0 +1,431 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../../include/plots/Raster.h"
+
+const int Raster::GLYPH_WIDTH = 5;
+const int Raster::GLYPH_HEIGHT = 7;
+
+/* 5x7 glyphs of the printable ASCII characters, one byte per column, the lowest bit at the top. */
+const unsigned char Raster::GLYPHS[][5] = {
+		{0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00}, {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14},
+		{0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62}, {0x36, 0x49, 0x55, 0x22, 0x50}, {0x00, 0x05, 0x03, 0x00, 0x00},
+		{0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00}, {0x08, 0x2A, 0x1C, 0x2A, 0x08}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+		{0x00, 0x50, 0x30, 0x00, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08}, {0x00, 0x60, 0x60, 0x00, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02},
+		{0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00}, {0x42, 0x61, 0x51, 0x49, 0x46}, {0x21, 0x41, 0x45, 0x4B, 0x31},
+		{0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39}, {0x3C, 0x4A, 0x49, 0x49, 0x30}, {0x01, 0x71, 0x09, 0x05, 0x03},
+		{0x36, 0x49, 0x49, 0x49, 0x36}, {0x06, 0x49, 0x49, 0x29, 0x1E}, {0x00, 0x36, 0x36, 0x00, 0x00}, {0x00, 0x56, 0x36, 0x00, 0x00},
+		{0x08, 0x14, 0x22, 0x41, 0x00}, {0x14, 0x14, 0x14, 0x14, 0x14}, {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x51, 0x09, 0x06},
+		{0x32, 0x49, 0x79, 0x41, 0x3E}, {0x7E, 0x11, 0x11, 0x11, 0x7E}, {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+		{0x7F, 0x41, 0x41, 0x22, 0x1C}, {0x7F, 0x49, 0x49, 0x49, 0x41}, {0x7F, 0x09, 0x09, 0x09, 0x01}, {0x3E, 0x41, 0x49, 0x49, 0x7A},
+		{0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00}, {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41},
+		{0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x0C, 0x02, 0x7F}, {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+		{0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E}, {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x46, 0x49, 0x49, 0x49, 0x31},
+		{0x01, 0x01, 0x7F, 0x01, 0x01}, {0x3F, 0x40, 0x40, 0x40, 0x3F}, {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F},
+		{0x63, 0x14, 0x08, 0x14, 0x63}, {0x07, 0x08, 0x70, 0x08, 0x07}, {0x61, 0x51, 0x49, 0x45, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x00},
+		{0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x7F, 0x00}, {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40},
+		{0x00, 0x01, 0x02, 0x04, 0x00}, {0x20, 0x54, 0x54, 0x54, 0x78}, {0x7F, 0x48, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x20},
+		{0x38, 0x44, 0x44, 0x48, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18}, {0x08, 0x7E, 0x09, 0x01, 0x02}, {0x0C, 0x52, 0x52, 0x52, 0x3E},
+		{0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00}, {0x20, 0x40, 0x44, 0x3D, 0x00}, {0x7F, 0x10, 0x28, 0x44, 0x00},
+		{0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x18, 0x04, 0x78}, {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38},
+		{0x7C, 0x14, 0x14, 0x14, 0x08}, {0x08, 0x14, 0x14, 0x18, 0x7C}, {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x20},
+		{0x04, 0x3F, 0x44, 0x40, 0x20}, {0x3C, 0x40, 0x40, 0x20, 0x7C}, {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C},
+		{0x44, 0x28, 0x10, 0x28, 0x44}, {0x0C, 0x50, 0x50, 0x50, 0x3C}, {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00},
+		{0x00, 0x00, 0x7F, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00}, {0x04, 0x02, 0x04, 0x08, 0x04}
+};
+
+/* The colors of R used by the plots. */
+const int Raster::NAMED_COLORS_SIZE = 17;
+const char* Raster::NAMED_COLORS[] = {
+		"black", "white", "red", "green", "green3", "blue", "cyan", "magenta", "yellow",
+		"gray", "grey", "orange", "purple", "brown", "darkgreen", "darkblue", "darkred"
+};
+const unsigned int Raster::NAMED_COLORS_RGB[] = {
+		0x000000, 0xFFFFFF, 0xFF0000, 0x00FF00, 0x00CD00, 0x0000FF, 0x00FFFF, 0xFF00FF, 0xFFFF00,
+		0xBEBEBE, 0xBEBEBE, 0xFFA500, 0xA020F0, 0xA52A2A, 0x006400, 0x00008B, 0x8B0000
+};
+
+const unsigned int Raster::BLACK = 0x000000;
+const unsigned int Raster::WHITE = 0xFFFFFF;
+
+Raster::Raster(int width, int height) throw (PlotException) : pixels(NULL), width(width), height(height),
+	clip_left(0), clip_top(0), clip_right(width - 1), clip_bottom(height - 1) {
+
+	if (width <= 0) {
+		throw PlotException("Raster", "Raster( int, int )", __LINE__, 1, "width");
+	}
+
+	if (height <= 0) {
+		throw PlotException("Raster", "Raster( int, int )", __LINE__, 1, "height");
+	}
+
+	pixels = (unsigned char*)malloc(3 * width * height * sizeof(unsigned char));
+	if (pixels == NULL) {
+		throw PlotException("Raster", "Raster( int, int )", __LINE__, 2, 3 * width * height * sizeof(unsigned char));
+	}
+
+	fill(WHITE);
+}
+
+Raster::~Raster() {
+	free(pixels);
+	pixels = NULL;
+}
+
+int Raster::get_width() {
+	return width;
+}
+
+int Raster::get_height() {
+	return height;
+}
+
+void Raster::set_clip(int left, int top, int right, int bottom) {
+	clip_left = left < 0 ? 0 : left;
+	clip_top = top < 0 ? 0 : top;
+	clip_right = right >= width ? width - 1 : right;
+	clip_bottom = bottom >= height ? height - 1 : bottom;
+}
+
+void Raster::reset_clip() {
+	set_clip(0, 0, width - 1, height - 1);
+}
+
+void Raster::set_pixel(int x, int y, unsigned int color) {
+	unsigned char* pixel = NULL;
+
+	if ((x < clip_left) || (x > clip_right) || (y < clip_top) || (y > clip_bottom)) {
+		return;
+	}
+
+	pixel = pixels + 3 * ((int64_t)y * width + x);
+	pixel[0] = (color >> 16) & 0xFF;
+	pixel[1] = (color >> 8) & 0xFF;
+	pixel[2] = color & 0xFF;
+}
+
+void Raster::fill(unsigned int color) {
+	fill_rectangle(clip_left, clip_top, clip_right, clip_bottom, color);
+}
+
+void Raster::fill_rectangle(int left, int top, int right, int bottom, unsigned int color) {
+	int swap = 0;
+
+	if (left > right) {
+		swap = left; left = right; right = swap;
+	}
+
+	if (top > bottom) {
+		swap = top; top = bottom; bottom = swap;
+	}
+
+	for (int y = top; y <= bottom; y++) {
+		for (int x = left; x <= right; x++) {
+			set_pixel(x, y, color);
+		}
+	}
+}
+
+void Raster::draw_rectangle(int left, int top, int right, int bottom, unsigned int color) {
+	draw_line(left, top, right, top, color);
+	draw_line(right, top, right, bottom, color);
+	draw_line(right, bottom, left, bottom, color);
+	draw_line(left, bottom, left, top, color);
+}
+
+/*
+ * Bresenham's line. A thick line is drawn with a square brush, a dashed line alternates 4 pixels on and 4 pixels off.
+ */
+void Raster::draw_line(int x0, int y0, int x1, int y1, unsigned int color, int thickness, bool dashed) {
+	int dx = abs(x1 - x0);
+	int dy = -abs(y1 - y0);
+	int sx = x0 < x1 ? 1 : -1;
+	int sy = y0 < y1 ? 1 : -1;
+	int error = dx + dy;
+	int doubled_error = 0;
+	int step = 0;
+	int from = -(thickness - 1) / 2;
+	int to = thickness / 2;
+
+	while (true) {
+		if (!dashed || ((step / 4) % 2 == 0)) {
+			for (int i = from; i <= to; i++) {
+				for (int j = from; j <= to; j++) {
+					set_pixel(x0 + i, y0 + j, color);
+				}
+			}
+		}
+
+		if ((x0 == x1) && (y0 == y1)) {
+			break;
+		}
+
+		doubled_error = 2 * error;
+		if (doubled_error >= dy) {
+			error += dy;
+			x0 += sx;
+		}
+		if (doubled_error <= dx) {
+			error += dx;
+			y0 += sy;
+		}
+		step += 1;
+	}
+}
+
+void Raster::fill_circle(int x, int y, int radius, unsigned int color) {
+	for (int j = -radius; j <= radius; j++) {
+		for (int i = -radius; i <= radius; i++) {
+			if (i * i + j * j <= radius * radius + radius) {
+				set_pixel(x + i, y + j, color);
+			}
+		}
+	}
+}
+
+void Raster::draw_circle(int x, int y, int radius, unsigned int color) {
+	int outer = radius * radius + radius;
+	int inner = radius * radius - radius;
+
+	for (int j = -radius; j <= radius; j++) {
+		for (int i = -radius; i <= radius; i++) {
+			if ((i * i + j * j <= outer) && (i * i + j * j > inner)) {
+				set_pixel(x + i, y + j, color);
+			}
+		}
+	}
+}
+
+void Raster::draw_glyph(int x, int y, char c, unsigned int color, int scale, bool vertical) {
+	const unsigned char* glyph = NULL;
+
+	if ((c < ' ') || (c > '~')) {
+		c = '?';
+	}
+
+	glyph = GLYPHS[c - ' '];
+
+	for (int column = 0; column < GLYPH_WIDTH; column++) {
+		for (int row = 0; row < GLYPH_HEIGHT; row++) {
+			if (((glyph[column] >> row) & 1) == 0) {
+				continue;
+			}
+			if (vertical) {
+				fill_rectangle(x + row * scale, y - (column + 1) * scale + 1, x + (row + 1) * scale - 1, y - column * scale, color);
+			} else {
+				fill_rectangle(x + column * scale, y + row * scale, x + (column + 1) * scale - 1, y + (row + 1) * scale - 1, color);
+			}
+		}
+	}
+}
+
+/*
+ * Draws the text with its top left corner at (x, y). A vertical text reads upwards and starts at its bottom left corner (x, y).
+ * Every new line starts below (or, for a vertical text, to the right of) the previous one.
+ */
+void Raster::draw_text(int x, int y, const char* text, unsigned int color, int scale, bool vertical) {
+	int line_x = x;
+	int line_y = y;
+
+	if (text == NULL) {
+		return;
+	}
+
+	for (const char* c = text; *c != '\0'; c++) {
+		if (*c == '\n') {
+			if (vertical) {
+				line_x += (GLYPH_HEIGHT + 3) * scale;
+				x = line_x;
+				y = line_y;
+			} else {
+				line_y += (GLYPH_HEIGHT + 3) * scale;
+				x = line_x;
+				y = line_y;
+			}
+			continue;
+		}
+
+		draw_glyph(x, y, *c, color, scale, vertical);
+
+		if (vertical) {
+			y -= (GLYPH_WIDTH + 1) * scale;
+		} else {
+			x += (GLYPH_WIDTH + 1) * scale;
+		}
+	}
+}
+
+int Raster::get_text_width(const char* text, int scale) {
+	int width = 0;
+	int line_width = 0;
+
+	if (text == NULL) {
+		return 0;
+	}
+
+	for (const char* c = text; *c != '\0'; c++) {
+		if (*c == '\n') {
+			line_width = 0;
+			continue;
+		}
+		line_width += (GLYPH_WIDTH + 1) * scale;
+		if (line_width > width) {
+			width = line_width;
+		}
+	}
+
+	return width > 0 ? width - scale : 0;
+}
+
+int Raster::get_text_height(const char* text, int scale) {
+	int lines = 1;
+
+	if (text == NULL) {
+		return 0;
+	}
+
+	for (const char* c = text; *c != '\0'; c++) {
+		if (*c == '\n') {
+			lines += 1;
+		}
+	}
+
+	return (lines * (GLYPH_HEIGHT + 3) - 3) * scale;
+}
+
+/*
+ * Returns the color of an R color name or of a "#RRGGBB" string. Unknown colors are black.
+ */
+unsigned int Raster::get_color(const char* name) {
+	char* end = NULL;
+	unsigned long rgb = 0;
+
+	if (name == NULL) {
+		return BLACK;
+	}
+
+	if ((name[0] == '#') && (strlen(name) == 7)) {
+		rgb = strtoul(name + 1, &end, 16);
+		return *end == '\0' ? (unsigned int)rgb : BLACK;
+	}
+
+	for (int i = 0; i < NAMED_COLORS_SIZE; i++) {
+		if (strcmp(name, NAMED_COLORS[i]) == 0) {
+			return NAMED_COLORS_RGB[i];
+		}
+	}
+
+	return BLACK;
+}
+
+void Raster::write_uint32(unsigned char* buffer, unsigned int value) {
+	buffer[0] = (value >> 24) & 0xFF;
+	buffer[1] = (value >> 16) & 0xFF;
+	buffer[2] = (value >> 8) & 0xFF;
+	buffer[3] = value & 0xFF;
+}
+
+void Raster::write_chunk(FILE* file, const char* type, const unsigned char* data, unsigned int length) {
+	unsigned char buffer[4];
+	uLong crc = crc32(0L, Z_NULL, 0);
+
+	crc = crc32(crc, (const Bytef*)type, 4);
+	if (length > 0) {
+		crc = crc32(crc, data, length);
+	}
+
+	write_uint32(buffer, length);
+	fwrite(buffer, sizeof(unsigned char), 4, file);
+	fwrite(type, sizeof(char), 4, file);
+	if (length > 0) {
+		fwrite(data, sizeof(unsigned char), length, file);
+	}
+	write_uint32(buffer, (unsigned int)crc);
+	fwrite(buffer, sizeof(unsigned char), 4, file);
+}
+
+/*
+ * Writes the image as an 8-bit RGB PNG without interlacing. Every row is stored unfiltered and the whole image is deflated at once.
+ */
+void Raster::write_png(const char* file_name) throw (PlotException) {
+	static const unsigned char SIGNATURE[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+	unsigned char header[13];
+	unsigned char* rows = NULL;
+	unsigned char* compressed = NULL;
+	uLong rows_size = (uLong)(3 * width + 1) * height;
+	uLongf compressed_size = compressBound(rows_size);
+	int status = Z_OK;
+	FILE* file = NULL;
+
+	if (file_name == NULL) {
+		throw PlotException("Raster", "write_png( const char* )", __LINE__, 0, "file_name");
+	}
+
+	rows = (unsigned char*)malloc(rows_size * sizeof(unsigned char));
+	if (rows == NULL) {
+		throw PlotException("Raster", "write_png( const char* )", __LINE__, 2, rows_size * sizeof(unsigned char));
+	}
+
+	for (int y = 0; y < height; y++) {
+		rows[(uLong)y * (3 * width + 1)] = 0;
+		memcpy(rows + (uLong)y * (3 * width + 1) + 1, pixels + 3 * (int64_t)y * width, 3 * width * sizeof(unsigned char));
+	}
+
+	compressed = (unsigned char*)malloc(compressed_size * sizeof(unsigned char));
+	if (compressed == NULL) {
+		free(rows);
+		throw PlotException("Raster", "write_png( const char* )", __LINE__, 2, compressed_size * sizeof(unsigned char));
+	}
+
+	status = compress2(compressed, &compressed_size, rows, rows_size, Z_DEFAULT_COMPRESSION);
+	free(rows);
+	rows = NULL;
+
+	if (status != Z_OK) {
+		free(compressed);
+		throw PlotException("Raster", "write_png( const char* )", __LINE__, 6, status);
+	}
+
+	write_uint32(header, width);
+	write_uint32(header + 4, height);
+	header[8] = 8;
+	header[9] = 2;
+	header[10] = 0;
+	header[11] = 0;
+	header[12] = 0;
+
+	file = fopen(file_name, "wb");
+	if (file == NULL) {
+		free(compressed);
+		throw PlotException("Raster", "write_png( const char* )", __LINE__, 5, file_name);
+	}
+
+	fwrite(SIGNATURE, sizeof(unsigned char), 8, file);
+	write_chunk(file, "IHDR", header, 13);
+	write_chunk(file, "IDAT", compressed, compressed_size);
+	write_chunk(file, "IEND", NULL, 0);
+
+	free(compressed);
+
+	status = ferror(file);
+	if ((fclose(file) != 0) || (status != 0)) {
+		throw PlotException("Raster", "write_png( const char* )", __LINE__, 5, file_name);
+	}
+}
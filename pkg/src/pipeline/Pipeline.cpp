@@ -0,0 +1,425 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "include/Pipeline.h"
+
+const unsigned int Pipeline::TOKENS_HEAP_SIZE = 64;
+const unsigned int Pipeline::TOKENS_HEAP_INCREMENT = 64;
+const char Pipeline::OUTPUT_SEPARATOR = '\t';
+
+Pipeline::Pipeline() : gwafile(NULL), reader(NULL), cache_row(0), columns_number(0), annotation_on(false),
+	tokens(NULL), tokens_heap_size(0),
+	output_file_name(NULL), spill_file_name(NULL),
+	inflation_factor(numeric_limits<double>::quiet_NaN()), inflation_factor_estimated(false),
+	n_total(0), n_filtered(0), n_lambda(0) {
+
+}
+
+Pipeline::~Pipeline() {
+	if (reader != NULL) {
+		delete reader;
+		reader = NULL;
+	}
+
+	if (tokens != NULL) {
+		free(tokens);
+		tokens = NULL;
+	}
+
+	if (output_file_name != NULL) {
+		free(output_file_name);
+		output_file_name = NULL;
+	}
+
+	if (spill_file_name != NULL) {
+		free(spill_file_name);
+		spill_file_name = NULL;
+	}
+
+	gwafile = NULL;
+}
+
+void Pipeline::open_gwafile(GwaFile* gwafile) throw (PipelineException) {
+	if (gwafile == NULL) {
+		throw PipelineException("Pipeline", "open_gwafile( GwaFile* )", __LINE__, 0, "gwafile");
+	}
+
+	try {
+		close_gwafile();
+
+		annotation_on = (gwafile->get_descriptor()->get_property(Descriptor::REGIONS_FILE) != NULL);
+
+		analyzer.open_gwafile(gwafile);
+		formatter.open_gwafile(gwafile);
+		if (annotation_on) {
+			annotator.open_gwafile(gwafile);
+		}
+
+		reader = ReaderFactory::create(gwafile->get_descriptor()->get_full_path());
+		reader->set_file_name(gwafile->get_descriptor()->get_full_path());
+		reader->open();
+
+		this->gwafile = gwafile;
+	} catch (Exception &e) {
+		PipelineException new_e(e);
+		new_e.add_message("Pipeline", "open_gwafile( GwaFile* )", __LINE__, 4, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+void Pipeline::close_gwafile() throw (PipelineException) {
+	try {
+		if (reader != NULL) {
+			reader->close();
+			delete reader;
+			reader = NULL;
+		}
+
+		cache.close();
+
+		analyzer.close_gwafile();
+		formatter.close_gwafile();
+		annotator.close_gwafile();
+	} catch (Exception &e) {
+		PipelineException new_e(e);
+		new_e.add_message("Pipeline", "close_gwafile()", __LINE__, 5, gwafile != NULL ? gwafile->get_descriptor()->get_full_path() : "NULL");
+		throw new_e;
+	}
+
+	if (output_file_name != NULL) {
+		free(output_file_name);
+		output_file_name = NULL;
+	}
+
+	if (spill_file_name != NULL) {
+		free(spill_file_name);
+		spill_file_name = NULL;
+	}
+
+	cache_row = 0;
+	columns_number = 0;
+	annotation_on = false;
+	inflation_factor = numeric_limits<double>::quiet_NaN();
+	inflation_factor_estimated = false;
+	n_total = 0;
+	n_filtered = 0;
+	n_lambda = 0;
+
+	gwafile = NULL;
+}
+
+void Pipeline::process_header() throw (PipelineException) {
+	char* line = NULL;
+	char header_separator = '\0';
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	try {
+		analyzer.process_header();
+		analyzer.initialize_column_dependencies();
+		analyzer.initialize_filtered_columns();
+		analyzer.initialize_columns_ratios();
+
+		formatter.process_header();
+
+		if (annotation_on) {
+			annotator.process_header();
+			if (annotator.is_map_present()) {
+				annotator.index_map();
+			}
+			annotator.index_regions();
+		}
+
+		if (reader->read_line() <= 0) {
+			throw PipelineException("Pipeline", "process_header()", __LINE__, 6, gwafile->get_descriptor()->get_full_path());
+		}
+
+		header_separator = gwafile->get_header_separator();
+		line = *(reader->line);
+		columns_number = 0;
+		while (auxiliary::strtok(&line, header_separator) != NULL) {
+			columns_number += 1;
+		}
+	} catch (PipelineException &e) {
+		e.add_message("Pipeline", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
+		throw;
+	} catch (Exception &e) {
+		PipelineException new_e(e);
+		new_e.add_message("Pipeline", "process_header()", __LINE__, 7, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+void Pipeline::process_data() throw (PipelineException) {
+	Descriptor* descriptor = NULL;
+
+	int line_length = 0;
+	unsigned int line_number = 2;
+	char data_separator = '\0';
+	unsigned int tokens_number = 0;
+
+	const char* target_file_name = NULL;
+	ofstream ofile_stream;
+
+	vector<string> annotations;
+	vector<string>::iterator annotations_it;
+
+	if (gwafile == NULL) {
+		return;
+	}
+
+	try {
+		descriptor = gwafile->get_descriptor();
+		data_separator = gwafile->get_data_separator();
+
+		auxiliary::transform_file_name(&output_file_name, descriptor->get_property(Descriptor::FORMATPREFIX), descriptor->get_name(), NULL, true);
+		if (output_file_name == NULL) {
+			throw PipelineException("Pipeline", "process_data()", __LINE__, 10);
+		}
+
+		inflation_factor = numeric_limits<double>::quiet_NaN();
+		inflation_factor_estimated = false;
+		if (gwafile->is_gc_on()) {
+			inflation_factor = gwafile->get_inflation_factor();
+			inflation_factor_estimated = isnan(inflation_factor);
+		}
+
+		formatter.initialize_output(inflation_factor, gwafile->is_gc_on());
+
+		if (inflation_factor_estimated) {
+			auxiliary::transform_file_name(&spill_file_name, NULL, output_file_name, Formatter::SPILL_EXTENSION, true);
+			if (spill_file_name == NULL) {
+				throw PipelineException("Pipeline", "process_data()", __LINE__, 10);
+			}
+			target_file_name = spill_file_name;
+		} else {
+			target_file_name = output_file_name;
+		}
+
+		if (tokens == NULL) {
+			tokens_heap_size = (columns_number > TOKENS_HEAP_SIZE) ? columns_number : TOKENS_HEAP_SIZE;
+			tokens = (char**)malloc(tokens_heap_size * sizeof(char*));
+			if (tokens == NULL) {
+				throw PipelineException("Pipeline", "process_data()", __LINE__, 2, tokens_heap_size * sizeof(char*));
+			}
+		}
+
+		cache_row = 0;
+		if (gwafile->is_cache_on()) {
+			if (!cache.open(descriptor->get_full_path(), data_separator, columns_number)) {
+				cache.create(descriptor->get_full_path(), data_separator, columns_number, descriptor->get_property(Descriptor::MISSING));
+			}
+		}
+
+		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
+		ofile_stream.precision(numeric_limits<double>::digits10);
+
+		try {
+			ofile_stream.open(target_file_name);
+		} catch (ofstream::failure &e) {
+			throw PipelineException("Pipeline", "process_data()", __LINE__, 11, target_file_name);
+		}
+
+		n_total = 0;
+		n_filtered = 0;
+
+		try {
+			if (!inflation_factor_estimated) {
+				formatter.write_header(ofile_stream, OUTPUT_SEPARATOR);
+				if (annotation_on) {
+					annotator.write_header(ofile_stream, OUTPUT_SEPARATOR);
+				}
+				ofile_stream << "\n";
+			}
+
+			while ((line_length = read_row(tokens_number)) > 0) {
+				analyzer.process_row(tokens, tokens_number, line_number);
+
+				if (formatter.load_row(tokens, tokens_number)) {
+					if (annotation_on) {
+						annotator.annotate_row(tokens, line_number, annotations, OUTPUT_SEPARATOR);
+						for (annotations_it = annotations.begin(); annotations_it != annotations.end(); annotations_it++) {
+							formatter.write_row(ofile_stream, OUTPUT_SEPARATOR);
+							ofile_stream << *annotations_it << "\n";
+						}
+					} else {
+						formatter.write_row(ofile_stream, OUTPUT_SEPARATOR);
+						ofile_stream << "\n";
+					}
+
+					n_filtered += 1;
+				}
+
+				line_number += 1;
+			}
+		} catch (ofstream::failure &e) {
+			throw PipelineException("Pipeline", "process_data()", __LINE__, 13, target_file_name);
+		}
+
+		try {
+			ofile_stream.close();
+		} catch (ofstream::failure &e) {
+			throw PipelineException("Pipeline", "process_data()", __LINE__, 12, target_file_name);
+		}
+
+		n_total = line_number - 2;
+
+		if (line_length == 0) {
+			throw PipelineException("Pipeline", "process_data()", __LINE__, 8, line_number, descriptor->get_full_path());
+		}
+
+		cache.write();
+
+		analyzer.complete_data();
+
+		inflation_factor = formatter.complete_lambda(n_lambda);
+
+		if (inflation_factor_estimated) {
+			copy_spill();
+		}
+	} catch (PipelineException &e) {
+		e.add_message("Pipeline", "process_data()", __LINE__, 9, gwafile->get_descriptor()->get_full_path());
+		throw;
+	} catch (Exception &e) {
+		PipelineException new_e(e);
+		new_e.add_message("Pipeline", "process_data()", __LINE__, 9, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+}
+
+int Pipeline::read_row(unsigned int& tokens_number) throw (PipelineException) {
+	char* line = NULL;
+	int line_length = 0;
+	char* token = NULL;
+	char data_separator = gwafile->get_data_separator();
+	char** new_tokens = NULL;
+
+	tokens_number = 0;
+
+	try {
+		if (cache.is_open()) {
+			if (cache_row >= cache.get_rows_number()) {
+				return -1;
+			}
+
+			cache.get_row(cache_row++, tokens);
+			tokens_number = columns_number;
+
+			return 1;
+		}
+
+		if ((line_length = reader->read_line()) <= 0) {
+			return line_length;
+		}
+
+		line = *(reader->line);
+
+		while ((token = auxiliary::strtok(&line, data_separator)) != NULL) {
+			if (tokens_number >= tokens_heap_size) {
+				new_tokens = (char**)realloc(tokens, (tokens_heap_size + TOKENS_HEAP_INCREMENT) * sizeof(char*));
+				if (new_tokens == NULL) {
+					throw PipelineException("Pipeline", "read_row( unsigned int& )", __LINE__, 3, (tokens_heap_size + TOKENS_HEAP_INCREMENT) * sizeof(char*));
+				}
+				tokens = new_tokens;
+				tokens_heap_size += TOKENS_HEAP_INCREMENT;
+			}
+
+			auxiliary::trim(&token);
+			cache.put(tokens_number, token);
+			tokens[tokens_number++] = token;
+		}
+
+		cache.complete_row();
+	} catch (PipelineException &e) {
+		throw;
+	} catch (Exception &e) {
+		PipelineException new_e(e);
+		new_e.add_message("Pipeline", "read_row( unsigned int& )", __LINE__, 9, gwafile->get_descriptor()->get_full_path());
+		throw new_e;
+	}
+
+	return line_length;
+}
+
+void Pipeline::copy_spill() throw (PipelineException) {
+	ofstream ofile_stream;
+
+	try {
+		ofile_stream.exceptions(ios_base::failbit | ios_base::badbit);
+		ofile_stream.precision(numeric_limits<double>::digits10);
+
+		try {
+			ofile_stream.open(output_file_name);
+		} catch (ofstream::failure &e) {
+			throw PipelineException("Pipeline", "copy_spill()", __LINE__, 11, output_file_name);
+		}
+
+		try {
+			formatter.write_header(ofile_stream, OUTPUT_SEPARATOR);
+			if (annotation_on) {
+				annotator.write_header(ofile_stream, OUTPUT_SEPARATOR);
+			}
+			ofile_stream << "\n";
+
+			formatter.rewrite_rows(spill_file_name, ofile_stream, OUTPUT_SEPARATOR);
+		} catch (ofstream::failure &e) {
+			throw PipelineException("Pipeline", "copy_spill()", __LINE__, 13, output_file_name);
+		}
+
+		try {
+			ofile_stream.close();
+		} catch (ofstream::failure &e) {
+			throw PipelineException("Pipeline", "copy_spill()", __LINE__, 12, output_file_name);
+		}
+	} catch (FormatterException &e) {
+		PipelineException new_e(e);
+		new_e.add_message("Pipeline", "copy_spill()", __LINE__, 13, output_file_name);
+		throw new_e;
+	}
+}
+
+Analyzer* Pipeline::get_analyzer() {
+	return &analyzer;
+}
+
+bool Pipeline::is_annotation_on() {
+	return annotation_on;
+}
+
+double Pipeline::get_inflation_factor() {
+	return inflation_factor;
+}
+
+bool Pipeline::is_inflation_factor_estimated() {
+	return inflation_factor_estimated;
+}
+
+int Pipeline::get_n_total() {
+	return n_total;
+}
+
+int Pipeline::get_n_filtered() {
+	return n_filtered;
+}
+
+int Pipeline::get_n_lambda() {
+	return n_lambda;
+}
@@ -0,0 +1,94 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PIPELINE_H_
+#define PIPELINE_H_
+
+#include <vector>
+#include <string>
+#include <cstdio>
+
+#include "../../auxiliary/include/auxiliary.h"
+#include "../../reader/include/ReaderFactory.h"
+#include "../../reader/include/TextReader.h"
+#include "../../gwafile/include/GwaFile.h"
+#include "../../cache/include/GwaCache.h"
+#include "../../gwasqc/include/analyzer/Analyzer.h"
+#include "../../gwasformat/include/formatter/Formatter.h"
+#include "../../annotation/include/Annotator.h"
+#include "PipelineException.h"
+
+using namespace std;
+
+/*
+ * Quality check, formatting and annotation of a GWAS file in a single read: every line is tokenized once.
+ * If the inflation factor is estimated, formatted lines go to an intermediate file until it is known.
+ */
+class Pipeline {
+private:
+	GwaFile* gwafile;
+	Reader* reader;
+	GwaCache cache;
+	unsigned int cache_row;
+	unsigned int columns_number;
+
+	Analyzer analyzer;
+	Formatter formatter;
+	Annotator annotator;
+	bool annotation_on;
+
+	char** tokens;
+	unsigned int tokens_heap_size;
+
+	char* output_file_name;
+	char* spill_file_name;
+
+	double inflation_factor;
+	bool inflation_factor_estimated;
+	int n_total;
+	int n_filtered;
+	int n_lambda;
+
+	int read_row(unsigned int& tokens_number) throw (PipelineException);
+	void copy_spill() throw (PipelineException);
+
+public:
+	static const unsigned int TOKENS_HEAP_SIZE;
+	static const unsigned int TOKENS_HEAP_INCREMENT;
+	static const char OUTPUT_SEPARATOR;
+
+	Pipeline();
+	virtual ~Pipeline();
+
+	void open_gwafile(GwaFile* gwafile) throw (PipelineException);
+	void close_gwafile() throw (PipelineException);
+
+	void process_header() throw (PipelineException);
+	void process_data() throw (PipelineException);
+
+	Analyzer* get_analyzer();
+	bool is_annotation_on();
+	double get_inflation_factor();
+	bool is_inflation_factor_estimated();
+	int get_n_total();
+	int get_n_filtered();
+	int get_n_lambda();
+};
+
+#endif
@@ -23,7 +23,7 @@ const unsigned int GzipReader::DEFAULT_BUFFER_SIZE = 16777216;
 const unsigned int GzipReader::TOP_ROWS_NUMBER = 10;
 
 GzipReader::GzipReader(unsigned int buffer_size) throw (ReaderException) : Reader(&buffer),
-	opened(false), buffer_size(buffer_size), buffer(NULL) {
+	opened(false), position(0), buffer_size(buffer_size), buffer(NULL) {
 
 	buffer = (char*)malloc((buffer_size + 1) * sizeof(char));
 	if (buffer == NULL) {
@@ -49,6 +49,7 @@ void GzipReader::open() throw (ReaderException) {
 	}
 
 	opened = true;
+	position = 0;
 }
 
 void GzipReader::close() throw (ReaderException) {
@@ -70,6 +71,7 @@ int GzipReader::read_line() throw (ReaderException) {
 
 	while ((i < buffer_size) && ((c = gzgetc(infile)) >= 0)) {
 		buffer[i] = (char)c;
+		position += 1;
 
 		if (buffer[i] == '\n') {
 			buffer[i] = '\0';
@@ -79,6 +81,8 @@ int GzipReader::read_line() throw (ReaderException) {
 			if ((c = gzgetc(infile)) >= 0) {
 				if ((char)c != '\n') {
 					c = gzungetc(c, infile);
+				} else {
+					position += 1;
 				}
 			}
 			return i;
@@ -96,10 +100,15 @@ int GzipReader::read_line() throw (ReaderException) {
 	return (i == 0 ? -1 : i);
 }
 
+/*
+ * Rewinds without gzseek(), which takes a 32-bit offset on some platforms.
+ */
 void GzipReader::reset() throw (ReaderException) {
-	if (gzseek(infile, 0L, SEEK_SET) < 0) {
+	if (gzrewind(infile) != 0) {
 		throw ReaderException("GzipReader", "reset()", __LINE__, 6, file_name);
 	}
+
+	position = 0;
 }
 
 bool GzipReader::eof() {
@@ -107,7 +116,18 @@ bool GzipReader::eof() {
 }
 
 bool GzipReader::sof() {
-	return gztell(infile) == 0;
+	return position == 0;
+}
+
+/*
+ * Returns the offset of the next line in the uncompressed data. The reader has no random access.
+ */
+int64_t GzipReader::get_position() throw (ReaderException) {
+	if (!opened) {
+		return -1;
+	}
+
+	return position;
 }
 
 bool GzipReader::is_open() {
@@ -50,6 +50,21 @@ const char* Reader::get_file_name() {
 	return file_name;
 }
 
+/*
+ * Moves the read position to the beginning of the first line that starts after the given fraction of the file length.
+ * Returns false if the reader doesn't support random access (e.g. compressed files).
+ */
+bool Reader::seek(double fraction) throw (ReaderException) {
+	return false;
+}
+
+/*
+ * Returns the byte offset of the next line to be read, or -1 if the reader doesn't support random access.
+ */
+int64_t Reader::get_position() throw (ReaderException) {
+	return -1;
+}
+
 unsigned long int Reader::estimate_lines_count() throw (ReaderException) {
 	return 0;
 }
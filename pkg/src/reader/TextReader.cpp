@@ -135,14 +135,85 @@ int TextReader::get_buffer_size() {
 	return buffer_size;
 }
 
+bool TextReader::seek(double fraction) throw (ReaderException) {
+	int64_t file_length = 0;
+	int c = 0;
+
+	if (!ifile_stream.is_open()) {
+		return false;
+	}
+
+	if ((fraction < 0.0) || (fraction >= 1.0)) {
+		throw ReaderException("TextReader", "bool seek( double )", __LINE__, 1, "fraction");
+	}
+
+	ifile_stream.clear();
+	ifile_stream.seekg((streampos)0, ifstream::end);
+	if (ifile_stream.fail()) {
+		throw ReaderException("TextReader", "bool seek( double )", __LINE__, 6, file_name);
+	}
+
+	file_length = (streamoff)ifile_stream.tellg();
+	if (file_length < 0) {
+		throw ReaderException("TextReader", "bool seek( double )", __LINE__, 9, file_name);
+	}
+
+	ifile_stream.seekg((streamoff)(file_length * fraction), ifstream::beg);
+	if (ifile_stream.fail()) {
+		throw ReaderException("TextReader", "bool seek( double )", __LINE__, 6, file_name);
+	}
+
+	while ((c = ifile_stream.get()) != ifstream::traits_type::eof()) {
+		if ((char)c == '\n') {
+			break;
+		} else if ((char)c == '\r') {
+			if ((c = ifile_stream.peek()) != ifstream::traits_type::eof()) {
+				if ((char)c == '\n') {
+					ifile_stream.ignore();
+				}
+			}
+			break;
+		}
+	}
+
+	if ((!ifile_stream.eof()) && ifile_stream.fail()) {
+		throw ReaderException("TextReader", "bool seek( double )", __LINE__, 4, file_name);
+	}
+
+	return true;
+}
+
+int64_t TextReader::get_position() throw (ReaderException) {
+	int64_t position = 0;
+
+	if (!ifile_stream.is_open()) {
+		return -1;
+	}
+
+	if (ifile_stream.eof()) {
+		ifile_stream.clear();
+		ifile_stream.seekg((streampos)0, ifstream::end);
+		if (ifile_stream.fail()) {
+			throw ReaderException("TextReader", "int64_t get_position()", __LINE__, 6, file_name);
+		}
+	}
+
+	position = (streamoff)ifile_stream.tellg();
+	if (position < 0) {
+		throw ReaderException("TextReader", "int64_t get_position()", __LINE__, 9, file_name);
+	}
+
+	return position;
+}
+
 unsigned long int TextReader::estimate_lines_count() throw (ReaderException) {
-	long int file_length = 0;
+	int64_t file_length = 0;
 	int header_length = 0;
 	int c = 0;
 
 	int denominator = ROWS_SAMPLE_SIZE * 100;
 	double estimated_location = 0.0;
-	long int file_position = 0;
+	int64_t file_position = 0;
 	int chars_count = 0;
 	int lines_count = 0;
 
@@ -169,7 +240,7 @@ unsigned long int TextReader::estimate_lines_count() throw (ReaderException) {
 		throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 6, file_name);
 	}
 
-	file_length = ifile_stream.tellg();
+	file_length = (streamoff)ifile_stream.tellg();
 	if (file_length < 0) {
 		ifile_stream.clear();
 		ifile_stream.close();
@@ -209,9 +280,9 @@ unsigned long int TextReader::estimate_lines_count() throw (ReaderException) {
 		for (unsigned int i = 0; i < ROWS_SAMPLE_COUNT; i++) {
 			for (unsigned int j = 0; j < ROWS_SAMPLE_SIZE; j++) {
 				estimated_location = (rand() % denominator) / (double)denominator;
-				file_position = (long int)(file_length * estimated_location);
+				file_position = (int64_t)(file_length * estimated_location);
 
-				ifile_stream.seekg((streampos)file_position, ifstream::beg);
+				ifile_stream.seekg((streamoff)file_position, ifstream::beg);
 				if (ifile_stream.fail()) {
 					throw ReaderException("TextReader", "unsigned int estimate_lines_count()", __LINE__, 6, file_name);
 				}
@@ -279,7 +350,7 @@ unsigned long int TextReader::estimate_lines_count() throw (ReaderException) {
 		}
 		mean = mean / sample_means.size();
 
-		estimated_lines_count =  (long int)ceil((file_length - header_length) / mean);
+		estimated_lines_count =  (unsigned int)ceil((file_length - header_length) / mean);
 	}
 
 	ifile_stream.clear();
@@ -29,6 +29,9 @@ private:
 
 	bool opened;
 
+	/* Offset in the uncompressed data. Kept here, since the offsets of zlib may be 32-bit. */
+	int64_t position;
+
 	int buffer_size;
 	char* buffer;
 
@@ -45,6 +48,7 @@ public:
 	void reset() throw (ReaderException);
 	bool eof();
 	bool sof();
+	int64_t get_position() throw (ReaderException);
 	bool is_open();
 	bool is_compressed();
 	int get_buffer_size();
@@ -20,6 +20,8 @@
 #ifndef READER_H_
 #define READER_H_
 
+#include <stdint.h>
+
 #include "ReaderException.h"
 
 class Reader {
@@ -48,6 +50,8 @@ public:
 	virtual bool is_open() = 0;
 	virtual bool is_compressed() = 0;
 	virtual int get_buffer_size() = 0;
+	virtual bool seek(double fraction) throw (ReaderException);
+	virtual int64_t get_position() throw (ReaderException);
 	virtual unsigned long int estimate_lines_count() throw (ReaderException);
 	virtual void detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException);
 };
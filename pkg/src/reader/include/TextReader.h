@@ -54,6 +54,8 @@ public:
 	bool is_open();
 	bool is_compressed();
 	int get_buffer_size();
+	bool seek(double fraction) throw (ReaderException);
+	int64_t get_position() throw (ReaderException);
 	unsigned long int estimate_lines_count() throw (ReaderException);
 	void detect_field_separators(char* header_separator, char* data_separator) throw (ReaderException);
 };
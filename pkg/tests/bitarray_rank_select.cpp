@@ -0,0 +1,119 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Test of BitArray::count(), rank() and select() against a bit-by-bit scan with get_bit().
+ *
+ * This is a manual tool, not part of the package checks. Build and run from the package directory:
+ *   g++ -std=gnu++11 -O2 -Isrc tests/bitarray_rank_select.cpp src/bitarray/BitArray.cpp src/bitarray/BitArrayException.cpp \
+ *     src/exception/Exception.cpp -o bitarray_rank_select
+ *   ./bitarray_rank_select 1000000
+ *
+ * Sets the bits of the given number of positions (1 million by default) with densities from empty to full, so that the
+ * words and the directory blocks are empty, full or mixed, and checks every rank and select. The bits are set in two
+ * steps, so that the queries after the second step check that the directory is rebuilt.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <stdint.h>
+
+#include "bitarray/include/BitArray.h"
+
+using namespace std;
+
+const unsigned int DENSITIES_CNT = 6;
+const double DENSITIES[] = {0.0, 0.001, 0.1, 0.5, 0.9, 1.0};
+
+uint64_t next_random(uint64_t* state) {
+	*state = *state * 6364136223846793005ull + 1442695040888963407ull;
+	return *state >> 11;
+}
+
+bool check(BitArray& bitarray, uint64_t size) throw (BitArrayException) {
+	uint64_t bits = 0;
+	uint64_t errors = 0;
+
+	for (uint64_t i = 0; i < size; i++) {
+		if (bitarray.rank(i) != bits) {
+			errors += 1;
+		}
+		if (bitarray.get_bit(i) != 0) {
+			if (bitarray.select(bits) != (int64_t)i) {
+				errors += 1;
+			}
+			bits += 1;
+		}
+	}
+
+	if (bitarray.count() != bits) {
+		errors += 1;
+	}
+
+	if (bitarray.rank(size + 1000) != bits) {
+		errors += 1;
+	}
+
+	if (bitarray.select(bits) != -1) {
+		errors += 1;
+	}
+
+	cout << "  " << bits << " set bits, " << errors << " errors" << endl;
+
+	return errors == 0;
+}
+
+int main(int args, char** argv) {
+	uint64_t size = 1000000u;
+	uint64_t state = 1u;
+	bool passed = true;
+
+	if (args > 1) {
+		size = strtoull(argv[1], NULL, 10);
+	}
+
+	try {
+		for (unsigned int d = 0u; d < DENSITIES_CNT; d++) {
+			BitArray bitarray(64u);
+
+			cout << "density " << DENSITIES[d] << endl;
+
+			for (uint64_t i = 0; i < size / 2; i++) {
+				if ((next_random(&state) % 1000000u) < DENSITIES[d] * 1000000u) {
+					bitarray.set_bit(i);
+				}
+			}
+			passed &= check(bitarray, size);
+
+			for (uint64_t i = size / 2; i < size; i++) {
+				if ((next_random(&state) % 1000000u) < DENSITIES[d] * 1000000u) {
+					bitarray.set_bit(i);
+				}
+			}
+			passed &= check(bitarray, size);
+		}
+	} catch (Exception &e) {
+		cerr << e.what() << endl;
+		passed = false;
+	}
+
+	cout << (passed ? "ok" : "FAILED") << endl;
+
+	return passed ? 0 : 1;
+}
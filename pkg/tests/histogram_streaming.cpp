@@ -0,0 +1,189 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Test of the Histogram classes, which are counted as the values arrive, against a direct count with the final breaks.
+ *
+ * This is a manual tool, not part of the package checks. Build and run from the package directory (R headers and library
+ * are required by the plots):
+ *   g++ -std=gnu++11 -O2 -Isrc $(R CMD config --cppflags) tests/histogram_streaming.cpp src/exception/Exception.cpp \
+ *     src/gwasqc/libs/plots/Histogram.cpp src/gwasqc/libs/plots/PlotException.cpp $(R CMD config --ldflags) \
+ *     -o histogram_streaming
+ *   ./histogram_streaming 1000000
+ *
+ * Adds up to the given number of values (1 million by default) from uniform, normal, skewed and discrete distributions,
+ * in random, increasing and decreasing order, with NaNs and infinities among them. Every value must be counted once, in
+ * the class (lower, upper] given by the breaks, except the lowest values, which may lie on the lower break of the first
+ * class. The values within 1e-7 of the class width from a break may be counted on either side of it. The empty classes
+ * at both ends must be dropped. The values of the declared ranges may fall outside of them.
+ */
+
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <stdint.h>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "gwasqc/include/plots/Histogram.h"
+
+using namespace std;
+
+const unsigned int DISTRIBUTIONS_CNT = 5;
+const char* DISTRIBUTIONS[] = {"uniform", "normal", "skewed", "clustered", "discrete"};
+
+uint64_t next_random(uint64_t* state) {
+	*state = *state * 6364136223846793005ull + 1442695040888963407ull;
+	return *state >> 11;
+}
+
+double next_uniform(uint64_t* state) {
+	return ((next_random(state) % 1000000000u) + 0.5) / 1000000000.0;
+}
+
+double next_value(unsigned int distribution, uint64_t i, uint64_t size, uint64_t* state) {
+	double u = next_uniform(state);
+
+	if (i % 97u == 0u) {
+		return numeric_limits<double>::quiet_NaN();
+	}
+
+	if (i % 1001u == 0u) {
+		return numeric_limits<double>::infinity();
+	}
+
+	switch (distribution) {
+		case 0:
+			return u;
+		case 1:
+			return sqrt(-2.0 * log(u)) * cos(6.283185307179586 * next_uniform(state));
+		case 2:
+			return exp(10.0 * u) - 3.0;
+		case 3:
+			return i < size / 2u ? u * 0.001 : u * 10000.0;
+		default:
+			return floor(u * 100.0) / 10.0;
+	}
+}
+
+bool check(Histogram* histogram, vector<double>& values) throw (PlotException) {
+	const double* breaks = NULL;
+	const int64_t* counts = NULL;
+	int nclass = 0;
+	double tolerance = 0.0;
+	vector<double> finite;
+	int64_t below = 0;
+	int64_t at_most = 0;
+	int64_t total = 0;
+	int errors = 0;
+
+	histogram->finish();
+
+	breaks = histogram->get_breaks();
+	counts = histogram->get_counts();
+	nclass = histogram->get_nclass();
+	tolerance = 1e-7 * (breaks[1] - breaks[0]);
+
+	for (unsigned int i = 0u; i < values.size(); i++) {
+		if ((!isnan(values[i])) && (!isinf(values[i]))) {
+			finite.push_back(values[i]);
+		}
+	}
+	sort(finite.begin(), finite.end());
+
+	if ((histogram->get_n_finite() != (int64_t)finite.size()) || (finite.front() < breaks[0] - tolerance)) {
+		errors += 1;
+	}
+
+	for (int j = 0; j < nclass; j++) {
+		total += counts[j];
+		below = upper_bound(finite.begin(), finite.end(), breaks[j + 1] - tolerance) - finite.begin();
+		at_most = upper_bound(finite.begin(), finite.end(), breaks[j + 1] + tolerance) - finite.begin();
+		if ((total < below) || (total > at_most)) {
+			errors += 1;
+		}
+	}
+
+	if (total != (int64_t)finite.size()) {
+		errors += 1;
+	}
+
+	if ((counts[0] == 0) || (counts[nclass - 1] == 0)) {
+		errors += 1;
+	}
+
+	cout << "  " << nclass << " classes from " << breaks[0] << " to " << breaks[nclass] << ", " << errors << " errors" << endl;
+
+	return errors == 0;
+}
+
+int main(int args, char** argv) {
+	uint64_t size = 1000000u;
+	uint64_t state = 1u;
+	vector<double> values;
+	Histogram* histogram = NULL;
+	bool passed = true;
+
+	if (args > 1) {
+		size = strtoull(argv[1], NULL, 10);
+	}
+
+	try {
+		for (unsigned int d = 0u; d < DISTRIBUTIONS_CNT; d++) {
+			for (unsigned int order = 0u; order < 3u; order++) {
+				values.clear();
+				for (uint64_t i = 0u; i < size; i++) {
+					values.push_back(next_value(d, i, size, &state));
+				}
+
+				if (order == 1u) {
+					sort(values.begin(), values.end());
+				} else if (order == 2u) {
+					sort(values.begin(), values.end(), greater<double>());
+				}
+
+				cout << DISTRIBUTIONS[d] << (order == 0u ? ", random" : (order == 1u ? ", increasing" : ", decreasing")) << endl;
+
+				histogram = Histogram::create("x", 1000);
+				for (unsigned int i = 0u; i < values.size(); i++) {
+					histogram->add(values[i]);
+				}
+				passed &= check(histogram, values);
+				delete histogram;
+
+				histogram = Histogram::create("x", 0.0, 1.0, 1000);
+				for (unsigned int i = 0u; i < values.size(); i++) {
+					histogram->add(values[i]);
+				}
+				passed &= check(histogram, values);
+				delete histogram;
+				histogram = NULL;
+			}
+		}
+	} catch (Exception &e) {
+		cerr << e.what() << endl;
+		delete histogram;
+		passed = false;
+	}
+
+	cout << (passed ? "ok" : "FAILED") << endl;
+
+	return passed ? 0 : 1;
+}
@@ -0,0 +1,114 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Stress test of the 64-bit counters on the low-memory path of MetaNumeric.
+ *
+ * This is a manual tool, not part of the package checks. Build and run from the package directory (R headers and library
+ * are required by the plots):
+ *   gcc -O2 -c src/zlib/*.c
+ *   g++ -std=gnu++11 -O2 -Isrc $(R CMD config --cppflags) tests/low_memory_stress.cpp src/auxiliary/auxiliary.cpp \
+ *     src/exception/Exception.cpp src/gwasqc/libs/metas/Meta.cpp src/gwasqc/libs/metas/MetaException.cpp \
+ *     src/gwasqc/libs/metas/MetaNumeric.cpp src/gwasqc/libs/plots/*.cpp *.o $(R CMD config --ldflags) -o low_memory_stress
+ *   ./low_memory_stress 3000000000
+ *
+ * Passes the given number of values (3 billion by default) twice through a low-memory column, as the analyzer does, and
+ * checks the counts and the order statistics against their known values. The values cycle through 0.000, 0.001, ..., 0.999
+ * followed by one NA, so the column holds more than 2^31 values without keeping any of them.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <stdint.h>
+
+#include "gwasqc/include/metas/MetaNumeric.h"
+
+using namespace std;
+
+const unsigned int CYCLE_SIZE = 1000;
+
+void pass(MetaNumeric& meta, char values[][8], uint64_t cycles) throw (MetaException) {
+	for (uint64_t i = 0u; i < cycles; i++) {
+		for (unsigned int j = 0u; j <= CYCLE_SIZE; j++) {
+			meta.put(values[j]);
+		}
+	}
+}
+
+bool check(const char* name, double actual, double expected) {
+	bool passed = fabs(actual - expected) <= 1e-9 * (fabs(expected) > 1.0 ? fabs(expected) : 1.0);
+
+	cout << setw(8) << left << name << setw(24) << setprecision(12) << actual;
+	cout << setw(24) << expected << (passed ? "ok" : "FAILED") << endl;
+
+	return passed;
+}
+
+int main(int args, char** argv) {
+	uint64_t size = 3000000000u;
+	uint64_t cycles = 0u;
+	char values[CYCLE_SIZE + 1][8];
+	bool passed = true;
+
+	if (args > 1) {
+		size = strtoull(argv[1], NULL, 10);
+	}
+
+	cycles = (size + CYCLE_SIZE - 1) / CYCLE_SIZE;
+	if (cycles < 1u) {
+		cycles = 1u;
+	}
+
+	for (unsigned int j = 0u; j < CYCLE_SIZE; j++) {
+		sprintf(values[j], "%.3f", j / (double)CYCLE_SIZE);
+	}
+	strcpy(values[CYCLE_SIZE], "NA");
+
+	try {
+		MetaNumeric meta;
+
+		meta.set_common_name("VALUE");
+		meta.set_na_marker("NA");
+		meta.set_plots(false, false, false);
+		meta.set_low_memory(true);
+
+		pass(meta, values, cycles);
+		meta.begin_refinement();
+		pass(meta, values, cycles);
+		meta.finalize();
+
+		/* Every value occurs once per cycle, so the value at rank r (from 0) is floor(r / cycles) / CYCLE_SIZE. */
+		cout << cycles * CYCLE_SIZE << " values, " << cycles << " NAs" << endl;
+		passed &= check("n", (double)meta.get_n(), (double)(cycles * CYCLE_SIZE));
+		passed &= check("na", (double)meta.get_na(), (double)cycles);
+		passed &= check("mean", meta.get_mean(), (CYCLE_SIZE - 1) / (2.0 * CYCLE_SIZE));
+		passed &= check("min", meta.get_min(), 0.0);
+		passed &= check("max", meta.get_max(), (CYCLE_SIZE - 1) / (double)CYCLE_SIZE);
+		passed &= check("median", meta.get_median(), (CYCLE_SIZE - 1) / (2.0 * CYCLE_SIZE));
+	} catch (Exception &e) {
+		cerr << e.what() << endl;
+		passed = false;
+	}
+
+	return passed ? 0 : 1;
+}
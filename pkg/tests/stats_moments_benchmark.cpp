@@ -0,0 +1,162 @@
+/*
+ * Copyright  2011 Daniel Taliun, Christian Fuchsberger and Cristian Pattaro. All rights reserved.
+ *
+ * This file is part of GWAtoolbox.
+ *
+ * GWAtoolbox is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * GWAtoolbox is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with GWAtoolbox.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Benchmark of auxiliary::stats_moments() against the scalar pow() loops it replaced.
+ *
+ * This is a manual tool, not part of the package checks. Build and run from the package directory:
+ *   g++ -std=gnu++11 -O2 -Isrc tests/stats_moments_benchmark.cpp src/auxiliary/auxiliary.cpp -o stats_moments_benchmark
+ *   ./stats_moments_benchmark 10000000 100000000
+ *
+ * For every array size given on the command line (10M and 100M values by default) prints the running time of both
+ * versions and their absolute errors against a long double reference.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <stdint.h>
+
+#include "auxiliary/include/auxiliary.h"
+
+using namespace std;
+
+void scalar_moments(const double* data, uint64_t size, double& mean, double& sd, double& skewness, double& kurtosis) {
+	double sum = 0.0;
+
+	for (uint64_t i = 0; i < size; i++) {
+		sum += data[i];
+	}
+	mean = sum / size;
+
+	sum = 0.0;
+	for (uint64_t i = 0; i < size; i++) {
+		sum += pow(data[i] - mean, 2.0);
+	}
+	sd = sqrt(sum / (size - 1));
+
+	sum = 0.0;
+	for (uint64_t i = 0; i < size; i++) {
+		sum += pow((data[i] - mean) / sd, 3.0);
+	}
+	skewness = sum / size;
+
+	sum = 0.0;
+	for (uint64_t i = 0; i < size; i++) {
+		sum += pow((data[i] - mean) / sd, 4.0);
+	}
+	kurtosis = sum / size - 3.0;
+}
+
+void reference_moments(const double* data, uint64_t size, long double* moments) {
+	long double sums[3] = {0.0L, 0.0L, 0.0L};
+	long double mean = 0.0L;
+	long double deviation = 0.0L;
+	long double sd2 = 0.0L;
+
+	for (uint64_t i = 0; i < size; i++) {
+		mean += data[i];
+	}
+	mean /= size;
+
+	for (uint64_t i = 0; i < size; i++) {
+		deviation = data[i] - mean;
+		sums[0] += deviation * deviation;
+		sums[1] += deviation * deviation * deviation;
+		sums[2] += deviation * deviation * deviation * deviation;
+	}
+
+	sd2 = sums[0] / (size - 1);
+
+	moments[0] = mean;
+	moments[1] = sqrtl(sd2);
+	moments[2] = sums[1] / (sd2 * moments[1]) / size;
+	moments[3] = sums[2] / (sd2 * sd2) / size - 3.0L;
+}
+
+void print(const char* name, double seconds, const double* moments, const long double* reference) {
+	cout << setw(14) << name << setw(10) << setprecision(3) << fixed << seconds;
+	for (unsigned int i = 0; i < 4; i++) {
+		cout << setw(14) << setprecision(3) << scientific << (double)fabsl(moments[i] - reference[i]);
+	}
+	cout << endl;
+}
+
+int main(int args, char** argv) {
+	const char* default_sizes[2] = {"10000000", "100000000"};
+	const char** sizes = default_sizes;
+	int n_sizes = 2;
+
+	double* data = NULL;
+	uint64_t size = 0u;
+
+	double moments[4];
+	long double reference[4];
+	clock_t start = 0;
+	double seconds = 0.0;
+
+	if (args > 1) {
+		sizes = (const char**)(argv + 1);
+		n_sizes = args - 1;
+	}
+
+	srand(1);
+
+	for (int s = 0; s < n_sizes; s++) {
+		size = strtoull(sizes[s], NULL, 10);
+		if (size < 2u) {
+			cerr << "Array size must be at least 2." << endl;
+			return 1;
+		}
+
+		data = (double*)malloc(size * sizeof(double));
+		if (data == NULL) {
+			cerr << "Can't allocate " << size << " values." << endl;
+			return 1;
+		}
+
+		/* Skewed values with a large offset, like the allele frequencies or the standard errors. */
+		for (uint64_t i = 0u; i < size; i++) {
+			data[i] = 1000.0 - log((rand() + 1.0) / (RAND_MAX + 2.0));
+		}
+
+		reference_moments(data, size, reference);
+
+		cout << size << " values" << endl;
+		cout << setw(14) << "" << setw(10) << "seconds" << setw(14) << "mean error" << setw(14) << "sd error";
+		cout << setw(14) << "skew error" << setw(14) << "kurt error" << endl;
+
+		start = clock();
+		scalar_moments(data, size, moments[0], moments[1], moments[2], moments[3]);
+		seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+		print("scalar", seconds, moments, reference);
+
+		start = clock();
+		auxiliary::stats_moments(data, size, moments[0], moments[1], moments[2], moments[3]);
+		seconds = (double)(clock() - start) / CLOCKS_PER_SEC;
+		print("stats_moments", seconds, moments, reference);
+
+		free(data);
+		data = NULL;
+	}
+
+	return 0;
+}